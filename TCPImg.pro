@@ -34,15 +34,57 @@ SOURCES += \
         main.cpp \
         dialog.cpp \
         ctcpimg.cpp \
+        frameparser.cpp \
+        framebuffer.cpp \
+        networkdiagnostics.cpp \
+        imageconverter.cpp \
+        imageviewer.cpp \
+        imagescaler.cpp \
+        tiledframe.cpp \
+        displayscheduler.cpp \
+        latencystats.cpp \
+        metricsregistry.cpp \
+        metricsserver.cpp \
+        sharedframering.cpp \
+        framerelay.cpp \
         dataformatter.cpp \
+        packetlogmodel.cpp \
+        debugserver.cpp \
+        trafficgenerator.cpp \
+        linkstats.cpp \
+        latencyprobe.cpp \
+        pcapcapture.cpp \
         tcpdebugger.cpp
 
 HEADERS += \
         dialog.h \
     ctcpimg.h \
+        frameprotocol.h \
+        frameparser.h \
+        framebuffer.h \
+        networkdiagnostics.h \
+        imageconverter.h \
+        imageviewer.h \
+        imagescaler.h \
+        tiledframe.h \
+        displayscheduler.h \
+        latencystats.h \
+        metricsregistry.h \
+        metricsserver.h \
+        sharedframering.h \
+        framerelay.h \
         sysdefine.h \
         dataformatter.h \
+        packetlogmodel.h \
+        debugserver.h \
+        trafficgenerator.h \
+        linkstats.h \
+        latencyprobe.h \
+        pcapcapture.h \
         tcpdebugger.h
 
 FORMS += \
         dialog.ui
+
+# 共享内存帧环使用 shm_open，glibc 2.34 之前位于 librt
+linux: LIBS += -lrt
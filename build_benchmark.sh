@@ -0,0 +1,140 @@
+#!/bin/bash
+
+# 接收热路径微基准测试编译脚本
+# 用于编译 tcpimg-bench，测量解析、转换、缩放和格式化的性能并输出JSON
+
+echo "🚀 TCP图像接收微基准测试编译器"
+echo "============================================"
+
+# 检查Qt版本
+echo "🔍 检查Qt环境..."
+qt_version=$(qmake --version | grep "Qt version" | awk '{print $4}')
+if [ -z "$qt_version" ]; then
+    echo "❌ 错误：未找到Qt环境，请安装Qt开发包"
+    echo "   Ubuntu/Debian: sudo apt-get install qt5-default qtbase5-dev"
+    echo "   CentOS/Fedora: sudo yum install qt5-qtbase-devel"
+    exit 1
+fi
+
+echo "✅ Qt版本：$qt_version"
+
+# 检查必需的源文件
+echo "🔍 检查源文件..."
+required_files=("tcpimg_bench.cpp" "frameparser.h" "frameparser.cpp" "framebuffer.h" "framebuffer.cpp" "frameprotocol.h" \
+                "imageconverter.h" "imageconverter.cpp" "imagescaler.h" "imagescaler.cpp" \
+                "tiledframe.h" "tiledframe.cpp" \
+                "dataformatter.h" "dataformatter.cpp" \
+                "linkstats.h" "linkstats.cpp")
+for file in "${required_files[@]}"; do
+    if [ ! -f "$file" ]; then
+        echo "❌ 错误：缺少必需文件 $file"
+        exit 1
+    fi
+done
+echo "✅ 所有源文件检查完成"
+
+# 创建基准测试专用的项目文件
+echo "📝 生成基准测试项目配置..."
+cat > tcpimg_bench.pro << 'EOF'
+# 接收热路径微基准测试项目配置
+QT += core gui
+
+TARGET = tcpimg-bench
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG += c++11
+CONFIG += release
+
+# 输出目录
+DESTDIR = ./
+
+# 源文件
+SOURCES += \
+    tcpimg_bench.cpp \
+    frameparser.cpp \
+    framebuffer.cpp \
+    imageconverter.cpp \
+    imagescaler.cpp \
+    tiledframe.cpp \
+    dataformatter.cpp \
+    linkstats.cpp
+
+# 头文件
+HEADERS += \
+    frameparser.h \
+    framebuffer.h \
+    frameprotocol.h \
+    imageconverter.h \
+    imagescaler.h \
+    tiledframe.h \
+    dataformatter.h \
+    linkstats.h
+
+# 编译选项（与主程序发布版本一致）
+QMAKE_CXXFLAGS += -O2 -Wall
+
+# Qt版本兼容性
+lessThan(QT_MAJOR_VERSION, 6) {
+    message("编译目标：Qt 5.x (兼容模式)")
+    DEFINES += QT_NO_FOREACH
+} else {
+    message("编译目标：Qt 6.x")
+}
+
+message("项目：TCP图像接收微基准测试")
+EOF
+
+# 创建构建目录
+echo "📁 准备构建环境..."
+BUILD_DIR="build_bench"
+if [ -d "$BUILD_DIR" ]; then
+    echo "🧹 清理旧的构建目录..."
+    rm -rf "$BUILD_DIR"
+fi
+mkdir -p "$BUILD_DIR"
+
+# 进入构建目录
+cd "$BUILD_DIR"
+
+# 运行qmake
+echo "⚙️  配置项目..."
+qmake ../tcpimg_bench.pro
+if [ $? -ne 0 ]; then
+    echo "❌ qmake配置失败"
+    exit 1
+fi
+
+# 编译项目
+echo "🔨 编译基准测试程序..."
+cpu_cores=$(nproc 2>/dev/null || echo "1")
+echo "🚀 使用 $cpu_cores 个CPU核心进行编译"
+
+make -j$cpu_cores
+if [ $? -ne 0 ]; then
+    echo "❌ 编译失败"
+    exit 1
+fi
+
+# 检查编译结果
+if [ -f "tcpimg-bench" ]; then
+    echo "✅ 编译成功！"
+    echo ""
+    echo "📊 基准测试信息："
+    echo "   - 可执行文件：./build_bench/tcpimg-bench"
+    echo "   - 测试项：数据流解析、帧头推断、通道提取、适应窗口缩放、十六进制/二进制格式化"
+    echo "   - 输出格式：JSON（ns/次、ns/帧、字节/秒）"
+    echo ""
+    echo "🚀 使用方法："
+    echo "   ./build_bench/tcpimg-bench -o bench_results.json"
+    echo "   ./build_bench/tcpimg-bench --filter parser --repeats 10"
+    echo "   ./build_bench/tcpimg-bench -W 640 -H 2048 -c 2 --list"
+    echo ""
+    echo "💡 提示："
+    echo "   - 测试期间避免运行其他高负载程序"
+    echo "   - 无显示环境下自动使用offscreen平台"
+else
+    echo "❌ 编译失败：未找到可执行文件"
+    exit 1
+fi
+
+echo "🎉 微基准测试程序编译完成！"
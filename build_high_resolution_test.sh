@@ -20,7 +20,7 @@ echo "✅ Qt版本：$qt_version"
 
 # 检查必需的源文件
 echo "🔍 检查源文件..."
-required_files=("ctcpimg.h" "ctcpimg.cpp" "sysdefine.h" "test_high_resolution.cpp")
+required_files=("ctcpimg.h" "ctcpimg.cpp" "frameparser.h" "frameparser.cpp" "framebuffer.h" "framebuffer.cpp" "networkdiagnostics.h" "networkdiagnostics.cpp" "frameprotocol.h" "latencystats.h" "latencystats.cpp" "metricsregistry.h" "metricsregistry.cpp" "sharedframering.h" "sharedframering.cpp" "framerelay.h" "framerelay.cpp" "sysdefine.h" "test_high_resolution.cpp")
 for file in "${required_files[@]}"; do
     if [ ! -f "$file" ]; then
         echo "❌ 错误：缺少必需文件 $file"
@@ -47,11 +47,26 @@ DESTDIR = ./
 # 源文件
 SOURCES += \
     test_high_resolution.cpp \
-    ctcpimg.cpp
+    ctcpimg.cpp \
+    frameparser.cpp \
+    framebuffer.cpp \
+    networkdiagnostics.cpp \
+    latencystats.cpp \
+    metricsregistry.cpp \
+    sharedframering.cpp \
+    framerelay.cpp
 
 # 头文件
 HEADERS += \
     ctcpimg.h \
+    frameparser.h \
+    framebuffer.h \
+    networkdiagnostics.h \
+    frameprotocol.h \
+    latencystats.h \
+    metricsregistry.h \
+    sharedframering.h \
+    framerelay.h \
     sysdefine.h
 
 # 编译选项
@@ -69,6 +84,7 @@ lessThan(QT_MAJOR_VERSION, 6) {
 unix {
     QMAKE_LFLAGS += -Wl,-rpath=.
 }
+linux: LIBS += -lrt
 
 message("项目：千兆网高分辨率图像接收测试")
 message("目标：1280×1024×8bit×2tap×20fps性能验证")
@@ -0,0 +1,144 @@
+#!/bin/bash
+
+# 无界面接收端编译脚本
+# 用于编译不依赖图形界面的接收程序 tcpimg-recv，适合无X环境的边缘设备
+
+echo "🚀 无界面接收端编译器"
+echo "============================================"
+
+# 检查Qt版本
+echo "🔍 检查Qt环境..."
+qt_version=$(qmake --version | grep "Qt version" | awk '{print $4}')
+if [ -z "$qt_version" ]; then
+    echo "❌ 错误：未找到Qt环境，请安装Qt开发包"
+    echo "   Ubuntu/Debian: sudo apt-get install qt5-default qtbase5-dev"
+    echo "   CentOS/Fedora: sudo yum install qt5-qtbase-devel"
+    exit 1
+fi
+
+echo "✅ Qt版本：$qt_version"
+
+# 检查必需的源文件
+echo "🔍 检查源文件..."
+required_files=("tcpimg_recv.cpp" "ctcpimg.h" "ctcpimg.cpp" "frameparser.h" "frameparser.cpp" "framebuffer.h" "framebuffer.cpp" "networkdiagnostics.h" "networkdiagnostics.cpp" "frameprotocol.h" "latencystats.h" "latencystats.cpp" "metricsregistry.h" "metricsregistry.cpp" "metricsserver.h" "metricsserver.cpp" "sharedframering.h" "sharedframering.cpp" "framerelay.h" "framerelay.cpp" "sysdefine.h")
+for file in "${required_files[@]}"; do
+    if [ ! -f "$file" ]; then
+        echo "❌ 错误：缺少必需文件 $file"
+        exit 1
+    fi
+done
+echo "✅ 所有源文件检查完成"
+
+# 创建接收端专用的项目文件
+echo "📝 生成接收端项目配置..."
+cat > tcpimg_recv.pro << 'EOF'
+# 无界面接收端项目配置
+QT += core network
+QT -= gui
+
+TARGET = tcpimg-recv
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG += c++11
+
+# 输出目录
+DESTDIR = ./
+
+# 源文件
+SOURCES += \
+    tcpimg_recv.cpp \
+    ctcpimg.cpp \
+    frameparser.cpp \
+    framebuffer.cpp \
+    networkdiagnostics.cpp \
+    latencystats.cpp \
+    metricsregistry.cpp \
+    metricsserver.cpp \
+    sharedframering.cpp \
+    framerelay.cpp
+
+# 头文件
+HEADERS += \
+    ctcpimg.h \
+    frameparser.h \
+    framebuffer.h \
+    networkdiagnostics.h \
+    frameprotocol.h \
+    latencystats.h \
+    metricsregistry.h \
+    metricsserver.h \
+    sharedframering.h \
+    framerelay.h \
+    sysdefine.h
+
+# 编译选项
+QMAKE_CXXFLAGS += -O2 -Wall
+
+# Qt版本兼容性
+lessThan(QT_MAJOR_VERSION, 6) {
+    message("编译目标：Qt 5.x (兼容模式)")
+    DEFINES += QT_NO_FOREACH
+} else {
+    message("编译目标：Qt 6.x")
+}
+
+linux: LIBS += -lrt
+
+message("项目：无界面接收端")
+EOF
+
+# 创建构建目录
+echo "📁 准备构建环境..."
+BUILD_DIR="build_recv"
+if [ -d "$BUILD_DIR" ]; then
+    echo "🧹 清理旧的构建目录..."
+    rm -rf "$BUILD_DIR"
+fi
+mkdir -p "$BUILD_DIR"
+
+# 进入构建目录
+cd "$BUILD_DIR"
+
+# 运行qmake
+echo "⚙️  配置项目..."
+qmake ../tcpimg_recv.pro
+if [ $? -ne 0 ]; then
+    echo "❌ qmake配置失败"
+    exit 1
+fi
+
+# 编译项目
+echo "🔨 编译接收端..."
+cpu_cores=$(nproc 2>/dev/null || echo "1")
+echo "🚀 使用 $cpu_cores 个CPU核心进行编译"
+
+make -j$cpu_cores
+if [ $? -ne 0 ]; then
+    echo "❌ 编译失败"
+    exit 1
+fi
+
+# 检查编译结果
+if [ -f "tcpimg-recv" ]; then
+    echo "✅ 编译成功！"
+    echo ""
+    echo "📊 接收端信息："
+    echo "   - 可执行文件：./build_recv/tcpimg-recv"
+    echo "   - 传输协议：auto / raw / 7e / ext"
+    echo "   - 输出：周期统计、原始帧保存、共享内存、帧转发、指标、延迟导出"
+    echo ""
+    echo "🚀 使用方法："
+    echo "   ./build_recv/tcpimg-recv --help"
+    echo ""
+    echo "📝 示例："
+    echo "   # 接收1280×1024×2通道数据流，每2秒输出统计，1000帧后退出"
+    echo "   ./build_recv/tcpimg-recv -a 127.0.0.1 -p 8080 -W 1280 -H 1024 -c 2 --stats 2 -n 1000"
+    echo ""
+    echo "   # 长期运行，开启指标服务和帧转发"
+    echo "   ./build_recv/tcpimg-recv -a 192.168.1.10 --metrics-port 9100 --relay-port 17778"
+else
+    echo "❌ 编译失败：未找到可执行文件"
+    exit 1
+fi
+
+echo "🎉 无界面接收端编译完成！"
@@ -0,0 +1,125 @@
+#!/bin/bash
+
+# 合成图像发送端编译脚本
+# 用于编译本地负载生成器 tcpimg-sender，为接收端提供测试数据流
+
+echo "🚀 合成图像发送端编译器"
+echo "============================================"
+
+# 检查Qt版本
+echo "🔍 检查Qt环境..."
+qt_version=$(qmake --version | grep "Qt version" | awk '{print $4}')
+if [ -z "$qt_version" ]; then
+    echo "❌ 错误：未找到Qt环境，请安装Qt开发包"
+    echo "   Ubuntu/Debian: sudo apt-get install qt5-default qtbase5-dev"
+    echo "   CentOS/Fedora: sudo yum install qt5-qtbase-devel"
+    exit 1
+fi
+
+echo "✅ Qt版本：$qt_version"
+
+# 检查必需的源文件
+echo "🔍 检查源文件..."
+required_files=("tcpimg_sender.cpp" "frameprotocol.h" "sysdefine.h")
+for file in "${required_files[@]}"; do
+    if [ ! -f "$file" ]; then
+        echo "❌ 错误：缺少必需文件 $file"
+        exit 1
+    fi
+done
+echo "✅ 所有源文件检查完成"
+
+# 创建发送端专用的项目文件
+echo "📝 生成发送端项目配置..."
+cat > tcpimg_sender.pro << 'EOF'
+# 合成图像发送端项目配置
+QT += core network
+QT -= gui
+
+TARGET = tcpimg-sender
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG += c++11
+
+# 输出目录
+DESTDIR = ./
+
+# 源文件
+SOURCES += \
+    tcpimg_sender.cpp
+
+# 头文件
+HEADERS += \
+    frameprotocol.h \
+    sysdefine.h
+
+# 编译选项
+QMAKE_CXXFLAGS += -O2 -Wall
+
+# Qt版本兼容性
+lessThan(QT_MAJOR_VERSION, 6) {
+    message("编译目标：Qt 5.x (兼容模式)")
+    DEFINES += QT_NO_FOREACH
+} else {
+    message("编译目标：Qt 6.x")
+}
+
+message("项目：合成图像发送端")
+EOF
+
+# 创建构建目录
+echo "📁 准备构建环境..."
+BUILD_DIR="build_sender"
+if [ -d "$BUILD_DIR" ]; then
+    echo "🧹 清理旧的构建目录..."
+    rm -rf "$BUILD_DIR"
+fi
+mkdir -p "$BUILD_DIR"
+
+# 进入构建目录
+cd "$BUILD_DIR"
+
+# 运行qmake
+echo "⚙️  配置项目..."
+qmake ../tcpimg_sender.pro
+if [ $? -ne 0 ]; then
+    echo "❌ qmake配置失败"
+    exit 1
+fi
+
+# 编译项目
+echo "🔨 编译发送端..."
+cpu_cores=$(nproc 2>/dev/null || echo "1")
+echo "🚀 使用 $cpu_cores 个CPU核心进行编译"
+
+make -j$cpu_cores
+if [ $? -ne 0 ]; then
+    echo "❌ 编译失败"
+    exit 1
+fi
+
+# 检查编译结果
+if [ -f "tcpimg-sender" ]; then
+    echo "✅ 编译成功！"
+    echo ""
+    echo "📊 发送端信息："
+    echo "   - 可执行文件：./build_sender/tcpimg-sender"
+    echo "   - 测试图案：ramp / noise / bar"
+    echo "   - 传输协议：raw / 7e / size"
+    echo ""
+    echo "🚀 使用方法："
+    echo "   ./build_sender/tcpimg-sender --help"
+    echo ""
+    echo "📝 示例："
+    echo "   # 为 test_high_resolution 提供1280×1024×2通道 20fps 数据流"
+    echo "   ./build_sender/tcpimg-sender -p 8080 -W 1280 -H 1024 -c 2 -f 20"
+    echo "   ./build_test/test_high_resolution 127.0.0.1 8080"
+    echo ""
+    echo "   # 饱和模式压测回环带宽，使用7E 7E帧头协议"
+    echo "   ./build_sender/tcpimg-sender -f 0 --protocol 7e --pattern noise"
+else
+    echo "❌ 编译失败：未找到可执行文件"
+    exit 1
+fi
+
+echo "🎉 合成图像发送端编译完成！"
@@ -0,0 +1,115 @@
+#!/bin/bash
+
+# 单元测试编译运行脚本
+# 逐个编译 test_*.cpp 回归测试（QtTest），编译后立即运行，任一测试失败时返回非0
+
+echo "🧪 TCP图像接收单元测试"
+echo "============================================"
+
+# 检查Qt版本
+echo "🔍 检查Qt环境..."
+qt_version=$(qmake --version | grep "Qt version" | awk '{print $4}')
+if [ -z "$qt_version" ]; then
+    echo "❌ 错误：未找到Qt环境，请安装Qt开发包"
+    echo "   Ubuntu/Debian: sudo apt-get install qt5-default qtbase5-dev"
+    echo "   CentOS/Fedora: sudo yum install qt5-qtbase-devel"
+    exit 1
+fi
+
+echo "✅ Qt版本：$qt_version"
+
+BUILD_DIR="build_tests"
+if [ -d "$BUILD_DIR" ]; then
+    echo "🧹 清理旧的构建目录..."
+    rm -rf "$BUILD_DIR"
+fi
+mkdir -p "$BUILD_DIR"
+
+cpu_cores=$(nproc 2>/dev/null || echo "1")
+failed_tests=()
+
+# 编译并运行一个测试
+# 参数：测试名（对应 test_<名称>.cpp） 被测源文件...
+run_test() {
+    local name="$1"
+    shift
+    local sources=("$@")
+
+    echo ""
+    echo "🔨 编译测试：test_$name"
+    for file in "test_$name.cpp" "${sources[@]}"; do
+        if [ ! -f "$file" ]; then
+            echo "❌ 错误：缺少必需文件 $file"
+            failed_tests+=("$name")
+            return
+        fi
+    done
+
+    # 被测源文件对应的头文件一并加入（含 Q_OBJECT 的类需要 moc）
+    local source_list=""
+    local header_list=""
+    for file in "${sources[@]}"; do
+        source_list="$source_list \\
+    ../$file"
+        if [ -f "${file%.cpp}.h" ]; then
+            header_list="$header_list \\
+    ../${file%.cpp}.h"
+        fi
+    done
+
+    mkdir -p "$BUILD_DIR/$name"
+    cat > "$BUILD_DIR/$name/test_$name.pro" << EOF
+# 单元测试项目配置（由 build_tests.sh 生成）
+QT += core network testlib
+QT -= gui
+
+TARGET = test_$name
+CONFIG += console testcase
+CONFIG -= app_bundle
+CONFIG += c++11
+
+INCLUDEPATH += ..
+
+SOURCES += \\
+    ../test_$name.cpp$source_list
+
+HEADERS +=$header_list
+
+QMAKE_CXXFLAGS += -O2 -Wall
+
+lessThan(QT_MAJOR_VERSION, 6) {
+    DEFINES += QT_NO_FOREACH
+}
+
+linux: LIBS += -lrt
+EOF
+
+    (cd "$BUILD_DIR/$name" && qmake "test_$name.pro" > /dev/null && make -j$cpu_cores > /dev/null)
+    if [ $? -ne 0 ]; then
+        echo "❌ 编译失败：test_$name"
+        failed_tests+=("$name")
+        return
+    fi
+
+    echo "🚀 运行测试：test_$name"
+    "./$BUILD_DIR/$name/test_$name"
+    if [ $? -ne 0 ]; then
+        echo "❌ 测试失败：test_$name"
+        failed_tests+=("$name")
+        return
+    fi
+    echo "✅ 测试通过：test_$name"
+}
+
+# 数据流解析：原始数据、7E 7E 帧头、扩展帧头、心跳、size=指令、重同步、旧版16位长度
+run_test frameparser frameparser.cpp framebuffer.cpp
+
+# 抓包文件：写入后读回（合成的TCP/IP头、时间戳），if_tsresol 换算和范围检查
+run_test pcapcapture pcapcapture.cpp
+
+echo ""
+if [ ${#failed_tests[@]} -ne 0 ]; then
+    echo "❌ 失败的测试：${failed_tests[*]}"
+    exit 1
+fi
+echo "🎉 全部单元测试通过！"
@@ -1,6 +1,16 @@
 #include "ctcpimg.h"
 #include <QDebug>
 #include <QtEndian>  // Qt 5.12字节序转换函数
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QSignalBlocker>
+#include <cmath>
+
+// 每次从套接字读取的最大字节数
+static const int RECV_CHUNK_SIZE = 256 * 1024;
+
+// size=指令的数字之后空闲多久视为指令结束（发送端发完指令即等待应答）
+static const int SIZE_COMMAND_IDLE_MS = 20;
 
 /**
  * @brief CTCPImg构造函数
@@ -18,9 +28,32 @@ CTCPImg::CTCPImg(QObject *parent)
     m_reconnectTimer = new QTimer(this);
     m_serverPort = 0;
     m_reconnectAttempts = 0;
-    m_maxReconnectAttempts = 5;
-    m_reconnectInterval = 3000;  // 3秒重连间隔
-    m_autoReconnectEnabled = true;  // 默认启用自动重连
+    m_reconnectDelay = 0;
+    m_connectTimeoutTimer = new QTimer(this);
+    m_autoReconnectEnabled = true;  // 默认启用自动重连（指数退避，次数不限）
+
+    // 多端点与热备连接（默认只有主端点，不建立备用连接）
+    m_activeEndpoint = -1;
+    m_standbyEnabled = false;
+    m_standbySocket = NULL;
+    m_standbyEndpoint = -1;
+    m_standbyTimer = new QTimer(this);
+    m_standbyTimer->setSingleShot(true);
+    connect(m_standbyTimer, &QTimer::timeout, this, &CTCPImg::slot_connectStandby);
+
+    // 接收停滞检测（默认关闭，见 setStallPolicy）
+    m_stallTimer = new QTimer(this);
+    m_heartbeatTimer = new QTimer(this);
+    m_stallSeenBytes = 0;
+    m_stallSeenFrames = 0;
+    m_lastByteMs = 0;
+    m_lastFrameMs = 0;
+    m_byteStallReported = false;
+    m_frameStallReported = false;
+    m_stallCount = 0;
+    m_heartbeatSequence = 0;
+    connect(m_stallTimer, &QTimer::timeout, this, &CTCPImg::slot_stallCheck);
+    connect(m_heartbeatTimer, &QTimer::timeout, this, &CTCPImg::slot_sendHeartbeat);
     
     // 使用默认的图像参数初始化
     m_imageWidth = WIDTH;
@@ -29,43 +62,61 @@ CTCPImg::CTCPImg(QObject *parent)
     m_tapMode = 1;  // 默认1tap模式
     
     // 计算图像数据总大小：宽度 × 高度 × 通道数
-    m_totalsize = m_imageWidth * m_imageHeight * m_imageChannels;
+    m_totalsize = qint64(m_imageWidth) * m_imageHeight * m_imageChannels;
     
-    // 为图像帧缓冲区分配内存并初始化为0
-    frameBuffer = new char[m_totalsize];
-    memset((void*)frameBuffer, 0, m_totalsize);
+    // 为图像帧缓冲区分配内存（匿名映射，内容为0）
+    m_frameBuffer.reserve(m_totalsize);
 
     // 初始化TCP套接字
     TCP_sendMesSocket = NULL;
     this->TCP_sendMesSocket = new QTcpSocket();
     TCP_sendMesSocket->abort();  // 中止任何现有连接
-
-    // 连接信号槽，处理TCP连接的各种状态
-    connect(TCP_sendMesSocket, SIGNAL(connected()), this, SLOT(slot_connected()));
-    connect(TCP_sendMesSocket, SIGNAL(readyRead()), this, SLOT(slot_recvmessage()));
-    connect(TCP_sendMesSocket, SIGNAL(disconnected()), this, SLOT(slot_disconnect()));
-    // 添加错误处理信号连接 - Qt版本兼容处理
-#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-    // Qt 5.15+ 和 Qt 6.x 使用 errorOccurred 信号
-    connect(TCP_sendMesSocket, &QTcpSocket::errorOccurred, 
-            this, &CTCPImg::slot_socketError);
-#else
-    // Qt 5.12-5.14 使用 error 信号
-    connect(TCP_sendMesSocket, SIGNAL(error(QAbstractSocket::SocketError)), 
-            this, SLOT(slot_socketError(QAbstractSocket::SocketError)));
-#endif
+    attachActiveSocket(TCP_sendMesSocket);
     
     // 连接重连定时器信号
     connect(m_reconnectTimer, &QTimer::timeout, this, &CTCPImg::slot_reconnect);
     m_reconnectTimer->setSingleShot(true);  // 设置为单次触发
+    m_reconnectTimer->setTimerType(Qt::PreciseTimer);  // 首次重连只等几十毫秒，需要精确定时
+
+    // 连接超时：不依赖系统的TCP连接超时（可能长达数十秒）
+    connect(m_connectTimeoutTimer, &QTimer::timeout, this, &CTCPImg::slot_connectTimeout);
+    m_connectTimeoutTimer->setSingleShot(true);
     
     // 初始化新的成员变量
     m_recvCount = 0;
-    m_foundFirstFrame = false;
-    m_recvBuffer.clear();
+    m_sharedRingSlots = CSharedFrameRing::DEFAULT_SLOTS;
+    m_displayUpdateEnabled = true;
+    m_invalidGeometryLogged = false;
+    m_recvChunk.resize(RECV_CHUNK_SIZE);
+    
+    // 初始化数据流解析器
+    m_frameParser.setExpectedPayloadSize(m_totalsize);
+    connect(&m_frameParser, &CFrameParser::frameReady, this, &CTCPImg::slot_frameReady);
+    connect(&m_frameParser, &CFrameParser::frameDropped, this, &CTCPImg::slot_frameDropped);
+    connect(&m_frameParser, &CFrameParser::sizeCommandReceived, this, &CTCPImg::slot_sizeCommand);
+    connect(&m_frameParser, &CFrameParser::heartbeatReceived, this, &CTCPImg::slot_heartbeatReceived);
+    m_sizeCommandTimer = new QTimer(this);
+    m_sizeCommandTimer->setSingleShot(true);
+    connect(m_sizeCommandTimer, &QTimer::timeout, &m_frameParser, &CFrameParser::flushSizeCommand);
+
+    // 连通性探测放在专用线程，探测期间不占用界面线程
+    m_diagnosticsRunning = false;
+    m_diagnostics = new CNetworkDiagnostics();
+    m_diagnostics->moveToThread(&m_diagnosticsThread);
+    connect(&m_diagnosticsThread, &QThread::finished, m_diagnostics, &QObject::deleteLater);
+    connect(m_diagnostics, &CNetworkDiagnostics::probeFinished, this, &CTCPImg::slot_diagnosticProbeFinished);
+    connect(m_diagnostics, &CNetworkDiagnostics::finished, this, &CTCPImg::slot_diagnosticsFinished);
+    m_diagnosticsThread.setObjectName("tcpimg-diagnostics");
+    m_diagnosticsThread.start();
+
+    initMetrics();
     
     qDebug() << "CTCPImg对象初始化完成，图像缓冲区大小：" << m_totalsize << "字节";
-    qDebug() << "自动重连功能已启用，最大重连次数：" << m_maxReconnectAttempts << "，重连间隔：" << m_reconnectInterval << "ms";
+    qDebug() << QString("自动重连功能已启用：首次%1ms，上限%2ms，连接超时%3ms，最大次数：%4")
+                .arg(m_reconnectPolicy.initialDelayMs)
+                .arg(m_reconnectPolicy.maxDelayMs)
+                .arg(m_reconnectPolicy.connectTimeoutMs)
+                .arg(m_reconnectPolicy.maxAttempts > 0 ? QString::number(m_reconnectPolicy.maxAttempts) : QString("不限"));
 }
 
 /**
@@ -75,10 +126,16 @@ CTCPImg::CTCPImg(QObject *parent)
  */
 CTCPImg::~CTCPImg(void)
 {
+    CMetricsRegistry::instance().removeCollectors(this);
+
     // 停止重连定时器
     if (m_reconnectTimer) {
         m_reconnectTimer->stop();
     }
+    m_connectTimeoutTimer->stop();
+    m_stallTimer->stop();
+    m_heartbeatTimer->stop();
+    closeStandby();
     
     // 修复：正确释放QTcpSocket对象
    if(NULL != TCP_sendMesSocket)
@@ -88,23 +145,45 @@ CTCPImg::~CTCPImg(void)
        TCP_sendMesSocket = NULL;
    }
 
-    // 修复：使用delete[]释放数组内存
-    if (frameBuffer != NULL)
-    {
-        delete[] frameBuffer;  // 修复：使用delete[]而不是delete
-        frameBuffer = NULL;
-    }
+    // 结束诊断线程，探测对象随线程结束释放
+    m_diagnosticsThread.quit();
+    m_diagnosticsThread.wait();
+
+    // 释放帧缓冲区映射
+    m_frameBuffer.release();
     
     qDebug() << "CTCPImg对象销毁完成，资源已释放";
 }
 
+/**
+ * @brief 连接主链路套接字的信号
+ * @param socket 主链路套接字
+ */
+void CTCPImg::attachActiveSocket(QTcpSocket* socket)
+{
+    // 连接信号槽，处理TCP连接的各种状态
+    connect(socket, SIGNAL(connected()), this, SLOT(slot_connected()));
+    connect(socket, SIGNAL(readyRead()), this, SLOT(slot_recvmessage()));
+    connect(socket, SIGNAL(disconnected()), this, SLOT(slot_disconnect()));
+    // 添加错误处理信号连接 - Qt版本兼容处理
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    // Qt 5.15+ 和 Qt 6.x 使用 errorOccurred 信号
+    connect(socket, &QTcpSocket::errorOccurred, 
+            this, &CTCPImg::slot_socketError);
+#else
+    // Qt 5.12-5.14 使用 error 信号
+    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), 
+            this, SLOT(slot_socketError(QAbstractSocket::SocketError)));
+#endif
+}
+
 /**
  * @brief 获取图像帧缓冲区指针
  * @return 返回图像数据缓冲区的指针
  */
 char *CTCPImg::getFrameBuffer()
 {
-    return frameBuffer;
+    return m_frameBuffer.data();
 }
 
 /**
@@ -127,9 +206,23 @@ void CTCPImg::start(QString strAddr, int port)
         return;
     }
     
+    // 端点列表：主端点在前，备用端点按优先级在后；健康状态重新统计
+    closeStandby();
+    m_endpoints.clear();
+    Endpoint primary;
+    primary.address = strAddr;
+    primary.port = quint16(port);
+    m_endpoints.append(primary);
+    for (const Endpoint& backup : m_backupEndpoints) {
+        Endpoint endpoint;
+        endpoint.address = backup.address;
+        endpoint.port = backup.port;
+        m_endpoints.append(endpoint);
+    }
+
     // 保存连接参数用于重连
-    m_serverAddress = strAddr;
-    m_serverPort = port;
+    m_activeEndpoint = -1;
+    selectEndpoint(0);
     m_reconnectAttempts = 0;  // 重置重连计数
     
     // 停止任何正在进行的重连尝试
@@ -149,7 +242,7 @@ void CTCPImg::start(QString strAddr, int port)
     
     qDebug() << "开始连接到服务器：" << strAddr << ":" << port;
     qDebug() << "自动重连状态：" << (m_autoReconnectEnabled ? "启用" : "禁用");
-    this->TCP_sendMesSocket->connectToHost(QHostAddress(strAddr), port);
+    connectWithTimeout();
 }
 
 /**
@@ -161,6 +254,9 @@ void CTCPImg::slot_connected()
 {
     m_brefresh = true;
     pictmp.clear();  // 清空接收缓冲区
+    m_frameParser.reset();  // 新连接从帧边界开始，重新识别协议
+    m_metricConnected->set(1);
+    m_connectTimeoutTimer->stop();
     
     qDebug() << "✅ [连接调试] TCP连接建立成功，准备接收图像数据";
     qDebug() << "✅ [连接调试] 连接到服务器：" << m_serverAddress << ":" << m_serverPort;
@@ -182,6 +278,19 @@ void CTCPImg::slot_connected()
     } else {
         qDebug() << "✅ [连接调试] 首次连接成功";
     }
+
+    if (m_activeEndpoint >= 0 && m_activeEndpoint < m_endpoints.size()) {
+        Endpoint& endpoint = m_endpoints[m_activeEndpoint];
+        endpoint.consecutiveFailures = 0;
+        endpoint.lastConnectedMs = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    // 主链路就绪后再建立备用连接（重连轮换到了备用连接的端点时换一个端点）
+    if (m_standbySocket && m_standbyEndpoint == m_activeEndpoint) {
+        closeStandby();
+    }
+    scheduleStandby(0);
+    armStallWatchdog();
     
     qDebug() << "🔄 重连计数已重置，当前连接状态：已连接";
 }
@@ -198,138 +307,138 @@ void CTCPImg::slot_sendmessage()
 }
 
 /**
- * @brief 接收TCP消息的核心处理函数 - 简化版直接显示模式
+ * @brief 接收TCP消息的核心处理函数
  * 
- * 处理从服务器接收到的数据，支持两种模式：
- * 1. 直接显示模式：服务器发送的图像数据直接显示
- * 2. 协议模式：带帧头的完整协议解析
+ * 将套接字数据分块读入复用缓冲区并交给 CFrameParser 切分帧，
+ * 支持原始数据、7E 7E 帧头和 size= 指令三种协议（见 frameparser.h）。
+ * 每帧完成后在 slot_frameReady 中更新显示并回复确认
  */
 void CTCPImg::slot_recvmessage()
 {
-    // 读取数据
-    QByteArray data = TCP_sendMesSocket->readAll();
-    if(data.isEmpty())
-    {
-        return;
+    m_metricBacklog->set(TCP_sendMesSocket->bytesAvailable());
+
+    while (TCP_sendMesSocket->bytesAvailable() > 0) {
+        const qint64 bytesRead = TCP_sendMesSocket->read(m_recvChunk.data(), m_recvChunk.size());
+        if (bytesRead <= 0) {
+            break;
+        }
+        
+        // 更新接收计数
+        m_recvCount += bytesRead;
+        m_metricBytes->add(bytesRead);
+        m_frameParser.feed(m_recvChunk.constData(), bytesRead);
     }
 
-    // 更新接收计数
-    m_recvCount += data.size();
-    qDebug() << "🔗 接收到数据包，大小：" << data.size() << "字节";
-    qDebug() << "🔗 累积接收数据：" << m_recvCount << "字节";
-
-    // 将新数据添加到缓冲区
-    m_recvBuffer.append(data);
-
-    // 检查是否包含size=指令（旧协议兼容）
-    if (data.contains("size=")) {
-        QByteArray sizeData = data;
-        sizeData = sizeData.replace("size=", "");
-        m_totalsize = sizeData.toInt();
-        pictmp.clear();
-        m_recvBuffer.clear();
-        TCP_sendMesSocket->write("OK");
-        TCP_sendMesSocket->waitForBytesWritten();
-        qDebug() << "📏 接收到大小指令：" << m_totalsize << "字节";
-        return;
+    // size=指令的数字可能分两次到达：读完后仍在等待数字时，空闲一小段时间再结束指令
+    if (m_frameParser.sizeCommandPending()) {
+        m_sizeCommandTimer->start(SIZE_COMMAND_IDLE_MS);
+    } else {
+        m_sizeCommandTimer->stop();
     }
 
-    // 模式1：直接图像数据模式（推荐）
-    // 如果接收的数据大小等于预期图像大小，直接显示
-    if (m_recvBuffer.size() == m_totalsize) {
-        qDebug() << "✅ 直接模式：接收到完整图像数据，直接显示";
-        updateImageDisplayDirect(m_recvBuffer);
-        m_recvBuffer.clear();
-        
-        // 发送确认（如果服务器需要）
-        TCP_sendMesSocket->write("OK");
-        TCP_sendMesSocket->waitForBytesWritten();
-        return;
+    // 解析器的重同步计数是普通整数，按增量同步到原子指标
+    const qint64 resyncs = m_frameParser.resyncCount();
+    if (resyncs > m_metricsPublishedResyncs) {
+        m_metricResyncs->add(resyncs - m_metricsPublishedResyncs);
     }
-    
-    // 模式2：检查是否为纯图像数据（无帧头）
-    if (m_recvBuffer.size() >= m_totalsize) {
-        // 检查数据是否看起来像图像数据（无明显的帧头）
-        bool hasFrameHeader = false;
-        if (m_recvBuffer.size() >= 2) {
-            unsigned char byte0 = static_cast<unsigned char>(m_recvBuffer[0]);
-            unsigned char byte1 = static_cast<unsigned char>(m_recvBuffer[1]);
-            hasFrameHeader = (byte0 == 0x7E && byte1 == 0x7E);
-        }
-        
-        if (!hasFrameHeader) {
-            // 纯图像数据，取前面的图像部分
-            QByteArray imageData = m_recvBuffer.left(m_totalsize);
-            qDebug() << "✅ 纯图像模式：提取" << imageData.size() << "字节图像数据显示";
-            updateImageDisplayDirect(imageData);
-            
-            // 移除已处理的数据
-            m_recvBuffer = m_recvBuffer.mid(m_totalsize);
-            
-            // 发送确认
-            TCP_sendMesSocket->write("OK");
-            TCP_sendMesSocket->waitForBytesWritten();
-            return;
-        }
+    m_metricsPublishedResyncs = resyncs;
+}
+
+/**
+ * @brief 解析器输出完整帧
+ * @param payload 图像数据（不含帧头）
+ * @param info 帧序号和接收时间戳
+ */
+void CTCPImg::slot_frameReady(const QByteArray &payload, const CFrameParser::FrameInfo &info)
+{
+    // 关闭自动识别（--fixed-geometry、界面取消勾选）时帧头只用于切分帧，始终按设置的分辨率显示
+    if (m_frameParser.autoGeometry() && info.hasGeometry()
+        && (info.width != m_imageWidth || info.height != m_imageHeight || info.channels != m_imageChannels)) {
+        applyFrameGeometry(info.width, info.height, info.channels);
     }
 
-    // 模式3：协议模式（带帧头7E 7E）
-    if (!m_foundFirstFrame) {
-        // 查找帧头 7E 7E
-        int frameStart = m_recvBuffer.indexOf(QByteArray::fromHex("7E7E"));
-        if (frameStart != -1) {
-            m_foundFirstFrame = true;
-            m_recvBuffer = m_recvBuffer.mid(frameStart);
-            qDebug() << "🔗 协议模式：找到帧头，开始协议解析";
-        } else {
-            // 如果缓冲区太大且没找到帧头，可能是纯图像数据
-            if (m_recvBuffer.size() >= m_totalsize) {
-                qDebug() << "🔄 未找到帧头，尝试作为纯图像数据处理";
-                QByteArray imageData = m_recvBuffer.left(m_totalsize);
-                updateImageDisplayDirect(imageData);
-                m_recvBuffer = m_recvBuffer.mid(m_totalsize);
-                
-                TCP_sendMesSocket->write("OK");
-                TCP_sendMesSocket->waitForBytesWritten();
-            } else if (m_recvBuffer.size() > 1024 * 1024) {
-                qDebug() << "⚠️ 缓冲区过大，清空重新开始";
-                m_recvBuffer.clear();
-            }
-            return;
-        }
+    m_lastFrameInfo = info;
+    m_metricFrames->increment();
+
+    // 网络阶段依赖发送端时间戳，只有扩展帧头才有
+    if (info.hasExtendedHeader && info.senderTimestampUs > 0) {
+        m_latencyStats.record(CLatencyStats::STAGE_NETWORK, info.firstByteWallUs - info.senderTimestampUs);
     }
+    m_latencyStats.record(CLatencyStats::STAGE_RECEIVE, (info.completeNs - info.firstByteNs) / 1000);
 
-    // 协议模式的完整性检查
-    if (m_foundFirstFrame && m_recvBuffer.size() >= 6) {
-        int expectedFrameSize = parseFrameSize(m_recvBuffer.left(6));
-        
-        if (expectedFrameSize > 0 && m_recvBuffer.size() >= expectedFrameSize) {
-            qDebug() << "✅ 协议模式：完整帧接收完成";
-            
-            QByteArray completeFrame = m_recvBuffer.left(expectedFrameSize);
-            
-            if (validateFrameData(completeFrame)) {
-                QByteArray imageData = completeFrame.mid(6);
-                updateImageDisplayDirect(imageData);
-                qDebug() << "✅ 协议模式：图像更新成功";
-            } else {
-                qDebug() << "❌ 协议模式：帧数据验证失败";
-            }
-            
-            m_recvBuffer = m_recvBuffer.mid(expectedFrameSize);
-            
-            // 发送确认
-            TCP_sendMesSocket->write("OK");
-            TCP_sendMesSocket->waitForBytesWritten();
-            
-            // 处理剩余数据
-            if (!m_recvBuffer.isEmpty() && m_recvBuffer.size() > 6) {
-                QTimer::singleShot(0, this, &CTCPImg::slot_recvmessage);
-            }
+    if (m_sharedRing.isOpen()) {
+        publishSharedFrame(payload, info);
+    }
+    if (m_frameRelay.isListening()) {
+        // 上游没有几何信息时补上当前分辨率，下游接收端同样可以自动识别
+        if (!info.hasGeometry() && payload.size() == m_totalsize && geometryMatchesFrameSize()) {
+            CFrameParser::FrameInfo relayInfo = info;
+            relayInfo.width = m_imageWidth;
+            relayInfo.height = m_imageHeight;
+            relayInfo.channels = m_imageChannels;
+            m_frameRelay.publish(payload, relayInfo);
         } else {
-            qDebug() << "⏳ 协议模式：等待更多数据，当前" << m_recvBuffer.size() << "/" << expectedFrameSize << "字节";
+            m_frameRelay.publish(payload, info);
         }
     }
+
+    if (m_displayUpdateEnabled) {
+        m_lastFrameData = (payload.size() == m_totalsize && geometryMatchesFrameSize()) ? payload : QByteArray();
+        updateImageDisplayDirect(payload);
+    }
+    
+    // 发送确认（如果服务器需要），由事件循环异步发送，不阻塞接收
+    TCP_sendMesSocket->write("OK");
+}
+
+/**
+ * @brief 解析器丢弃无效帧
+ * @param payloadSize 帧头声明的数据大小
+ */
+void CTCPImg::slot_frameDropped(int payloadSize)
+{
+    m_metricFramesDropped->increment();
+    qDebug() << "❌ 协议模式：帧数据验证失败，帧头声明" << payloadSize << "字节，期望" << m_totalsize << "字节";
+    
+    // 与正常帧一样回复确认，避免服务器等待
+    TCP_sendMesSocket->write("OK");
+}
+
+/**
+ * @brief 收到size=指令（旧协议兼容）
+ * @param size 指令中的帧大小
+ */
+void CTCPImg::slot_sizeCommand(int size)
+{
+    pictmp.clear();
+    TCP_sendMesSocket->write("OK");
+    qDebug() << "📏 接收到大小指令：" << size << "字节";
+
+    if (size == m_totalsize) {
+        return;
+    }
+
+    // 解析器已按指令切换期望大小，这里同步帧大小和显示缓冲，不复位解析器
+    // 宽度和通道数不变、大小为整行时只换算高度，显示、转发和共享内存的几何都与帧一致
+    const qint64 rowBytes = qint64(m_imageWidth) * m_imageChannels;
+    if (rowBytes > 0 && size % rowBytes == 0
+        && FrameProtocol::isValidGeometry(m_imageWidth, size / rowBytes, m_imageChannels)) {
+        applyFrameGeometry(m_imageWidth, int(size / rowBytes), m_imageChannels);
+        return;
+    }
+
+    // 不是整行：保持分辨率，显示时按分辨率截取或补零，缓冲区按两者中较大的分配
+    qDebug() << QString("⚠️ 指令大小不是整行（%1×%2通道），保持分辨率%1×%3×%2，显示时截取或补零")
+                .arg(m_imageWidth).arg(m_imageChannels).arg(m_imageHeight);
+    m_totalsize = size;
+    m_lastFrameData = QByteArray();
+    const qint64 displayBytes = qint64(m_imageWidth) * m_imageHeight * m_imageChannels;
+    if (!m_frameBuffer.reserve(qMax(m_totalsize, displayBytes))) {
+        qDebug() << "❌ 图像缓冲区分配失败：" << qMax(m_totalsize, displayBytes) << "字节";
+        return;
+    }
+    // 帧比分辨率小时，每帧只覆盖缓冲区前部，其余部分保持为0
+    memset(m_frameBuffer.data(), 0, size_t(m_frameBuffer.size()));
 }
 
 /**
@@ -342,6 +451,10 @@ void CTCPImg::updateImageDisplayDirect(const QByteArray &imageData)
         qDebug() << "⚠️ 图像数据为空";
         return;
     }
+    if (m_frameBuffer.isNull() || m_frameBuffer.size() < m_totalsize) {
+        qDebug() << "⚠️ 图像缓冲区未分配";
+        return;
+    }
     
     // 检查数据大小
     if (imageData.size() != m_totalsize) {
@@ -350,23 +463,22 @@ void CTCPImg::updateImageDisplayDirect(const QByteArray &imageData)
         
         // 如果数据偏大，截取前面部分
         if (imageData.size() > m_totalsize) {
-            QByteArray truncatedData = imageData.left(m_totalsize);
-            memcpy(frameBuffer, truncatedData.data(), m_totalsize);
+            memcpy(m_frameBuffer.data(), imageData.constData(), size_t(m_totalsize));
             qDebug() << "🔧 数据截取：使用前" << m_totalsize << "字节";
         } else {
             // 数据偏小，填充剩余部分为0
-            memcpy(frameBuffer, imageData.data(), imageData.size());
-            memset(frameBuffer + imageData.size(), 0, m_totalsize - imageData.size());
+            memcpy(m_frameBuffer.data(), imageData.constData(), size_t(imageData.size()));
+            memset(m_frameBuffer.data() + imageData.size(), 0, size_t(m_totalsize - imageData.size()));
             qDebug() << "🔧 数据填充：填充" << (m_totalsize - imageData.size()) << "字节零值";
         }
     } else {
         // 大小完全匹配，直接复制
-        memcpy(frameBuffer, imageData.data(), imageData.size());
+        memcpy(m_frameBuffer.data(), imageData.constData(), size_t(imageData.size()));
         qDebug() << "✅ 完美匹配：图像数据大小正确";
     }
     
     // 执行快速图像质量检查
-    const unsigned char* pixels = reinterpret_cast<const unsigned char*>(frameBuffer);
+    const unsigned char* pixels = reinterpret_cast<const unsigned char*>(m_frameBuffer.data());
     int totalPixels = m_imageWidth * m_imageHeight;
     
     if (totalPixels > 0) {
@@ -406,15 +518,21 @@ void CTCPImg::updateImageDisplayDirect(const QByteArray &imageData)
  */
 void CTCPImg::slot_disconnect()
 {
+    // 主链路自行断开（而非调用方主动断开）时优先切换到备用连接
+    if (sender() == TCP_sendMesSocket && promoteStandby("主链路断开")) {
+        return;
+    }
+
     m_brefresh = false;
     pictmp.clear();  // 清空接收缓冲区
+    m_metricConnected->set(0);
     
     qDebug() << "❌ TCP连接已断开，清理连接状态";
     qDebug() << "🔄 [断开调试] 当前自动重连状态：" << (m_autoReconnectEnabled ? "启用" : "禁用");
     qDebug() << "🔄 [断开调试] 服务器地址：" << m_serverAddress;
     qDebug() << "🔄 [断开调试] 服务器端口：" << m_serverPort;
     qDebug() << "🔄 [断开调试] 当前重连尝试次数：" << m_reconnectAttempts;
-    qDebug() << "🔄 [断开调试] 最大重连尝试次数：" << m_maxReconnectAttempts;
+    qDebug() << "🔄 [断开调试] 最大重连尝试次数：" << m_reconnectPolicy.maxAttempts;
     
     // 安全关闭连接
     if (TCP_sendMesSocket->state() != QAbstractSocket::UnconnectedState) {
@@ -469,10 +587,16 @@ void CTCPImg::slot_socketError(QAbstractSocket::SocketError error)
     
     qDebug() << "❌ [错误调试] TCP连接错误：" << errorString;
     qDebug() << "❌ [错误调试] 详细错误信息：" << TCP_sendMesSocket->errorString();
+
+    // 主链路出错时优先切换到备用连接
+    if (sender() == TCP_sendMesSocket && promoteStandby(errorString)) {
+        return;
+    }
     
     // 重置连接状态
     m_brefresh = false;
     pictmp.clear();
+    m_connectTimeoutTimer->stop();
     
     // 对于连接失败的错误，需要主动触发重连逻辑
     // 因为这些错误可能不会触发disconnected()信号
@@ -509,26 +633,26 @@ void CTCPImg::slot_socketError(QAbstractSocket::SocketError error)
  */
 bool CTCPImg::setImageResolution(int width, int height, int channels)
 {
-    // 参数有效性检查
-    if (width <= 0 || width > 8192) {
-        qDebug() << "错误：图像宽度无效，有效范围：1-8192，当前值：" << width;
+    // 参数有效性检查（与帧头几何使用同一范围，见 FrameProtocol::isValidGeometry）
+    if (width <= 0 || width > FrameProtocol::MAX_IMAGE_DIMENSION) {
+        qDebug() << "错误：图像宽度无效，有效范围：1-" << FrameProtocol::MAX_IMAGE_DIMENSION << "，当前值：" << width;
         return false;
     }
     
-    if (height <= 0 || height > 8192) {
-        qDebug() << "错误：图像高度无效，有效范围：1-8192，当前值：" << height;
+    if (height <= 0 || height > FrameProtocol::MAX_IMAGE_DIMENSION) {
+        qDebug() << "错误：图像高度无效，有效范围：1-" << FrameProtocol::MAX_IMAGE_DIMENSION << "，当前值：" << height;
         return false;
     }
     
-    if (channels <= 0 || channels > 8) {
-        qDebug() << "错误：图像通道数无效，有效范围：1-8，当前值：" << channels;
+    if (channels <= 0 || channels > FrameProtocol::MAX_IMAGE_CHANNELS) {
+        qDebug() << "错误：图像通道数无效，有效范围：1-" << FrameProtocol::MAX_IMAGE_CHANNELS << "，当前值：" << channels;
         return false;
     }
     
-    // 检查内存大小限制（最大50MB）
-    long long totalBytes = (long long)width * height * channels;
-    if (totalBytes > 50 * 1024 * 1024) {
-        qDebug() << "错误：图像数据太大，超过50MB限制：" << totalBytes << "字节";
+    // 单帧大小只受组帧缓冲（QByteArray）容量限制
+    const qint64 totalBytes = qint64(width) * height * channels;
+    if (totalBytes > FrameProtocol::MAX_PAYLOAD_SIZE) {
+        qDebug() << "错误：图像数据太大，超过单帧上限" << FrameProtocol::MAX_PAYLOAD_SIZE << "字节：" << totalBytes << "字节";
         return false;
     }
     
@@ -564,40 +688,61 @@ bool CTCPImg::setImageResolution(int width, int height, int channels)
  */
 bool CTCPImg::reallocateFrameBuffer()
 {
-    try {
-        // 释放旧的缓冲区
-        if (frameBuffer != nullptr) {
-            delete[] frameBuffer;
-            frameBuffer = nullptr;
-        }
-        
-        // 计算新的总大小
-        m_totalsize = m_imageWidth * m_imageHeight * m_imageChannels;
-        
-        // 分配新的缓冲区
-        frameBuffer = new char[m_totalsize];
-        if (frameBuffer == nullptr) {
-            qDebug() << "错误：内存分配失败";
-            return false;
-        }
-        
-        // 初始化缓冲区
-        memset(frameBuffer, 0, m_totalsize);
-        
-        qDebug() << "图像缓冲区重新分配成功，大小：" << m_totalsize << "字节";
-        return true;
-        
-    } catch (const std::bad_alloc& e) {
-        qDebug() << "错误：内存分配异常：" << e.what();
-        frameBuffer = nullptr;
-        m_totalsize = 0;
-        return false;
-    } catch (...) {
-        qDebug() << "错误：未知异常在内存分配过程中";
-        frameBuffer = nullptr;
+    // 计算新的总大小（64位，避免宽×高×通道数溢出int）
+    m_totalsize = qint64(m_imageWidth) * m_imageHeight * m_imageChannels;
+    m_frameParser.setExpectedPayloadSize(m_totalsize);
+    m_lastFrameData = QByteArray();
+
+    // 容量在同一档内时复用原缓冲，否则先释放再分配，避免新旧两块同时占用内存
+    if (!m_frameBuffer.reserve(m_totalsize)) {
+        qDebug() << "错误：内存分配失败，需要" << m_totalsize << "字节";
         m_totalsize = 0;
         return false;
     }
+
+    qDebug() << QString("图像缓冲区就绪，大小：%1字节，容量：%2字节（%3）")
+                .arg(m_totalsize).arg(m_frameBuffer.capacity())
+                .arg(CFrameBuffer::pageModeName(m_frameBuffer.pageMode()));
+    return true;
+}
+
+/**
+ * @brief 采用帧头携带的图像几何
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param channels 通道数
+ *
+ * 解析器已按帧头切换了期望大小，这里只同步图像参数和显示缓冲，不复位解析器
+ */
+void CTCPImg::applyFrameGeometry(int width, int height, int channels)
+{
+    // 与 setImageResolution 相同的范围：超出时忽略帧头几何，保持当前分辨率（只提示一次）
+    if (!FrameProtocol::isValidGeometry(width, height, channels)) {
+        if (!m_invalidGeometryLogged) {
+            m_invalidGeometryLogged = true;
+            qDebug() << QString("⚠️ 帧头几何 %1×%2×%3 超出支持范围，保持当前分辨率 %4×%5×%6")
+                        .arg(width).arg(height).arg(channels)
+                        .arg(m_imageWidth).arg(m_imageHeight).arg(m_imageChannels);
+        }
+        return;
+    }
+
+    qDebug() << QString("📐 帧头几何变化：%1×%2×%3 → %4×%5×%6")
+                .arg(m_imageWidth).arg(m_imageHeight).arg(m_imageChannels)
+                .arg(width).arg(height).arg(channels);
+
+    m_imageWidth = width;
+    m_imageHeight = height;
+    m_imageChannels = channels;
+    m_totalsize = qint64(width) * height * channels;
+    m_lastFrameData = QByteArray();
+
+    // 匿名映射按需分配物理页，无界面运行时预留也不占实际内存
+    if (!m_frameBuffer.reserve(m_totalsize)) {
+        qDebug() << "❌ 图像缓冲区分配失败：" << m_totalsize << "字节";
+    }
+
+    emit imageGeometryChanged(width, height, channels);
 }
 
 /**
@@ -745,10 +890,11 @@ void CTCPImg::slot_reconnect()
     // 禁用代理
     TCP_sendMesSocket->setProxy(QNetworkProxy::NoProxy);
     
+    m_metricReconnects->increment();
     qDebug() << "🔄 [重连调试] 正在调用 connectToHost()...";
     
     // 尝试重新连接
-    TCP_sendMesSocket->connectToHost(QHostAddress(m_serverAddress), m_serverPort);
+    connectWithTimeout();
     
     qDebug() << "🔄 [重连调试] connectToHost() 调用完成";
     qDebug() << "🔄 [重连调试] 连接后的套接字状态：" << TCP_sendMesSocket->state();
@@ -775,8 +921,17 @@ void CTCPImg::triggerReconnectLogic(const QString& source)
         return;
     }
     
-    if (m_reconnectAttempts >= m_maxReconnectAttempts) {
-        qDebug() << QString("❌ [%1] 已达到最大重连次数 (%2次)，停止自动重连").arg(source).arg(m_maxReconnectAttempts);
+    // 断开和错误可能先后到达，已安排的重连不重复计数
+    if (m_reconnectTimer->isActive()) {
+        qDebug() << QString("🔄 [%1] 重连已安排，%2ms后进行").arg(source).arg(m_reconnectTimer->remainingTime());
+        return;
+    }
+    
+    recordEndpointFailure(m_activeEndpoint, source);
+
+    const int maxAttempts = m_reconnectPolicy.maxAttempts;
+    if (maxAttempts > 0 && m_reconnectAttempts >= maxAttempts) {
+        qDebug() << QString("❌ [%1] 已达到最大重连次数 (%2次)，停止自动重连").arg(source).arg(maxAttempts);
         qDebug() << "🔍 开始执行服务端诊断检查...";
         
         // 执行服务端诊断
@@ -784,139 +939,703 @@ void CTCPImg::triggerReconnectLogic(const QString& source)
         return;
     }
     
-    // 增加重连计数
+    // 增加重连计数；多个端点时依次轮换，一轮端点都失败后才增加退避等待
     m_reconnectAttempts++;
-    qDebug() << QString("🔄 [%1] 准备自动重连 (第%2/%3次尝试)，%4秒后开始...")
+    const int endpointCount = qMax(1, m_endpoints.size());
+    if (endpointCount > 1) {
+        selectEndpoint((m_activeEndpoint + 1) % endpointCount);
+    }
+    m_reconnectDelay = nextReconnectDelay((m_reconnectAttempts - 1) / endpointCount + 1);
+    qDebug() << QString("🔄 [%1] 准备自动重连 %2:%3 (第%4/%5次尝试)，%6ms后开始...")
                 .arg(source)
+                .arg(m_serverAddress).arg(m_serverPort)
                 .arg(m_reconnectAttempts)
-                .arg(m_maxReconnectAttempts)
-                .arg(m_reconnectInterval / 1000.0);
-    
-    // 检查并停止现有定时器
-    if (m_reconnectTimer->isActive()) {
-        qDebug() << QString("🔄 [%1] 重连定时器已经在运行，先停止").arg(source);
-        m_reconnectTimer->stop();
-    }
-    
-    qDebug() << QString("🔄 [%1] 启动重连定时器，间隔：%2ms").arg(source).arg(m_reconnectInterval);
+                .arg(maxAttempts > 0 ? QString::number(maxAttempts) : QString("∞"))
+                .arg(m_reconnectDelay);
     
     // 启动重连定时器
-    m_reconnectTimer->start(m_reconnectInterval);
-    
-    qDebug() << QString("🔄 [%1] 重连定时器启动状态：%2").arg(source).arg(m_reconnectTimer->isActive() ? "成功" : "失败");
-    qDebug() << QString("🔄 [%1] 定时器剩余时间：%2ms").arg(source).arg(m_reconnectTimer->remainingTime());
+    m_reconnectTimer->start(m_reconnectDelay);
+}
+
+/**
+ * @brief 按退避策略计算重连等待时间
+ * @param attempt 第几次重连（从1开始）
+ * @return 等待时间（毫秒）
+ */
+int CTCPImg::nextReconnectDelay(int attempt) const
+{
+    const ReconnectPolicy &policy = m_reconnectPolicy;
+
+    // 指数增长，到上限后不再增长（指数部分限制在30以内，避免溢出）
+    const double base = policy.initialDelayMs * std::pow(policy.multiplier, qMin(attempt - 1, 30));
+    const double capped = qMin(base, double(policy.maxDelayMs));
+
+    // 在 [1-jitter, 1] 倍之间随机取值
+    const double factor = 1.0 - policy.jitter * QRandomGenerator::global()->generateDouble();
+    return qMax(0, int(capped * factor));
+}
+
+/**
+ * @brief 发起连接并启动连接超时
+ */
+void CTCPImg::connectWithTimeout()
+{
+    TCP_sendMesSocket->connectToHost(QHostAddress(m_serverAddress), m_serverPort);
+    if (m_reconnectPolicy.connectTimeoutMs > 0) {
+        m_connectTimeoutTimer->start(m_reconnectPolicy.connectTimeoutMs);
+    }
+}
+
+/**
+ * @brief 连接超时槽函数
+ * 中止尚未建立的连接，按连接失败处理
+ */
+void CTCPImg::slot_connectTimeout()
+{
+    if (TCP_sendMesSocket->state() == QAbstractSocket::ConnectedState) {
+        return;
+    }
+
+    qDebug() << QString("⏱️ 连接 %1:%2 超过%3ms未建立，中止本次连接")
+                .arg(m_serverAddress).arg(m_serverPort).arg(m_reconnectPolicy.connectTimeoutMs);
+
+    if (promoteStandby("连接超时")) {
+        return;
+    }
+
+    // abort() 对未建立的连接不会发射 disconnected 或 error，需主动进入重连
+    TCP_sendMesSocket->abort();
+    m_brefresh = false;
+    pictmp.clear();
+    triggerReconnectLogic("连接超时");
+}
+
+/**
+ * @brief 设置接收停滞检测
+ * @param policy 停滞检测参数，负数按0（关闭）处理
+ */
+void CTCPImg::setStallPolicy(const StallPolicy& policy)
+{
+    m_stallPolicy = policy;
+    m_stallPolicy.byteTimeoutMs = qMax(0, policy.byteTimeoutMs);
+    m_stallPolicy.frameTimeoutMs = qMax(0, policy.frameTimeoutMs);
+    m_stallPolicy.heartbeatIntervalMs = qMax(0, policy.heartbeatIntervalMs);
+
+    qDebug() << QString("⏱️ 停滞检测：无数据%1，无完整帧%2，心跳%3，停滞后%4")
+                .arg(m_stallPolicy.byteTimeoutMs > 0 ? QString("%1ms").arg(m_stallPolicy.byteTimeoutMs) : QString("不检测"))
+                .arg(m_stallPolicy.frameTimeoutMs > 0 ? QString("%1ms").arg(m_stallPolicy.frameTimeoutMs) : QString("不检测"))
+                .arg(m_stallPolicy.heartbeatIntervalMs > 0 ? QString("每%1ms").arg(m_stallPolicy.heartbeatIntervalMs) : QString("关闭"))
+                .arg(m_stallPolicy.reconnectOnStall ? "重连" : "只报告");
+
+    if (TCP_sendMesSocket->state() == QAbstractSocket::ConnectedState) {
+        armStallWatchdog();
+    }
+}
+
+/**
+ * @brief 连接建立后启动看门狗和心跳
+ *
+ * 采样周期取较小阈值的1/4（不小于10ms），停滞判定最多延后一个采样周期
+ */
+void CTCPImg::armStallWatchdog()
+{
+    m_stallClock.start();
+    m_stallSeenBytes = m_recvCount;
+    m_stallSeenFrames = m_frameParser.framesCompleted();
+    m_lastByteMs = 0;
+    m_lastFrameMs = 0;
+    m_byteStallReported = false;
+    m_frameStallReported = false;
+
+    int shortest = 0;
+    if (m_stallPolicy.byteTimeoutMs > 0) {
+        shortest = m_stallPolicy.byteTimeoutMs;
+    }
+    if (m_stallPolicy.frameTimeoutMs > 0) {
+        shortest = (shortest > 0) ? qMin(shortest, m_stallPolicy.frameTimeoutMs) : m_stallPolicy.frameTimeoutMs;
+    }
+    if (shortest > 0) {
+        m_stallTimer->start(qMax(10, shortest / 4));
+    } else {
+        m_stallTimer->stop();
+    }
+
+    if (m_stallPolicy.heartbeatIntervalMs > 0) {
+        m_heartbeatTimer->start(m_stallPolicy.heartbeatIntervalMs);
+    } else {
+        m_heartbeatTimer->stop();
+    }
+}
+
+/**
+ * @brief 看门狗采样
+ *
+ * 只比较接收计数是否变化，记下变化时刻；连接已断开时停止采样，
+ * 等下次连接建立后重新启动
+ */
+void CTCPImg::slot_stallCheck()
+{
+    if (TCP_sendMesSocket->state() != QAbstractSocket::ConnectedState) {
+        m_stallTimer->stop();
+        m_heartbeatTimer->stop();
+        return;
+    }
+
+    const qint64 now = m_stallClock.elapsed();
+    const qint64 frames = m_frameParser.framesCompleted();
+    if (m_recvCount != m_stallSeenBytes) {
+        m_stallSeenBytes = m_recvCount;
+        m_lastByteMs = now;
+        m_byteStallReported = false;
+    }
+    if (frames != m_stallSeenFrames) {
+        m_stallSeenFrames = frames;
+        m_lastFrameMs = now;
+        m_frameStallReported = false;
+    }
+
+    const qint64 byteIdleMs = now - m_lastByteMs;
+    const qint64 frameIdleMs = now - m_lastFrameMs;
+    if (m_stallPolicy.byteTimeoutMs > 0 && byteIdleMs >= m_stallPolicy.byteTimeoutMs) {
+        if (!m_byteStallReported) {
+            m_byteStallReported = true;
+            handleStall(STALL_BYTES, byteIdleMs);
+        }
+    } else if (m_stallPolicy.frameTimeoutMs > 0 && frameIdleMs >= m_stallPolicy.frameTimeoutMs) {
+        if (!m_frameStallReported) {
+            m_frameStallReported = true;
+            handleStall(STALL_FRAMES, frameIdleMs);
+        }
+    }
+}
+
+/**
+ * @brief 处理一次停滞
+ * @param kind 停滞类型
+ * @param idleMs 已停滞的时间（毫秒）
+ */
+void CTCPImg::handleStall(StallKind kind, qint64 idleMs)
+{
+    m_stallCount++;
+    if (kind == STALL_BYTES) {
+        m_metricByteStalls->increment();
+    } else {
+        m_metricFrameStalls->increment();
+    }
+
+    const QString reason = (kind == STALL_BYTES)
+        ? QString("接收停滞：%1ms未收到数据").arg(idleMs)
+        : QString("接收停滞：%1ms未收到完整帧").arg(idleMs);
+    qDebug() << QString("⏱️ %1（%2:%3，连接仍显示为已连接）").arg(reason).arg(m_serverAddress).arg(m_serverPort);
+    emit streamStalled(kind, idleMs);
+
+    if (!m_stallPolicy.reconnectOnStall) {
+        return;
+    }
+    if (promoteStandby(reason)) {
+        return;
+    }
+
+    // 半开连接上 abort() 不等待对端，立即释放；屏蔽它同步发出的断开信号，
+    // 由这里按停滞原因记录端点失败并进入重连
+    m_stallTimer->stop();
+    m_heartbeatTimer->stop();
+    {
+        const QSignalBlocker blocker(TCP_sendMesSocket);
+        TCP_sendMesSocket->abort();
+    }
+    m_brefresh = false;
+    pictmp.clear();
+    m_metricConnected->set(0);
+    triggerReconnectLogic("接收停滞");
+}
+
+/**
+ * @brief 向发送端发送心跳
+ *
+ * 发送缓冲中仍有未发出的数据时跳过：链路已不通时不在用户态缓冲中堆积心跳
+ */
+void CTCPImg::slot_sendHeartbeat()
+{
+    if (TCP_sendMesSocket->state() != QAbstractSocket::ConnectedState) {
+        m_heartbeatTimer->stop();
+        return;
+    }
+    if (TCP_sendMesSocket->bytesToWrite() > 0) {
+        return;
+    }
+
+    char heartbeat[FrameProtocol::HEARTBEAT_SIZE];
+    FrameProtocol::writeHeartbeat(heartbeat, ++m_heartbeatSequence, FrameProtocol::wallClockMicros());
+    TCP_sendMesSocket->write(heartbeat, sizeof(heartbeat));
+}
+
+/**
+ * @brief 收到发送端心跳
+ * @param sequence 心跳序号
+ * @param timestampUs 发送时间戳（Unix纪元微秒）
+ *
+ * 心跳字节已计入接收计数，看门狗据此认为链路存活，这里只计数
+ */
+void CTCPImg::slot_heartbeatReceived(quint64 sequence, qint64 timestampUs)
+{
+    Q_UNUSED(sequence);
+    Q_UNUSED(timestampUs);
+    m_metricHeartbeats->increment();
+}
+
+/**
+ * @brief 设置备用端点
+ * @param endpoints 备用端点（按优先级）
+ */
+void CTCPImg::setBackupEndpoints(const QVector<Endpoint>& endpoints)
+{
+    m_backupEndpoints = endpoints;
+    qDebug() << QString("🔀 备用端点：%1个，下次连接时生效").arg(endpoints.size());
+}
+
+/**
+ * @brief 解析端点列表文本
+ * @param text "地址:端口" 列表，以逗号、分号或空白分隔
+ * @param endpoints 输出端点
+ * @return 有无效项时返回false
+ */
+bool CTCPImg::parseEndpoints(const QString& text, QVector<Endpoint>& endpoints)
+{
+    endpoints.clear();
+    const QStringList items = text.split(QRegularExpression("[,;\\s]+"));
+    for (const QString& item : items) {
+        if (item.isEmpty()) {
+            continue;
+        }
+        const int colon = item.lastIndexOf(':');
+        bool ok = false;
+        const int port = (colon > 0) ? item.mid(colon + 1).toInt(&ok) : 0;
+        if (!ok || port <= 0 || port > 65535 || QHostAddress(item.left(colon)).isNull()) {
+            qDebug() << "❌ 无效的端点：" << item << "（格式：IP:端口）";
+            return false;
+        }
+
+        Endpoint endpoint;
+        endpoint.address = item.left(colon);
+        endpoint.port = quint16(port);
+        endpoints.append(endpoint);
+    }
+    return true;
+}
+
+/**
+ * @brief 启用或关闭热备连接
+ * @param enabled 是否启用
+ */
+void CTCPImg::setStandbyEnabled(bool enabled)
+{
+    m_standbyEnabled = enabled;
+    qDebug() << QString("🛡️ 热备连接：%1").arg(enabled ? "启用" : "关闭");
+    if (enabled) {
+        scheduleStandby(0);
+    } else {
+        closeStandby();
+    }
+}
+
+/**
+ * @brief 备用连接是否已建立
+ */
+bool CTCPImg::isStandbyReady() const
+{
+    return m_standbySocket && m_standbySocket->state() == QAbstractSocket::ConnectedState;
+}
+
+/**
+ * @brief 切换到指定端点
+ * @param index 端点序号
+ */
+void CTCPImg::selectEndpoint(int index)
+{
+    if (index < 0 || index >= m_endpoints.size()) {
+        return;
+    }
+
+    const bool changed = (index != m_activeEndpoint);
+    m_activeEndpoint = index;
+    m_serverAddress = m_endpoints[index].address;
+    m_serverPort = m_endpoints[index].port;
+
+    if (changed) {
+        if (m_endpoints.size() > 1) {
+            qDebug() << QString("🔀 切换到端点%1：%2:%3").arg(index + 1).arg(m_serverAddress).arg(m_serverPort);
+        }
+        emit activeEndpointChanged(index, m_serverAddress, m_serverPort);
+    }
+}
+
+/**
+ * @brief 记录端点连接失败
+ * @param index 端点序号
+ * @param reason 失败原因
+ */
+void CTCPImg::recordEndpointFailure(int index, const QString& reason)
+{
+    if (index < 0 || index >= m_endpoints.size()) {
+        return;
+    }
+
+    Endpoint& endpoint = m_endpoints[index];
+    endpoint.consecutiveFailures++;
+    endpoint.totalFailures++;
+    endpoint.lastFailureMs = QDateTime::currentMSecsSinceEpoch();
+    endpoint.lastError = reason;
+}
+
+/**
+ * @brief 主链路失效时用备用连接接管
+ * @param reason 主链路失效原因
+ * @return 备用连接未就绪时返回false
+ *
+ * 不经过重连等待：备用连接已建立，接管后立即继续接收。
+ * 备用连接此前收到的数据都已丢弃，解析器从下一个帧头开始组帧
+ */
+bool CTCPImg::promoteStandby(const QString& reason)
+{
+    if (!isStandbyReady()) {
+        return false;
+    }
+
+    // 释放失效的主链路（可能正处于它自己的信号中，延迟删除）
+    QTcpSocket* failed = TCP_sendMesSocket;
+    failed->disconnect(this);
+    failed->abort();
+    failed->deleteLater();
+    recordEndpointFailure(m_activeEndpoint, reason);
+
+    // 备用连接成为主链路
+    QTcpSocket* socket = m_standbySocket;
+    const int standbyEndpoint = m_standbyEndpoint;
+    m_standbySocket = NULL;
+    m_standbyEndpoint = -1;
+    m_standbyTimer->stop();
+    socket->disconnect(this);
+    TCP_sendMesSocket = socket;
+    attachActiveSocket(socket);
+
+    m_reconnectTimer->stop();
+    m_connectTimeoutTimer->stop();
+    m_reconnectAttempts = 0;
+    selectEndpoint(standbyEndpoint);
+
+    m_brefresh = true;
+    pictmp.clear();
+    m_frameParser.resynchronize();
+    m_metricFailovers->increment();
+    m_metricConnected->set(1);
+    m_endpoints[m_activeEndpoint].lastConnectedMs = QDateTime::currentMSecsSinceEpoch();
+    armStallWatchdog();
+
+    qDebug() << QString("🛡️ %1，备用连接 %2:%3 接管，从下一帧开始继续接收")
+                .arg(reason).arg(m_serverAddress).arg(m_serverPort);
+
+    // 接管前已到达的数据直接交给解析器
+    if (socket->bytesAvailable() > 0) {
+        slot_recvmessage();
+    }
+
+    // 为新的主链路再准备一条备用连接（刚失效的端点多半还不可用，稍后再试）
+    scheduleStandby(nextReconnectDelay(1));
+    return true;
+}
+
+/**
+ * @brief 关闭备用连接
+ */
+void CTCPImg::closeStandby()
+{
+    m_standbyTimer->stop();
+    if (m_standbySocket) {
+        m_standbySocket->disconnect(this);
+        m_standbySocket->abort();
+        m_standbySocket->deleteLater();
+        m_standbySocket = NULL;
+    }
+    m_standbyEndpoint = -1;
+}
+
+/**
+ * @brief 按需安排建立备用连接
+ * @param delayMs 延迟（毫秒）
+ */
+void CTCPImg::scheduleStandby(int delayMs)
+{
+    if (!m_standbyEnabled || m_endpoints.size() < 2 || m_standbySocket) {
+        return;
+    }
+    if (TCP_sendMesSocket->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+    m_standbyTimer->start(qMax(0, delayMs));
+}
+
+/**
+ * @brief 建立备用连接；连接中定时器再次触发表示连接超时
+ */
+void CTCPImg::slot_connectStandby()
+{
+    if (m_standbySocket) {
+        if (m_standbySocket->state() != QAbstractSocket::ConnectedState) {
+            recordEndpointFailure(m_standbyEndpoint, "连接超时");
+            const int failures = m_endpoints.value(m_standbyEndpoint).consecutiveFailures;
+            qDebug() << "🛡️ 备用连接超时，稍后重试";
+            closeStandby();
+            scheduleStandby(nextReconnectDelay(failures));
+        }
+        return;
+    }
+    if (!m_standbyEnabled || m_endpoints.size() < 2) {
+        return;
+    }
+
+    // 选择主链路之外连续失败次数最少的端点，相同时按优先级
+    int best = -1;
+    for (int i = 0; i < m_endpoints.size(); ++i) {
+        if (i == m_activeEndpoint) {
+            continue;
+        }
+        if (best < 0 || m_endpoints[i].consecutiveFailures < m_endpoints[best].consecutiveFailures) {
+            best = i;
+        }
+    }
+    if (best < 0) {
+        return;
+    }
+
+    m_standbyEndpoint = best;
+    m_standbySocket = new QTcpSocket(this);
+    m_standbySocket->setProxy(QNetworkProxy::NoProxy);
+    connect(m_standbySocket, &QTcpSocket::connected, this, &CTCPImg::slot_standbyConnected);
+    connect(m_standbySocket, &QTcpSocket::readyRead, this, &CTCPImg::slot_standbyReadyRead);
+    connect(m_standbySocket, &QTcpSocket::disconnected, this, &CTCPImg::slot_standbyFailed);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    connect(m_standbySocket, &QTcpSocket::errorOccurred, this, &CTCPImg::slot_standbyFailed);
+#else
+    connect(m_standbySocket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(slot_standbyFailed()));
+#endif
+
+    const Endpoint& endpoint = m_endpoints[best];
+    qDebug() << QString("🛡️ 建立备用连接：%1:%2").arg(endpoint.address).arg(endpoint.port);
+    m_standbySocket->connectToHost(QHostAddress(endpoint.address), endpoint.port);
+    if (m_reconnectPolicy.connectTimeoutMs > 0) {
+        m_standbyTimer->start(m_reconnectPolicy.connectTimeoutMs);
+    }
+}
+
+/**
+ * @brief 备用连接建立
+ */
+void CTCPImg::slot_standbyConnected()
+{
+    if (!m_standbySocket || sender() != m_standbySocket) {
+        return;
+    }
+
+    m_standbyTimer->stop();
+    Endpoint& endpoint = m_endpoints[m_standbyEndpoint];
+    endpoint.consecutiveFailures = 0;
+    endpoint.lastConnectedMs = QDateTime::currentMSecsSinceEpoch();
+    qDebug() << QString("🛡️ 备用连接就绪：%1:%2").arg(endpoint.address).arg(endpoint.port);
+
+    // 主链路已失效、正在重连时，备用连接直接接管
+    if (TCP_sendMesSocket->state() != QAbstractSocket::ConnectedState) {
+        promoteStandby("主链路未连接");
+    }
+}
+
+/**
+ * @brief 备用连接收到数据：丢弃，只保持连接
+ */
+void CTCPImg::slot_standbyReadyRead()
+{
+    if (!m_standbySocket || sender() != m_standbySocket) {
+        return;
+    }
+    while (m_standbySocket->bytesAvailable() > 0) {
+        if (m_standbySocket->read(m_recvChunk.data(), m_recvChunk.size()) <= 0) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 备用连接断开或出错：稍后重新建立
+ */
+void CTCPImg::slot_standbyFailed()
+{
+    if (!m_standbySocket || sender() != m_standbySocket) {
+        return;
+    }
+
+    const QString reason = m_standbySocket->errorString();
+    recordEndpointFailure(m_standbyEndpoint, reason);
+    const int failures = m_endpoints.value(m_standbyEndpoint).consecutiveFailures;
+    qDebug() << QString("🛡️ 备用连接失效：%1，稍后重试").arg(reason);
+
+    closeStandby();
+    scheduleStandby(nextReconnectDelay(qMax(1, failures)));
 }
 
 /**
  * @brief 执行服务端诊断检查
  * 当重连失败后，检查服务端状态和网络连通性
+ *
+ * 检查清单立即显示；连通性探测交给诊断线程并行进行，
+ * 每完成一路更新一次报告，界面线程不等待网络
  */
 void CTCPImg::performServerDiagnostics()
 {
-    QStringList diagnosticOutput;
-    
+    if (m_diagnosticsRunning) {
+        qDebug() << "🔍 诊断正在进行，忽略重复请求";
+        return;
+    }
+    m_diagnosticsRunning = true;
+
+    const int probeCount = CNetworkDiagnostics::DEFAULT_PROBE_COUNT;
+    const int timeoutMs = CNetworkDiagnostics::DEFAULT_TIMEOUT_MS;
+
+    m_diagnosticHead.clear();
+    m_diagnosticProbes.clear();
+    m_diagnosticTail.clear();
+
     // 诊断标题
-    diagnosticOutput << "🔍 ==================== 服务端诊断报告 ====================";
-    diagnosticOutput << QString("🔍 连接目标：%1:%2").arg(m_serverAddress).arg(m_serverPort);
-    diagnosticOutput << QString("🔍 重连尝试：%1/%2次").arg(m_reconnectAttempts).arg(m_maxReconnectAttempts);
-    diagnosticOutput << QString("🔍 诊断时间：%1").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
-    diagnosticOutput << "";
-    
-    // 1. 网络连通性检查
-    diagnosticOutput << "🔍 【步骤1】网络连通性检查";
-    QString connectivityResult = checkNetworkConnectivity(m_serverAddress, m_serverPort);
-    diagnosticOutput << QString("🔍 连通性结果：%1").arg(connectivityResult);
-    diagnosticOutput << "";
-    
+    m_diagnosticHead << "🔍 ==================== 服务端诊断报告 ====================";
+    m_diagnosticHead << QString("🔍 连接目标：%1:%2").arg(m_serverAddress).arg(m_serverPort);
+    m_diagnosticHead << QString("🔍 重连尝试：%1/%2次").arg(m_reconnectAttempts)
+                        .arg(m_reconnectPolicy.maxAttempts > 0 ? QString::number(m_reconnectPolicy.maxAttempts) : QString("∞"));
+    m_diagnosticHead << QString("🔍 诊断时间：%1").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"));
+    m_diagnosticHead << "";
+    
+    // 1. 网络连通性检查（结果由诊断线程逐路填入）
+    m_diagnosticHead << QString("🔍 【步骤1】网络连通性检查（%1路并行探测，超时%2秒）")
+                        .arg(probeCount).arg(timeoutMs / 1000.0);
+    m_diagnosticProbes << "🔍 连通性结果：⏳ 正在探测...";
+
     // 2. 服务端状态分析
-    diagnosticOutput << "🔍 【步骤2】服务端状态分析";
-    diagnosticOutput << "🔍 ✅ 请检查以下项目：";
-    diagnosticOutput << QString("🔍    1. 服务端程序是否正在运行？");
-    diagnosticOutput << QString("🔍    2. 服务端是否监听在端口%1？").arg(m_serverPort);
-    diagnosticOutput << "🔍    3. 服务端是否有图像数据可发送？";
-    diagnosticOutput << "🔍    4. 服务端网络配置是否正确？";
-    diagnosticOutput << "";
+    m_diagnosticTail << "";
+    m_diagnosticTail << "🔍 【步骤2】服务端状态分析";
+    m_diagnosticTail << "🔍 ✅ 请检查以下项目：";
+    m_diagnosticTail << QString("🔍    1. 服务端程序是否正在运行？");
+    m_diagnosticTail << QString("🔍    2. 服务端是否监听在端口%1？").arg(m_serverPort);
+    m_diagnosticTail << "🔍    3. 服务端是否有图像数据可发送？";
+    m_diagnosticTail << "🔍    4. 服务端网络配置是否正确？";
+    m_diagnosticTail << "";
     
     // 3. 采集端程序检查
-    diagnosticOutput << "🔍 【步骤3】采集端程序检查";
-    diagnosticOutput << "🔍 ✅ 请检查以下项目：";
-    diagnosticOutput << "🔍    1. 图像采集设备是否正常连接？";
-    diagnosticOutput << "🔍    2. 采集程序是否正常运行？";
-    diagnosticOutput << "🔍    3. 采集程序是否有图像数据输出？";
-    diagnosticOutput << "🔍    4. 采集程序网络发送是否正常？";
-    diagnosticOutput << "";
+    m_diagnosticTail << "🔍 【步骤3】采集端程序检查";
+    m_diagnosticTail << "🔍 ✅ 请检查以下项目：";
+    m_diagnosticTail << "🔍    1. 图像采集设备是否正常连接？";
+    m_diagnosticTail << "🔍    2. 采集程序是否正常运行？";
+    m_diagnosticTail << "🔍    3. 采集程序是否有图像数据输出？";
+    m_diagnosticTail << "🔍    4. 采集程序网络发送是否正常？";
+    m_diagnosticTail << "";
     
     // 4. 网络环境检查
-    diagnosticOutput << "🔍 【步骤4】网络环境检查";
-    diagnosticOutput << "🔍 ✅ 请检查以下项目：";
-    diagnosticOutput << "🔍    1. 客户端与服务端网络是否连通？";
-    diagnosticOutput << QString("🔍    2. 防火墙是否阻止了端口%1？").arg(m_serverPort);
-    diagnosticOutput << "🔍    3. 路由器/交换机配置是否正确？";
-    diagnosticOutput << "🔍    4. 网络带宽是否足够传输图像数据？";
-    diagnosticOutput << "";
+    m_diagnosticTail << "🔍 【步骤4】网络环境检查";
+    m_diagnosticTail << "🔍 ✅ 请检查以下项目：";
+    m_diagnosticTail << "🔍    1. 客户端与服务端网络是否连通？";
+    m_diagnosticTail << QString("🔍    2. 防火墙是否阻止了端口%1？").arg(m_serverPort);
+    m_diagnosticTail << "🔍    3. 路由器/交换机配置是否正确？";
+    m_diagnosticTail << "🔍    4. 网络带宽是否足够传输图像数据？";
+    m_diagnosticTail << "";
     
     // 5. 生成完整诊断报告
     QString diagnosticReport = generateDiagnosticReport();
-    diagnosticOutput << "🔍 【诊断总结】";
-    diagnosticOutput << diagnosticReport;
-    diagnosticOutput << "";
+    m_diagnosticTail << "🔍 【诊断总结】";
+    m_diagnosticTail << diagnosticReport;
+    m_diagnosticTail << "";
     
     // 6. 建议操作
-    diagnosticOutput << "🔍 【建议操作】";
-    diagnosticOutput << "🔍 💡 1. 手动重连：点击'立即重连'按钮重新尝试";
-    diagnosticOutput << "🔍 💡 2. 检查服务端：确认服务端程序正在运行并监听端口";
-    diagnosticOutput << "🔍 💡 3. 检查采集端：确认图像采集程序正常工作";
-    diagnosticOutput << "🔍 💡 4. 网络测试：使用ping/telnet等工具测试网络连通性";
-    diagnosticOutput << "🔍 💡 5. 重启服务：重启服务端和采集端程序";
-    diagnosticOutput << "🔍 💡 6. 联系技术支持：如问题持续存在，请联系技术支持";
-    diagnosticOutput << "";
-    diagnosticOutput << "🔍 ========================================================";
-    
-    // 将诊断信息发送到界面显示
-    QString fullDiagnosticText = diagnosticOutput.join("\n");
-    emit signalDiagnosticInfo(fullDiagnosticText);
-    
+    m_diagnosticTail << "🔍 【建议操作】";
+    m_diagnosticTail << "🔍 💡 1. 手动重连：点击'立即重连'按钮重新尝试";
+    m_diagnosticTail << "🔍 💡 2. 检查服务端：确认服务端程序正在运行并监听端口";
+    m_diagnosticTail << "🔍 💡 3. 检查采集端：确认图像采集程序正常工作";
+    m_diagnosticTail << "🔍 💡 4. 网络测试：使用ping/telnet等工具测试网络连通性";
+    m_diagnosticTail << "🔍 💡 5. 重启服务：重启服务端和采集端程序";
+    m_diagnosticTail << "🔍 💡 6. 联系技术支持：如问题持续存在，请联系技术支持";
+    m_diagnosticTail << "";
+    m_diagnosticTail << "🔍 ========================================================";
+    
+    // 先显示检查清单，连通性结果到达后再逐步更新
+    emitDiagnosticReport();
+
     // 同时输出到控制台（用于开发调试）
-    for (const QString& line : diagnosticOutput) {
+    for (const QString& line : m_diagnosticHead + m_diagnosticTail) {
         qDebug() << line;
     }
+
+    QMetaObject::invokeMethod(m_diagnostics, "start", Qt::QueuedConnection,
+                              Q_ARG(QString, m_serverAddress), Q_ARG(int, m_serverPort),
+                              Q_ARG(int, probeCount), Q_ARG(int, timeoutMs));
 }
 
 /**
- * @brief 检查网络连通性
- * @param host 目标主机地址
- * @param port 目标端口
- * @return 连通性检查结果
+ * @brief 拼接当前诊断报告并发送到界面
  */
-QString CTCPImg::checkNetworkConnectivity(const QString& host, int port)
+void CTCPImg::emitDiagnosticReport()
 {
-    // 创建临时套接字进行连通性测试
-    QTcpSocket testSocket;
-    testSocket.setProxy(QNetworkProxy::NoProxy);
-    
-    // 设置较短的超时时间进行快速测试
-    testSocket.connectToHost(QHostAddress(host), port);
-    
-    if (testSocket.waitForConnected(3000)) {  // 3秒超时
-        testSocket.disconnectFromHost();
-        return "✅ 网络连通正常，可以建立TCP连接";
+    emit signalDiagnosticInfo((m_diagnosticHead + m_diagnosticProbes + m_diagnosticTail).join("\n"));
+}
+
+/**
+ * @brief 诊断线程完成一路连通性探测
+ * @param index 探测序号
+ * @param success 是否成功
+ * @param rttMs 连接耗时（毫秒）
+ * @param message 结果说明
+ */
+void CTCPImg::slot_diagnosticProbeFinished(int index, bool success, double rttMs, const QString &message)
+{
+    if (!m_diagnosticsRunning) {
+        return;
+    }
+
+    const QString line = QString("🔍    探测%1：%2（%3 %4 ms）")
+                         .arg(index + 1)
+                         .arg(message)
+                         .arg(success ? "连接RTT" : "耗时")
+                         .arg(rttMs, 0, 'f', 2);
+    m_diagnosticProbes << line;
+    qDebug() << line;
+    emitDiagnosticReport();
+}
+
+/**
+ * @brief 诊断线程完成全部连通性探测
+ * @param succeeded 成功路数
+ * @param total 总路数
+ * @param minRttMs 最小连接RTT（毫秒）
+ * @param avgRttMs 平均连接RTT（毫秒）
+ * @param maxRttMs 最大连接RTT（毫秒）
+ */
+void CTCPImg::slot_diagnosticsFinished(int succeeded, int total, double minRttMs, double avgRttMs, double maxRttMs)
+{
+    if (!m_diagnosticsRunning) {
+        return;
+    }
+    m_diagnosticsRunning = false;
+
+    QString summary;
+    if (succeeded > 0) {
+        summary = QString("🔍 连通性结果：✅ 网络连通正常，%1/%2路探测成功，连接RTT 最小/平均/最大 %3/%4/%5 ms")
+                  .arg(succeeded).arg(total)
+                  .arg(minRttMs, 0, 'f', 2).arg(avgRttMs, 0, 'f', 2).arg(maxRttMs, 0, 'f', 2);
     } else {
-        QAbstractSocket::SocketError error = testSocket.error();
-        QString errorString = testSocket.errorString();
-        
-        switch (error) {
-            case QAbstractSocket::ConnectionRefusedError:
-                return "❌ 连接被拒绝 - 服务端可能未启动或端口未监听";
-            case QAbstractSocket::HostNotFoundError:
-                return "❌ 主机未找到 - 请检查IP地址是否正确";
-            case QAbstractSocket::SocketTimeoutError:
-                return "❌ 连接超时 - 网络可能不通或服务端响应慢";
-            case QAbstractSocket::NetworkError:
-                return "❌ 网络错误 - 请检查网络连接";
-            default:
-                return QString("❌ 连接失败 - %1").arg(errorString);
-        }
+        summary = QString("🔍 连通性结果：❌ %1路探测均失败，无法建立TCP连接").arg(total);
     }
+
+    // 用汇总替换"正在探测"，各路明细保留在下面
+    m_diagnosticProbes[0] = summary;
+    qDebug() << summary;
+    emitDiagnosticReport();
+
+    emit diagnosticsFinished(succeeded > 0);
 }
 
 /**
@@ -929,7 +1648,7 @@ QString CTCPImg::generateDiagnosticReport()
     
     // 连接信息
     report << QString("📊 连接信息：%1:%2").arg(m_serverAddress).arg(m_serverPort);
-    report << QString("📊 重连状态：已尝试%1次，均失败").arg(m_maxReconnectAttempts);
+    report << QString("📊 重连状态：已尝试%1次，均失败").arg(m_reconnectAttempts);
     report << QString("📊 自动重连：已禁用（达到最大尝试次数）");
     
     // 可能的问题分析
@@ -960,6 +1679,7 @@ QString CTCPImg::generateDiagnosticReport()
  */
 void CTCPImg::stopReconnect()
 {
+    m_connectTimeoutTimer->stop();
     if (m_reconnectTimer->isActive()) {
         m_reconnectTimer->stop();
         qDebug() << "🛑 已停止自动重连";
@@ -970,25 +1690,48 @@ void CTCPImg::stopReconnect()
 /**
  * @brief 设置自动重连参数
  * @param enabled 是否启用自动重连
- * @param maxAttempts 最大重连尝试次数
- * @param interval 重连间隔时间（毫秒）
+ * @param maxAttempts 最大连续重连次数，0表示不限
+ * @param maxDelayMs 重连等待时间上限（毫秒）
  */
-void CTCPImg::setAutoReconnect(bool enabled, int maxAttempts, int interval)
+void CTCPImg::setAutoReconnect(bool enabled, int maxAttempts, int maxDelayMs)
 {
+    ReconnectPolicy policy = m_reconnectPolicy;
+    policy.maxAttempts = maxAttempts;
+    policy.maxDelayMs = maxDelayMs;
+
     m_autoReconnectEnabled = enabled;
-    m_maxReconnectAttempts = qMax(1, maxAttempts);  // 至少1次
-    m_reconnectInterval = qMax(1000, interval);     // 至少1秒间隔
+    setReconnectPolicy(policy);
     
-    qDebug() << QString("🔄 自动重连设置更新：%1，最大尝试次数：%2，间隔：%3ms")
-                .arg(enabled ? "启用" : "禁用")
-                .arg(m_maxReconnectAttempts)
-                .arg(m_reconnectInterval);
+    qDebug() << QString("🔄 自动重连设置更新：%1").arg(enabled ? "启用" : "禁用");
     
     if (!enabled && m_reconnectTimer->isActive()) {
         stopReconnect();
     }
 }
 
+/**
+ * @brief 设置重连策略
+ * @param policy 重连策略，超出范围的参数被修正
+ */
+void CTCPImg::setReconnectPolicy(const ReconnectPolicy& policy)
+{
+    m_reconnectPolicy = policy;
+    m_reconnectPolicy.initialDelayMs = qMax(0, policy.initialDelayMs);
+    m_reconnectPolicy.maxDelayMs = qMax(m_reconnectPolicy.initialDelayMs, policy.maxDelayMs);
+    m_reconnectPolicy.multiplier = qMax(1.0, policy.multiplier);
+    m_reconnectPolicy.jitter = qBound(0.0, policy.jitter, 1.0);
+    m_reconnectPolicy.connectTimeoutMs = qMax(0, policy.connectTimeoutMs);
+    m_reconnectPolicy.maxAttempts = qMax(0, policy.maxAttempts);
+
+    qDebug() << QString("🔄 重连策略：首次%1ms，×%2递增，上限%3ms，抖动%4%，连接超时%5ms，最大次数：%6")
+                .arg(m_reconnectPolicy.initialDelayMs)
+                .arg(m_reconnectPolicy.multiplier, 0, 'f', 1)
+                .arg(m_reconnectPolicy.maxDelayMs)
+                .arg(int(m_reconnectPolicy.jitter * 100))
+                .arg(m_reconnectPolicy.connectTimeoutMs)
+                .arg(m_reconnectPolicy.maxAttempts > 0 ? QString::number(m_reconnectPolicy.maxAttempts) : QString("不限"));
+}
+
 /**
  * @brief 获取当前连接状态
  * @return 连接状态
@@ -1027,7 +1770,7 @@ void CTCPImg::updateImageDisplay(const QByteArray &imageData)
 {
     // 将接收到的数据复制到帧缓冲区
     if (imageData.size() <= m_totalsize) {
-        memcpy(frameBuffer, imageData.data(), imageData.size());
+        memcpy(m_frameBuffer.data(), imageData.constData(), size_t(imageData.size()));
         
         // 执行图像质量分析
         QString qualityReport = analyzeImageQuality(imageData);
@@ -1041,101 +1784,6 @@ void CTCPImg::updateImageDisplay(const QByteArray &imageData)
     }
 }
 
-/**
- * @brief 从帧头解析帧大小信息
- * @param frameHeader 帧头数据（至少6字节）
- * @return 解析出的帧大小，-1表示解析失败
- */
-int CTCPImg::parseFrameSize(const QByteArray& frameHeader)
-{
-    if (frameHeader.size() < 6) {
-        qDebug() << "🔍 帧头数据不足，无法解析帧大小";
-        return -1;
-    }
-    
-    // 验证帧头标识符 7E 7E
-    if (frameHeader[0] != (char)0x7E || frameHeader[1] != (char)0x7E) {
-        qDebug() << "🔍 帧头标识符不匹配";
-        return -1;
-    }
-    
-    // 分析帧头结构（根据实际协议调整）
-    unsigned char byte2 = static_cast<unsigned char>(frameHeader[2]);
-    unsigned char byte3 = static_cast<unsigned char>(frameHeader[3]);
-    unsigned char byte4 = static_cast<unsigned char>(frameHeader[4]);
-    unsigned char byte5 = static_cast<unsigned char>(frameHeader[5]);
-    
-    qDebug() << QString("🔍 帧头字节分析：[7E 7E %1 %2 %3 %4]")
-                .arg(byte2, 2, 16, QChar('0')).toUpper()
-                .arg(byte3, 2, 16, QChar('0')).toUpper()
-                .arg(byte4, 2, 16, QChar('0')).toUpper()
-                .arg(byte5, 2, 16, QChar('0')).toUpper();
-    
-    // 方案1：字节4-5作为大端序16位长度
-    int size1 = (byte4 << 8) | byte5;
-    
-    // 方案2：字节2-3作为大端序16位长度
-    int size2 = (byte2 << 8) | byte3;
-    
-    // 方案3：字节4-5作为小端序16位长度
-    int size3 = (byte5 << 8) | byte4;
-    
-    // 方案4：使用预设的图像大小
-    int size4 = m_totalsize + 6; // 图像数据 + 帧头
-    
-    qDebug() << QString("🔍 大小解析方案：");
-    qDebug() << QString("🔍   方案1(byte4-5大端)：%1 字节").arg(size1);
-    qDebug() << QString("🔍   方案2(byte2-3大端)：%2 字节").arg(size2);
-    qDebug() << QString("🔍   方案3(byte4-5小端)：%3 字节").arg(size3);
-    qDebug() << QString("🔍   方案4(预设大小)：%4 字节").arg(size4);
-    
-    // 选择最合理的大小（接近预期图像大小的方案）
-    int expectedImageSize = m_totalsize;
-    int bestSize = size4; // 默认使用预设大小
-    
-    // 检查哪个方案最接近预期
-    QList<int> sizes = {size1, size2, size3, size4};
-    for (int size : sizes) {
-        if (size >= expectedImageSize && size <= expectedImageSize + 100) {
-            bestSize = size;
-            qDebug() << QString("🔍 选择最佳匹配方案：%1 字节").arg(bestSize);
-            break;
-        }
-    }
-    
-    return bestSize;
-}
-
-/**
- * @brief 验证帧数据完整性
- * @param frameData 完整帧数据
- * @return 如果帧数据有效返回true
- */
-bool CTCPImg::validateFrameData(const QByteArray& frameData)
-{
-    if (frameData.size() < 6) {
-        qDebug() << "🔍 帧数据太小，验证失败";
-        return false;
-    }
-    
-    // 验证帧头
-    if (frameData[0] != (char)0x7E || frameData[1] != (char)0x7E) {
-        qDebug() << "🔍 帧头验证失败";
-        return false;
-    }
-    
-    // 验证图像数据大小
-    int imageDataSize = frameData.size() - 6;
-    if (imageDataSize != m_totalsize) {
-        qDebug() << QString("🔍 图像数据大小不匹配：期望%1，实际%2")
-                    .arg(m_totalsize).arg(imageDataSize);
-        return false;
-    }
-    
-    qDebug() << "🔍 帧数据验证通过 ✅";
-    return true;
-}
-
 /**
  * @brief 图像质量检测功能
  * @param imageData 图像数据
@@ -1153,7 +1801,7 @@ QString CTCPImg::analyzeImageQuality(const QByteArray& imageData)
     // 基本统计
     int totalPixels = m_imageWidth * m_imageHeight;
     int totalChannels = m_imageChannels;
-    int expectedSize = totalPixels * totalChannels;
+    qint64 expectedSize = m_totalsize;
     
     report << QString("   📏 预期尺寸：%1x%2x%3 (%4字节)")
               .arg(m_imageWidth).arg(m_imageHeight).arg(totalChannels).arg(expectedSize);
@@ -1228,4 +1876,154 @@ QString CTCPImg::analyzeImageQuality(const QByteArray& imageData)
     return report.join("\n");
 }
 
+/**
+ * @brief 启用共享内存帧导出
+ * @param name 共享内存名
+ * @param slotCount 环形槽位数
+ * @return 创建成功返回true
+ */
+bool CTCPImg::enableSharedFrameRing(const QString& name, int slotCount)
+{
+    if (!m_sharedRing.create(name, slotCount, m_totalsize)) {
+        qDebug() << "❌ 共享内存帧导出启用失败：" << m_sharedRing.errorString();
+        return false;
+    }
+
+    m_sharedRingName = name;
+    m_sharedRingSlots = slotCount;
+    return true;
+}
+
+/**
+ * @brief 停止共享内存帧导出
+ */
+void CTCPImg::disableSharedFrameRing()
+{
+    m_sharedRing.close();
+    m_sharedRingName.clear();
+}
+
+/**
+ * @brief 启用帧转发服务
+ * @param config 转发配置
+ * @return 监听成功返回true
+ */
+bool CTCPImg::enableFrameRelay(const CFrameRelay::Config& config)
+{
+    return m_frameRelay.start(config);
+}
 
+/**
+ * @brief 停止帧转发服务
+ */
+void CTCPImg::disableFrameRelay()
+{
+    m_frameRelay.stop();
+}
+
+/**
+ * @brief 把完成的帧写入共享内存环
+ * @param payload 图像数据
+ * @param info 帧元数据
+ *
+ * 帧大于槽位容量（分辨率变大或size=指令）时按新大小重建共享内存，
+ * 读取方通过 isClosedByWriter() 得知后重新打开
+ */
+void CTCPImg::publishSharedFrame(const QByteArray &payload, const CFrameParser::FrameInfo &info)
+{
+    if (payload.size() > m_sharedRing.slotCapacity()) {
+        qDebug() << QString("🧩 帧大小%1超过共享内存槽位容量%2，重建帧环")
+                    .arg(payload.size()).arg(m_sharedRing.slotCapacity());
+        // 按容量档预留，帧大小在档内变化时不再重建
+        if (!m_sharedRing.create(m_sharedRingName, m_sharedRingSlots, CFrameBuffer::sizeClass(payload.size()))) {
+            qDebug() << "❌ 共享内存帧环重建失败：" << m_sharedRing.errorString();
+            return;
+        }
+    }
+
+    CSharedFrameRing::FrameMeta meta;
+    meta.senderSequence = info.hasExtendedHeader ? info.sequence : 0;
+    meta.timestampUs = info.firstByteWallUs + (info.completeNs - info.firstByteNs) / 1000;
+    meta.width = quint32(m_imageWidth);
+    meta.height = quint32(m_imageHeight);
+    meta.channels = quint32(m_imageChannels);
+
+    if (m_sharedRing.publish(payload.constData(), payload.size(), meta)) {
+        m_metricShmPublished->increment();
+    }
+}
+
+/**
+ * @brief 注册运行指标和采集回调
+ *
+ * 计数器由 CMetricsRegistry 持有，本对象只保存指针；多个实例注册同名指标时共享计数
+ */
+void CTCPImg::initMetrics()
+{
+    CMetricsRegistry& registry = CMetricsRegistry::instance();
+    m_metricBytes = registry.counter("tcpimg_receiver_bytes_total", "图像接收端收到的字节数");
+    m_metricFrames = registry.counter("tcpimg_receiver_frames_total", "图像接收端完成的帧数");
+    m_metricFramesDropped = registry.counter("tcpimg_receiver_frames_dropped_total", "帧头大小与期望不符而丢弃的帧数");
+    m_metricResyncs = registry.counter("tcpimg_receiver_resyncs_total", "帧头失步后重新同步的次数");
+    m_metricReconnects = registry.counter("tcpimg_receiver_reconnects_total", "自动重连尝试次数");
+    m_metricFailovers = registry.counter("tcpimg_receiver_failovers_total", "主链路失效后由备用连接接管的次数");
+    m_metricByteStalls = registry.counter("tcpimg_receiver_byte_stalls_total", "连接未断开但超时未收到数据的次数");
+    m_metricFrameStalls = registry.counter("tcpimg_receiver_frame_stalls_total", "有数据但超时未收到完整帧的次数");
+    m_metricHeartbeats = registry.counter("tcpimg_receiver_heartbeats_total", "收到的发送端心跳数");
+    m_metricBacklog = registry.gauge("tcpimg_receiver_socket_backlog_bytes", "最近一次读取前套接字中排队的字节数");
+    m_metricConnected = registry.gauge("tcpimg_receiver_connected", "是否已连接到图像服务器");
+    m_metricShmPublished = registry.counter("tcpimg_shm_frames_published_total", "写入共享内存帧环的帧数");
+
+    m_metricsPublishedResyncs = 0;
+    m_metricsRateFrames = 0;
+    m_metricsRateBytes = 0;
+    m_metricsFps = 0.0;
+    m_metricsMbps = 0.0;
+    m_metricsRateTimer.start();
+
+    registry.addCollector(this, [this](QString &out) { collectMetrics(out); });
+}
+
+/**
+ * @brief 采集回调：输出帧率、码率和各阶段延迟分位数
+ * @param out Prometheus文本格式输出
+ *
+ * 帧率和码率按两次抓取之间的计数增量计算，间隔不足1秒时沿用上次结果
+ */
+void CTCPImg::collectMetrics(QString &out)
+{
+    const qint64 elapsedMs = m_metricsRateTimer.elapsed();
+    if (elapsedMs >= 1000) {
+        const qint64 frames = m_metricFrames->value();
+        const qint64 bytes = m_metricBytes->value();
+        m_metricsFps = (frames - m_metricsRateFrames) * 1000.0 / elapsedMs;
+        m_metricsMbps = (bytes - m_metricsRateBytes) * 8.0 / 1000.0 / elapsedMs;
+        m_metricsRateFrames = frames;
+        m_metricsRateBytes = bytes;
+        m_metricsRateTimer.restart();
+    }
+
+    CMetricsRegistry::appendHeader(out, "tcpimg_receiver_fps", "gauge", "图像接收帧率（自上次抓取）");
+    out += QString("tcpimg_receiver_fps %1\n").arg(m_metricsFps, 0, 'f', 3);
+    CMetricsRegistry::appendHeader(out, "tcpimg_receiver_mbps", "gauge", "图像接收码率Mbps（自上次抓取）");
+    out += QString("tcpimg_receiver_mbps %1\n").arg(m_metricsMbps, 0, 'f', 3);
+
+    // 延迟：滚动窗口分位数 + 累计总和/次数，单位秒
+    CMetricsRegistry::appendHeader(out, "tcpimg_latency_seconds", "summary", "各阶段延迟（滚动窗口分位数）");
+    const double quantiles[] = {0.5, 0.9, 0.99};
+    for (int i = 0; i < CLatencyStats::STAGE_COUNT; ++i) {
+        const CLatencyStats::Stage stage = static_cast<CLatencyStats::Stage>(i);
+        const CLatencyStats::Summary s = m_latencyStats.summary(stage);
+        if (s.totalCount == 0) {
+            continue;
+        }
+        const QString key = CLatencyStats::stageKey(stage);
+        const qint64 values[] = {s.p50, s.p90, s.p99};
+        for (int q = 0; q < 3; ++q) {
+            out += QString("tcpimg_latency_seconds{stage=\"%1\",quantile=\"%2\"} %3\n")
+                   .arg(key).arg(quantiles[q]).arg(values[q] / 1e6, 0, 'f', 6);
+        }
+        out += QString("tcpimg_latency_seconds_sum{stage=\"%1\"} %2\n").arg(key).arg(s.totalSum / 1e6, 0, 'f', 6);
+        out += QString("tcpimg_latency_seconds_count{stage=\"%1\"} %2\n").arg(key).arg(s.totalCount);
+    }
+}
@@ -9,8 +9,18 @@
 #include <QNetworkProxy>
 #include <QTimer>
 #include <QDateTime>
-#include <QImage>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QVector>
+#include <QStringList>
 #include "sysdefine.h"
+#include "frameparser.h"
+#include "latencystats.h"
+#include "metricsregistry.h"
+#include "sharedframering.h"
+#include "framerelay.h"
+#include "framebuffer.h"
+#include "networkdiagnostics.h"
 
 /**
  * @class CTCPImg
@@ -24,6 +34,73 @@ class CTCPImg: public QObject
     Q_OBJECT
 
 public:
+    /**
+     * @struct ReconnectPolicy
+     * @brief 自动重连策略：指数退避 + 随机抖动
+     *
+     * 第n次重连前等待 min(maxDelayMs, initialDelayMs × multiplier^(n-1))，
+     * 再在 [1-jitter, 1] 倍之间随机取值，多个接收端不会同时重连。
+     * 首次重连只等 initialDelayMs，发送端重启后能很快恢复；服务端长时间不在时
+     * 重连间隔逐步拉长到 maxDelayMs，不会频繁连接。
+     */
+    struct ReconnectPolicy
+    {
+        int initialDelayMs = 50;        ///< 首次重连等待时间（毫秒）
+        int maxDelayMs = 2000;          ///< 重连等待时间上限（毫秒）
+        double multiplier = 2.0;        ///< 每次失败后等待时间的倍数
+        double jitter = 0.5;            ///< 随机抖动比例（0-1）
+        int connectTimeoutMs = 2000;    ///< 单次连接超时（毫秒），超时后中止并进入下一次重连
+        int maxAttempts = 0;            ///< 最大连续重连次数，0表示不限
+    };
+
+    /**
+     * @struct Endpoint
+     * @brief 图像服务器端点及其健康状态
+     *
+     * 端点按优先级排列：start() 给出的地址为主端点，setBackupEndpoints 给出的依次在后。
+     * 连接失败时切换到下一个端点，一轮端点都失败后才按退避策略增加等待时间。
+     */
+    struct Endpoint
+    {
+        QString address;
+        quint16 port = 0;
+        int consecutiveFailures = 0;    ///< 连续失败次数，连接成功后清零
+        qint64 totalFailures = 0;       ///< 累计失败次数
+        qint64 lastConnectedMs = 0;     ///< 最近一次连接成功的时间（Unix纪元毫秒）
+        qint64 lastFailureMs = 0;       ///< 最近一次失败的时间（Unix纪元毫秒）
+        QString lastError;              ///< 最近一次失败的原因
+
+        bool isHealthy() const { return consecutiveFailures == 0; }
+    };
+
+    /**
+     * @struct StallPolicy
+     * @brief 接收停滞检测（应用层看门狗）
+     *
+     * 拔掉网线或发送端挂起时连接处于半开状态，TCP要很久才报错，断开和错误信号都不会到达。
+     * 看门狗按阈值的1/4周期采样接收计数，超过 byteTimeoutMs 没有新字节或超过
+     * frameTimeoutMs 没有完整帧即判定停滞；接收路径上不读取时钟。
+     * 发送端空闲时发送心跳（见 FrameProtocol::writeHeartbeat）可避免无图像时被误判：
+     * 心跳计入字节，不计入帧
+     */
+    struct StallPolicy
+    {
+        int byteTimeoutMs = 0;          ///< 超过该时间未收到任何字节判定停滞（毫秒），0表示不检测
+        int frameTimeoutMs = 0;         ///< 超过该时间未完成一帧判定停滞（毫秒），0表示不检测
+        int heartbeatIntervalMs = 0;    ///< 向发送端发送心跳的间隔（毫秒），0表示不发送
+        bool reconnectOnStall = true;   ///< 停滞后断开重连（热备连接就绪时直接切换）
+    };
+
+    /**
+     * @enum StallKind
+     * @brief 停滞类型
+     */
+    enum StallKind {
+        STALL_BYTES,    ///< 没有收到任何字节
+        STALL_FRAMES    ///< 有数据但没有完整帧
+    };
+    Q_ENUM(StallKind)
+
     /**
      * @brief 构造函数
      * @param parent 父对象指针，用于Qt对象树管理
@@ -70,9 +147,10 @@ public:
     
     /**
      * @brief 获取当前图像数据总大小
-     * @return 图像数据字节数
+     * @return 图像数据字节数（64位，宽×高×通道数不会溢出）；
+     *         size=指令的大小不是整行时为指令大小，显示仍按宽×高×通道数
      */
-    int getImageTotalSize() const { return m_totalsize; }
+    qint64 getImageTotalSize() const { return m_totalsize; }
     
     /**
      * @brief 获取当前tap模式
@@ -81,12 +159,18 @@ public:
     int getTapMode() const { return m_tapMode; }
     
     /**
-     * @brief 设置自动重连参数
+     * @brief 设置自动重连参数（其余参数保持当前重连策略）
      * @param enabled 是否启用自动重连
-     * @param maxAttempts 最大重连尝试次数（默认5次）
-     * @param interval 重连间隔时间（毫秒，默认3000ms）
+     * @param maxAttempts 最大连续重连次数，0表示不限（默认不限）
+     * @param maxDelayMs 重连等待时间上限（毫秒，默认2000ms）
+     */
+    void setAutoReconnect(bool enabled, int maxAttempts = 0, int maxDelayMs = 2000);
+
+    /**
+     * @brief 设置重连策略（退避参数、连接超时、最大次数）
      */
-    void setAutoReconnect(bool enabled, int maxAttempts = 5, int interval = 3000);
+    void setReconnectPolicy(const ReconnectPolicy& policy);
+    const ReconnectPolicy& reconnectPolicy() const { return m_reconnectPolicy; }
     
     /**
      * @brief 获取当前连接状态
@@ -108,15 +192,15 @@ public:
     
     /**
      * @brief 获取最大重连尝试次数
-     * @return 最大重连尝试次数
+     * @return 最大重连尝试次数，0表示不限
      */
-    int getMaxReconnectAttempts() const { return m_maxReconnectAttempts; }
+    int getMaxReconnectAttempts() const { return m_reconnectPolicy.maxAttempts; }
     
     /**
-     * @brief 获取重连间隔时间
-     * @return 重连间隔时间（毫秒）
+     * @brief 获取本次重连的等待时间（按退避策略计算，含抖动）
+     * @return 等待时间（毫秒）
      */
-    int getReconnectInterval() const { return m_reconnectInterval; }
+    int getReconnectInterval() const { return m_reconnectDelay; }
     
     /**
      * @brief 检查是否正在重连
@@ -137,19 +221,68 @@ public:
      */
     void stopAutoReconnect();
 
+    /**
+     * @brief 设置备用端点（按优先级），下次 start() 时生效
+     * @param endpoints 备用端点，只使用地址和端口
+     */
+    void setBackupEndpoints(const QVector<Endpoint>& endpoints);
+
+    /**
+     * @brief 解析端点列表文本（如 "192.168.1.32:17777, 192.168.2.31:17777"）
+     * @param text "IP:端口" 列表，以逗号、分号或空白分隔
+     * @param endpoints 输出端点
+     * @return 有无效项时返回false
+     */
+    static bool parseEndpoints(const QString& text, QVector<Endpoint>& endpoints);
+
+    /**
+     * @brief 全部端点（主端点在前）及其健康状态
+     */
+    const QVector<Endpoint>& endpoints() const { return m_endpoints; }
+
+    /**
+     * @brief 当前使用的端点序号，未开始连接时为-1
+     */
+    int activeEndpointIndex() const { return m_activeEndpoint; }
+
+    /**
+     * @brief 启用热备连接
+     *
+     * 启用且有多个端点时，主链路连接后再与下一个端点预先建立一条备用连接，
+     * 备用连接收到的数据直接丢弃。主链路断开或出错时立即切换到备用连接，
+     * 不经过重连等待，解析器从下一个帧头开始组帧（原始数据协议无帧边界，从切换处开始）
+     */
+    void setStandbyEnabled(bool enabled);
+    bool isStandbyEnabled() const { return m_standbyEnabled; }
+
+    /**
+     * @brief 备用连接是否已建立，可以立即接管
+     */
+    bool isStandbyReady() const;
+
+    /**
+     * @brief 设置接收停滞检测，已连接时立即生效
+     */
+    void setStallPolicy(const StallPolicy& policy);
+    const StallPolicy& stallPolicy() const { return m_stallPolicy; }
+
+    /**
+     * @brief 累计检测到的停滞次数
+     */
+    qint64 stallCount() const { return m_stallCount; }
+
     /**
      * @brief 执行服务端诊断检查
-     * 当重连失败后，检查服务端状态和网络连通性
+     * 当重连失败后，检查服务端状态和网络连通性。立即返回：连通性探测在
+     * 诊断线程中并行进行，结果通过 signalDiagnosticInfo 逐步更新，
+     * 结束时发射 diagnosticsFinished；诊断进行中再次调用被忽略
      */
     void performServerDiagnostics();
 
     /**
-     * @brief 检查网络连通性
-     * @param host 目标主机地址
-     * @param port 目标端口
-     * @return 连通性检查结果
+     * @brief 是否有诊断正在进行
      */
-    QString checkNetworkConnectivity(const QString& host, int port);
+    bool isDiagnosticsRunning() const { return m_diagnosticsRunning; }
     
     /**
      * @brief 生成诊断报告
@@ -157,6 +290,98 @@ public:
      */
     QString generateDiagnosticReport();
 
+    /**
+     * @brief 获取数据流解析器（用于读取帧统计）
+     * @return 解析器常量引用
+     */
+    const CFrameParser& frameParser() const { return m_frameParser; }
+
+    /**
+     * @brief 固定传输协议（默认自动识别）
+     * @param mode 见 CFrameParser::setProtocolLock
+     */
+    void setProtocolLock(CFrameParser::ProtocolMode mode) { m_frameParser.setProtocolLock(mode); }
+
+    /**
+     * @brief 是否按扩展帧头中的图像几何自动切换分辨率（默认开启）
+     *
+     * 开启时无需预先设置与发送端一致的分辨率：版本2扩展帧头携带宽、高、通道数，
+     * 几何变化时在当前连接上直接切换，缓冲区按容量档复用，并发射 imageGeometryChanged
+     */
+    void setAutoGeometryEnabled(bool enabled) { m_frameParser.setAutoGeometry(enabled); }
+    bool isAutoGeometryEnabled() const { return m_frameParser.autoGeometry(); }
+
+    /**
+     * @brief 是否把每帧复制到显示缓冲并发射 tcpImgReadySig（默认开启）
+     *
+     * 无界面运行时关闭，可省去每帧的整帧拷贝、亮度采样和日志；
+     * 帧仍通过 frameParser() 的 frameReady 信号、共享内存和帧转发输出
+     */
+    void setDisplayUpdateEnabled(bool enabled) { m_displayUpdateEnabled = enabled; }
+    bool isDisplayUpdateEnabled() const { return m_displayUpdateEnabled; }
+
+    /**
+     * @brief 获取最近一帧的元数据（帧序号、发送时间戳、接收时间戳）
+     * @return 在 tcpImgReadySig 处理期间对应当前帧
+     */
+    const CFrameParser::FrameInfo& lastFrameInfo() const { return m_lastFrameInfo; }
+
+    /**
+     * @brief 获取最近一帧的原始数据（与解析器共享，不拷贝）
+     *
+     * 与 getFrameBuffer 不同，返回的数据在后续帧到达后保持不变（解析器会为新帧另行分配），
+     * 可供界面分块显示时延后读取。大小与当前分辨率不一致时为空。
+     */
+    const QByteArray& lastFrameData() const { return m_lastFrameData; }
+
+    /**
+     * @brief 获取端到端延迟统计
+     * 网络和接收阶段在此记录，转换、显示和绘制阶段由界面层记录
+     */
+    CLatencyStats& latencyStats() { return m_latencyStats; }
+    const CLatencyStats& latencyStats() const { return m_latencyStats; }
+
+    /**
+     * @brief 启用共享内存帧导出
+     * @param name 共享内存名（如 tcpimg_frames，对应 /dev/shm/tcpimg_frames）
+     * @param slotCount 环形槽位数
+     * @return 创建成功返回true
+     *
+     * 启用后每个完整帧都会写入共享内存环，本机其他进程可通过
+     * CSharedFrameRing::open 映射读取；分辨率变大时自动按新大小重建
+     */
+    bool enableSharedFrameRing(const QString& name, int slotCount = CSharedFrameRing::DEFAULT_SLOTS);
+
+    /**
+     * @brief 停止共享内存帧导出并删除共享内存
+     */
+    void disableSharedFrameRing();
+
+    /**
+     * @brief 共享内存帧环（只读访问，用于状态显示）
+     */
+    const CSharedFrameRing& sharedFrameRing() const { return m_sharedRing; }
+
+    /**
+     * @brief 启用帧转发服务
+     * @param config 监听端口、队列长度、慢速客户端策略和下游协议
+     * @return 监听成功返回true
+     *
+     * 启用后每个完整帧都会转发给所有已连接的下游客户端，
+     * 用于只允许一个连接的相机同时供多个查看器使用
+     */
+    bool enableFrameRelay(const CFrameRelay::Config& config);
+
+    /**
+     * @brief 停止帧转发服务并断开所有下游客户端
+     */
+    void disableFrameRelay();
+
+    /**
+     * @brief 帧转发服务（只读访问，用于状态显示）
+     */
+    const CFrameRelay& frameRelay() const { return m_frameRelay; }
+
 public slots:
     /**
      * @brief 启动TCP连接
@@ -196,12 +421,83 @@ public slots:
      * 在连接断开后尝试重新连接到服务器
      */
     void slot_reconnect();
+
+    /**
+     * @brief 连接超时：中止本次连接并进入下一次重连
+     */
+    void slot_connectTimeout();
     
     /**
      * @brief 停止自动重连
      * 停止重连定时器，取消自动重连
      */
     void stopReconnect();
+
+private slots:
+    /**
+     * @brief 解析器输出完整帧
+     * @param payload 图像数据
+     * @param info 帧序号和接收时间戳
+     */
+    void slot_frameReady(const QByteArray &payload, const CFrameParser::FrameInfo &info);
+
+    /**
+     * @brief 解析器丢弃无效帧
+     * @param payloadSize 帧头声明的数据大小
+     */
+    void slot_frameDropped(int payloadSize);
+
+    /**
+     * @brief 收到size=指令
+     * @param size 指令中的帧大小
+     */
+    void slot_sizeCommand(int size);
+
+    /**
+     * @brief 备用连接建立
+     */
+    void slot_standbyConnected();
+
+    /**
+     * @brief 备用连接收到数据：丢弃，只保持连接
+     */
+    void slot_standbyReadyRead();
+
+    /**
+     * @brief 备用连接断开或出错：稍后重新建立
+     */
+    void slot_standbyFailed();
+
+    /**
+     * @brief 建立备用连接（定时器触发）
+     */
+    void slot_connectStandby();
+
+    /**
+     * @brief 看门狗采样：检查是否超过停滞阈值
+     */
+    void slot_stallCheck();
+
+    /**
+     * @brief 向发送端发送心跳
+     */
+    void slot_sendHeartbeat();
+
+    /**
+     * @brief 收到发送端心跳
+     */
+    void slot_heartbeatReceived(quint64 sequence, qint64 timestampUs);
+
+    /**
+     * @brief 诊断线程完成一路连通性探测
+     */
+    void slot_diagnosticProbeFinished(int index, bool success, double rttMs, const QString &message);
+
+    /**
+     * @brief 诊断线程完成全部连通性探测
+     */
+    void slot_diagnosticsFinished(int succeeded, int total, double minRttMs, double avgRttMs, double maxRttMs);
+
 signals:
    /**
     * @brief 图像数据就绪信号
@@ -209,6 +505,14 @@ signals:
     * 通知界面层更新图像显示
     */
    void  tcpImgReadySig();
+
+   /**
+    * @brief 图像几何随帧头变化（自动识别分辨率时）
+    * @param width 图像宽度
+    * @param height 图像高度
+    * @param channels 通道数
+    */
+   void imageGeometryChanged(int width, int height, int channels);
    
    /**
     * @brief 图像数据接收信号
@@ -222,6 +526,27 @@ signals:
     */
    void signalDiagnosticInfo(QString diagnosticInfo);
 
+   /**
+    * @brief 当前使用的端点变化（重连到其他端点或切换到备用连接）
+    * @param index 端点序号
+    * @param address 端点地址
+    * @param port 端点端口
+    */
+   void activeEndpointChanged(int index, const QString &address, int port);
+
+   /**
+    * @brief 检测到接收停滞（连接仍显示为已连接）
+    * @param kind 停滞类型
+    * @param idleMs 已停滞的时间（毫秒）
+    */
+   void streamStalled(CTCPImg::StallKind kind, qint64 idleMs);
+
+   /**
+    * @brief 诊断完成信号
+    * @param reachable 是否至少有一路探测成功建立连接
+    */
+   void diagnosticsFinished(bool reachable);
+
    // 添加新的信号
    void signal_showframestruct(const QString &info);
    void signal_showframeheader(const QString &info);
@@ -230,17 +555,41 @@ private:
    QTcpSocket* TCP_sendMesSocket;  ///< TCP套接字对象指针，用于网络通信
    bool m_brefresh;                ///< 刷新标志位，表示是否正在接收数据
    QByteArray pictmp;              ///< 临时数据缓冲区，用于累积接收的图像数据
-   char* frameBuffer;              ///< 图像帧缓冲区，存储完整的图像数据
-   int m_totalsize;                ///< 预期接收的图像数据总大小（字节）
+   CFrameBuffer m_frameBuffer;     ///< 图像帧缓冲区，存储完整的图像数据（mmap分配，优先大页）
+   qint64 m_totalsize;             ///< 预期接收的图像数据总大小（字节）
    
    // 重连相关成员变量
    QTimer* m_reconnectTimer;       ///< 重连定时器
    QString m_serverAddress;        ///< 服务器地址
    int m_serverPort;               ///< 服务器端口
    int m_reconnectAttempts;        ///< 重连尝试次数
-   int m_maxReconnectAttempts;     ///< 最大重连尝试次数
-   int m_reconnectInterval;        ///< 重连间隔时间（毫秒）
+   ReconnectPolicy m_reconnectPolicy;  ///< 重连策略
+   int m_reconnectDelay;           ///< 本次重连等待时间（毫秒）
+   QTimer* m_connectTimeoutTimer;  ///< 连接超时定时器
    bool m_autoReconnectEnabled;    ///< 是否启用自动重连
+
+   // 多端点与热备连接
+   QVector<Endpoint> m_endpoints;          ///< 全部端点（主端点在前）
+   QVector<Endpoint> m_backupEndpoints;    ///< 备用端点配置，start() 时并入 m_endpoints
+   int m_activeEndpoint;                   ///< 当前使用的端点序号
+   bool m_standbyEnabled;                  ///< 是否启用热备连接
+   QTcpSocket* m_standbySocket;            ///< 备用连接，未建立时为NULL
+   int m_standbyEndpoint;                  ///< 备用连接的端点序号
+   QTimer* m_standbyTimer;                 ///< 备用连接重建定时器
+
+   // 接收停滞检测
+   StallPolicy m_stallPolicy;              ///< 停滞检测参数
+   QTimer* m_stallTimer;                   ///< 看门狗采样定时器
+   QTimer* m_heartbeatTimer;               ///< 心跳发送定时器
+   QElapsedTimer m_stallClock;             ///< 看门狗时钟（连接建立时启动）
+   qint64 m_stallSeenBytes;                ///< 上次采样时的接收字节数
+   qint64 m_stallSeenFrames;               ///< 上次采样时的完成帧数
+   qint64 m_lastByteMs;                    ///< 最近一次采样到新字节的时刻
+   qint64 m_lastFrameMs;                   ///< 最近一次采样到新帧的时刻
+   bool m_byteStallReported;               ///< 本次停滞已报告（不重连时避免重复报告）
+   bool m_frameStallReported;
+   qint64 m_stallCount;                    ///< 累计停滞次数
+   quint64 m_heartbeatSequence;            ///< 发出的心跳序号
    
        // 动态图像参数
     int m_imageWidth;               ///< 图像宽度（像素）
@@ -253,6 +602,21 @@ private:
      * @return 成功返回true，失败返回false
      */
     bool reallocateFrameBuffer();
+
+    /**
+     * @brief 采用帧头携带的图像几何（不复位解析器，缓冲区按容量档复用）
+     *
+     * 几何超出 FrameProtocol::isValidGeometry 范围时忽略，保持当前分辨率
+     */
+    void applyFrameGeometry(int width, int height, int channels);
+
+    /**
+     * @brief 单帧大小是否等于宽×高×通道数（size=指令不是整行时不相等）
+     */
+    bool geometryMatchesFrameSize() const
+    {
+        return m_totalsize == qint64(m_imageWidth) * m_imageHeight * m_imageChannels;
+    }
     
     /**
      * @brief 格式化数据为十六进制字符串用于调试显示
@@ -278,20 +642,6 @@ private:
      */
     int findFrameHeader(const QByteArray& data, const QByteArray& header);
     
-    /**
-     * @brief 从帧头解析帧大小信息
-     * @param frameHeader 帧头数据（至少6字节）
-     * @return 解析出的帧大小，-1表示解析失败
-     */
-    int parseFrameSize(const QByteArray& frameHeader);
-    
-    /**
-     * @brief 验证帧数据完整性
-     * @param frameData 完整帧数据
-     * @return 如果帧数据有效返回true
-     */
-    bool validateFrameData(const QByteArray& frameData);
-    
     /**
      * @brief 图像质量检测功能
      * @param imageData 图像数据
@@ -305,10 +655,121 @@ private:
      */
     void triggerReconnectLogic(const QString& source);
 
+    /**
+     * @brief 连接主链路套接字的信号（接收、断开、错误）
+     */
+    void attachActiveSocket(QTcpSocket* socket);
+
+    /**
+     * @brief 切换到当前使用的端点，同步 m_serverAddress/m_serverPort
+     */
+    void selectEndpoint(int index);
+
+    /**
+     * @brief 记录端点连接失败
+     */
+    void recordEndpointFailure(int index, const QString& reason);
+
+    /**
+     * @brief 主链路失效时用备用连接接管
+     * @return 备用连接未就绪时返回false
+     */
+    bool promoteStandby(const QString& reason);
+
+    /**
+     * @brief 关闭备用连接
+     */
+    void closeStandby();
+
+    /**
+     * @brief 按需安排建立备用连接
+     * @param delayMs 延迟（毫秒）
+     */
+    void scheduleStandby(int delayMs);
+
+    /**
+     * @brief 连接建立（或切换到备用连接）后启动看门狗和心跳
+     */
+    void armStallWatchdog();
+
+    /**
+     * @brief 处理一次停滞：计数、通知，按策略切换或重连
+     */
+    void handleStall(StallKind kind, qint64 idleMs);
+
+    /**
+     * @brief 按退避策略计算第attempt次重连前的等待时间
+     */
+    int nextReconnectDelay(int attempt) const;
+
+    /**
+     * @brief 发起连接并启动连接超时
+     */
+    void connectWithTimeout();
+
     // 添加新的成员变量
     qint64 m_recvCount;           // 接收数据计数
-    QByteArray m_recvBuffer;      // 接收缓冲区
-    bool m_foundFirstFrame;       // 是否找到第一帧标志
+    QByteArray m_recvChunk;       // 套接字读取缓冲区（复用，避免每次readAll分配）
+    CFrameParser m_frameParser;   // 数据流解析器，负责切分帧
+    QTimer* m_sizeCommandTimer;   // size=指令后空闲时结束指令
+    CFrameParser::FrameInfo m_lastFrameInfo;  // 最近一帧的元数据
+    QByteArray m_lastFrameData;   // 最近一帧的原始数据（与解析器共享）
+    CLatencyStats m_latencyStats; // 端到端延迟统计
+    CSharedFrameRing m_sharedRing;  // 共享内存帧导出（未启用时不占用资源）
+    QString m_sharedRingName;       // 共享内存名，重建时使用
+    int m_sharedRingSlots;          // 共享内存槽位数
+    CFrameRelay m_frameRelay;       // 帧转发服务（未启用时不监听）
+    bool m_displayUpdateEnabled;    // 是否更新显示缓冲
+    bool m_invalidGeometryLogged;   // 已提示过超出范围的帧头几何
+
+    // 服务端诊断：连通性探测在专用线程中进行，界面线程只拼接报告
+    QThread m_diagnosticsThread;            ///< 诊断线程
+    CNetworkDiagnostics* m_diagnostics;     ///< 连通性探测（属于诊断线程）
+    bool m_diagnosticsRunning;              ///< 是否有诊断正在进行
+    QStringList m_diagnosticHead;           ///< 报告中连通性结果之前的部分
+    QStringList m_diagnosticProbes;         ///< 连通性结果（逐路追加）
+    QStringList m_diagnosticTail;           ///< 报告中连通性结果之后的部分
+
+    /**
+     * @brief 拼接当前诊断报告并发送到界面
+     */
+    void emitDiagnosticReport();
+
+    /**
+     * @brief 把完成的帧写入共享内存环
+     */
+    void publishSharedFrame(const QByteArray &payload, const CFrameParser::FrameInfo &info);
+
+    // 运行指标（见 metricsregistry.h），热路径上只做原子加法
+    CMetricsRegistry::Metric* m_metricBytes;          ///< 接收字节数
+    CMetricsRegistry::Metric* m_metricFrames;         ///< 完成帧数
+    CMetricsRegistry::Metric* m_metricFramesDropped;  ///< 丢弃帧数
+    CMetricsRegistry::Metric* m_metricResyncs;        ///< 重同步次数
+    CMetricsRegistry::Metric* m_metricReconnects;     ///< 重连尝试次数
+    CMetricsRegistry::Metric* m_metricFailovers;      ///< 切换到备用连接的次数
+    CMetricsRegistry::Metric* m_metricByteStalls;     ///< 无数据停滞次数
+    CMetricsRegistry::Metric* m_metricFrameStalls;    ///< 无完整帧停滞次数
+    CMetricsRegistry::Metric* m_metricHeartbeats;     ///< 收到的发送端心跳数
+    CMetricsRegistry::Metric* m_metricBacklog;        ///< 读取前套接字中排队的字节数
+    CMetricsRegistry::Metric* m_metricConnected;      ///< 是否已连接
+    CMetricsRegistry::Metric* m_metricShmPublished;   ///< 写入共享内存的帧数
+    qint64 m_metricsPublishedResyncs;                 ///< 已计入指标的解析器重同步次数
+    QElapsedTimer m_metricsRateTimer;                 ///< 速率计算计时（两次抓取之间）
+    qint64 m_metricsRateFrames;
+    qint64 m_metricsRateBytes;
+    double m_metricsFps;
+    double m_metricsMbps;
+
+    /**
+     * @brief 注册运行指标和采集回调
+     */
+    void initMetrics();
+
+    /**
+     * @brief 采集回调：输出帧率、码率和各阶段延迟分位数
+     * @param out Prometheus文本格式输出
+     */
+    void collectMetrics(QString &out);
 
     // 添加新的成员函数
     void updateImageDisplay(const QByteArray &imageData);
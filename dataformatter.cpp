@@ -3,6 +3,12 @@
 #include <QJsonParseError>
 #include <QRegularExpression>
 #include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TCPIMG_HAVE_SSE2 1
+#endif
 
 /**
  * @brief 构造函数
@@ -72,6 +78,113 @@ QString CDataFormatter::formatData(const QByteArray& data, DataDisplayFormat for
     return result;
 }
 
+/**
+ * @brief 按字节预先生成的编码表
+ *
+ * 程序内只生成一次；二进制和ASCII显示的每行除字节序号外只取决于字节值，
+ * 整行（从序号后的冒号到换行）直接存表
+ */
+struct CDataFormatter::ByteTables
+{
+    ushort hex[256][2];             ///< 两位大写十六进制
+    ushort dumpChar[256];           ///< 十六进制显示右侧的字符列
+    bool printable[256];            ///< isPrintableChar 的结果
+    QString binaryGrouped[256];     ///< ": 0000 1111 (0x0F, 15)\n"
+    QString binaryPlain[256];       ///< ": 00001111 (0x0F, 15)\n"
+    QString asciiLine[256];         ///< ": 'A' (ASCII: 65, HEX: 0x41)\n"
+
+    ByteTables()
+    {
+        static const char digits[] = "0123456789ABCDEF";
+        for (int value = 0; value < 256; ++value) {
+            const char ch = static_cast<char>(value);
+            hex[value][0] = ushort(digits[value >> 4]);
+            hex[value][1] = ushort(digits[value & 0x0F]);
+            printable[value] = CDataFormatter::isPrintableChar(ch);
+            dumpChar[value] = printable[value] ? ushort(value) : ushort('.');
+
+            const QString hexText = QString::fromLatin1(digits + (value >> 4), 1)
+                                  + QString::fromLatin1(digits + (value & 0x0F), 1);
+            QString bits;
+            for (int bit = 7; bit >= 0; --bit) {
+                bits += (value & (1 << bit)) ? '1' : '0';
+            }
+            const QString suffix = QString(" (0x%1, %2)\n").arg(hexText).arg(value);
+            binaryPlain[value] = ": " + bits + suffix;
+            binaryGrouped[value] = ": " + bits.left(4) + ' ' + bits.mid(4) + suffix;
+
+            const QString shown = printable[value]
+                    ? QString("'%1'").arg(QChar(ushort(value)))
+                    : CDataFormatter::replaceNonPrintable(ch);
+            asciiLine[value] = QString(": %1 (ASCII: %2, HEX: 0x%3)\n").arg(shown).arg(value).arg(hexText);
+        }
+    }
+};
+
+/**
+ * @brief 编码表（首次使用时生成）
+ */
+const CDataFormatter::ByteTables& CDataFormatter::byteTables()
+{
+    static const ByteTables tables;
+    return tables;
+}
+
+namespace {
+
+/**
+ * @brief 十进制位数
+ */
+inline int decimalDigits(int value)
+{
+    int digits = 1;
+    while (value >= 10) {
+        value /= 10;
+        ++digits;
+    }
+    return digits;
+}
+
+/**
+ * @brief 写入右对齐的十进制数，左侧补空格
+ * @return 写入后的位置
+ */
+inline QChar* writeDecimal(QChar* out, int value, int width)
+{
+    const int digits = decimalDigits(value);
+    for (int i = digits; i < width; ++i) {
+        *out++ = QLatin1Char(' ');
+    }
+    QChar* end = out + digits;
+    QChar* p = end;
+    do {
+        *--p = QLatin1Char(char('0' + value % 10));
+        value /= 10;
+    } while (value > 0);
+    return end;
+}
+
+/**
+ * @brief 写入字符串
+ * @return 写入后的位置
+ */
+inline QChar* writeString(QChar* out, const QString& text)
+{
+    memcpy(out, text.constData(), size_t(text.size()) * sizeof(QChar));
+    return out + text.size();
+}
+
+/**
+ * @brief 逐字节行（二进制、ASCII显示）的序号前缀
+ */
+const QString& byteLinePrefix()
+{
+    static const QString prefix = QString::fromUtf8("字节");
+    return prefix;
+}
+
+} // namespace
+
 /**
  * @brief 将数据格式化为十六进制显示
  * @param data 原始数据
@@ -81,41 +194,56 @@ QString CDataFormatter::formatData(const QByteArray& data, DataDisplayFormat for
  */
 QString CDataFormatter::toHexFormat(const QByteArray& data, int bytesPerLine, bool showAddress)
 {
-    QString result;
-    
-    for (int i = 0; i < data.size(); i += bytesPerLine) {
-        QString line;
-        
-        // 添加地址
+    if (data.isEmpty()) {
+        return QString();
+    }
+    if (bytesPerLine <= 0) {
+        bytesPerLine = 16;
+    }
+
+    const ByteTables& tables = byteTables();
+    const int size = data.size();
+    const int lines = (size + bytesPerLine - 1) / bytesPerLine;
+
+    // 每行："XXXXXXXX: " + 补齐到 bytesPerLine*3 的十六进制 + " |" + 字符列 + "|\n"
+    const int fixedPerLine = (showAddress ? 10 : 0) + bytesPerLine * 3 + 4;
+    QString result(int(qint64(lines) * fixedPerLine + size), Qt::Uninitialized);
+    QChar* out = result.data();
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+
+    for (int i = 0; i < size; i += bytesPerLine) {
+        const int count = qMin(bytesPerLine, size - i);
+
         if (showAddress) {
-            line += QString("%1: ").arg(i, 8, 16, QChar('0')).toUpper();
-        }
-        
-        // 十六进制部分
-        QString hexPart;
-        QString asciiPart;
-        
-        for (int j = 0; j < bytesPerLine && (i + j) < data.size(); ++j) {
-            unsigned char byte = static_cast<unsigned char>(data[i + j]);
-            hexPart += QString("%1 ").arg(byte, 2, 16, QChar('0')).toUpper();
-            
-            // ASCII部分
-            if (isPrintableChar(byte)) {
-                asciiPart += QChar(byte);
-            } else {
-                asciiPart += '.';
+            for (int shift = 24; shift >= 0; shift -= 8) {
+                const ushort* pair = tables.hex[(uint(i) >> shift) & 0xFF];
+                *out++ = QChar(pair[0]);
+                *out++ = QChar(pair[1]);
             }
+            *out++ = QLatin1Char(':');
+            *out++ = QLatin1Char(' ');
+        }
+
+        for (int j = 0; j < count; ++j) {
+            const ushort* pair = tables.hex[bytes[i + j]];
+            out[0] = QChar(pair[0]);
+            out[1] = QChar(pair[1]);
+            out[2] = QLatin1Char(' ');
+            out += 3;
         }
-        
-        // 补齐空格
-        while (hexPart.length() < bytesPerLine * 3) {
-            hexPart += "   ";
+        for (int j = count * 3; j < bytesPerLine * 3; ++j) {
+            *out++ = QLatin1Char(' ');
         }
-        
-        line += hexPart + " |" + asciiPart + "|";
-        result += line + "\n";
+
+        *out++ = QLatin1Char(' ');
+        *out++ = QLatin1Char('|');
+        for (int j = 0; j < count; ++j) {
+            *out++ = QChar(tables.dumpChar[bytes[i + j]]);
+        }
+        *out++ = QLatin1Char('|');
+        *out++ = QLatin1Char('\n');
     }
-    
+
     return result;
 }
 
@@ -127,28 +255,25 @@ QString CDataFormatter::toHexFormat(const QByteArray& data, int bytesPerLine, bo
  */
 QString CDataFormatter::toBinaryFormat(const QByteArray& data, int bitsPerByte)
 {
-    QString result;
-    
-    for (int i = 0; i < data.size(); ++i) {
-        unsigned char byte = static_cast<unsigned char>(data[i]);
-        QString binaryStr;
-        
-        for (int bit = 7; bit >= 0; --bit) {
-            binaryStr += (byte & (1 << bit)) ? '1' : '0';
-            
-            // 按位分组
-            if (bitsPerByte == 4 && bit == 4) {
-                binaryStr += ' ';
-            }
-        }
-        
-        result += QString("字节%1: %2 (0x%3, %4)\n")
-                 .arg(i, 3, 10, QChar(' '))
-                 .arg(binaryStr)
-                 .arg(byte, 2, 16, QChar('0')).toUpper()
-                 .arg(byte);
+    const ByteTables& tables = byteTables();
+    const QString* lines = (bitsPerByte == 4) ? tables.binaryGrouped : tables.binaryPlain;
+    const QString& prefix = byteLinePrefix();
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+    const int size = data.size();
+
+    qint64 length = 0;
+    for (int i = 0; i < size; ++i) {
+        length += prefix.size() + qMax(3, decimalDigits(i)) + lines[bytes[i]].size();
     }
-    
+
+    QString result(int(length), Qt::Uninitialized);
+    QChar* out = result.data();
+    for (int i = 0; i < size; ++i) {
+        out = writeString(out, prefix);
+        out = writeDecimal(out, i, 3);
+        out = writeString(out, lines[bytes[i]]);
+    }
+
     return result;
 }
 
@@ -160,26 +285,77 @@ QString CDataFormatter::toBinaryFormat(const QByteArray& data, int bitsPerByte)
  */
 QString CDataFormatter::toAsciiFormat(const QByteArray& data, bool showNonPrintable)
 {
-    QString result;
-    
-    for (int i = 0; i < data.size(); ++i) {
-        unsigned char byte = static_cast<unsigned char>(data[i]);
-        
-        if (isPrintableChar(byte)) {
-            result += QString("字节%1: '%2' (ASCII: %3, HEX: 0x%4)\n")
-                     .arg(i, 3, 10, QChar(' '))
-                     .arg(QChar(byte))
-                     .arg(byte)
-                     .arg(byte, 2, 16, QChar('0')).toUpper();
-        } else if (showNonPrintable) {
-            result += QString("字节%1: %2 (ASCII: %3, HEX: 0x%4)\n")
-                     .arg(i, 3, 10, QChar(' '))
-                     .arg(replaceNonPrintable(byte))
-                     .arg(byte)
-                     .arg(byte, 2, 16, QChar('0')).toUpper();
+    const ByteTables& tables = byteTables();
+    const QString& prefix = byteLinePrefix();
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+    const int size = data.size();
+
+    qint64 length = 0;
+    for (int i = 0; i < size; ++i) {
+        if (showNonPrintable || tables.printable[bytes[i]]) {
+            length += prefix.size() + qMax(3, decimalDigits(i)) + tables.asciiLine[bytes[i]].size();
         }
     }
-    
+
+    QString result(int(length), Qt::Uninitialized);
+    QChar* out = result.data();
+    for (int i = 0; i < size; ++i) {
+        if (showNonPrintable || tables.printable[bytes[i]]) {
+            out = writeString(out, prefix);
+            out = writeDecimal(out, i, 3);
+            out = writeString(out, tables.asciiLine[bytes[i]]);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief 将数据编码为大写十六进制字符串
+ * @param data 原始数据
+ * @param spaced 字节之间是否以空格分隔
+ * @return 十六进制字符串
+ */
+QString CDataFormatter::toHexString(const QByteArray& data, bool spaced)
+{
+    if (data.isEmpty()) {
+        return QString();
+    }
+
+    const ByteTables& tables = byteTables();
+    const int size = data.size();
+    QString result(spaced ? size * 3 - 1 : size * 2, Qt::Uninitialized);
+    QChar* out = result.data();
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+
+    for (int i = 0; i < size; ++i) {
+        if (spaced && i > 0) {
+            *out++ = QLatin1Char(' ');
+        }
+        const ushort* pair = tables.hex[bytes[i]];
+        out[0] = QChar(pair[0]);
+        out[1] = QChar(pair[1]);
+        out += 2;
+    }
+
+    return result;
+}
+
+/**
+ * @brief 将数据转换为可打印文本
+ * @param data 原始数据
+ * @return 与数据等长的文本
+ */
+QString CDataFormatter::toPrintableText(const QByteArray& data)
+{
+    QString result(data.size(), Qt::Uninitialized);
+    QChar* out = result.data();
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+
+    for (int i = 0; i < data.size(); ++i) {
+        out[i] = (bytes[i] >= 32 && bytes[i] <= 126) ? QLatin1Char(char(bytes[i])) : QLatin1Char('.');
+    }
+
     return result;
 }
 
@@ -215,55 +391,240 @@ QString CDataFormatter::generateDataStatistics(const QByteArray& data)
         return "数据为空";
     }
     
-    // 基本统计
-    int totalBytes = data.size();
-    int printableChars = 0;
-    int controlChars = 0;
-    int nullBytes = 0;
-    
-    // 字符频率统计
-    QMap<unsigned char, int> charFreq;
-    
-    for (int i = 0; i < data.size(); ++i) {
-        unsigned char byte = static_cast<unsigned char>(data[i]);
-        charFreq[byte]++;
-        
-        if (byte == 0) {
-            nullBytes++;
-        } else if (isPrintableChar(byte)) {
-            printableChars++;
-        } else {
-            controlChars++;
-        }
-    }
-    
-    // 计算熵值（简化版）
-    double entropy = 0.0;
-    for (auto it = charFreq.begin(); it != charFreq.end(); ++it) {
-        double probability = static_cast<double>(it.value()) / totalBytes;
-        if (probability > 0) {
-            entropy -= probability * log2(probability);
-        }
-    }
+    const DataProfile profile = profileData(data);
+    const double counted = profile.sampledBytes;
     
     QString result;
-    result += QString("数据大小：%1 字节\n").arg(totalBytes);
+    result += QString("数据大小：%1 字节\n").arg(profile.totalBytes);
+    if (profile.isSampled()) {
+        result += QString("统计方式：抽样 %1 字节（%2 块）\n")
+                  .arg(profile.sampledBytes)
+                  .arg(PROFILE_SAMPLE_BLOCKS);
+    }
     result += QString("可打印字符：%1 (%2%)\n")
-              .arg(printableChars)
-              .arg(printableChars * 100.0 / totalBytes, 0, 'f', 1);
+              .arg(profile.printableBytes)
+              .arg(profile.printableBytes * 100.0 / counted, 0, 'f', 1);
     result += QString("控制字符：%1 (%2%)\n")
-              .arg(controlChars)
-              .arg(controlChars * 100.0 / totalBytes, 0, 'f', 1);
+              .arg(profile.controlBytes)
+              .arg(profile.controlBytes * 100.0 / counted, 0, 'f', 1);
     result += QString("空字节：%1 (%2%)\n")
-              .arg(nullBytes)
-              .arg(nullBytes * 100.0 / totalBytes, 0, 'f', 1);
-    result += QString("唯一字节数：%1\n").arg(charFreq.size());
-    result += QString("数据熵值：%1\n").arg(entropy, 0, 'f', 2);
-    result += QString("建议格式：%1\n").arg(formatToString(detectDataFormat(data)));
+              .arg(profile.nullBytes)
+              .arg(profile.nullBytes * 100.0 / counted, 0, 'f', 1);
+    result += QString("唯一字节数：%1\n").arg(profile.uniqueBytes);
+    result += QString("数据熵值：%1\n").arg(profile.entropy, 0, 'f', 2);
+    result += QString("UTF-8编码：%1\n").arg(profile.validUtf8 ? "有效" : "无效");
+    result += QString("建议格式：%1\n").arg(formatToString(detectDataFormat(data, profile)));
     
     return result;
 }
 
+namespace {
+
+/**
+ * @brief 累加字节频率
+ *
+ * 四组计数交替累加，相邻的相同字节不会连续写同一个计数器，
+ * 避免存储转发依赖拖慢循环
+ */
+void accumulateHistogram(const uchar* bytes, int size, quint32 (&counts)[4][256])
+{
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        counts[0][bytes[i]]++;
+        counts[1][bytes[i + 1]]++;
+        counts[2][bytes[i + 2]]++;
+        counts[3][bytes[i + 3]]++;
+    }
+    for (; i < size; ++i) {
+        counts[0][bytes[i]]++;
+    }
+}
+
+/**
+ * @brief 检查UTF-8编码是否有效
+ * @param bytes 数据
+ * @param size 大小
+ * @param fragment 是否为抽样片段：开头的续字节和结尾被截断的字符不算错误
+ */
+bool isValidUtf8(const uchar* bytes, int size, bool fragment)
+{
+    int i = 0;
+    if (fragment) {
+        while (i < size && i < 3 && (bytes[i] & 0xC0) == 0x80) {
+            ++i;
+        }
+    }
+
+    while (i < size) {
+        // ASCII 先按16字节（SSE2）再按8字节跳过，遇到最高位为1的字节再逐字节解码
+#ifdef TCPIMG_HAVE_SSE2
+        while (i + 16 <= size) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+            if (_mm_movemask_epi8(chunk) != 0) {
+                break;
+            }
+            i += 16;
+        }
+#endif
+        while (i + 8 <= size) {
+            quint64 word;
+            memcpy(&word, bytes + i, sizeof(word));
+            if (word & Q_UINT64_C(0x8080808080808080)) {
+                break;
+            }
+            i += 8;
+        }
+        if (i >= size) {
+            break;
+        }
+
+        const uchar lead = bytes[i];
+        if (lead < 0x80) {
+            ++i;
+            continue;
+        }
+
+        // 后续字节数及第二字节的有效范围（排除超长编码、代理项和超出U+10FFFF）
+        int extra = 0;
+        uchar low = 0x80;
+        uchar high = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            extra = 1;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            extra = 2;
+            if (lead == 0xE0) low = 0xA0;
+            if (lead == 0xED) high = 0x9F;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            extra = 3;
+            if (lead == 0xF0) low = 0x90;
+            if (lead == 0xF4) high = 0x8F;
+        } else {
+            return false;
+        }
+
+        if (i + extra >= size) {
+            return fragment;
+        }
+        if (bytes[i + 1] < low || bytes[i + 1] > high) {
+            return false;
+        }
+        for (int k = 2; k <= extra; ++k) {
+            if ((bytes[i + k] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += extra + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief JSON空白字符
+ */
+inline bool isJsonSpace(uchar byte)
+{
+    return byte == ' ' || byte == '\n' || byte == '\r' || byte == '\t';
+}
+
+} // namespace
+
+/**
+ * @brief 统计数据特征
+ * @param data 原始数据
+ * @return 特征统计
+ */
+CDataFormatter::DataProfile CDataFormatter::profileData(const QByteArray& data)
+{
+    DataProfile profile;
+    memset(profile.histogram, 0, sizeof(profile.histogram));
+    profile.totalBytes = data.size();
+    if (data.isEmpty()) {
+        return profile;
+    }
+
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+    const int size = data.size();
+    quint32 counts[4][256];
+    memset(counts, 0, sizeof(counts));
+
+    // 第一遍只做计数；大数据均匀取块（含首块和尾块）
+    const bool sampled = size > PROFILE_SAMPLE_THRESHOLD;
+    if (sampled) {
+        const qint64 span = size - PROFILE_SAMPLE_BLOCK_SIZE;
+        for (int block = 0; block < PROFILE_SAMPLE_BLOCKS; ++block) {
+            const int offset = int(span * block / (PROFILE_SAMPLE_BLOCKS - 1));
+            accumulateHistogram(bytes + offset, PROFILE_SAMPLE_BLOCK_SIZE, counts);
+        }
+        profile.sampledBytes = PROFILE_SAMPLE_BLOCKS * PROFILE_SAMPLE_BLOCK_SIZE;
+    } else {
+        accumulateHistogram(bytes, size, counts);
+        profile.sampledBytes = size;
+    }
+
+    // 其余统计都从256项频率表得出
+    const double total = profile.sampledBytes;
+    for (int value = 0; value < 256; ++value) {
+        const quint32 count = counts[0][value] + counts[1][value] + counts[2][value] + counts[3][value];
+        profile.histogram[value] = count;
+        if (count == 0) {
+            continue;
+        }
+
+        profile.uniqueBytes++;
+        const double probability = count / total;
+        profile.entropy -= probability * std::log2(probability);
+
+        if (value == 0) {
+            profile.nullBytes += int(count);
+        } else if (isPrintableChar(char(value))) {
+            profile.printableBytes += int(count);
+        } else {
+            profile.controlBytes += int(count);
+        }
+        if (value >= 0x80) {
+            profile.highBytes += int(count);
+        }
+    }
+    profile.textBytes = profile.printableBytes + int(profile.histogram[uchar('\n')]
+                      + profile.histogram[uchar('\r')] + profile.histogram[uchar('\t')]);
+
+    // 只有出现0x80以上的字节时才需要检查UTF-8
+    if (profile.highBytes > 0) {
+        if (sampled) {
+            const qint64 span = size - PROFILE_SAMPLE_BLOCK_SIZE;
+            for (int block = 0; block < PROFILE_SAMPLE_BLOCKS && profile.validUtf8; ++block) {
+                const int offset = int(span * block / (PROFILE_SAMPLE_BLOCKS - 1));
+                profile.validUtf8 = isValidUtf8(bytes + offset, PROFILE_SAMPLE_BLOCK_SIZE, true);
+            }
+        } else {
+            profile.validUtf8 = isValidUtf8(bytes, size, false);
+        }
+    }
+
+    // JSON特征：首尾非空白字符成对；完整统计时括号和引号的数量也要对得上
+    int first = 0;
+    int last = size - 1;
+    while (first < size && isJsonSpace(bytes[first])) {
+        ++first;
+    }
+    while (last > first && isJsonSpace(bytes[last])) {
+        --last;
+    }
+    if (first < last) {
+        const uchar open = bytes[first];
+        const uchar close = bytes[last];
+        profile.jsonLike = (open == '{' && close == '}') || (open == '[' && close == ']');
+        if (profile.jsonLike && !sampled) {
+            profile.jsonLike = profile.histogram[uchar('{')] == profile.histogram[uchar('}')]
+                            && profile.histogram[uchar('[')] == profile.histogram[uchar(']')]
+                            && profile.histogram[uchar('"')] % 2 == 0;
+        }
+        profile.jsonLike = profile.jsonLike && profile.nullBytes == 0 && profile.validUtf8;
+    }
+
+    return profile;
+}
+
 /**
  * @brief 获取当前时间戳字符串
  * @return 格式化的时间戳
@@ -284,26 +645,35 @@ CDataFormatter::DataDisplayFormat CDataFormatter::detectDataFormat(const QByteAr
         return FORMAT_RAW_TEXT;
     }
     
-    // 检查是否为JSON
-    if (isValidJson(data)) {
+    return detectDataFormat(data, profileData(data));
+}
+
+/**
+ * @brief 根据特征统计推断显示格式
+ * @param data 原始数据
+ * @param profile 特征统计
+ * @return 建议的显示格式
+ */
+CDataFormatter::DataDisplayFormat CDataFormatter::detectDataFormat(const QByteArray& data, const DataProfile& profile)
+{
+    if (profile.totalBytes == 0) {
+        return FORMAT_RAW_TEXT;
+    }
+    
+    // 检查是否为JSON：只有首尾特征符合时才解析；抽样统计的大数据不做完整解析
+    if (profile.jsonLike && (profile.isSampled() || isValidJson(data))) {
         return FORMAT_JSON;
     }
     
-    // 检查是否为纯文本
-    if (isPlainText(data)) {
+    // 检查是否为纯文本（90%以上是文本字符；非UTF-8时高位字节不算文本）
+    const int textBytes = profile.validUtf8 ? profile.textBytes : profile.textBytes - profile.highBytes;
+    if (textBytes >= profile.sampledBytes * 0.9) {
         return FORMAT_RAW_TEXT;
     }
     
     // 如果包含很多二进制数据，建议十六进制显示
-    int binaryBytes = 0;
-    for (int i = 0; i < data.size(); ++i) {
-        unsigned char byte = static_cast<unsigned char>(data[i]);
-        if (!isPrintableChar(byte) && byte != '\n' && byte != '\r' && byte != '\t') {
-            binaryBytes++;
-        }
-    }
-    
-    if (binaryBytes > data.size() * 0.3) {  // 如果超过30%是二进制数据
+    const int binaryBytes = profile.sampledBytes - textBytes;
+    if (binaryBytes > profile.sampledBytes * 0.3) {  // 如果超过30%是二进制数据
         return FORMAT_HEX;
     }
     
@@ -395,14 +765,7 @@ bool CDataFormatter::isPlainText(const QByteArray& data)
         return true;
     }
     
-    int printableCount = 0;
-    for (int i = 0; i < data.size(); ++i) {
-        unsigned char byte = static_cast<unsigned char>(data[i]);
-        if (isPrintableChar(byte) || byte == '\n' || byte == '\r' || byte == '\t') {
-            printableCount++;
-        }
-    }
-    
     // 如果90%以上是可打印字符，认为是纯文本
-    return printableCount >= data.size() * 0.9;
-} 
\ No newline at end of file
+    const DataProfile profile = profileData(data);
+    return profile.textBytes >= profile.sampledBytes * 0.9;
+}
@@ -18,6 +18,10 @@
  * - ASCII码显示
  * - JSON格式化显示
  * - 数据统计分析
+ *
+ * 十六进制、二进制和ASCII显示按查表编码：每个字节的文本预先生成，
+ * 先算出结果长度一次分配，再直接写入，不逐字节构造和拼接字符串。
+ * 统计信息和格式检测共用 profileData 的一次遍历结果，大数据只抽样统计
  */
 class CDataFormatter
 {
@@ -35,6 +39,32 @@ public:
         FORMAT_MIXED         ///< 混合格式显示
     };
 
+    static const int PROFILE_SAMPLE_THRESHOLD = 256 * 1024;    ///< 超过此大小时抽样统计（字节）
+    static const int PROFILE_SAMPLE_BLOCKS = 32;                ///< 抽样块数（均匀分布，含首尾）
+    static const int PROFILE_SAMPLE_BLOCK_SIZE = 2048;          ///< 抽样块大小（字节）
+
+    /**
+     * @struct DataProfile
+     * @brief 数据特征统计（一次遍历得到）
+     */
+    struct DataProfile
+    {
+        int totalBytes = 0;         ///< 数据总大小
+        int sampledBytes = 0;       ///< 参与统计的字节数（未抽样时等于总大小）
+        quint32 histogram[256];     ///< 字节频率
+        int printableBytes = 0;     ///< 可打印字符（含扩展ASCII）
+        int controlBytes = 0;       ///< 控制字符（不含空字节）
+        int nullBytes = 0;          ///< 空字节
+        int textBytes = 0;          ///< 可打印字符加换行、回车、制表符
+        int highBytes = 0;          ///< 0x80及以上的字节
+        int uniqueBytes = 0;        ///< 出现过的不同字节值
+        double entropy = 0.0;       ///< 香农熵（位/字节）
+        bool validUtf8 = true;      ///< 是否为有效UTF-8（抽样时只检查抽样块）
+        bool jsonLike = false;      ///< 首尾为成对的 {} 或 []，看起来像JSON
+
+        bool isSampled() const { return sampledBytes < totalBytes; }
+    };
+
     /**
      * @brief 构造函数
      */
@@ -79,6 +109,21 @@ public:
      */
     QString toAsciiFormat(const QByteArray& data, bool showNonPrintable = true);
 
+    /**
+     * @brief 将数据编码为大写十六进制字符串（如 "7E 01 FF"）
+     * @param data 原始数据
+     * @param spaced 字节之间是否以空格分隔
+     * @return 十六进制字符串，末尾无空格
+     */
+    static QString toHexString(const QByteArray& data, bool spaced = true);
+
+    /**
+     * @brief 将数据转换为可打印文本，ASCII可打印字符以外的字节显示为 '.'
+     * @param data 原始数据
+     * @return 与数据等长的文本
+     */
+    static QString toPrintableText(const QByteArray& data);
+
     /**
      * @brief 尝试将数据格式化为JSON显示
      * @param data 原始数据
@@ -106,6 +151,14 @@ public:
      */
     DataDisplayFormat detectDataFormat(const QByteArray& data);
 
+    /**
+     * @brief 统计数据特征
+     * @param data 原始数据
+     * @return 字节频率、可打印比例、熵、UTF-8有效性和JSON特征；
+     *         超过 PROFILE_SAMPLE_THRESHOLD 时只统计均匀分布的抽样块
+     */
+    static DataProfile profileData(const QByteArray& data);
+
     /**
      * @brief 格式名称转换
      * @param format 格式枚举
@@ -119,14 +172,14 @@ private:
      * @param ch 字符
      * @return true如果可打印
      */
-    bool isPrintableChar(char ch);
+    static bool isPrintableChar(char ch);
 
     /**
      * @brief 替换不可打印字符
      * @param ch 字符
      * @return 替换后的字符串表示
      */
-    QString replaceNonPrintable(char ch);
+    static QString replaceNonPrintable(char ch);
 
     /**
      * @brief 检查数据是否为有效的JSON
@@ -141,6 +194,20 @@ private:
      * @return true如果是纯文本
      */
     bool isPlainText(const QByteArray& data);
+
+    /**
+     * @brief 根据特征统计推断显示格式
+     * @param data 原始数据（只在需要确认JSON时解析）
+     * @param profile 特征统计
+     * @return 建议的显示格式
+     */
+    DataDisplayFormat detectDataFormat(const QByteArray& data, const DataProfile& profile);
+
+    /**
+     * @brief 按字节预先生成的编码表
+     */
+    struct ByteTables;
+    static const ByteTables& byteTables();
 };
 
 #endif // DATAFORMATTER_H 
\ No newline at end of file
@@ -0,0 +1,618 @@
+#include "debugserver.h"
+#include <QNetworkProxy>
+#include <QDateTime>
+#include <QDebug>
+
+/**
+ * @brief CDebugServer构造函数
+ * @param workerCount 工作线程数，0表示按CPU核数
+ * @param linkStats 链路统计，可为空
+ * @param capture 抓包文件，可为空
+ * @param parent 父对象指针
+ */
+CDebugServer::CDebugServer(int workerCount, CLinkStats* linkStats, CPcapWriter* capture, QObject *parent)
+    : QTcpServer(parent)
+    , m_watchAll(false)
+    , m_verifyTraffic(false)
+    , m_echo(false)
+    , m_nextClientId(1)
+    , m_statsTimer(this)
+{
+    qRegisterMetaType<CDebugServer::ClientStats>();
+    qRegisterMetaType<QVector<CDebugServer::ClientStats> >();
+
+    CMetricsRegistry& registry = CMetricsRegistry::instance();
+    m_metricClients = registry.gauge("tcpimg_debugger_clients", "网络调试服务器当前客户端数");
+    m_metricConnections = registry.counter("tcpimg_debugger_connections_total", "网络调试服务器累计接受的连接数");
+
+    if (workerCount <= 0) {
+        workerCount = QThread::idealThreadCount();
+    }
+    workerCount = qBound(1, workerCount, int(MAX_WORKERS));
+
+    for (int i = 0; i < workerCount; ++i) {
+        QThread* thread = new QThread(this);
+        thread->setObjectName(QString("tcpimg-debug-%1").arg(i));
+
+        CDebugServerWorker* worker = new CDebugServerWorker(linkStats, capture);
+        worker->moveToThread(thread);
+        connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+        connect(worker, &CDebugServerWorker::clientOpened, this, &CDebugServer::onWorkerClientOpened);
+        connect(worker, &CDebugServerWorker::clientClosed, this, &CDebugServer::onWorkerClientClosed);
+        connect(worker, &CDebugServerWorker::clientFailed, this, &CDebugServer::onWorkerClientFailed);
+        connect(worker, &CDebugServerWorker::statsReady, this, &CDebugServer::onWorkerStats);
+        connect(worker, &CDebugServerWorker::clientData, this, &CDebugServer::clientData);
+        thread->start();
+
+        m_threads.append(thread);
+        m_workers.append(worker);
+        m_workerLoad.append(0);
+    }
+
+    m_statsTimer.setInterval(STATS_INTERVAL_MS);
+    connect(&m_statsTimer, &QTimer::timeout, this, &CDebugServer::statsUpdated);
+    m_statsTimer.start();
+
+    qDebug() << QString("🧵 调试服务器：%1个工作线程").arg(workerCount);
+}
+
+/**
+ * @brief 析构函数：停止工作线程（客户端套接字随工作对象一起释放）
+ */
+CDebugServer::~CDebugServer()
+{
+    close();
+    for (QThread* thread : m_threads) {
+        thread->quit();
+        thread->wait();
+    }
+    m_metricClients->add(-m_clients.size());
+}
+
+/**
+ * @brief 全部客户端的累计统计
+ */
+CDebugServer::ClientStats CDebugServer::totals() const
+{
+    ClientStats total = m_closedTotals;
+    total.rxBytesPerSec = 0.0;
+    total.txBytesPerSec = 0.0;
+    total.pendingBytes = 0;
+    for (const ClientStats& stats : m_clients) {
+        total.bytesReceived += stats.bytesReceived;
+        total.bytesSent += stats.bytesSent;
+        total.packetsReceived += stats.packetsReceived;
+        total.packetsSent += stats.packetsSent;
+        total.messagesDropped += stats.messagesDropped;
+        total.pendingBytes += stats.pendingBytes;
+        total.rxBytesPerSec += stats.rxBytesPerSec;
+        total.txBytesPerSec += stats.txBytesPerSec;
+        total.integrity += stats.integrity;
+    }
+    return total;
+}
+
+/**
+ * @brief 向所有客户端发送数据
+ * @param data 数据
+ * @return 接收数据的客户端数
+ */
+int CDebugServer::broadcast(const QByteArray& data)
+{
+    if (data.isEmpty() || m_clients.isEmpty()) {
+        return 0;
+    }
+
+    // 每个工作线程收到的是同一份缓冲的引用
+    for (CDebugServerWorker* worker : m_workers) {
+        QMetaObject::invokeMethod(worker, "broadcast", Qt::QueuedConnection, Q_ARG(QByteArray, data));
+    }
+    return m_clients.size();
+}
+
+/**
+ * @brief 向指定客户端发送数据
+ */
+bool CDebugServer::sendTo(quint64 id, const QByteArray& data)
+{
+    const int worker = m_clientWorker.value(id, -1);
+    if (worker < 0 || data.isEmpty()) {
+        return false;
+    }
+    QMetaObject::invokeMethod(m_workers[worker], "sendTo", Qt::QueuedConnection,
+                              Q_ARG(quint64, id), Q_ARG(QByteArray, data));
+    return true;
+}
+
+/**
+ * @brief 断开指定客户端
+ */
+void CDebugServer::disconnectClient(quint64 id)
+{
+    const int worker = m_clientWorker.value(id, -1);
+    if (worker >= 0) {
+        QMetaObject::invokeMethod(m_workers[worker], "disconnectClient", Qt::QueuedConnection, Q_ARG(quint64, id));
+    }
+}
+
+/**
+ * @brief 断开所有客户端
+ */
+void CDebugServer::disconnectAll()
+{
+    for (CDebugServerWorker* worker : m_workers) {
+        QMetaObject::invokeMethod(worker, "disconnectAll", Qt::QueuedConnection);
+    }
+}
+
+/**
+ * @brief 是否转发所有客户端的数据
+ */
+void CDebugServer::setWatchAll(bool watchAll)
+{
+    m_watchAll = watchAll;
+    for (CDebugServerWorker* worker : m_workers) {
+        QMetaObject::invokeMethod(worker, "setWatchAll", Qt::QueuedConnection, Q_ARG(bool, watchAll));
+    }
+}
+
+/**
+ * @brief 设置是否转发指定客户端的数据
+ */
+void CDebugServer::setWatched(quint64 id, bool watched)
+{
+    if (watched) {
+        m_watched.insert(id);
+    } else {
+        m_watched.remove(id);
+    }
+
+    const int worker = m_clientWorker.value(id, -1);
+    if (worker >= 0) {
+        QMetaObject::invokeMethod(m_workers[worker], "setWatched", Qt::QueuedConnection,
+                                  Q_ARG(quint64, id), Q_ARG(bool, watched));
+    }
+}
+
+/**
+ * @brief 是否校验流量发生器数据
+ */
+void CDebugServer::setVerifyTraffic(bool verify)
+{
+    m_verifyTraffic = verify;
+    for (CDebugServerWorker* worker : m_workers) {
+        QMetaObject::invokeMethod(worker, "setVerifyTraffic", Qt::QueuedConnection, Q_ARG(bool, verify));
+    }
+}
+
+/**
+ * @brief 是否回显收到的数据
+ */
+void CDebugServer::setEcho(bool echo)
+{
+    m_echo = echo;
+    for (CDebugServerWorker* worker : m_workers) {
+        QMetaObject::invokeMethod(worker, "setEcho", Qt::QueuedConnection, Q_ARG(bool, echo));
+    }
+}
+
+/**
+ * @brief 新连接交给负载最小的工作线程
+ * @param socketDescriptor 套接字描述符
+ */
+void CDebugServer::incomingConnection(qintptr socketDescriptor)
+{
+    int worker = 0;
+    for (int i = 1; i < m_workerLoad.size(); ++i) {
+        if (m_workerLoad[i] < m_workerLoad[worker]) {
+            worker = i;
+        }
+    }
+
+    const quint64 id = m_nextClientId++;
+    m_workerLoad[worker]++;
+    m_clientWorker.insert(id, worker);
+    m_metricConnections->increment();
+
+    QMetaObject::invokeMethod(m_workers[worker], "addClient", Qt::QueuedConnection,
+                              Q_ARG(qint64, qint64(socketDescriptor)), Q_ARG(quint64, id));
+}
+
+/**
+ * @brief 工作线程中的客户端已建立
+ */
+void CDebugServer::onWorkerClientOpened(quint64 id, const QString& address)
+{
+    ClientStats stats;
+    stats.id = id;
+    stats.address = address;
+    stats.connectedMs = QDateTime::currentMSecsSinceEpoch();
+    m_clients.insert(id, stats);
+    m_metricClients->increment();
+
+    emit clientConnected(id, address);
+}
+
+/**
+ * @brief 工作线程中的客户端已断开
+ * @param stats 最终统计
+ */
+void CDebugServer::onWorkerClientClosed(const CDebugServer::ClientStats& stats)
+{
+    if (m_clientWorker.contains(stats.id)) {
+        m_workerLoad[m_clientWorker.take(stats.id)]--;
+    }
+    if (m_clients.remove(stats.id) > 0) {
+        m_metricClients->add(-1);
+    }
+    m_watched.remove(stats.id);
+
+    m_closedTotals.bytesReceived += stats.bytesReceived;
+    m_closedTotals.bytesSent += stats.bytesSent;
+    m_closedTotals.packetsReceived += stats.packetsReceived;
+    m_closedTotals.packetsSent += stats.packetsSent;
+    m_closedTotals.messagesDropped += stats.messagesDropped;
+    m_closedTotals.integrity += stats.integrity;
+
+    emit clientDisconnected(stats.id, stats.address);
+}
+
+/**
+ * @brief 工作线程未能接管新连接：只释放分配记录，界面从未见过该客户端，不发射断开信号
+ * @param id 客户端编号
+ * @param error 错误信息
+ */
+void CDebugServer::onWorkerClientFailed(quint64 id, const QString& error)
+{
+    if (m_clientWorker.contains(id)) {
+        m_workerLoad[m_clientWorker.take(id)]--;
+    }
+    m_watched.remove(id);
+    qDebug() << QString("⚠️ 调试服务器：连接 #%1 未建立（%2）").arg(id).arg(error);
+}
+
+/**
+ * @brief 工作线程的周期统计
+ */
+void CDebugServer::onWorkerStats(const QVector<CDebugServer::ClientStats>& stats)
+{
+    for (const ClientStats& entry : stats) {
+        QHash<quint64, ClientStats>::iterator it = m_clients.find(entry.id);
+        if (it != m_clients.end()) {
+            const qint64 connectedMs = it->connectedMs;
+            *it = entry;
+            it->connectedMs = connectedMs;
+        }
+    }
+}
+
+/**
+ * @brief CDebugServerWorker构造函数
+ * @param linkStats 链路统计，可为空
+ * @param capture 抓包文件，可为空
+ * @param parent 父对象指针
+ */
+CDebugServerWorker::CDebugServerWorker(CLinkStats* linkStats, CPcapWriter* capture, QObject *parent)
+    : QObject(parent)
+    , m_watchAll(false)
+    , m_verifyTraffic(false)
+    , m_echo(false)
+    , m_statsTimer(this)
+    , m_linkStats(linkStats)
+    , m_capture(capture)
+{
+    CMetricsRegistry& registry = CMetricsRegistry::instance();
+    m_metricBytesReceived = registry.counter("tcpimg_debugger_bytes_received_total", "网络调试器接收字节数");
+    m_metricBytesSent = registry.counter("tcpimg_debugger_bytes_sent_total", "网络调试器发送字节数");
+    m_metricPacketsReceived = registry.counter("tcpimg_debugger_packets_received_total", "网络调试器接收包数");
+    m_metricPacketsSent = registry.counter("tcpimg_debugger_packets_sent_total", "网络调试器发送包数");
+    m_metricDropped = registry.counter("tcpimg_debugger_messages_dropped_total", "网络调试服务器因发送队列满丢弃的消息数");
+
+    m_statsTimer.setInterval(CDebugServer::STATS_INTERVAL_MS);
+    connect(&m_statsTimer, &QTimer::timeout, this, &CDebugServerWorker::publishStats);
+}
+
+/**
+ * @brief 接管新连接
+ * @param socketDescriptor 套接字描述符
+ * @param id 客户端编号
+ */
+void CDebugServerWorker::addClient(qint64 socketDescriptor, quint64 id)
+{
+    QTcpSocket* socket = new QTcpSocket(this);
+    if (!socket->setSocketDescriptor(qintptr(socketDescriptor))) {
+        const QString error = socket->errorString();
+        qDebug() << "❌ 调试服务器接管连接失败：" << error;
+        delete socket;
+        emit clientFailed(id, error);
+        return;
+    }
+    socket->setProxy(QNetworkProxy::NoProxy);
+
+    Client client;
+    client.socket = socket;
+    client.stats.id = id;
+    client.stats.address = QString("%1:%2").arg(socket->peerAddress().toString()).arg(socket->peerPort());
+    client.flow = CPcapWriter::Flow::fromSocket(socket);
+    m_clients.insert(id, client);
+    m_socketIds.insert(socket, id);
+
+    connect(socket, &QTcpSocket::readyRead, this, &CDebugServerWorker::onReadyRead);
+    connect(socket, &QTcpSocket::bytesWritten, this, &CDebugServerWorker::onBytesWritten);
+    connect(socket, &QTcpSocket::disconnected, this, &CDebugServerWorker::onDisconnected);
+
+    if (m_capture && m_capture->isOpen()) {
+        m_capture->openFlow(client.flow, false);
+    }
+
+    if (!m_statsTimer.isActive()) {
+        m_statsClock.start();
+        m_statsTimer.start();
+    }
+
+    emit clientOpened(id, client.stats.address);
+}
+
+/**
+ * @brief 向本线程的所有客户端发送数据
+ */
+void CDebugServerWorker::broadcast(const QByteArray& data)
+{
+    for (QHash<quint64, Client>::iterator it = m_clients.begin(); it != m_clients.end(); ++it) {
+        enqueue(*it, data);
+    }
+}
+
+/**
+ * @brief 向指定客户端发送数据
+ */
+void CDebugServerWorker::sendTo(quint64 id, const QByteArray& data)
+{
+    QHash<quint64, Client>::iterator it = m_clients.find(id);
+    if (it != m_clients.end()) {
+        enqueue(*it, data);
+    }
+}
+
+/**
+ * @brief 断开指定客户端
+ */
+void CDebugServerWorker::disconnectClient(quint64 id)
+{
+    if (m_clients.contains(id)) {
+        closeClient(id);
+    }
+}
+
+/**
+ * @brief 断开本线程的所有客户端
+ */
+void CDebugServerWorker::disconnectAll()
+{
+    const QList<quint64> ids = m_clients.keys();
+    for (quint64 id : ids) {
+        closeClient(id);
+    }
+}
+
+/**
+ * @brief 是否转发所有客户端的数据
+ */
+void CDebugServerWorker::setWatchAll(bool watchAll)
+{
+    m_watchAll = watchAll;
+}
+
+/**
+ * @brief 设置是否转发指定客户端的数据
+ */
+void CDebugServerWorker::setWatched(quint64 id, bool watched)
+{
+    QHash<quint64, Client>::iterator it = m_clients.find(id);
+    if (it != m_clients.end()) {
+        it->watched = watched;
+    }
+}
+
+/**
+ * @brief 是否校验流量发生器数据
+ */
+void CDebugServerWorker::setVerifyTraffic(bool verify)
+{
+    m_verifyTraffic = verify;
+    if (!verify) {
+        m_verifiers.clear();
+    }
+}
+
+/**
+ * @brief 是否回显收到的数据
+ */
+void CDebugServerWorker::setEcho(bool echo)
+{
+    m_echo = echo;
+}
+
+/**
+ * @brief 读取客户端数据
+ */
+void CDebugServerWorker::onReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    QHash<quint64, Client>::iterator it = m_clients.find(m_socketIds.value(socket));
+    if (!socket || it == m_clients.end()) {
+        return;
+    }
+
+    const QByteArray data = socket->readAll();
+    if (data.isEmpty()) {
+        return;
+    }
+
+    it->stats.bytesReceived += data.size();
+    it->stats.packetsReceived++;
+    m_metricBytesReceived->add(data.size());
+    m_metricPacketsReceived->increment();
+    if (m_linkStats) {
+        m_linkStats->recordReceived(data.size());
+    }
+    if (m_capture && m_capture->isOpen()) {
+        m_capture->record(it->flow, CPcapWriter::DIRECTION_INBOUND, data);
+    }
+
+    if (m_verifyTraffic) {
+        CTrafficVerifier& verifier = m_verifiers[it->stats.id];
+        verifier.feed(data);
+        it->stats.integrity = verifier.result();
+    }
+
+    // 回显：共享收到的缓冲，按普通发送排队（慢速客户端同样受队列上限约束）
+    if (m_echo) {
+        enqueue(*it, data);
+    }
+
+    // 未被查看的客户端只统计，不把数据送到界面线程
+    if (m_watchAll || it->watched) {
+        emit clientData(it->stats.id, it->stats.address, data);
+    }
+}
+
+/**
+ * @brief 数据已写入网络：计数并继续写出
+ * @param bytes 本次写出的字节数
+ */
+void CDebugServerWorker::onBytesWritten(qint64 bytes)
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    QHash<quint64, Client>::iterator it = m_clients.find(m_socketIds.value(socket));
+    if (!socket || it == m_clients.end()) {
+        return;
+    }
+
+    it->stats.bytesSent += bytes;
+    m_metricBytesSent->add(bytes);
+    if (m_linkStats) {
+        m_linkStats->recordSent(bytes, 0);
+    }
+    pump(*it);
+}
+
+/**
+ * @brief 客户端断开
+ */
+void CDebugServerWorker::onDisconnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (m_socketIds.contains(socket)) {
+        closeClient(m_socketIds.value(socket));
+    }
+}
+
+/**
+ * @brief 计算本周期速率并上报统计
+ */
+void CDebugServerWorker::publishStats()
+{
+    if (m_clients.isEmpty()) {
+        m_statsTimer.stop();
+        return;
+    }
+
+    const double seconds = qMax<qint64>(1, m_statsClock.restart()) / 1000.0;
+    QVector<CDebugServer::ClientStats> stats;
+    stats.reserve(m_clients.size());
+    for (QHash<quint64, Client>::iterator it = m_clients.begin(); it != m_clients.end(); ++it) {
+        Client& client = *it;
+        client.stats.rxBytesPerSec = (client.stats.bytesReceived - client.lastBytesReceived) / seconds;
+        client.stats.txBytesPerSec = (client.stats.bytesSent - client.lastBytesSent) / seconds;
+        client.lastBytesReceived = client.stats.bytesReceived;
+        client.lastBytesSent = client.stats.bytesSent;
+        stats.append(client.stats);
+    }
+    emit statsReady(stats);
+}
+
+/**
+ * @brief 加入发送队列并写出
+ * @param client 客户端
+ * @param data 数据（共享缓冲，不拷贝）
+ */
+void CDebugServerWorker::enqueue(Client& client, const QByteArray& data)
+{
+    // 慢速客户端：丢弃最旧的未开始发送的消息，排队字节保持有界
+    while (!client.queue.isEmpty() && client.stats.pendingBytes + data.size() > CDebugServer::MAX_QUEUED_BYTES) {
+        if (client.queue.size() == 1 && client.offset > 0) {
+            break;
+        }
+        const int index = (client.offset > 0) ? 1 : 0;
+        client.stats.pendingBytes -= client.queue.at(index).size();
+        client.queue.removeAt(index);
+        client.stats.messagesDropped++;
+        m_metricDropped->increment();
+    }
+
+    client.queue.enqueue(data);
+    client.stats.pendingBytes += data.size();
+    pump(client);
+}
+
+/**
+ * @brief 在发送缓冲低于水位时继续写出分片
+ * @param client 客户端
+ */
+void CDebugServerWorker::pump(Client& client)
+{
+    QTcpSocket* socket = client.socket;
+    while (!client.queue.isEmpty() && socket->bytesToWrite() < WRITE_LOW_WATER
+           && socket->state() == QAbstractSocket::ConnectedState) {
+        const QByteArray& message = client.queue.head();
+        const qint64 slice = WRITE_SLICE;
+        const qint64 length = qMin(slice, qint64(message.size()) - client.offset);
+        const qint64 written = socket->write(message.constData() + client.offset, length);
+        if (written <= 0) {
+            break;
+        }
+        if (m_capture && m_capture->isOpen()) {
+            m_capture->record(client.flow, CPcapWriter::DIRECTION_OUTBOUND,
+                              message.constData() + client.offset, int(written));
+        }
+
+        client.offset += written;
+        client.stats.pendingBytes -= written;
+        if (client.offset >= message.size()) {
+            client.queue.dequeue();
+            client.offset = 0;
+            client.stats.packetsSent++;
+            m_metricPacketsSent->increment();
+            if (m_linkStats) {
+                m_linkStats->recordSent(0, 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 移除客户端并报告最终统计
+ * @param id 客户端编号
+ */
+void CDebugServerWorker::closeClient(quint64 id)
+{
+    Client client = m_clients.take(id);
+    if (!client.socket) {
+        return;
+    }
+
+    m_socketIds.remove(client.socket);
+    m_verifiers.remove(id);
+    if (m_capture) {
+        m_capture->closeFlow(client.flow);
+    }
+    client.socket->disconnect(this);
+    client.socket->abort();
+    client.socket->deleteLater();
+
+    client.stats.pendingBytes = 0;
+    client.stats.rxBytesPerSec = 0.0;
+    client.stats.txBytesPerSec = 0.0;
+    emit clientClosed(client.stats);
+}
@@ -0,0 +1,289 @@
+#ifndef DEBUGSERVER_H
+#define DEBUGSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QQueue>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QList>
+#include "metricsregistry.h"
+#include "trafficgenerator.h"
+#include "linkstats.h"
+#include "pcapcapture.h"
+
+class CDebugServerWorker;
+
+/**
+ * @class CDebugServer
+ * @brief 网络调试器的多客户端服务器（工作线程收发）
+ *
+ * 用作压测时的设备群替身，支持数千个并发客户端：
+ * - 新连接按负载分配到若干工作线程，套接字的读写、统计都在工作线程中完成，
+ *   界面线程只接收每秒一次的统计汇总
+ * - 每个客户端独立统计收发字节数、包数和速率
+ * - 广播时所有客户端共享同一份数据（QByteArray 引用计数），按分片写入套接字，
+ *   待发送字节低于水位时才继续写，不会整份复制进每个客户端的发送缓冲
+ * - 收到的数据只在需要查看时才转发到界面线程：默认只统计，按需转发全部客户端或指定的客户端
+ * - 回显模式下工作线程把收到的数据原样发回（延迟探测的对端）
+ * - 抓包时工作线程直接把收发数据记录到 pcapng 文件
+ *
+ * 除信号外所有接口都在所属线程（通常是界面线程）中调用
+ */
+class CDebugServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @struct ClientStats
+     * @brief 单个客户端的收发统计
+     */
+    struct ClientStats
+    {
+        quint64 id = 0;                 ///< 客户端编号（服务器内唯一）
+        QString address;                ///< 远程地址 "IP:端口"
+        qint64 connectedMs = 0;         ///< 连接时间（Unix纪元毫秒）
+        qint64 bytesReceived = 0;
+        qint64 bytesSent = 0;           ///< 已写入网络的字节数
+        qint64 packetsReceived = 0;     ///< 接收次数（每次读到的数据计一包）
+        qint64 packetsSent = 0;         ///< 完整发出的消息数
+        qint64 messagesDropped = 0;     ///< 发送队列超过上限时丢弃的消息数
+        qint64 pendingBytes = 0;        ///< 排队未写出的字节数
+        double rxBytesPerSec = 0.0;     ///< 最近一个统计周期的接收速率
+        double txBytesPerSec = 0.0;     ///< 最近一个统计周期的发送速率
+        CTrafficVerifier::Result integrity; ///< 流量发生器数据的校验结果（开启校验时）
+    };
+
+    static const int MAX_WORKERS = 8;                           ///< 最多工作线程数
+    static const int STATS_INTERVAL_MS = 1000;                  ///< 统计汇总周期
+    static const qint64 MAX_QUEUED_BYTES = 8 * 1024 * 1024;     ///< 每个客户端最多排队的发送字节数
+
+    /**
+     * @brief 构造函数
+     * @param workerCount 工作线程数，0表示按CPU核数（不超过 MAX_WORKERS）
+     * @param linkStats 工作线程同时记录到的链路统计（可为空，生命周期须长于服务器）
+     * @param capture 抓包文件（可为空，生命周期须长于服务器，打开时工作线程记录收发数据）
+     * @param parent 父对象指针
+     */
+    explicit CDebugServer(int workerCount = 0, CLinkStats* linkStats = nullptr,
+                          CPcapWriter* capture = nullptr, QObject *parent = nullptr);
+    ~CDebugServer();
+
+    int workerCount() const { return m_workers.size(); }
+    int clientCount() const { return m_clients.size(); }
+
+    /**
+     * @brief 当前客户端的统计快照（最近一次汇总）
+     */
+    QList<ClientStats> clients() const { return m_clients.values(); }
+
+    /**
+     * @brief 指定客户端的统计快照
+     * @return 客户端不存在时 id 为0
+     */
+    ClientStats client(quint64 id) const { return m_clients.value(id); }
+
+    /**
+     * @brief 全部客户端（含已断开的）的累计统计，速率为当前客户端之和
+     */
+    ClientStats totals() const;
+
+    /**
+     * @brief 向所有客户端发送数据（共享同一份缓冲）
+     * @param data 数据
+     * @return 接收数据的客户端数
+     */
+    int broadcast(const QByteArray& data);
+
+    /**
+     * @brief 向指定客户端发送数据
+     * @return 客户端不存在时返回false
+     */
+    bool sendTo(quint64 id, const QByteArray& data);
+
+    /**
+     * @brief 断开指定客户端
+     */
+    void disconnectClient(quint64 id);
+
+    /**
+     * @brief 断开所有客户端（不停止监听）
+     */
+    void disconnectAll();
+
+    /**
+     * @brief 是否转发所有客户端的数据（默认关闭：只统计，不把数据送到界面线程）
+     */
+    void setWatchAll(bool watchAll);
+    bool watchAll() const { return m_watchAll; }
+
+    /**
+     * @brief 设置是否转发指定客户端的数据（不转发全部时生效）
+     */
+    void setWatched(quint64 id, bool watched);
+    bool isWatched(quint64 id) const { return m_watchAll || m_watched.contains(id); }
+
+    /**
+     * @brief 是否按流量发生器的校验帧头检查收到的数据（结果见 ClientStats::integrity）
+     */
+    void setVerifyTraffic(bool verify);
+    bool verifyTraffic() const { return m_verifyTraffic; }
+
+    /**
+     * @brief 是否把收到的数据原样发回给发送的客户端（在工作线程中完成，不经过界面线程）
+     */
+    void setEcho(bool echo);
+    bool echo() const { return m_echo; }
+
+signals:
+    /**
+     * @brief 客户端连接
+     */
+    void clientConnected(quint64 id, const QString& address);
+
+    /**
+     * @brief 客户端断开
+     */
+    void clientDisconnected(quint64 id, const QString& address);
+
+    /**
+     * @brief 被查看的客户端收到数据
+     */
+    void clientData(quint64 id, const QString& address, const QByteArray& data);
+
+    /**
+     * @brief 统计汇总已更新（每 STATS_INTERVAL_MS 一次）
+     */
+    void statsUpdated();
+
+protected:
+    /**
+     * @brief 新连接交给负载最小的工作线程，套接字在工作线程中创建
+     */
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private slots:
+    void onWorkerClientOpened(quint64 id, const QString& address);
+    void onWorkerClientClosed(const CDebugServer::ClientStats& stats);
+    void onWorkerClientFailed(quint64 id, const QString& error);
+    void onWorkerStats(const QVector<CDebugServer::ClientStats>& stats);
+
+private:
+    QVector<QThread*> m_threads;
+    QVector<CDebugServerWorker*> m_workers;
+    QVector<int> m_workerLoad;              ///< 每个工作线程的客户端数
+    QHash<quint64, int> m_clientWorker;     ///< 客户端所在的工作线程
+    QHash<quint64, ClientStats> m_clients;  ///< 最近一次汇总的客户端统计
+    QSet<quint64> m_watched;
+    bool m_watchAll;
+    bool m_verifyTraffic;
+    bool m_echo;
+    quint64 m_nextClientId;
+    ClientStats m_closedTotals;             ///< 已断开客户端的累计统计
+    QTimer m_statsTimer;
+
+    CMetricsRegistry::Metric* m_metricClients;
+    CMetricsRegistry::Metric* m_metricConnections;
+};
+
+Q_DECLARE_METATYPE(CDebugServer::ClientStats)
+Q_DECLARE_METATYPE(QVector<CDebugServer::ClientStats>)
+
+/**
+ * @class CDebugServerWorker
+ * @brief 调试服务器的工作线程对象
+ *
+ * 拥有分配给它的客户端套接字，公共槽函数只能通过队列调用
+ * （QMetaObject::invokeMethod(..., Qt::QueuedConnection)）
+ */
+class CDebugServerWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CDebugServerWorker(CLinkStats* linkStats, CPcapWriter* capture, QObject *parent = nullptr);
+
+public slots:
+    void addClient(qint64 socketDescriptor, quint64 id);
+    void broadcast(const QByteArray& data);
+    void sendTo(quint64 id, const QByteArray& data);
+    void disconnectClient(quint64 id);
+    void disconnectAll();
+    void setWatchAll(bool watchAll);
+    void setWatched(quint64 id, bool watched);
+    void setVerifyTraffic(bool verify);
+    void setEcho(bool echo);
+
+signals:
+    void clientOpened(quint64 id, const QString& address);
+    void clientClosed(const CDebugServer::ClientStats& stats);
+    void clientFailed(quint64 id, const QString& error);    ///< 接管连接失败（未发射过 clientOpened）
+    void clientData(quint64 id, const QString& address, const QByteArray& data);
+    void statsReady(const QVector<CDebugServer::ClientStats>& stats);
+
+private slots:
+    void onReadyRead();
+    void onBytesWritten(qint64 bytes);
+    void onDisconnected();
+    void publishStats();
+
+private:
+    /**
+     * @brief 单个客户端状态
+     */
+    struct Client
+    {
+        QTcpSocket* socket = nullptr;
+        CDebugServer::ClientStats stats;
+        QQueue<QByteArray> queue;       ///< 待发送的消息（共享缓冲）
+        qint64 offset = 0;              ///< 队首消息已写入套接字的字节数
+        qint64 lastBytesReceived = 0;   ///< 上个统计周期结束时的计数
+        qint64 lastBytesSent = 0;
+        bool watched = false;
+        CPcapWriter::Flow flow;         ///< 抓包时的连接地址
+    };
+
+    /**
+     * @brief 加入发送队列并写出
+     */
+    void enqueue(Client& client, const QByteArray& data);
+
+    /**
+     * @brief 在发送缓冲低于水位时继续写出分片
+     */
+    void pump(Client& client);
+
+    /**
+     * @brief 移除客户端并报告最终统计
+     */
+    void closeClient(quint64 id);
+
+    static const qint64 WRITE_SLICE = 64 * 1024;        ///< 每次写入套接字的最大字节数
+    static const qint64 WRITE_LOW_WATER = 128 * 1024;   ///< 待发送字节低于此值时继续写
+
+    QHash<quint64, Client> m_clients;
+    QHash<QTcpSocket*, quint64> m_socketIds;
+    QHash<quint64, CTrafficVerifier> m_verifiers;   ///< 开启校验时每个客户端的校验器
+    bool m_watchAll;
+    bool m_verifyTraffic;
+    bool m_echo;
+    QTimer m_statsTimer;
+    QElapsedTimer m_statsClock;
+    CLinkStats* m_linkStats;                ///< 链路统计（可为空，原子计数，可跨线程记录）
+    CPcapWriter* m_capture;                 ///< 抓包文件（可为空，可跨线程记录）
+
+    CMetricsRegistry::Metric* m_metricBytesReceived;
+    CMetricsRegistry::Metric* m_metricBytesSent;
+    CMetricsRegistry::Metric* m_metricPacketsReceived;
+    CMetricsRegistry::Metric* m_metricPacketsSent;
+    CMetricsRegistry::Metric* m_metricDropped;
+};
+
+#endif // DEBUGSERVER_H
@@ -1,5 +1,6 @@
 #include "dialog.h"
 #include "ui_dialog.h"
+#include <algorithm>
 
 /**
  * @brief Dialog构造函数
@@ -10,12 +11,14 @@
 Dialog::Dialog(QWidget *parent) :
     QDialog(parent),
     // ui(new Ui::Dialog),  // 已移除UI依赖
-    m_showBuffer(nullptr),
     m_reconnectBtn(nullptr),
     m_autoReconnectCheckBox(nullptr),
+    m_stallDetectCheckBox(nullptr),
     m_connectionStatusLabel(nullptr),
     m_serverIPEdit(nullptr),
     m_serverPortEdit(nullptr),
+    m_backupEndpointsEdit(nullptr),
+    m_standbyCheckBox(nullptr),
     m_connectBtn(nullptr),
     m_currentZoomFactor(1.0),
     m_fitToWindow(true),
@@ -47,7 +50,14 @@ Dialog::Dialog(QWidget *parent) :
     m_totalBytesReceived(0),
     m_commandCount(0),
     m_autoSwitchEnabled(false),
-    m_currentDisplayState(true)
+    m_currentDisplayState(true),
+    m_latencyLabel(nullptr),
+    m_exportLatencyBtn(nullptr),
+    m_latencyUpdateTimer(nullptr),
+    m_pendingDisplayNs(0),
+    m_latencyPaintPending(false),
+    m_displayScheduler(nullptr),
+    m_displayRateLabel(nullptr)
 {
     // 设置用户界面
     // ui->setupUi(this);  // 不再需要，使用完全现代化界面
@@ -62,15 +72,49 @@ Dialog::Dialog(QWidget *parent) :
     
     // 初始化网络调试器
     m_tcpDebugger = new CTCPDebugger(this);
+    m_debugLogModel = new CPacketLogModel(this);
     
-    // 连接调试器信号
-    connect(m_tcpDebugger, &CTCPDebugger::dataReceived, 
-            this, &Dialog::onDebugDataReceived);
+    // 连接调试器信号（只接收原始数据，显示时再按需格式化）
+    connect(m_tcpDebugger, &CTCPDebugger::packetReceived, 
+            this, &Dialog::onDebugPacketReceived);
+    connect(m_debugLogModel, &CPacketLogModel::rowsFlushed,
+            this, &Dialog::onDebugLogFlushed);
     connect(m_tcpDebugger, &CTCPDebugger::connectionStateChanged, 
             this, &Dialog::onDebugConnectionStateChanged);
+    connect(m_tcpDebugger, &CTCPDebugger::clientStatsUpdated,
+            this, &Dialog::onDebugClientStatsUpdated);
+    connect(m_tcpDebugger, &CTCPDebugger::linkStatsUpdated, [this]() {
+        updateDebugUIState();  // 没有新数据时也每秒刷新速率统计
+    });
+    connect(m_tcpDebugger, &CTCPDebugger::latencyProbeUpdated,
+            this, &Dialog::onLatencyProbeUpdated);
+    connect(m_tcpDebugger, &CTCPDebugger::latencyProbeFinished,
+            this, &Dialog::onLatencyProbeFinished);
+    connect(m_tcpDebugger, &CTCPDebugger::captureFailed,
+            this, &Dialog::onCaptureFailed);
+    
+    // 抓包文件导入（分时读取，不阻塞界面）
+    m_captureImportTimer = new QTimer(this);
+    m_captureImportTimer->setInterval(0);
+    m_captureImportPackets = 0;
+    m_captureImportBytes = 0;
+    connect(m_captureImportTimer, &QTimer::timeout, this, &Dialog::onCaptureImportTick);
+    
+    // 流量发生器
+    m_trafficGenerator = new CTrafficGenerator(this);
+    connect(m_trafficGenerator, &CTrafficGenerator::progress,
+            this, &Dialog::onTrafficProgress);
+    connect(m_trafficGenerator, &CTrafficGenerator::finished,
+            this, &Dialog::onTrafficFinished);
     
     // 初始化串口对象
     m_serialPort = new QSerialPort(this);
+
+    // 串口运行指标（不随界面统计清零）
+    CMetricsRegistry& registry = CMetricsRegistry::instance();
+    m_metricSerialBytesReceived = registry.counter("tcpimg_serial_bytes_received_total", "指令串口接收字节数");
+    m_metricSerialBytesSent = registry.counter("tcpimg_serial_bytes_sent_total", "指令串口发送字节数");
+    m_metricSerialCommands = registry.counter("tcpimg_serial_commands_total", "指令串口发送指令数");
     
     // 初始化时间更新定时器
     m_timeUpdateTimer = new QTimer(this);
@@ -88,11 +132,35 @@ Dialog::Dialog(QWidget *parent) :
     // 现代化服务器连接面板初始化
     // 注意：这些控件将在createServerConnectionPanel()中创建
 
-    // 连接TCP图像数据就绪信号到图像显示槽函数
-    connect(&m_tcpImg, &CTCPImg::tcpImgReadySig, this, &Dialog::showLabelImg);
+    // 连接TCP图像数据就绪信号到显示调度器，由调度器按显示帧率上限调用图像显示槽函数
+    m_displayScheduler = new CDisplayScheduler(this);
+    m_displayScheduler->setTargetWidget(m_imageTab);
+    connect(&m_tcpImg, &CTCPImg::tcpImgReadySig, m_displayScheduler, &CDisplayScheduler::frameReceived);
+    connect(m_displayScheduler, &CDisplayScheduler::displayFrame, this, &Dialog::showLabelImg);
+    connect(&m_tcpImg, &CTCPImg::imageGeometryChanged, this, &Dialog::onImageGeometryChanged);
     
     // 连接诊断信息信号
     connect(&m_tcpImg, &CTCPImg::signalDiagnosticInfo, this, &Dialog::showDiagnosticInfo);
+    connect(&m_tcpImg, &CTCPImg::diagnosticsFinished, this, [this](bool reachable) {
+        if (m_reconnectProgressLabel) {
+            m_reconnectProgressLabel->setText(reachable ? "✅ 诊断完成：服务端端口可连通 | 详细信息已显示在图像区域"
+                                                        : "❌ 诊断完成：无法连接服务端 | 详细信息已显示在图像区域");
+        }
+        if (m_diagnosticBtn) {
+            m_diagnosticBtn->setEnabled(true);
+            m_diagnosticBtn->setText("🔍 诊断");
+        }
+    });
+    
+    // 接收停滞：连接仍显示为已连接但数据已中断
+    connect(&m_tcpImg, &CTCPImg::streamStalled, this, [this](CTCPImg::StallKind kind, qint64 idleMs) {
+        if (m_reconnectProgressLabel) {
+            m_reconnectProgressLabel->setText(QString("⏱️ 接收停滞：%1ms未收到%2 | 累计%3次")
+                                              .arg(idleMs)
+                                              .arg(kind == CTCPImg::STALL_BYTES ? "数据" : "完整帧")
+                                              .arg(m_tcpImg.stallCount()));
+        }
+    });
     
     // 初始化自动重连功能（默认启用）
     // 注意：这个调用必须在initDebugInterface()之后，因为控件需要先创建
@@ -100,30 +168,28 @@ Dialog::Dialog(QWidget *parent) :
         if (m_autoReconnectCheckBox && m_autoReconnectCheckBox->isChecked()) {
             toggleAutoReconnect(true);
         }
+        if (m_stallDetectCheckBox) {
+            toggleStallDetection(m_stallDetectCheckBox->isChecked());
+        }
     });
     
-    // 为图像显示分配内存缓冲区
-    m_showBuffer = new char[WIDTH * HEIGHT * CHANLE];
-    if (m_showBuffer == nullptr) {
-        qDebug() << "严重错误：图像缓冲区内存分配失败";
-        m_imageDisplayLabel->setText("严重错误：内存分配失败\n程序可能无法正常工作");
-        return;
-    }
-    
-    // 初始化显示缓冲区为0
-    memset((void*)m_showBuffer, 0, WIDTH * HEIGHT * CHANLE);
-    
     // 设置标签的初始显示文本（已使用现代化界面）
     // ui->labelShowImg->setText("TCP图像传输接收程序已启动\n\n请输入服务器地址和端口号，然后点击开始连接\n\n默认配置：\nIP：192.168.1.31\n端口：17777");
     // ui->labelShowImg->setAlignment(Qt::AlignCenter);  // 居中显示文本
     
-    qDebug() << "Dialog界面初始化完成，图像缓冲区大小：" << (WIDTH * HEIGHT * CHANLE) << "字节";
+    qDebug() << "Dialog界面初始化完成";
 
     // 初始化缩放防抖动定时器
     m_resizeTimer = new QTimer(this);
     m_resizeTimer->setSingleShot(true); // 设置为单次触发
     m_resizeTimer->setInterval(50);     // 设置50ms延迟
     connect(m_resizeTimer, &QTimer::timeout, this, &Dialog::fitImageToWindow);
+
+    // 延迟摘要每秒刷新一次，统计本身在每帧处理时记录
+    m_latencyUpdateTimer = new QTimer(this);
+    connect(m_latencyUpdateTimer, &QTimer::timeout, this, &Dialog::updateLatencyDisplay);
+    connect(m_latencyUpdateTimer, &QTimer::timeout, this, &Dialog::updateDisplayRateLabel);
+    m_latencyUpdateTimer->start(1000);
 }
 
 /**
@@ -142,13 +208,6 @@ Dialog::~Dialog()
         qDebug() << "串口连接已关闭";
     }
     
-    // 释放图像显示缓冲区
-    if (m_showBuffer != nullptr) {
-        delete[] m_showBuffer;
-        m_showBuffer = nullptr;
-        qDebug() << "图像显示缓冲区已释放";
-    }
-    
     qDebug() << "Dialog对象销毁完成";
 }
 
@@ -175,97 +234,54 @@ void Dialog::showLabelImg()
     int width = m_tcpImg.getImageWidth();
     int height = m_tcpImg.getImageHeight();
     int channels = m_tcpImg.getImageChannels();
-    int totalSize = width * height * channels;
-    
-    // 将接收到的图像数据复制到显示缓冲区
-    try {
-        memcpy(m_showBuffer, frameBuffer, totalSize);
-    } catch (const std::exception& e) {
-        qDebug() << "错误：图像数据复制失败：" << e.what();
-        m_imageDisplayLabel->setText("错误：图像数据处理失败");
-        // ui->pushButtonStart->setEnabled(true);  // 已移除原始UI控件
-        return;
-    }
-    
-    // 根据通道数选择合适的图像格式
-    QImage::Format imageFormat;
-    switch (channels) {
-        case 1:
-            imageFormat = QImage::Format_Grayscale8;
-            break;
-        case 3:
-            imageFormat = QImage::Format_RGB888;
-            break;
-        case 4:
-            imageFormat = QImage::Format_RGBA8888;
-            break;
-        case 2:
-        case 5:
-        case 6:
-        case 7:
-        case 8:
-            // 对于2通道或5-8通道，提取第一个通道显示为灰度图像
-            imageFormat = QImage::Format_Grayscale8;
-            qDebug() << "多通道图像" << channels << "通道，提取第一通道显示为灰度图像";
-            break;
-        default:
-            // 其他情况使用灰度格式
-            imageFormat = QImage::Format_Grayscale8;
-            qDebug() << "不支持的通道数" << channels << "，使用灰度格式显示";
-            break;
-    }
+    const qint64 totalSize = m_tcpImg.getImageTotalSize();
     
-    // 创建QImage对象进行图像格式转换
-    if (channels == 1) {
-        // 灰度图像：直接使用数据
-        m_qimage = QImage((const unsigned char*)(m_showBuffer), width, height, imageFormat);
-    } else if (channels == 3) {
-        // RGB图像：计算行跨度
-        int bytesPerLine = width * channels;
-        m_qimage = QImage((const unsigned char*)(m_showBuffer), width, height, bytesPerLine, imageFormat);
-    } else if (channels == 4) {
-        // RGBA图像：计算行跨度
-        int bytesPerLine = width * channels;
-        m_qimage = QImage((const unsigned char*)(m_showBuffer), width, height, bytesPerLine, imageFormat);
-    } else {
-        // 多通道图像（2，5-8通道）：提取第一个通道显示
-        unsigned char* grayBuffer = new unsigned char[width * height];
-        
-        try {
-            // 提取第一个通道的数据
-            for (int i = 0; i < width * height; ++i) {
-                grayBuffer[i] = static_cast<unsigned char>(m_showBuffer[i * channels]);
-            }
-            
-            // 创建灰度图像
-            m_qimage = QImage(grayBuffer, width, height, QImage::Format_Grayscale8).copy();
-            
-            // 释放临时缓冲区
-            delete[] grayBuffer;
-            
-            qDebug() << "多通道图像处理完成，提取了第一通道用于显示";
-            
-        } catch (const std::exception& e) {
-            qDebug() << "多通道图像处理失败：" << e.what();
-            delete[] grayBuffer;
-            m_imageDisplayLabel->setText("错误：多通道图像处理失败");
-            // ui->pushButtonStart->setEnabled(true);  // 已移除原始UI控件
-            return;
+    // 大帧分块显示：只交给显示控件帧数据，绘制时只转换可见区域内的分块
+    bool tiled = false;
+    if (qint64(width) * height >= CImageViewer::TILED_MIN_PIXELS) {
+        const QByteArray& frameData = m_tcpImg.lastFrameData();
+        if (frameData.size() == totalSize && m_imageDisplayLabel->setFrameData(frameData, width, height, channels)) {
+            m_qimage = QImage();  // 不再需要整帧转换缓冲
+            tiled = true;
         }
     }
+
+    // 转换为显示图像：1/3/4通道直接拷贝，2、5-8通道提取第一通道显示为灰度图像
+    // 直接从帧缓冲区写入m_qimage，尺寸不变时复用其内存
+    if (!tiled && !CImageConverter::convertToDisplayImage(frameBuffer, width, height, channels, m_qimage)) {
+        m_qimage = QImage();
+    }
+
+    // 延迟统计：帧缓冲和 lastFrameInfo 都是最新一帧（显示调度器合并刷新时跳过的帧不计入）
+    const CFrameParser::FrameInfo& frameInfo = m_tcpImg.lastFrameInfo();
+    CLatencyStats& latencyStats = m_tcpImg.latencyStats();
+    const qint64 convertedNs = FrameProtocol::monotonicNanos();
+    if (frameInfo.completeNs > 0) {
+        latencyStats.record(CLatencyStats::STAGE_CONVERT, (convertedNs - frameInfo.completeNs) / 1000);
+    }
     
     // 检查QImage对象是否创建成功
-    if (!m_qimage.isNull()) {
-        // 图像创建成功，保存原始图像并更新显示
-        m_originalPixmap = QPixmap::fromImage(m_qimage);
+    if (tiled || !m_qimage.isNull()) {
+        // 图像创建成功，交给显示控件；m_qimage 换回上一帧的缓冲，下一帧复用
+        if (!tiled) {
+            m_imageDisplayLabel->swapImage(m_qimage);
+        }
         
         // 更新图像显示
-        updateImageDisplay(m_originalPixmap);
+        updateImageDisplay();
+
+        // 显示控件已更新，等待绘制；绘制前到达的新帧会覆盖未绘制的帧
+        if (frameInfo.completeNs > 0) {
+            m_pendingDisplayNs = FrameProtocol::monotonicNanos();
+            latencyStats.record(CLatencyStats::STAGE_DISPLAY, (m_pendingDisplayNs - convertedNs) / 1000);
+            m_pendingPaintInfo = frameInfo;
+            m_latencyPaintPending = true;
+        }
         
         // 重新启用开始按钮，允许用户重新连接
         // ui->pushButtonStart->setEnabled(true);  // 已移除原始UI控件
         
-        qDebug() << "图像显示更新成功，图像尺寸：" << m_qimage.width() << "x" << m_qimage.height();
+        qDebug() << "图像显示更新成功，图像尺寸：" << width << "x" << height;
         
         // 🔍 在界面上显示帧头验证结果
         char* frameBuffer = m_tcpImg.getFrameBuffer();
@@ -333,8 +349,23 @@ void Dialog::initDebugInterface()
     m_toggleControlsBtn->setStyleSheet("QPushButton { background-color: transparent; border: 1px solid #ccc; padding: 4px 8px; }");
     connect(m_toggleControlsBtn, &QPushButton::clicked, this, &Dialog::toggleControlsVisibility);
     
+    // 端到端延迟摘要和导出
+    m_latencyLabel = new QLabel("⏱️ 延迟：等待图像数据");
+    m_latencyLabel->setToolTip("端到端延迟（发送时间戳或首字节 → 绘制），悬停查看各阶段统计");
+    m_exportLatencyBtn = new QPushButton("📤 导出延迟");
+    m_exportLatencyBtn->setToolTip("导出各阶段延迟分位数和直方图（CSV或JSON）");
+    m_exportLatencyBtn->setStyleSheet("QPushButton { background-color: transparent; border: 1px solid #ccc; padding: 4px 8px; }");
+    connect(m_exportLatencyBtn, &QPushButton::clicked, this, &Dialog::exportLatencyStats);
+
+    // 显示帧率与接收帧率
+    m_displayRateLabel = new QLabel("🖥️ 显示 0.0 / 接收 0.0 FPS");
+    m_displayRateLabel->setToolTip("界面按显示器刷新率（或设定上限）合并刷新，只显示最新一帧");
+
     topToolbarLayout->addWidget(m_toggleControlsBtn);
     topToolbarLayout->addStretch();
+    topToolbarLayout->addWidget(m_displayRateLabel);
+    topToolbarLayout->addWidget(m_latencyLabel);
+    topToolbarLayout->addWidget(m_exportLatencyBtn);
     imageLayout->addLayout(topToolbarLayout);
 
     // --- 修改：创建可隐藏的控件容器 ---
@@ -352,10 +383,11 @@ void Dialog::initDebugInterface()
     
     // 创建图像滚动区域替代原来的labelShowImg
     m_imageScrollArea = new QScrollArea();
-    m_imageDisplayLabel = new QLabel();
+    m_imageDisplayLabel = new CImageViewer();
     m_imageDisplayLabel->setAlignment(Qt::AlignCenter);
     m_imageDisplayLabel->setStyleSheet("QLabel { background-color: #f0f0f0; border: 1px solid #ccc; }");
     m_imageDisplayLabel->setText("TCP图像传输接收程序已启动\n\n请输入服务器地址和端口号，然后点击开始连接\n\n默认配置：\nIP：192.168.1.31\n端口：17777");
+    m_imageDisplayLabel->installEventFilter(this);  // 记录绘制阶段延迟
     
     m_imageScrollArea->setWidget(m_imageDisplayLabel);
     m_imageScrollArea->setWidgetResizable(false);  // 不自动调整大小，支持滚动
@@ -372,6 +404,12 @@ void Dialog::initDebugInterface()
     // 添加调试控制面板
     debugLayout->addLayout(createDebugControlPanel());
     
+    // 添加流量发生器面板
+    debugLayout->addLayout(createTrafficGeneratorPanel());
+    
+    // 添加延迟探测面板
+    debugLayout->addLayout(createLatencyProbePanel());
+    
     // 添加调试数据面板  
     debugLayout->addLayout(createDebugDataPanel());
     
@@ -394,16 +432,16 @@ void Dialog::initDebugInterface()
     qDebug() << "当前应用程序代理类型：" << appProxy.type();
     qDebug() << "调试界面初始化完成";
     
-    m_debugDataDisplay->append("=== TCP图像传输 + 网络调试工具 v2.0 ===");
-    m_debugDataDisplay->append("✅ 网络代理已禁用，避免代理设置干扰");
-    m_debugDataDisplay->append("✅ 支持客户端/服务器双模式");
-    m_debugDataDisplay->append("✅ 支持多种数据格式显示");
-    m_debugDataDisplay->append("📝 使用说明：");
-    m_debugDataDisplay->append("  1. 选择工作模式（客户端/服务器）");
-    m_debugDataDisplay->append("  2. 配置连接参数");
-    m_debugDataDisplay->append("  3. 选择数据显示格式");
-    m_debugDataDisplay->append("  4. 点击开始按钮建立连接");
-    m_debugDataDisplay->append("准备就绪，等待操作...\n");
+    m_debugLogModel->appendEvent("=== TCP图像传输 + 网络调试工具 v2.0 ===");
+    m_debugLogModel->appendEvent("✅ 网络代理已禁用，避免代理设置干扰");
+    m_debugLogModel->appendEvent("✅ 支持客户端/服务器双模式");
+    m_debugLogModel->appendEvent("✅ 支持多种数据格式显示");
+    m_debugLogModel->appendEvent("📝 使用说明：");
+    m_debugLogModel->appendEvent("  1. 选择工作模式（客户端/服务器）");
+    m_debugLogModel->appendEvent("  2. 配置连接参数");
+    m_debugLogModel->appendEvent("  3. 选择数据显示格式");
+    m_debugLogModel->appendEvent("  4. 点击开始按钮建立连接");
+    m_debugLogModel->appendEvent("准备就绪，等待操作...");
 }
 
 /**
@@ -467,6 +505,19 @@ QLayout* Dialog::createDebugControlPanel()
     m_debugPortEdit = new QLineEdit("12345");
     connectionLayout->addWidget(m_debugPortEdit, 2, 1);
     
+    // 服务器模式查看的客户端：客户端很多时只看一个或只看统计，其余数据不进入界面线程
+    connectionLayout->addWidget(new QLabel("查看客户端:"), 3, 0);
+    m_debugClientCombo = new QComboBox();
+    m_debugClientCombo->setToolTip(QString("服务器模式下显示哪些客户端的数据，列表最多显示接收速率最高的 %1 个客户端")
+                                   .arg(DEBUG_CLIENT_LIST_MAX));
+    m_debugClientCombo->addItem("全部客户端", QVariant::fromValue<quint64>(quint64(DEBUG_CLIENT_VIEW_ALL)));
+    m_debugClientCombo->addItem("仅统计（不显示数据）", QVariant::fromValue<quint64>(0));
+    m_debugClientCombo->setCurrentIndex(1);  // 默认只统计，需要时再选择要查看的客户端
+    connectionLayout->addWidget(m_debugClientCombo, 3, 1);
+    
+    connect(m_debugClientCombo, SIGNAL(currentIndexChanged(int)),
+            this, SLOT(onDebugClientViewChanged()));
+    
     controlLayout->addWidget(connectionGroup);
     
     // 数据格式选择组
@@ -492,6 +543,7 @@ QLayout* Dialog::createDebugControlPanel()
             this, SLOT(onDataFormatChanged()));
     connect(m_timestampCheckBox, &QCheckBox::toggled, [this](bool checked) {
         m_tcpDebugger->setShowTimestamp(checked);
+        m_debugLogModel->setShowTimestamp(checked);
     });
     
     controlLayout->addWidget(formatGroup);
@@ -548,12 +600,47 @@ QLayout* Dialog::createDebugDataPanel()
     QGroupBox* displayGroup = new QGroupBox("接收数据");
     QVBoxLayout* displayLayout = new QVBoxLayout(displayGroup);
     
-    m_debugDataDisplay = new QTextEdit();
-    m_debugDataDisplay->setReadOnly(true);
-    m_debugDataDisplay->setFont(QFont("Consolas", 9));  // 使用等宽字体
-    m_debugDataDisplay->setPlainText("等待数据接收...\n\n提示：\n- 支持多种数据格式显示\n- 可显示时间戳\n- 支持客户端和服务器模式\n- 实时统计连接信息");
-    
-    displayLayout->addWidget(m_debugDataDisplay);
+    // 收发记录列表：每条记录一行摘要，只格式化可见行；行高一致，滚动时不逐行测量
+    m_debugLogView = new QListView();
+    m_debugLogView->setModel(m_debugLogModel);
+    m_debugLogView->setUniformItemSizes(true);
+    m_debugLogView->setFont(QFont("Consolas", 9));  // 使用等宽字体
+    m_debugLogView->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_debugLogView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    
+    // 选中记录的完整内容
+    m_debugDetailView = new QPlainTextEdit();
+    m_debugDetailView->setReadOnly(true);
+    m_debugDetailView->setFont(QFont("Consolas", 9));
+    m_debugDetailView->setMaximumHeight(160);
+    m_debugDetailView->setPlaceholderText("选中一条记录查看完整内容");
+    
+    m_debugAutoScrollCheckBox = new QCheckBox("自动滚动");
+    m_debugAutoScrollCheckBox->setChecked(true);
+    m_debugAutoScrollCheckBox->setToolTip(QString("最多保留最近 %1 条记录").arg(CPacketLogModel::DEFAULT_MAX_ENTRIES));
+    
+    connect(m_debugLogView->selectionModel(), &QItemSelectionModel::currentChanged,
+            this, &Dialog::onDebugLogSelectionChanged);
+    
+    // 抓包：导出为 pcapng，或导入 pcap/pcapng 离线查看
+    m_captureBtn = new QPushButton("开始抓包");
+    m_captureBtn->setToolTip("把之后的收发数据写入 pcapng 文件（合成TCP/IP头，可用 Wireshark 打开）");
+    m_captureImportBtn = new QPushButton("导入抓包");
+    m_captureImportBtn->setToolTip("把 pcap/pcapng 文件中的TCP/UDP负载导入收发记录（替换当前记录）");
+    m_captureStatusLabel = new QLabel("未抓包");
+    connect(m_captureBtn, &QPushButton::clicked, this, &Dialog::toggleCapture);
+    connect(m_captureImportBtn, &QPushButton::clicked, this, &Dialog::toggleCaptureImport);
+    
+    QHBoxLayout* logOptionsLayout = new QHBoxLayout();
+    logOptionsLayout->addWidget(m_debugAutoScrollCheckBox);
+    logOptionsLayout->addStretch();
+    logOptionsLayout->addWidget(m_captureStatusLabel);
+    logOptionsLayout->addWidget(m_captureBtn);
+    logOptionsLayout->addWidget(m_captureImportBtn);
+    
+    displayLayout->addWidget(m_debugLogView, 1);
+    displayLayout->addWidget(m_debugDetailView);
+    displayLayout->addLayout(logOptionsLayout);
     dataLayout->addWidget(displayGroup);
     
     // 数据发送区域
@@ -578,6 +665,420 @@ QLayout* Dialog::createDebugDataPanel()
     return dataLayout;
 }
 
+/**
+ * @brief 创建流量发生器面板
+ * @return 面板布局
+ */
+QLayout* Dialog::createTrafficGeneratorPanel()
+{
+    QHBoxLayout* trafficLayout = new QHBoxLayout();
+    
+    QGroupBox* trafficGroup = new QGroupBox("流量发生器");
+    QGridLayout* gridLayout = new QGridLayout(trafficGroup);
+    
+    // 负载和包大小
+    gridLayout->addWidget(new QLabel("负载:"), 0, 0);
+    m_trafficPayloadCombo = new QComboBox();
+    m_trafficPayloadCombo->addItem("递增图案", static_cast<int>(CTrafficGenerator::PAYLOAD_PATTERN));
+    m_trafficPayloadCombo->addItem("随机数据", static_cast<int>(CTrafficGenerator::PAYLOAD_RANDOM));
+    m_trafficPayloadCombo->addItem("固定内容（发送框文本）", static_cast<int>(CTrafficGenerator::PAYLOAD_FIXED));
+    m_trafficPayloadCombo->addItem("文件...", static_cast<int>(CTrafficGenerator::PAYLOAD_FILE));
+    gridLayout->addWidget(m_trafficPayloadCombo, 0, 1);
+    
+    gridLayout->addWidget(new QLabel("包大小(字节):"), 0, 2);
+    m_trafficPacketSizeEdit = new QLineEdit("1024");
+    gridLayout->addWidget(m_trafficPacketSizeEdit, 0, 3);
+    
+    gridLayout->addWidget(new QLabel("连接数:"), 0, 4);
+    m_trafficConnectionsEdit = new QLineEdit("1");
+    m_trafficConnectionsEdit->setToolTip(QString("并行连接数，最多 %1 个").arg(CTrafficGenerator::MAX_CONNECTIONS));
+    gridLayout->addWidget(m_trafficConnectionsEdit, 0, 5);
+    
+    // 速率和时长
+    gridLayout->addWidget(new QLabel("速率(Mbps):"), 1, 0);
+    m_trafficRateEdit = new QLineEdit("0");
+    m_trafficRateEdit->setToolTip("所有连接的总速率，0表示不限速");
+    gridLayout->addWidget(m_trafficRateEdit, 1, 1);
+    
+    gridLayout->addWidget(new QLabel("时长(秒):"), 1, 2);
+    m_trafficDurationEdit = new QLineEdit("10");
+    m_trafficDurationEdit->setToolTip("0表示直到手动停止");
+    gridLayout->addWidget(m_trafficDurationEdit, 1, 3);
+    
+    m_trafficFramedCheckBox = new QCheckBox("校验帧头");
+    m_trafficFramedCheckBox->setChecked(true);
+    m_trafficFramedCheckBox->setToolTip("每包前加序号和CRC，接收端可检查丢包、乱序和数据损坏");
+    gridLayout->addWidget(m_trafficFramedCheckBox, 1, 4);
+    
+    m_trafficVerifyCheckBox = new QCheckBox("接收校验");
+    m_trafficVerifyCheckBox->setToolTip("服务器模式下按校验帧头检查每个客户端收到的数据，结果显示在统计信息中");
+    gridLayout->addWidget(m_trafficVerifyCheckBox, 1, 5);
+    connect(m_trafficVerifyCheckBox, &QCheckBox::toggled, [this](bool checked) {
+        m_tcpDebugger->setVerifyTraffic(checked);
+    });
+    
+    m_trafficStartBtn = new QPushButton("开始发送");
+    m_trafficStartBtn->setStyleSheet("QPushButton { background-color: #FF9800; color: white; font-weight: bold; }");
+    m_trafficStartBtn->setToolTip("向“目标主机:端口”发送测试流量");
+    gridLayout->addWidget(m_trafficStartBtn, 0, 6, 2, 1);
+    connect(m_trafficStartBtn, &QPushButton::clicked, this, &Dialog::toggleTrafficGenerator);
+    
+    m_trafficStatsLabel = new QLabel("未运行");
+    m_trafficStatsLabel->setStyleSheet("QLabel { font-size: 9pt; color: #888; }");
+    gridLayout->addWidget(m_trafficStatsLabel, 2, 0, 1, 7);
+    
+    trafficLayout->addWidget(trafficGroup);
+    return trafficLayout;
+}
+
+/**
+ * @brief 开始或停止流量发生器
+ */
+void Dialog::toggleTrafficGenerator()
+{
+    if (m_trafficGenerator->isRunning()) {
+        m_trafficGenerator->stop();
+        m_trafficStartBtn->setEnabled(false);  // 等已排队的数据写完，结束时恢复
+        return;
+    }
+    
+    CTrafficGenerator::Config config;
+    config.host = m_debugHostEdit->text().trimmed();
+    config.port = quint16(m_debugPortEdit->text().toUInt());
+    config.connections = m_trafficConnectionsEdit->text().toInt();
+    config.packetSize = m_trafficPacketSizeEdit->text().toInt();
+    config.rateBytesPerSec = qint64(m_trafficRateEdit->text().toDouble() * 1e6 / 8);
+    config.durationSec = m_trafficDurationEdit->text().toInt();
+    config.framed = m_trafficFramedCheckBox->isChecked();
+    config.payload = static_cast<CTrafficGenerator::PayloadMode>(m_trafficPayloadCombo->currentData().toInt());
+    
+    if (config.payload == CTrafficGenerator::PAYLOAD_FIXED) {
+        config.fixedData = m_debugSendEdit->text().toUtf8();
+    } else if (config.payload == CTrafficGenerator::PAYLOAD_FILE) {
+        config.filePath = QFileDialog::getOpenFileName(this, "选择发送的文件");
+        if (config.filePath.isEmpty()) {
+            return;
+        }
+    }
+    
+    if (!m_trafficGenerator->start(config)) {
+        m_debugLogModel->appendEvent(QString("=== 流量发生器启动失败：%1 ===").arg(m_trafficGenerator->errorString()));
+        return;
+    }
+    
+    m_trafficStartBtn->setText("停止发送");
+    m_trafficStatsLabel->setText("正在连接...");
+    m_debugLogModel->appendEvent(QString("=== 流量发生器开始：%1:%2，%3 个连接 ===")
+                                 .arg(config.host).arg(config.port).arg(config.connections));
+}
+
+/**
+ * @brief 流量发生器周期统计
+ * @param stats 统计
+ */
+void Dialog::onTrafficProgress(const CTrafficGenerator::Stats& stats)
+{
+    m_trafficStatsLabel->setText(CTrafficGenerator::formatStats(stats));
+}
+
+/**
+ * @brief 流量发生器结束
+ * @param stats 最终统计
+ */
+void Dialog::onTrafficFinished(const CTrafficGenerator::Stats& stats)
+{
+    m_trafficStatsLabel->setText(CTrafficGenerator::formatStats(stats));
+    m_trafficStartBtn->setText("开始发送");
+    m_trafficStartBtn->setEnabled(true);
+    m_debugLogModel->appendEvent(QString("=== 流量发生器结束：%1 包，平均 %2 Mbps%3 ===")
+                                 .arg(stats.packetsSent)
+                                 .arg(stats.throughputBps * 8 / 1e6, 0, 'f', 2)
+                                 .arg(stats.error.isEmpty() ? QString() : "，" + stats.error));
+}
+
+/**
+ * @brief 创建延迟探测面板
+ * @return 面板布局
+ */
+QLayout* Dialog::createLatencyProbePanel()
+{
+    QHBoxLayout* probeLayout = new QHBoxLayout();
+    
+    QGroupBox* probeGroup = new QGroupBox("延迟探测");
+    QGridLayout* gridLayout = new QGridLayout(probeGroup);
+    
+    // 探测方式和请求内容
+    gridLayout->addWidget(new QLabel("方式:"), 0, 0);
+    m_probeModeCombo = new QComboBox();
+    m_probeModeCombo->addItem("时间戳探测（对端回显）", static_cast<int>(CLatencyProbe::MODE_TIMESTAMP));
+    m_probeModeCombo->addItem("自定义请求", static_cast<int>(CLatencyProbe::MODE_REQUEST));
+    gridLayout->addWidget(m_probeModeCombo, 0, 1);
+    
+    gridLayout->addWidget(new QLabel("请求:"), 0, 2);
+    m_probeRequestEdit = new QLineEdit();
+    m_probeRequestEdit->setPlaceholderText("如 READ {seq}\\r\\n");
+    m_probeRequestEdit->setToolTip("自定义请求内容：{seq} 替换为序号，支持 \\r \\n \\t \\\\ 和 \\xHH 转义");
+    gridLayout->addWidget(m_probeRequestEdit, 0, 3);
+    
+    gridLayout->addWidget(new QLabel("应答正则:"), 0, 4);
+    m_probePatternEdit = new QLineEdit();
+    m_probePatternEdit->setPlaceholderText("如 OK (?<seq>\\d+)\\r\\n");
+    m_probePatternEdit->setToolTip("匹配一条应答的正则；含命名分组 seq 时按序号匹配请求，否则按发送顺序；"
+                                   "为空时收到任意数据即视为应答");
+    gridLayout->addWidget(m_probePatternEdit, 0, 5);
+    
+    // 节奏和超时
+    gridLayout->addWidget(new QLabel("间隔(ms):"), 1, 0);
+    m_probeIntervalEdit = new QLineEdit("100");
+    gridLayout->addWidget(m_probeIntervalEdit, 1, 1);
+    
+    gridLayout->addWidget(new QLabel("次数:"), 1, 2);
+    m_probeCountEdit = new QLineEdit("0");
+    m_probeCountEdit->setToolTip("请求总数，0表示直到手动停止");
+    gridLayout->addWidget(m_probeCountEdit, 1, 3);
+    
+    gridLayout->addWidget(new QLabel("超时(ms):"), 1, 4);
+    m_probeTimeoutEdit = new QLineEdit("2000");
+    gridLayout->addWidget(m_probeTimeoutEdit, 1, 5);
+    
+    gridLayout->addWidget(new QLabel("并发:"), 2, 0);
+    m_probeInFlightEdit = new QLineEdit("1");
+    m_probeInFlightEdit->setToolTip(QString("最多同时未应答的请求数（1为一问一答，最多 %1）")
+                                    .arg(CLatencyProbe::MAX_IN_FLIGHT));
+    gridLayout->addWidget(m_probeInFlightEdit, 2, 1);
+    
+    m_echoCheckBox = new QCheckBox("回显模式");
+    m_echoCheckBox->setToolTip("把收到的数据原样发回，作为另一台机器上延迟探测的对端（服务器模式在工作线程中回显）");
+    gridLayout->addWidget(m_echoCheckBox, 2, 2);
+    connect(m_echoCheckBox, &QCheckBox::toggled, [this](bool checked) {
+        m_tcpDebugger->setEchoMode(checked);
+    });
+    
+    m_probeStartBtn = new QPushButton("开始探测");
+    m_probeStartBtn->setStyleSheet("QPushButton { background-color: #009688; color: white; font-weight: bold; }");
+    m_probeStartBtn->setToolTip("客户端模式连接后，向对端发送请求并测量应答的往返时间");
+    gridLayout->addWidget(m_probeStartBtn, 0, 6, 3, 1);
+    connect(m_probeStartBtn, &QPushButton::clicked, this, &Dialog::toggleLatencyProbe);
+    
+    m_probeStatsLabel = new QLabel("未运行");
+    m_probeStatsLabel->setStyleSheet("QLabel { font-size: 9pt; color: #888; }");
+    gridLayout->addWidget(m_probeStatsLabel, 3, 0, 1, 7);
+    
+    probeLayout->addWidget(probeGroup);
+    return probeLayout;
+}
+
+/**
+ * @brief 开始或停止延迟探测
+ */
+void Dialog::toggleLatencyProbe()
+{
+    if (m_tcpDebugger->isLatencyProbeRunning()) {
+        m_tcpDebugger->stopLatencyProbe();
+        return;
+    }
+    
+    CLatencyProbe::Config config;
+    config.mode = static_cast<CLatencyProbe::Mode>(m_probeModeCombo->currentData().toInt());
+    config.intervalMs = m_probeIntervalEdit->text().toInt();
+    config.count = m_probeCountEdit->text().toInt();
+    config.timeoutMs = m_probeTimeoutEdit->text().toInt();
+    config.maxInFlight = m_probeInFlightEdit->text().toInt();
+    config.request = CLatencyProbe::unescape(m_probeRequestEdit->text());
+    config.responsePattern = m_probePatternEdit->text();
+    
+    QString error;
+    if (!m_tcpDebugger->startLatencyProbe(config, &error)) {
+        m_debugLogModel->appendEvent(QString("=== 延迟探测启动失败：%1 ===").arg(error));
+        return;
+    }
+    
+    m_probeStartBtn->setText("停止探测");
+    m_probeStatsLabel->setText("正在探测...");
+    m_debugLogModel->appendEvent(QString("=== 延迟探测开始：间隔 %1 ms ===").arg(config.intervalMs));
+}
+
+/**
+ * @brief 延迟探测周期统计
+ * @param stats 统计
+ */
+void Dialog::onLatencyProbeUpdated(const CLatencyProbe::Stats& stats)
+{
+    m_probeStatsLabel->setText(CLatencyProbe::formatStats(stats).trimmed());
+}
+
+/**
+ * @brief 延迟探测结束
+ * @param stats 最终统计
+ */
+void Dialog::onLatencyProbeFinished(const CLatencyProbe::Stats& stats)
+{
+    m_probeStatsLabel->setText(CLatencyProbe::formatStats(stats).trimmed());
+    m_probeStartBtn->setText("开始探测");
+    m_debugLogModel->appendEvent(QString("=== 延迟探测结束：%1 次应答，%2 次超时，p50 %3 ms，p99 %4 ms ===")
+                                 .arg(stats.replied).arg(stats.timeouts)
+                                 .arg(stats.p50Us / 1000.0, 0, 'f', 3)
+                                 .arg(stats.p99Us / 1000.0, 0, 'f', 3));
+}
+
+/**
+ * @brief 开始或停止抓包
+ */
+void Dialog::toggleCapture()
+{
+    if (m_tcpDebugger->isCapturing()) {
+        m_tcpDebugger->stopCapture();
+        const CPcapWriter::Stats stats = m_tcpDebugger->getCaptureStats();
+        m_debugLogModel->appendEvent(QString("=== 抓包结束：%1，已保存到 %2 ===")
+                                     .arg(CPcapWriter::formatStats(stats), stats.fileName));
+        m_captureBtn->setText("开始抓包");
+        updateCaptureStatus();
+        return;
+    }
+    
+    const QString defaultName = QString("tcpimg_%1.pcapng")
+                                .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+    const QString fileName = QFileDialog::getSaveFileName(this, "保存抓包文件", defaultName,
+                                                          "pcapng 抓包文件 (*.pcapng)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    
+    QString error;
+    if (!m_tcpDebugger->startCapture(fileName, &error)) {
+        m_debugLogModel->appendEvent(QString("=== 抓包启动失败：%1 ===").arg(error));
+        return;
+    }
+    
+    m_captureBtn->setText("停止抓包");
+    m_debugLogModel->appendEvent(QString("=== 开始抓包：%1 ===").arg(fileName));
+    updateCaptureStatus();
+}
+
+/**
+ * @brief 抓包文件写入失败
+ * @param message 错误信息
+ */
+void Dialog::onCaptureFailed(const QString& message)
+{
+    m_captureBtn->setText("开始抓包");
+    m_debugLogModel->appendEvent(QString("=== 抓包文件写入失败，已停止：%1 ===").arg(message));
+    updateCaptureStatus();
+}
+
+/**
+ * @brief 导入抓包文件，或取消正在进行的导入
+ */
+void Dialog::toggleCaptureImport()
+{
+    if (m_captureImportTimer->isActive()) {
+        finishCaptureImport("已取消");
+        return;
+    }
+    
+    const QString fileName = QFileDialog::getOpenFileName(this, "导入抓包文件", QString(),
+                                                          "抓包文件 (*.pcapng *.pcap *.cap);;所有文件 (*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    
+    QString error;
+    if (!m_captureReader.open(fileName, &error)) {
+        m_debugLogModel->appendEvent(QString("=== 导入失败：%1 ===").arg(error));
+        return;
+    }
+    
+    // 导入的记录替换当前记录，按包的时间戳显示
+    m_debugLogModel->clear();
+    m_debugDetailView->clear();
+    m_debugLogModel->appendEvent(QString("=== 导入抓包文件：%1 ===").arg(fileName));
+    m_captureImportPackets = 0;
+    m_captureImportBytes = 0;
+    m_captureImportBtn->setText("取消导入");
+    m_captureImportTimer->start();
+}
+
+/**
+ * @brief 分时读取导入的抓包文件
+ */
+void Dialog::onCaptureImportTick()
+{
+    QElapsedTimer slice;
+    slice.start();
+    
+    CPcapReader::Packet packet;
+    while (slice.elapsed() < CAPTURE_IMPORT_SLICE_MS) {
+        // 超出收发记录的保留上限时停止，后面的包导入了也会被丢弃
+        if (m_captureImportPackets + 1 >= m_debugLogModel->maxEntries()
+            || m_captureImportBytes >= m_debugLogModel->maxBytes()) {
+            finishCaptureImport(QString("已达到收发记录上限（%1 条 / %2 MB），其余的包未导入")
+                                .arg(m_debugLogModel->maxEntries())
+                                .arg(m_debugLogModel->maxBytes() / (1024 * 1024)));
+            return;
+        }
+        if (!m_captureReader.readNext(packet)) {
+            finishCaptureImport(m_captureReader.errorString());
+            return;
+        }
+        
+        const qint64 timestampMs = packet.timestampUs / 1000;
+        switch (packet.direction) {
+        case CPcapWriter::DIRECTION_OUTBOUND:
+            m_debugLogModel->appendSent(packet.payload, packet.destination, timestampMs);
+            break;
+        case CPcapWriter::DIRECTION_INBOUND:
+            m_debugLogModel->appendReceived(packet.payload, packet.source, timestampMs);
+            break;
+        default:
+            m_debugLogModel->appendReceived(packet.payload,
+                                            QString("%1 → %2").arg(packet.source, packet.destination),
+                                            timestampMs);
+            break;
+        }
+        m_captureImportPackets++;
+        m_captureImportBytes += packet.payload.size();
+    }
+    
+    const qint64 size = m_captureReader.size();
+    m_captureStatusLabel->setText(QString("正在导入 %1%，%2 包")
+                                  .arg(size > 0 ? m_captureReader.position() * 100 / size : 0)
+                                  .arg(m_captureImportPackets));
+}
+
+/**
+ * @brief 结束抓包文件导入
+ * @param reason 结束原因（为空表示正常读完）
+ */
+void Dialog::finishCaptureImport(const QString& reason)
+{
+    m_captureImportTimer->stop();
+    QString summary = QString("=== 导入结束：%1 个带负载的包，%2 字节（跳过 %3 个非TCP/UDP或无负载的包）")
+                      .arg(m_captureImportPackets).arg(m_captureImportBytes)
+                      .arg(m_captureReader.packetsSkipped());
+    if (!reason.isEmpty()) {
+        summary += QString("，%1").arg(reason);
+    }
+    m_debugLogModel->appendEvent(summary + " ===");
+    m_captureReader.close();
+    m_captureImportBtn->setText("导入抓包");
+    updateCaptureStatus();
+}
+
+/**
+ * @brief 刷新抓包状态标签
+ */
+void Dialog::updateCaptureStatus()
+{
+    if (m_captureImportTimer->isActive()) {
+        return;  // 导入进度由导入定时器刷新
+    }
+    if (m_tcpDebugger->isCapturing()) {
+        m_captureStatusLabel->setText(QString("抓包中：%1").arg(CPcapWriter::formatStats(m_tcpDebugger->getCaptureStats())));
+    } else {
+        m_captureStatusLabel->setText("未抓包");
+    }
+}
+
 /**
  * @brief 更新调试界面状态
  */
@@ -600,9 +1101,11 @@ void Dialog::updateDebugUIState()
     m_debugHostEdit->setEnabled(!isConnected && isClientMode);
     m_localIPCombo->setEnabled(!isConnected && !isClientMode);
     m_debugPortEdit->setEnabled(!isConnected);
+    m_debugClientCombo->setEnabled(isConnected && !isClientMode);
     
     // 更新统计信息
     m_debugStatsLabel->setText(m_tcpDebugger->getConnectionStats());
+    updateCaptureStatus();
 }
 
 /**
@@ -622,7 +1125,7 @@ void Dialog::startDebugMode()
     bool ok;
     quint16 port = m_debugPortEdit->text().toUInt(&ok);
     if (!ok || port == 0) {
-        m_debugDataDisplay->append("错误：端口号格式不正确");
+        m_debugLogModel->appendEvent("错误：端口号格式不正确");
         return;
     }
     
@@ -630,7 +1133,7 @@ void Dialog::startDebugMode()
     if (mode == CTCPDebugger::MODE_CLIENT) {
         QString host = m_debugHostEdit->text().trimmed();
         if (host.isEmpty()) {
-            m_debugDataDisplay->append("错误：请输入目标主机地址");
+            m_debugLogModel->appendEvent("错误：请输入目标主机地址");
             return;
         }
         m_tcpDebugger->startClient(host, port);
@@ -651,6 +1154,7 @@ void Dialog::startDebugMode()
         
         qDebug() << "服务器模式 - 选择的IP：" << selectedIP << "绑定地址：" << bindAddress.toString();
         m_tcpDebugger->startServer(port, bindAddress);
+        onDebugClientViewChanged();
     }
     
     updateDebugUIState();
@@ -662,8 +1166,9 @@ void Dialog::startDebugMode()
 void Dialog::stopDebugMode()
 {
     m_tcpDebugger->stop();
+    onDebugClientStatsUpdated();
     updateDebugUIState();
-    m_debugDataDisplay->append("=== 连接已停止 ===");
+    m_debugLogModel->appendEvent("=== 连接已停止 ===");
 }
 
 /**
@@ -676,12 +1181,18 @@ void Dialog::sendDebugData()
         return;
     }
     
-    qint64 sent = m_tcpDebugger->sendText(text);
+    // 服务器模式下选中了单个客户端时只发给该客户端
+    const quint64 clientId = m_debugClientCombo->currentData().value<quint64>();
+    const bool toOneClient = m_serverModeRadio->isChecked()
+                             && clientId != 0 && clientId != DEBUG_CLIENT_VIEW_ALL;
+    qint64 sent = toOneClient ? m_tcpDebugger->sendToClient(clientId, text.toUtf8())
+                              : m_tcpDebugger->sendText(text);
     if (sent > 0) {
-        m_debugDataDisplay->append(QString(">>> 发送: %1 (%2 字节)").arg(text).arg(sent));
+        m_debugLogModel->appendSent(text.toUtf8().left(int(sent)),
+                                    toOneClient ? m_debugClientCombo->currentText() : QString());
         m_debugSendEdit->clear();
     } else {
-        m_debugDataDisplay->append(">>> 发送失败：连接异常");
+        m_debugLogModel->appendEvent(">>> 发送失败：连接异常");
     }
     
     updateDebugUIState();
@@ -692,7 +1203,8 @@ void Dialog::sendDebugData()
  */
 void Dialog::clearDebugData()
 {
-    m_debugDataDisplay->clear();
+    m_debugLogModel->clear();
+    m_debugDetailView->clear();
     m_tcpDebugger->clearStats();
     updateDebugUIState();
 }
@@ -705,6 +1217,8 @@ void Dialog::onDataFormatChanged()
     int formatValue = m_dataFormatCombo->currentData().toInt();
     CDataFormatter::DataDisplayFormat format = static_cast<CDataFormatter::DataDisplayFormat>(formatValue);
     m_tcpDebugger->setDataDisplayFormat(format);
+    m_debugLogModel->setDisplayFormat(format);
+    onDebugLogSelectionChanged();
 }
 
 /**
@@ -718,26 +1232,105 @@ void Dialog::onWorkModeChanged()
 /**
  * @brief 调试数据接收槽函数
  * @param data 原始数据
- * @param formattedData 格式化后的数据
  * @param remoteAddress 远程地址
+ *
+ * 只保存原始数据，界面由 onDebugLogFlushed 按批刷新
  */
-void Dialog::onDebugDataReceived(const QByteArray& data, const QString& formattedData, const QString& remoteAddress)
+void Dialog::onDebugPacketReceived(const QByteArray& data, const QString& remoteAddress)
 {
-    QString displayText = QString("<<< 接收来自 %1 (%2 字节):\n%3\n")
-                         .arg(remoteAddress)
-                         .arg(data.size())
-                         .arg(formattedData);
-    
-    m_debugDataDisplay->append(displayText);
+    m_debugLogModel->appendReceived(data, remoteAddress);
+}
+
+/**
+ * @brief 收发记录批量插入后刷新界面
+ * @param added 本批插入的行数
+ */
+void Dialog::onDebugLogFlushed(int added)
+{
+    Q_UNUSED(added)
     
     // 自动滚动到底部
-    QTextCursor cursor = m_debugDataDisplay->textCursor();
-    cursor.movePosition(QTextCursor::End);
-    m_debugDataDisplay->setTextCursor(cursor);
+    if (m_debugAutoScrollCheckBox->isChecked()) {
+        m_debugLogView->scrollToBottom();
+    }
     
     updateDebugUIState();
 }
 
+/**
+ * @brief 显示选中记录的完整内容
+ */
+void Dialog::onDebugLogSelectionChanged()
+{
+    const QModelIndex current = m_debugLogView->currentIndex();
+    if (!current.isValid()) {
+        m_debugDetailView->clear();
+        return;
+    }
+    m_debugDetailView->setPlainText(m_debugLogModel->detailText(current.row()));
+}
+
+/**
+ * @brief 服务器模式客户端统计更新
+ *
+ * 每秒一次；客户端集合变化时才重建列表，列表按接收速率排序且有上限，
+ * 数千个客户端时也不会让下拉框本身成为瓶颈
+ */
+void Dialog::onDebugClientStatsUpdated()
+{
+    QList<CDebugServer::ClientStats> clients = m_tcpDebugger->getClientStats();
+    
+    QSet<quint64> ids;
+    ids.reserve(clients.size());
+    for (const CDebugServer::ClientStats& client : clients) {
+        ids.insert(client.id);
+    }
+    
+    if (ids != m_debugClientIds) {
+        m_debugClientIds = ids;
+        
+        const quint64 selected = m_debugClientCombo->currentData().value<quint64>();
+        std::sort(clients.begin(), clients.end(),
+                  [](const CDebugServer::ClientStats& a, const CDebugServer::ClientStats& b) {
+                      return a.rxBytesPerSec > b.rxBytesPerSec;
+                  });
+        
+        m_debugClientCombo->blockSignals(true);
+        while (m_debugClientCombo->count() > 2) {
+            m_debugClientCombo->removeItem(2);
+        }
+        for (int i = 0; i < clients.size() && i < DEBUG_CLIENT_LIST_MAX; ++i) {
+            m_debugClientCombo->addItem(QString("#%1 %2").arg(clients[i].id).arg(clients[i].address),
+                                        QVariant::fromValue<quint64>(clients[i].id));
+        }
+        
+        // 保持原来的选择；查看的客户端已断开时改为只统计
+        int index = m_debugClientCombo->findData(QVariant::fromValue<quint64>(selected));
+        m_debugClientCombo->setCurrentIndex(index >= 0 ? index : 1);
+        m_debugClientCombo->blockSignals(false);
+        if (index < 0) {
+            onDebugClientViewChanged();
+        }
+    }
+    
+    updateDebugUIState();
+}
+
+/**
+ * @brief 服务器模式查看的客户端变化
+ */
+void Dialog::onDebugClientViewChanged()
+{
+    const quint64 clientId = m_debugClientCombo->currentData().value<quint64>();
+    if (clientId == DEBUG_CLIENT_VIEW_ALL) {
+        m_tcpDebugger->setWatchedClient(0);
+        m_tcpDebugger->setWatchAllClients(true);
+    } else {
+        m_tcpDebugger->setWatchAllClients(false);
+        m_tcpDebugger->setWatchedClient(clientId);
+    }
+}
+
 /**
  * @brief 调试连接状态变化槽函数
  * @param state 连接状态
@@ -748,7 +1341,7 @@ void Dialog::onDebugConnectionStateChanged(CTCPDebugger::ConnectionState state,
     Q_UNUSED(state)  // 标记参数已被处理，避免编译警告
     
     m_debugStatusLabel->setText(QString("状态：%1").arg(message));
-    m_debugDataDisplay->append(QString("=== %1 ===").arg(message));
+    m_debugLogModel->appendEvent(QString("=== %1 ===").arg(message));
     
     updateDebugUIState();
 }
@@ -778,7 +1371,7 @@ void Dialog::refreshLocalIPAddresses()
         }
     }
     
-    m_debugDataDisplay->append(QString("=== 已刷新本地IP地址列表，发现 %1 个可用地址 ===").arg(ipAddresses.size()));
+    m_debugLogModel->appendEvent(QString("=== 已刷新本地IP地址列表，发现 %1 个可用地址 ===").arg(ipAddresses.size()));
     
     qDebug() << "本地IP地址列表已刷新，当前选择：" << m_localIPCombo->currentText();
 }
@@ -872,6 +1465,13 @@ QLayout* Dialog::createResolutionPanel()
     m_resetResolutionBtn->setToolTip("重置为默认分辨率");
     resolutionLayout->addWidget(m_resetResolutionBtn);
     
+    // 自动识别：发送端使用扩展帧头（版本2）时按帧头中的宽、高、通道数切换
+    m_autoGeometryCheckBox = new QCheckBox("📐 从帧头自动识别");
+    m_autoGeometryCheckBox->setChecked(m_tcpImg.isAutoGeometryEnabled());
+    m_autoGeometryCheckBox->setToolTip("发送端使用扩展帧头时，按每帧帧头中的宽、高、通道数自动切换分辨率，无需重连\n"
+                                       "原始数据、7E 7E帧头和size=模式仍使用上面设置的分辨率");
+    resolutionLayout->addWidget(m_autoGeometryCheckBox);
+    
     // 添加一些弹性空间
     resolutionLayout->addStretch();
     
@@ -886,6 +1486,10 @@ QLayout* Dialog::createResolutionPanel()
     // 连接信号槽
     connect(m_applyResolutionBtn, &QPushButton::clicked, this, &Dialog::applyResolutionSettings);
     connect(m_resetResolutionBtn, &QPushButton::clicked, this, &Dialog::resetResolutionToDefault);
+    connect(m_autoGeometryCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        m_tcpImg.setAutoGeometryEnabled(checked);
+        qDebug() << "📐 从帧头自动识别分辨率：" << (checked ? "开启" : "关闭");
+    });
     connect(m_resolutionPresetCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), 
             this, &Dialog::applyResolutionPreset);
     
@@ -930,43 +1534,30 @@ void Dialog::applyResolutionSettings()
     }
     
     // 计算内存大小并提醒用户
-    long long totalBytes = (long long)width * height * channels;
-    if (totalBytes > 50 * 1024 * 1024) {
-        m_imageDisplayLabel->setText(QString("错误：图像数据过大\n需要 %1 MB 内存，超过50MB限制")
-                                  .arg(totalBytes / 1024.0 / 1024.0, 0, 'f', 1));
+    const qint64 totalBytes = qint64(width) * height * channels;
+    if (totalBytes > FrameProtocol::MAX_PAYLOAD_SIZE) {
+        m_imageDisplayLabel->setText(QString("错误：图像数据过大\n需要 %1 MB 内存，超过单帧上限 %2 MB")
+                                  .arg(totalBytes / 1024.0 / 1024.0, 0, 'f', 1)
+                                  .arg(FrameProtocol::MAX_PAYLOAD_SIZE / (1024 * 1024)));
         return;
     }
     
     // 应用新的分辨率设置
     if (m_tcpImg.setImageResolution(width, height, channels)) {
-        // 重新分配显示缓冲区
-        if (m_showBuffer != nullptr) {
-            delete[] m_showBuffer;
-        }
+        updateResolutionStatus();
         
-        try {
-            m_showBuffer = new char[totalBytes];
-            memset(m_showBuffer, 0, totalBytes);
-            
-                         updateResolutionStatus();
-             
-             QString channelInfo;
-             if (channels == 1) channelInfo = "灰度图像";
-             else if (channels == 3) channelInfo = "RGB彩色图像";
-             else if (channels == 4) channelInfo = "RGBA彩色图像";
-             else channelInfo = QString("%1通道图像(提取第一通道显示)").arg(channels);
-             
-             m_imageDisplayLabel->setText(QString("✅ 分辨率设置成功\n\n新设置：%1 x %2 x %3\n格式：8bit %4\n内存占用：%5 MB\n\n准备接收新的图像数据...")
-                                       .arg(width).arg(height).arg(channels)
-                                       .arg(channelInfo)
-                                       .arg(totalBytes / 1024.0 / 1024.0, 0, 'f', 2));
-                                      
-            qDebug() << "分辨率设置成功：" << width << "x" << height << "x" << channels;
-            
-        } catch (const std::bad_alloc&) {
-            m_imageDisplayLabel->setText("错误：显示缓冲区内存分配失败");
-            m_showBuffer = nullptr;
-        }
+        QString channelInfo;
+        if (channels == 1) channelInfo = "灰度图像";
+        else if (channels == 3) channelInfo = "RGB彩色图像";
+        else if (channels == 4) channelInfo = "RGBA彩色图像";
+        else channelInfo = QString("%1通道图像(提取第一通道显示)").arg(channels);
+        
+        m_imageDisplayLabel->setText(QString("✅ 分辨率设置成功\n\n新设置：%1 x %2 x %3\n格式：8bit %4\n内存占用：%5 MB\n\n准备接收新的图像数据...")
+                                  .arg(width).arg(height).arg(channels)
+                                  .arg(channelInfo)
+                                  .arg(totalBytes / 1024.0 / 1024.0, 0, 'f', 2));
+        
+        qDebug() << "分辨率设置成功：" << width << "x" << height << "x" << channels;
     } else {
         m_imageDisplayLabel->setText("错误：分辨率设置失败\n请检查输入参数");
     }
@@ -1064,6 +1655,29 @@ void Dialog::updateResolutionStatus()
     m_resolutionStatusLabel->setText(statusText);
 }
 
+/**
+ * @brief 帧头携带的图像几何变化
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param channels 通道数
+ */
+void Dialog::onImageGeometryChanged(int width, int height, int channels)
+{
+    // 只同步显示，不触发预设切换
+    const QSignalBlocker widthBlocker(m_widthEdit);
+    const QSignalBlocker heightBlocker(m_heightEdit);
+    m_widthEdit->setText(QString::number(width));
+    m_heightEdit->setText(QString::number(height));
+
+    const int index = m_channelsCombo->findData(channels);
+    if (index >= 0) {
+        m_channelsCombo->setCurrentIndex(index);
+    }
+
+    updateResolutionStatus();
+    m_resolutionStatusLabel->setText(m_resolutionStatusLabel->text() + "（来自帧头）");
+}
+
 /**
  * @brief 创建重连控制面板
  * @return 重连控制面板布局
@@ -1083,7 +1697,16 @@ QLayout* Dialog::createReconnectPanel()
     // 自动重连开关
     m_autoReconnectCheckBox = new QCheckBox("🔄 自动重连");
     m_autoReconnectCheckBox->setChecked(true);  // 默认启用
-    m_autoReconnectCheckBox->setToolTip("启用后，连接断开时会自动尝试重连\n最大5次尝试，间隔3秒");
+    m_autoReconnectCheckBox->setToolTip("启用后，连接断开时会自动尝试重连\n首次重连约50ms后进行，之后间隔逐次加倍（带随机抖动），最长2秒，次数不限");
+    
+    // 停滞检测开关
+    m_stallDetectCheckBox = new QCheckBox("⏱️ 停滞检测");
+    m_stallDetectCheckBox->setChecked(false);  // 默认关闭：空闲的相机和不发心跳的发送端会被误判
+    m_stallDetectCheckBox->setToolTip(QString("连接未断开但%1ms未收到任何数据时（拔网线、发送端挂起）\n"
+                                              "判定为停滞并立即重连，不等待TCP超时\n"
+                                              "仅在发送端持续发送图像或扩展帧头心跳时开启，\n"
+                                              "触发式相机、原始数据/size=发送端空闲时会被反复重连")
+                                      .arg(STALL_TIMEOUT_MS));
     
     // 手动重连按钮
     m_reconnectBtn = new QPushButton("🚀 立即重连");
@@ -1097,6 +1720,7 @@ QLayout* Dialog::createReconnectPanel()
     
     controlLayout->addWidget(m_connectionStatusLabel);
     controlLayout->addWidget(m_autoReconnectCheckBox);
+    controlLayout->addWidget(m_stallDetectCheckBox);
     controlLayout->addWidget(m_reconnectBtn);
     controlLayout->addWidget(m_diagnosticBtn);
     controlLayout->addStretch();
@@ -1136,6 +1760,7 @@ QLayout* Dialog::createReconnectPanel()
     
     // 连接信号
     connect(m_autoReconnectCheckBox, &QCheckBox::toggled, this, &Dialog::toggleAutoReconnect);
+    connect(m_stallDetectCheckBox, &QCheckBox::toggled, this, &Dialog::toggleStallDetection);
     connect(m_reconnectBtn, &QPushButton::clicked, this, &Dialog::manualReconnect);
     connect(m_diagnosticBtn, &QPushButton::clicked, this, &Dialog::performDiagnostics);
     
@@ -1184,6 +1809,14 @@ void Dialog::updateConnectionStatus()
             break;
         case QAbstractSocket::ConnectedState:
             statusText = "🟢 已连接";
+            if (m_tcpImg.endpoints().size() > 1) {
+                // 多端点时显示当前端点和热备状态
+                const CTCPImg::Endpoint& endpoint = m_tcpImg.endpoints().value(m_tcpImg.activeEndpointIndex());
+                statusText += QString(" %1:%2").arg(endpoint.address).arg(endpoint.port);
+                if (m_tcpImg.isStandbyReady()) {
+                    statusText += " 🛡️";
+                }
+            }
             styleSheet = "QLabel { font-weight: bold; color: white; background-color: #4CAF50; padding: 4px 8px; border-radius: 3px; }";
             if (m_reconnectBtn) m_reconnectBtn->setEnabled(false);
             // 连接成功时隐藏进度条
@@ -1252,6 +1885,17 @@ void Dialog::manualReconnect()
     }
 }
 
+/**
+ * @brief 切换接收停滞检测
+ * @param enabled 是否启用
+ */
+void Dialog::toggleStallDetection(bool enabled)
+{
+    CTCPImg::StallPolicy policy = m_tcpImg.stallPolicy();
+    policy.byteTimeoutMs = enabled ? STALL_TIMEOUT_MS : 0;
+    m_tcpImg.setStallPolicy(policy);
+}
+
 /**
  * @brief 切换自动重连状态
  * @param enabled 是否启用自动重连
@@ -1261,7 +1905,7 @@ void Dialog::toggleAutoReconnect(bool enabled)
     qDebug() << "自动重连设置变更：" << (enabled ? "启用" : "禁用");
     
     // 设置TCP图像对象的自动重连参数
-    m_tcpImg.setAutoReconnect(enabled, 5, 3000);  // 最大5次，间隔3秒
+    m_tcpImg.setAutoReconnect(enabled);  // 指数退避，次数不限
     
     // 更新界面显示
     if (m_reconnectProgressLabel) {
@@ -1312,22 +1956,8 @@ void Dialog::performDiagnostics()
     // 在主图像显示区域显示诊断提示
     m_imageDisplayLabel->setText("🔍 正在执行服务端诊断检查...\n\n请稍候，正在检测网络连通性和服务端状态...");
     
-    // 异步执行诊断，避免阻塞UI
-    QTimer::singleShot(100, this, [this]() {
-        // 调用CTCPImg的诊断功能（会通过信号显示结果）
-        m_tcpImg.performServerDiagnostics();
-        
-        // 更新界面显示
-        if (m_reconnectProgressLabel) {
-            m_reconnectProgressLabel->setText("✅ 诊断完成 | 详细信息已显示在图像区域");
-        }
-        
-        // 重新启用诊断按钮
-        if (m_diagnosticBtn) {
-            m_diagnosticBtn->setEnabled(true);
-            m_diagnosticBtn->setText("🔍 诊断");
-        }
-    });
+    // 诊断立即返回，连通性探测在诊断线程中进行，完成后由 diagnosticsFinished 恢复按钮
+    m_tcpImg.performServerDiagnostics();
 }
 
 /**
@@ -1363,26 +1993,26 @@ void Dialog::updateReconnectProgress()
         // 正在重连等待中
         m_reconnectProgressBar->setVisible(true);
         
-        QString progressText = QString("🔄 重连中 (第%1/%2次) - %3秒后重试")
+        QString progressText = QString("🔄 重连中 (第%1%2次) - %3秒后重试")
                               .arg(currentAttempts)
-                              .arg(maxAttempts)
-                              .arg(remainingTime / 1000 + 1); // 转换为秒并向上取整
+                              .arg(maxAttempts > 0 ? QString("/%1").arg(maxAttempts) : QString())
+                              .arg(remainingTime / 1000.0, 0, 'f', 1);
         
         m_reconnectProgressLabel->setText(progressText);
         
         // 计算进度百分比
-        int totalTime = interval; // 总间隔时间
+        int totalTime = qMax(1, interval); // 本次退避等待时间
         int elapsedTime = totalTime - remainingTime;
         int progress = (elapsedTime * 100) / totalTime;
         
         m_reconnectProgressBar->setValue(progress);
-        m_reconnectProgressBar->setFormat(QString("%1秒后重试").arg(remainingTime / 1000 + 1));
+        m_reconnectProgressBar->setFormat(QString("%1秒后重试").arg(remainingTime / 1000.0, 0, 'f', 1));
         
         // 启动进度更新定时器（如果还没启动）
         if (m_reconnectDisplayTimer && !m_reconnectDisplayTimer->isActive()) {
             m_reconnectDisplayTimer->start(100); // 每100ms更新一次进度
         }
-    } else if (currentAttempts >= maxAttempts && !isReconnecting) {
+    } else if (maxAttempts > 0 && currentAttempts >= maxAttempts && !isReconnecting) {
         // 重连失败
         m_reconnectProgressBar->setVisible(false);
         m_reconnectProgressLabel->setText(QString("🔍 重连失败：正在诊断服务端状态..."));
@@ -1715,6 +2345,18 @@ QLayout* Dialog::createZoomControlPanel()
     m_actualSizeBtn->setToolTip("显示图像的实际像素大小 (100%)");
     zoomLayout->addWidget(m_actualSizeBtn);
     
+    // 缩放质量
+    m_scaleQualityCombo = new QComboBox();
+    m_scaleQualityCombo->addItem("区域平均", CImageViewer::QUALITY_AREA);
+    m_scaleQualityCombo->addItem("双线性", CImageViewer::QUALITY_BILINEAR);
+    m_scaleQualityCombo->addItem("最近邻", CImageViewer::QUALITY_NEAREST);
+    m_scaleQualityCombo->setToolTip("缩小显示时的缩放质量：\n"
+                                    "区域平均 - 多分辨率金字塔，抗锯齿且速度快（默认）\n"
+                                    "双线性 - 直接从原图平滑缩放\n"
+                                    "最近邻 - 最快，缩小时有锯齿");
+    zoomLayout->addWidget(new QLabel("质量:"));
+    zoomLayout->addWidget(m_scaleQualityCombo);
+    
     // 添加弹性空间
     zoomLayout->addStretch();
     
@@ -1732,6 +2374,12 @@ QLayout* Dialog::createZoomControlPanel()
         }
     });
     connect(m_actualSizeBtn, &QPushButton::clicked, this, &Dialog::showActualSize);
+    connect(m_scaleQualityCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        const CImageViewer::ScaleQuality quality =
+            static_cast<CImageViewer::ScaleQuality>(m_scaleQualityCombo->itemData(index).toInt());
+        m_imageDisplayLabel->setScaleQuality(quality);
+        qDebug() << "🔍 缩放质量：" << m_scaleQualityCombo->itemText(index);
+    });
     
     QVBoxLayout* panelLayout = new QVBoxLayout();
     panelLayout->addWidget(zoomGroup);
@@ -1740,17 +2388,14 @@ QLayout* Dialog::createZoomControlPanel()
 }
 
 /**
- * @brief 更新图像显示
- * @param pixmap 要显示的图像
+ * @brief 按当前缩放模式更新图像显示
  */
-void Dialog::updateImageDisplay(const QPixmap& pixmap)
+void Dialog::updateImageDisplay()
 {
-    if (pixmap.isNull()) {
+    if (!m_imageDisplayLabel->hasImage()) {
         return;
     }
     
-    QPixmap scaledPixmap;
-    
     if (m_fitToWindow) {
         // 适应窗口模式：根据滚动区域大小自动缩放
         fitImageToWindow();
@@ -1766,29 +2411,25 @@ void Dialog::updateImageDisplay(const QPixmap& pixmap)
  */
 void Dialog::scaleImage(double factor)
 {
-    if (m_originalPixmap.isNull()) {
+    if (!m_imageDisplayLabel->hasImage()) {
         return;
     }
     
+    const bool zoomChanged = !qFuzzyCompare(factor, m_imageDisplayLabel->zoomFactor());
     m_currentZoomFactor = factor;
     
-    // 计算缩放后的尺寸
-    QSize scaledSize = m_originalPixmap.size() * factor;
-    
-    // 缩放图像
-    QPixmap scaledPixmap = m_originalPixmap.scaled(scaledSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    
-    // 更新显示标签
-    m_imageDisplayLabel->setPixmap(scaledPixmap);
-    m_imageDisplayLabel->resize(scaledSize);
+    // 显示控件在绘制时按缩放因子绘制，缩放变化时才生成缩放缓存
+    m_imageDisplayLabel->setZoomFactor(factor);
     
     // 更新缩放控件状态
     updateZoomControls();
     
-    qDebug() << QString("图像已缩放到 %1%，尺寸：%2x%3")
-                .arg(factor * 100, 0, 'f', 1)
-                .arg(scaledSize.width())
-                .arg(scaledSize.height());
+    if (zoomChanged) {
+        qDebug() << QString("图像已缩放到 %1%，尺寸：%2x%3")
+                    .arg(factor * 100, 0, 'f', 1)
+                    .arg(m_imageDisplayLabel->width())
+                    .arg(m_imageDisplayLabel->height());
+    }
 }
 
 /**
@@ -1796,13 +2437,13 @@ void Dialog::scaleImage(double factor)
  */
 void Dialog::fitImageToWindow()
 {
-    if (m_originalPixmap.isNull() || !m_imageScrollArea) {
+    if (!m_imageDisplayLabel->hasImage() || !m_imageScrollArea) {
         return;
     }
     
     // 获取滚动区域的可用空间（减去滚动条和边距）
     QSize availableSize = m_imageScrollArea->viewport()->size();
-    QSize imageSize = m_originalPixmap.size();
+    QSize imageSize = m_imageDisplayLabel->imageSize();
     
     // 计算适应窗口的缩放因子
     double scaleX = static_cast<double>(availableSize.width()) / imageSize.width();
@@ -1910,7 +2551,7 @@ void Dialog::resizeEvent(QResizeEvent* event)
     QDialog::resizeEvent(event);
     
     // 如果处于适应窗口模式，重新调整图像大小
-    if (m_fitToWindow && !m_originalPixmap.isNull()) {
+    if (m_fitToWindow && m_imageDisplayLabel->hasImage()) {
         // 使用一个 ngắn (e.g., 50ms) 的定时器来延迟缩放操作。
         // 这可以防止在用户连续拖动窗口大小时过于频繁地调用fitImageToWindow，
         // 从而获得更平滑的用户体验，并避免性能问题。
@@ -1922,6 +2563,37 @@ void Dialog::resizeEvent(QResizeEvent* event)
    }
 }
 
+/**
+ * @brief 事件过滤器
+ * @param watched 被监视的对象
+ * @param event 事件
+ * @return 是否拦截事件（始终不拦截）
+ *
+ * 图像标签收到绘制事件时，记录等待绘制的帧的绘制阶段和端到端延迟。
+ * 以事件到达时间作为绘制时间（之后的缩放绘制不计入）。
+ */
+bool Dialog::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == m_imageDisplayLabel && event->type() == QEvent::Paint && m_latencyPaintPending) {
+        m_latencyPaintPending = false;
+
+        CLatencyStats& latencyStats = m_tcpImg.latencyStats();
+        const qint64 paintNs = FrameProtocol::monotonicNanos();
+        latencyStats.record(CLatencyStats::STAGE_PAINT, (paintNs - m_pendingDisplayNs) / 1000);
+
+        // 有发送时间戳时从发送算起（换算到墙上时间），否则从收到第一个字节算起
+        const qint64 sinceFirstByteUs = (paintNs - m_pendingPaintInfo.firstByteNs) / 1000;
+        if (m_pendingPaintInfo.hasExtendedHeader && m_pendingPaintInfo.senderTimestampUs > 0) {
+            const qint64 paintWallUs = m_pendingPaintInfo.firstByteWallUs + sinceFirstByteUs;
+            latencyStats.record(CLatencyStats::STAGE_TOTAL, paintWallUs - m_pendingPaintInfo.senderTimestampUs);
+        } else {
+            latencyStats.record(CLatencyStats::STAGE_TOTAL, sinceFirstByteUs);
+        }
+    }
+
+    return QDialog::eventFilter(watched, event);
+}
+
 /**
  * @brief 创建服务器连接面板
  * @return 服务器连接面板布局
@@ -1941,6 +2613,15 @@ QLayout* Dialog::createServerConnectionPanel()
     m_serverPortEdit->setPlaceholderText("端口号");
     m_serverIPEdit->setToolTip("请输入服务器的IP地址");
     m_serverPortEdit->setToolTip("请输入服务器的端口号 (1-65535)");
+
+    // 备用端点：冗余网卡或冗余发送主机，主端点失效时按顺序切换
+    m_backupEndpointsEdit = new QLineEdit();
+    m_backupEndpointsEdit->setPlaceholderText("备用 IP:端口, ...");
+    m_backupEndpointsEdit->setToolTip("按优先级填写备用端点，如 192.168.2.31:17777, 192.168.1.32:17777\n"
+                                      "连接失败时依次切换，一轮都失败后才延长重连等待");
+    m_standbyCheckBox = new QCheckBox("🛡️ 热备");
+    m_standbyCheckBox->setToolTip("预先与下一个端点建立备用连接（数据丢弃）\n"
+                                  "主链路断开时立即接管，从下一帧开始继续接收");
     
     // 设置连接按钮样式
     m_connectBtn->setStyleSheet("QPushButton { background-color: #4CAF50; color: white; font-weight: bold; padding: 8px 16px; border-radius: 4px; min-width: 100px; }");
@@ -1950,6 +2631,9 @@ QLayout* Dialog::createServerConnectionPanel()
     connectionLayout->addWidget(m_serverIPEdit);
     connectionLayout->addWidget(new QLabel("端口:"));
     connectionLayout->addWidget(m_serverPortEdit);
+    connectionLayout->addWidget(new QLabel("备用:"));
+    connectionLayout->addWidget(m_backupEndpointsEdit);
+    connectionLayout->addWidget(m_standbyCheckBox);
     connectionLayout->addWidget(m_connectBtn);
     connectionLayout->addStretch(); // 添加弹性空间
     
@@ -1979,6 +2663,13 @@ QLayout* Dialog::createServerConnectionPanel()
             m_imageDisplayLabel->setText("❌ 连接失败：端口号无效\n请输入1-65535范围内的数字");
             return;
         }
+
+        QVector<CTCPImg::Endpoint> backups;
+        if (!CTCPImg::parseEndpoints(m_backupEndpointsEdit->text(), backups)) {
+            m_imageDisplayLabel->setText("❌ 连接失败：备用端点格式无效\n格式：IP:端口，多个端点用逗号分隔");
+            return;
+        }
+        m_tcpImg.setBackupEndpoints(backups);
         
         // 显示连接状态信息
         m_imageDisplayLabel->setText(QString("🔄 正在连接到服务器...\n\nIP：%1\n端口：%2\n\n请稍候...").arg(ipAddress).arg(port));
@@ -1991,10 +2682,11 @@ QLayout* Dialog::createServerConnectionPanel()
         
         // 启用自动重连（如果勾选了自动重连）
         if (m_autoReconnectCheckBox && m_autoReconnectCheckBox->isChecked()) {
-            m_tcpImg.setAutoReconnect(true, 5, 3000);
+            m_tcpImg.setAutoReconnect(true);
         }
         
         m_tcpImg.start(ipAddress, port);
+        m_tcpImg.setStandbyEnabled(m_standbyCheckBox->isChecked());
         
         // 3秒后重新启用按钮，防止界面卡住
         QTimer::singleShot(3000, this, [this]() {
@@ -2004,6 +2696,8 @@ QLayout* Dialog::createServerConnectionPanel()
         });
     });
     
+    connect(m_standbyCheckBox, &QCheckBox::toggled, &m_tcpImg, &CTCPImg::setStandbyEnabled);
+    
     QVBoxLayout* layout = new QVBoxLayout();
     layout->addWidget(connectionGroup);
     return layout;
@@ -2362,11 +3056,7 @@ QByteArray Dialog::generateTimeDisplayCommand(const QDateTime& dateTime)
     }
     
     // 调试输出每个字节的详细信息
-    QString debugHex;
-    for (int i = 0; i < command.size(); ++i) {
-        debugHex += QString("%1 ").arg(static_cast<unsigned char>(command[i]), 2, 16, QChar('0')).toUpper();
-    }
-    qDebug() << "🔍 生成的指令数据:" << debugHex.trimmed();
+    qDebug() << "🔍 生成的指令数据:" << CDataFormatter::toHexString(command);
     
     Q_ASSERT(command.size() == 39);
     
@@ -2450,11 +3140,7 @@ QByteArray Dialog::generateTimeOffCommand(const QDateTime& dateTime)
     }
     
     // 调试输出每个字节的详细信息
-    QString debugHex;
-    for (int i = 0; i < command.size(); ++i) {
-        debugHex += QString("%1 ").arg(static_cast<unsigned char>(command[i]), 2, 16, QChar('0')).toUpper();
-    }
-    qDebug() << "🔍 生成的关闭显示指令数据:" << debugHex.trimmed();
+    qDebug() << "🔍 生成的关闭显示指令数据:" << CDataFormatter::toHexString(command);
     
     Q_ASSERT(command.size() == 39);
     
@@ -2631,13 +3317,11 @@ void Dialog::sendTimeDisplayCommand()
     if (bytesWritten > 0) {
         m_totalBytesSent += bytesWritten;
         m_commandCount++;
+        m_metricSerialBytesSent->add(bytesWritten);
+        m_metricSerialCommands->increment();
         
         // 生成16进制显示字符串
-        QString hexString;
-        for (int i = 0; i < command.size(); ++i) {
-            if (i > 0) hexString += " ";
-            hexString += QString("%1").arg(static_cast<unsigned char>(command[i]), 2, 16, QChar('0')).toUpper();
-        }
+        QString hexString = CDataFormatter::toHexString(command);
         
         // 生成详细的发送记录
         QString timestamp = sendTime.toString("hh:mm:ss.zzz");
@@ -2726,18 +3410,17 @@ void Dialog::sendCustomCommand()
     if (bytesWritten > 0) {
         m_totalBytesSent += bytesWritten;
         m_commandCount++;
+        m_metricSerialBytesSent->add(bytesWritten);
+        m_metricSerialCommands->increment();
         
         // 更新发送数据显示
-        QString hexString;
-        for (char byte : command) {
-            hexString += QString("%1 ").arg(static_cast<unsigned char>(byte), 2, 16, QChar('0')).toUpper();
-        }
+        QString hexString = CDataFormatter::toHexString(command);
         
         QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
         QString displayText = QString("[%1] 发送自定义指令 (%2字节):\n%3\n文本: %4\n")
                                 .arg(timestamp)
                                 .arg(command.size())
-                                .arg(hexString.trimmed())
+                                .arg(hexString)
                                 .arg(QString::fromUtf8(command));
         
         m_commandSendDisplay->append(displayText);
@@ -2790,11 +3473,7 @@ void Dialog::updateTimeDisplay()
     QByteArray previewCommand = generateTimeDisplayCommand(currentTime);
     
     // 转换为16进制显示格式
-    QString hexString;
-    for (int i = 0; i < previewCommand.size(); ++i) {
-        if (i > 0) hexString += " ";
-        hexString += QString("%1").arg(static_cast<unsigned char>(previewCommand[i]), 2, 16, QChar('0')).toUpper();
-    }
+    QString hexString = CDataFormatter::toHexString(previewCommand);
     
     // 更新预览显示
     m_timeCommandPreview->setText(hexString);
@@ -2838,26 +3517,22 @@ void Dialog::onCommandSerialDataReceived()
     if (data.isEmpty()) return;
     
     m_totalBytesReceived += data.size();
+    m_metricSerialBytesReceived->add(data.size());
     
-    // 转换为16进制显示
-    QString hexString;
-    QString textString;
-    for (char byte : data) {
-        hexString += QString("%1 ").arg(static_cast<unsigned char>(byte), 2, 16, QChar('0')).toUpper();
-        textString += (byte >= 32 && byte <= 126) ? byte : '.';
-    }
+    // 转换为16进制显示（查表编码，一次分配）
+    const QString hexString = CDataFormatter::toHexString(data);
+    const QString textString = CDataFormatter::toPrintableText(data);
     
     QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
     QString displayText = QString("[%1] 接收数据 (%2字节):\n%3\n文本: %4\n")
                             .arg(timestamp)
                             .arg(data.size())
-                            .arg(hexString.trimmed())
-                            .arg(textString);
+                            .arg(hexString, textString);
     
     m_commandReceiveDisplay->append(displayText);
     updateCommandDataStats();
     
-    qDebug() << "📥 接收数据：" << hexString.trimmed();
+    qDebug() << "📥 接收数据：" << hexString;
 }
 
 /**
@@ -3059,13 +3734,11 @@ void Dialog::sendTimeOffCommand()
     if (bytesWritten > 0) {
         m_totalBytesSent += bytesWritten;
         m_commandCount++;
+        m_metricSerialBytesSent->add(bytesWritten);
+        m_metricSerialCommands->increment();
         
         // 生成16进制显示字符串
-        QString hexString;
-        for (int i = 0; i < command.size(); ++i) {
-            if (i > 0) hexString += " ";
-            hexString += QString("%1").arg(static_cast<unsigned char>(command[i]), 2, 16, QChar('0')).toUpper();
-        }
+        QString hexString = CDataFormatter::toHexString(command);
         
         // 生成详细的发送记录
         QString timestamp = sendTime.toString("hh:mm:ss.zzz");
@@ -3190,13 +3863,11 @@ void Dialog::autoSwitchDisplay()
     if (bytesWritten > 0) {
         m_totalBytesSent += bytesWritten;
         m_commandCount++;
+        m_metricSerialBytesSent->add(bytesWritten);
+        m_metricSerialCommands->increment();
         
         // 生成16进制显示字符串
-        QString hexString;
-        for (int i = 0; i < command.size(); ++i) {
-            if (i > 0) hexString += " ";
-            hexString += QString("%1").arg(static_cast<unsigned char>(command[i]), 2, 16, QChar('0')).toUpper();
-        }
+        QString hexString = CDataFormatter::toHexString(command);
         
         // 生成详细的发送记录
         QString timestamp = currentTime.toString("hh:mm:ss.zzz");
@@ -3236,3 +3907,84 @@ void Dialog::autoSwitchDisplay()
     }
 }
 
+/**
+ * @brief 刷新工具栏上的延迟统计
+ *
+ * 标签显示端到端延迟的p50/p99/max，悬停提示显示各阶段详细统计
+ */
+void Dialog::updateLatencyDisplay()
+{
+    if (!m_latencyLabel) return;
+
+    const CLatencyStats& latencyStats = m_tcpImg.latencyStats();
+    const CLatencyStats::Summary total = latencyStats.summary(CLatencyStats::STAGE_TOTAL);
+    if (total.windowCount == 0) {
+        return;
+    }
+
+    m_latencyLabel->setText(QString("⏱️ 延迟 p50 %1 ms | p99 %2 ms | max %3 ms")
+                            .arg(total.p50 / 1000.0, 0, 'f', 1)
+                            .arg(total.p99 / 1000.0, 0, 'f', 1)
+                            .arg(total.max / 1000.0, 0, 'f', 1));
+
+    QString tooltip = QString("最近%1帧各阶段延迟：\n").arg(total.windowCount) + latencyStats.summaryText();
+    if (!m_tcpImg.lastFrameInfo().hasExtendedHeader) {
+        tooltip += "\n\n发送端未使用扩展帧头，无发送时间戳，总计从收到第一个字节算起";
+    }
+    m_latencyLabel->setToolTip(tooltip);
+}
+
+/**
+ * @brief 设置显示帧率上限
+ * @param fps 帧率，0表示使用显示器刷新率
+ */
+void Dialog::setDisplayRateLimit(double fps)
+{
+    m_displayScheduler->setMaxFps(fps);
+}
+
+/**
+ * @brief 刷新工具栏上的显示帧率和接收帧率
+ */
+void Dialog::updateDisplayRateLabel()
+{
+    if (!m_displayRateLabel) return;
+
+    m_displayScheduler->updateRates();
+    m_displayRateLabel->setText(QString("🖥️ 显示 %1 / 接收 %2 FPS")
+                                .arg(m_displayScheduler->displayedFps(), 0, 'f', 1)
+                                .arg(m_displayScheduler->receivedFps(), 0, 'f', 1));
+    m_displayRateLabel->setToolTip(QString("显示上限 %1 FPS%2\n累计接收 %3 帧，显示 %4 帧，合并跳过 %5 帧\n"
+                                           "切换到其他标签页或最小化时不刷新图像")
+                                   .arg(m_displayScheduler->effectiveMaxFps(), 0, 'f', 1)
+                                   .arg(m_displayScheduler->maxFps() > 0 ? "" : "（显示器刷新率）")
+                                   .arg(m_displayScheduler->framesReceived())
+                                   .arg(m_displayScheduler->framesDisplayed())
+                                   .arg(m_displayScheduler->framesSkipped()));
+}
+
+/**
+ * @brief 导出延迟统计到文件
+ *
+ * 按所选扩展名导出CSV或JSON，内容包括各阶段分位数和累计直方图
+ */
+void Dialog::exportLatencyStats()
+{
+    QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
+    QString defaultFileName = QString("延迟统计_%1.csv").arg(timestamp);
+
+    QString fileName = QFileDialog::getSaveFileName(this,
+                                                   "导出延迟统计",
+                                                   defaultFileName,
+                                                   "CSV文件 (*.csv);;JSON文件 (*.json);;所有文件 (*.*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    QString errorString;
+    if (m_tcpImg.latencyStats().exportToFile(fileName, &errorString)) {
+        qDebug() << "💾 延迟统计已导出到：" << fileName;
+    } else {
+        qDebug() << "❌ 延迟统计导出失败：" << errorString;
+    }
+}
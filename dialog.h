@@ -5,6 +5,8 @@
 #include <ctcpimg.h>
 #include <QImage>
 #include <QTextEdit>
+#include <QPlainTextEdit>
+#include <QListView>
 #include <QComboBox>
 #include <QPushButton>
 #include <QTabWidget>
@@ -30,6 +32,7 @@
 #include <QAction>
 #include <QApplication>
 #include <QClipboard>
+#include <QSet>
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
 #include <QStringConverter>
 #endif
@@ -38,7 +41,12 @@
 #endif
 #include "sysdefine.h"
 #include "tcpdebugger.h"
+#include "trafficgenerator.h"
 #include "dataformatter.h"
+#include "packetlogmodel.h"
+#include "imageconverter.h"
+#include "imageviewer.h"
+#include "displayscheduler.h"
 
 // 前向声明
 // class CommandWindow; // 已移除独立窗口
@@ -78,6 +86,17 @@ public:
      */
     ~Dialog();
 
+    /**
+     * @brief 获取图像接收对象（用于启动参数配置共享内存导出等功能）
+     */
+    CTCPImg& tcpImg() { return m_tcpImg; }
+
+    /**
+     * @brief 设置图像显示帧率上限
+     * @param fps 帧率，0表示使用显示器刷新率（默认）
+     */
+    void setDisplayRateLimit(double fps);
+
 public slots:
     /**
      * @brief 显示图像标签的槽函数
@@ -92,10 +111,85 @@ public slots:
     /**
      * @brief 调试数据接收槽函数
      * @param data 原始数据
-     * @param formattedData 格式化后的数据
      * @param remoteAddress 远程地址
      */
-    void onDebugDataReceived(const QByteArray& data, const QString& formattedData, const QString& remoteAddress);
+    void onDebugPacketReceived(const QByteArray& data, const QString& remoteAddress);
+
+    /**
+     * @brief 收发记录批量插入后刷新界面
+     * @param added 本批插入的行数
+     */
+    void onDebugLogFlushed(int added);
+
+    /**
+     * @brief 显示选中记录的完整内容
+     */
+    void onDebugLogSelectionChanged();
+
+    /**
+     * @brief 服务器模式客户端统计更新：刷新统计和客户端列表
+     */
+    void onDebugClientStatsUpdated();
+
+    /**
+     * @brief 服务器模式查看的客户端变化
+     */
+    void onDebugClientViewChanged();
+
+    /**
+     * @brief 开始或停止流量发生器
+     */
+    void toggleTrafficGenerator();
+
+    /**
+     * @brief 流量发生器周期统计
+     * @param stats 统计
+     */
+    void onTrafficProgress(const CTrafficGenerator::Stats& stats);
+
+    /**
+     * @brief 流量发生器结束
+     * @param stats 最终统计
+     */
+    void onTrafficFinished(const CTrafficGenerator::Stats& stats);
+
+    /**
+     * @brief 开始或停止延迟探测
+     */
+    void toggleLatencyProbe();
+
+    /**
+     * @brief 延迟探测周期统计
+     * @param stats 统计
+     */
+    void onLatencyProbeUpdated(const CLatencyProbe::Stats& stats);
+
+    /**
+     * @brief 延迟探测结束
+     * @param stats 最终统计
+     */
+    void onLatencyProbeFinished(const CLatencyProbe::Stats& stats);
+
+    /**
+     * @brief 开始或停止抓包（写入 pcapng 文件）
+     */
+    void toggleCapture();
+
+    /**
+     * @brief 抓包文件写入失败
+     * @param message 错误信息
+     */
+    void onCaptureFailed(const QString& message);
+
+    /**
+     * @brief 导入 pcap/pcapng 文件到收发记录，或取消正在进行的导入
+     */
+    void toggleCaptureImport();
+
+    /**
+     * @brief 分时读取导入的抓包文件（每次最多 CAPTURE_IMPORT_SLICE_MS）
+     */
+    void onCaptureImportTick();
 
     /**
      * @brief 调试连接状态变化槽函数
@@ -177,6 +271,11 @@ private slots:
      */
     void toggleAutoReconnect(bool enabled);
 
+    /**
+     * @brief 切换接收停滞检测
+     */
+    void toggleStallDetection(bool enabled);
+
     /**
      * @brief 更新分辨率状态显示
      */
@@ -189,10 +288,9 @@ private slots:
     QLayout* createZoomControlPanel();
     
     /**
-     * @brief 更新图像显示
-     * @param pixmap 要显示的图像
+     * @brief 按当前缩放模式更新图像显示
      */
-    void updateImageDisplay(const QPixmap& pixmap);
+    void updateImageDisplay();
     
     /**
      * @brief 缩放图像到指定因子
@@ -326,6 +424,26 @@ private slots:
      */
     void showReceiveDataContextMenu(const QPoint& pos);
 
+    /**
+     * @brief 刷新工具栏上的延迟统计
+     */
+    void updateLatencyDisplay();
+
+    /**
+     * @brief 导出延迟统计到文件（CSV或JSON）
+     */
+    void exportLatencyStats();
+
+    /**
+     * @brief 刷新工具栏上的显示帧率和接收帧率
+     */
+    void updateDisplayRateLabel();
+
+    /**
+     * @brief 帧头携带的图像几何变化：同步分辨率输入框和状态
+     */
+    void onImageGeometryChanged(int width, int height, int channels);
+
 protected:
     /**
      * @brief 窗口大小调整事件
@@ -333,11 +451,18 @@ protected:
      */
     void resizeEvent(QResizeEvent* event) override;
 
+    /**
+     * @brief 事件过滤器
+     * 监视图像显示标签的绘制事件，记录绘制阶段和端到端延迟
+     */
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
 private:
+    static const int STALL_TIMEOUT_MS = 3000;   ///< 界面启用停滞检测时的无数据阈值（毫秒）
+
     // Ui::Dialog *ui;          ///< UI界面指针，已使用现代化界面替代
     CTCPImg m_tcpImg;        ///< TCP图像传输对象，处理网络通信和数据接收
-    char* m_showBuffer;      ///< 图像显示缓冲区，用于临时存储要显示的图像数据
-    QImage m_qimage;         ///< Qt图像对象，用于图像格式转换和显示处理
+    QImage m_qimage;         ///< 图像转换缓冲，与显示控件交换后复用上一帧的内存
 
     // 网络调试功能相关成员
     CTCPDebugger* m_tcpDebugger;        ///< TCP网络调试器对象
@@ -347,9 +472,16 @@ private:
     QWidget* m_commandTab;              ///< 指令调试标签页
     
     // 调试界面控件
-    QTextEdit* m_debugDataDisplay;      ///< 调试数据显示区域
+    CPacketLogModel* m_debugLogModel;   ///< 调试收发记录（有界，按需格式化）
+    QListView* m_debugLogView;          ///< 调试收发记录列表（只绘制可见行）
+    QPlainTextEdit* m_debugDetailView;  ///< 选中记录的完整内容
+    QCheckBox* m_debugAutoScrollCheckBox; ///< 自动滚动到最新记录
     QLineEdit* m_debugHostEdit;         ///< 调试主机地址输入
     QLineEdit* m_debugPortEdit;         ///< 调试端口输入
+    QComboBox* m_debugClientCombo;      ///< 服务器模式查看的客户端
+    static const int DEBUG_CLIENT_LIST_MAX = 200;                   ///< 客户端列表最多显示的客户端数
+    static constexpr quint64 DEBUG_CLIENT_VIEW_ALL = ~quint64(0);   ///< 客户端列表“全部客户端”项的数据
+    QSet<quint64> m_debugClientIds;     ///< 客户端列表对应的客户端集合
     QComboBox* m_dataFormatCombo;       ///< 数据格式选择
     QComboBox* m_localIPCombo;          ///< 本地IP地址选择
     QPushButton* m_refreshIPBtn;        ///< 刷新IP地址按钮
@@ -364,6 +496,40 @@ private:
     QLabel* m_debugStatsLabel;          ///< 调试统计信息标签
     QCheckBox* m_timestampCheckBox;     ///< 时间戳显示选择
     
+    // 流量发生器
+    CTrafficGenerator* m_trafficGenerator;  ///< 流量发生器（工作线程发送）
+    QComboBox* m_trafficPayloadCombo;   ///< 负载内容选择
+    QLineEdit* m_trafficPacketSizeEdit; ///< 包大小（字节）
+    QLineEdit* m_trafficRateEdit;       ///< 总速率（Mbps，0为不限速）
+    QLineEdit* m_trafficDurationEdit;   ///< 持续时间（秒，0为直到停止）
+    QLineEdit* m_trafficConnectionsEdit; ///< 并行连接数
+    QCheckBox* m_trafficFramedCheckBox; ///< 发送时加校验帧头
+    QCheckBox* m_trafficVerifyCheckBox; ///< 服务器模式校验收到的数据
+    QPushButton* m_trafficStartBtn;     ///< 开始/停止发送按钮
+    QLabel* m_trafficStatsLabel;        ///< 发生器统计
+    
+    // 延迟探测
+    QComboBox* m_probeModeCombo;        ///< 探测方式选择
+    QLineEdit* m_probeRequestEdit;      ///< 自定义请求（支持转义）
+    QLineEdit* m_probePatternEdit;      ///< 应答正则
+    QLineEdit* m_probeIntervalEdit;     ///< 发送间隔（毫秒）
+    QLineEdit* m_probeCountEdit;        ///< 请求总数（0为直到停止）
+    QLineEdit* m_probeTimeoutEdit;      ///< 应答超时（毫秒）
+    QLineEdit* m_probeInFlightEdit;     ///< 最多未应答请求数
+    QCheckBox* m_echoCheckBox;          ///< 回显模式
+    QPushButton* m_probeStartBtn;       ///< 开始/停止探测按钮
+    QLabel* m_probeStatsLabel;          ///< 探测统计
+    
+    // 抓包导出和导入
+    static const int CAPTURE_IMPORT_SLICE_MS = 20;  ///< 导入时每次占用界面线程的最长时间
+    QPushButton* m_captureBtn;          ///< 开始/停止抓包按钮
+    QPushButton* m_captureImportBtn;    ///< 导入/取消导入按钮
+    QLabel* m_captureStatusLabel;       ///< 抓包或导入状态
+    QTimer* m_captureImportTimer;       ///< 分时导入定时器
+    CPcapReader m_captureReader;        ///< 正在导入的抓包文件
+    qint64 m_captureImportPackets;      ///< 已导入的包数
+    qint64 m_captureImportBytes;        ///< 已导入的负载字节数
+    
     // 分辨率设置相关控件
     QLineEdit* m_widthEdit;             ///< 图像宽度输入框
     QLineEdit* m_heightEdit;            ///< 图像高度输入框
@@ -372,6 +538,7 @@ private:
     QPushButton* m_applyResolutionBtn;  ///< 应用分辨率按钮
     QPushButton* m_resetResolutionBtn;  ///< 重置分辨率按钮
     QLabel* m_resolutionStatusLabel;    ///< 分辨率状态标签
+    QCheckBox* m_autoGeometryCheckBox;  ///< 从帧头自动识别分辨率
     
     // 图像缩放相关控件
     QSlider* m_zoomSlider;              ///< 缩放滑块
@@ -380,12 +547,14 @@ private:
     QPushButton* m_actualSizeBtn;       ///< 实际大小按钮
     QPushButton* m_zoomInBtn;           ///< 放大按钮
     QPushButton* m_zoomOutBtn;          ///< 缩小按钮
+    QComboBox* m_scaleQualityCombo;     ///< 缩放质量选择
     QScrollArea* m_imageScrollArea;     ///< 图像滚动区域
-    QLabel* m_imageDisplayLabel;        ///< 图像显示标签（替代原来的labelShowImg）
+    CImageViewer* m_imageDisplayLabel;  ///< 图像显示控件（替代原来的labelShowImg，无图像时显示文本）
     
     // 重连控制相关控件
     QPushButton* m_reconnectBtn;        ///< 手动重连按钮
     QCheckBox* m_autoReconnectCheckBox; ///< 自动重连开关
+    QCheckBox* m_stallDetectCheckBox;   ///< 接收停滞检测开关
     QLabel* m_connectionStatusLabel;    ///< 连接状态标签
     QLabel* m_reconnectProgressLabel;   ///< 重连进度标签
     QProgressBar* m_reconnectProgressBar; ///< 重连进度条
@@ -395,11 +564,12 @@ private:
     // 现代化服务器连接控件
     QLineEdit* m_serverIPEdit;          ///< 服务器IP输入框
     QLineEdit* m_serverPortEdit;        ///< 服务器端口输入框
+    QLineEdit* m_backupEndpointsEdit;   ///< 备用端点输入框（IP:端口，逗号分隔）
+    QCheckBox* m_standbyCheckBox;       ///< 热备连接开关
     QPushButton* m_connectBtn;          ///< 连接按钮
 
     // 缩放相关变量
     double m_currentZoomFactor;         ///< 当前缩放因子
-    QPixmap m_originalPixmap;           ///< 原始图像像素图
     bool m_fitToWindow;                 ///< 是否适应窗口模式
     QTimer* m_resizeTimer;              ///< 用于窗口缩放防抖动的定时器
 
@@ -445,6 +615,21 @@ private:
     int m_commandCount;                 ///< 发送指令计数
     bool m_autoSwitchEnabled;           ///< 自动切换是否启用
     bool m_currentDisplayState;         ///< 当前显示状态 (true=开启, false=关闭)
+    CMetricsRegistry::Metric* m_metricSerialBytesReceived; ///< 串口接收字节数指标
+    CMetricsRegistry::Metric* m_metricSerialBytesSent;     ///< 串口发送字节数指标
+    CMetricsRegistry::Metric* m_metricSerialCommands;      ///< 串口发送指令数指标
+
+    // 端到端延迟统计
+    QLabel* m_latencyLabel;             ///< 工具栏延迟摘要标签
+    QPushButton* m_exportLatencyBtn;    ///< 导出延迟统计按钮
+    QTimer* m_latencyUpdateTimer;       ///< 延迟摘要刷新定时器
+    CFrameParser::FrameInfo m_pendingPaintInfo; ///< 已更新显示、等待绘制的帧
+    qint64 m_pendingDisplayNs;          ///< 该帧交给显示控件的时间（单调时钟纳秒）
+    bool m_latencyPaintPending;         ///< 是否有帧等待绘制
+
+    // 显示刷新调度
+    CDisplayScheduler* m_displayScheduler; ///< 按显示帧率上限合并刷新
+    QLabel* m_displayRateLabel;         ///< 工具栏显示/接收帧率标签
 
     /**
      * @brief 初始化调试界面
@@ -463,6 +648,29 @@ private:
      */
     QLayout* createDebugDataPanel();
 
+    /**
+     * @brief 创建流量发生器面板
+     * @return 面板布局
+     */
+    QLayout* createTrafficGeneratorPanel();
+
+    /**
+     * @brief 创建延迟探测面板
+     * @return 面板布局
+     */
+    QLayout* createLatencyProbePanel();
+
+    /**
+     * @brief 结束抓包文件导入
+     * @param reason 结束原因（为空表示正常读完）
+     */
+    void finishCaptureImport(const QString& reason = QString());
+
+    /**
+     * @brief 刷新抓包状态标签
+     */
+    void updateCaptureStatus();
+
     /**
      * @brief 创建指令调试标签页内容
      */
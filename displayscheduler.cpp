@@ -0,0 +1,181 @@
+#include "displayscheduler.h"
+#include <QGuiApplication>
+#include <QScreen>
+#include <QWindow>
+#include <QEvent>
+#include <QDebug>
+#include <cmath>
+
+// 无法获取显示器刷新率时使用的显示上限
+static const double FALLBACK_DISPLAY_FPS = 60.0;
+
+/**
+ * @brief CDisplayScheduler构造函数
+ * @param parent 父对象指针
+ */
+CDisplayScheduler::CDisplayScheduler(QObject *parent)
+    : QObject(parent)
+    , m_maxFps(0.0)
+    , m_pending(false)
+    , m_lastDisplayNs(-1000000000LL)  // 第一帧立即显示
+    , m_framesReceived(0)
+    , m_framesDisplayed(0)
+    , m_framesSkipped(0)
+    , m_rateReceived(0)
+    , m_rateDisplayed(0)
+    , m_receivedFps(0.0)
+    , m_displayedFps(0.0)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &CDisplayScheduler::onTimeout);
+
+    m_clock.start();
+    m_rateClock.start();
+
+    CMetricsRegistry& registry = CMetricsRegistry::instance();
+    m_metricDisplayed = registry.counter("tcpimg_display_frames_total", "界面实际显示的帧数");
+    m_metricSkipped = registry.counter("tcpimg_display_frames_skipped_total", "显示节流或界面不可见时被新帧覆盖的帧数");
+}
+
+/**
+ * @brief 设置可见性判断的目标控件
+ * @param widget 目标控件
+ */
+void CDisplayScheduler::setTargetWidget(QWidget *widget)
+{
+    if (m_target) {
+        m_target->removeEventFilter(this);
+        m_target->window()->removeEventFilter(this);
+    }
+
+    m_target = widget;
+    if (m_target) {
+        // 标签页切换回来时收到 Show，窗口还原时收到 WindowStateChange
+        m_target->installEventFilter(this);
+        m_target->window()->installEventFilter(this);
+    }
+}
+
+/**
+ * @brief 设置显示帧率上限
+ * @param fps 帧率，0表示使用显示器刷新率
+ */
+void CDisplayScheduler::setMaxFps(double fps)
+{
+    m_maxFps = qMax(0.0, fps);
+    qDebug() << QString("🖥️ 显示帧率上限：%1 FPS%2")
+                .arg(effectiveMaxFps(), 0, 'f', 1)
+                .arg(m_maxFps > 0 ? "" : "（显示器刷新率）");
+}
+
+/**
+ * @brief 实际使用的显示帧率上限
+ */
+double CDisplayScheduler::effectiveMaxFps() const
+{
+    if (m_maxFps > 0) {
+        return m_maxFps;
+    }
+
+    QScreen *screen = nullptr;
+    if (m_target && m_target->window()->windowHandle()) {
+        screen = m_target->window()->windowHandle()->screen();
+    }
+    if (!screen) {
+        screen = QGuiApplication::primaryScreen();
+    }
+
+    const double refreshRate = screen ? screen->refreshRate() : 0.0;
+    return refreshRate >= 1.0 ? refreshRate : FALLBACK_DISPLAY_FPS;
+}
+
+/**
+ * @brief 按上次调用以来的计数更新帧率
+ */
+void CDisplayScheduler::updateRates()
+{
+    const double seconds = qMax(m_rateClock.restart(), qint64(1)) / 1000.0;
+    m_receivedFps = (m_framesReceived - m_rateReceived) / seconds;
+    m_displayedFps = (m_framesDisplayed - m_rateDisplayed) / seconds;
+    m_rateReceived = m_framesReceived;
+    m_rateDisplayed = m_framesDisplayed;
+}
+
+/**
+ * @brief 收到新帧
+ */
+void CDisplayScheduler::frameReceived()
+{
+    m_framesReceived++;
+    if (m_pending) {
+        // 上一帧还没显示就被新帧覆盖
+        m_framesSkipped++;
+        m_metricSkipped->increment();
+    }
+    m_pending = true;
+    schedule();
+}
+
+/**
+ * @brief 有待显示的帧且目标可见时，立即显示或定时显示
+ */
+void CDisplayScheduler::schedule()
+{
+    if (!m_pending || m_timer.isActive() || !isTargetVisible()) {
+        return;
+    }
+
+    const qint64 intervalNs = qint64(1e9 / effectiveMaxFps());
+    const qint64 sinceLastNs = m_clock.nsecsElapsed() - m_lastDisplayNs;
+    if (sinceLastNs >= intervalNs) {
+        deliver();
+    } else {
+        m_timer.start(int(std::ceil((intervalNs - sinceLastNs) / 1e6)));
+    }
+}
+
+/**
+ * @brief 定时到点，显示最新帧
+ */
+void CDisplayScheduler::onTimeout()
+{
+    if (m_pending && isTargetVisible()) {
+        deliver();
+    }
+}
+
+/**
+ * @brief 发射显示信号
+ */
+void CDisplayScheduler::deliver()
+{
+    m_pending = false;
+    m_lastDisplayNs = m_clock.nsecsElapsed();
+    m_framesDisplayed++;
+    m_metricDisplayed->increment();
+    emit displayFrame();
+}
+
+/**
+ * @brief 目标控件是否可见且窗口未最小化
+ */
+bool CDisplayScheduler::isTargetVisible() const
+{
+    if (!m_target) {
+        return true;
+    }
+    return m_target->isVisible() && !(m_target->window()->windowState() & Qt::WindowMinimized);
+}
+
+/**
+ * @brief 目标重新可见时显示积压的最新帧
+ */
+bool CDisplayScheduler::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Show || event->type() == QEvent::WindowStateChange) {
+        // 事件处理完成后可见状态才更新，延后到下一轮事件循环再判断
+        QTimer::singleShot(0, this, &CDisplayScheduler::schedule);
+    }
+    return QObject::eventFilter(watched, event);
+}
@@ -0,0 +1,106 @@
+#ifndef DISPLAYSCHEDULER_H
+#define DISPLAYSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QWidget>
+#include "metricsregistry.h"
+
+/**
+ * @class CDisplayScheduler
+ * @brief 显示刷新调度器（接收帧率与显示帧率解耦）
+ *
+ * 每收到一帧调用 frameReceived()，调度器按显示上限合并刷新：
+ * - 距上次显示已超过一个显示间隔时立即发射 displayFrame，否则定时到点再发射，
+ *   期间到达的多帧只显示最新一帧（帧缓冲中总是最新帧）
+ * - 显示上限默认取显示器刷新率，也可手动设置
+ * - 目标控件不可见（切换到其他标签页）或窗口最小化时不发射，
+ *   重新可见时立即显示最新帧
+ * - 统计接收帧率和显示帧率
+ */
+class CDisplayScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CDisplayScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief 设置可见性判断的目标控件（如图像标签页）
+     */
+    void setTargetWidget(QWidget *widget);
+
+    /**
+     * @brief 设置显示帧率上限
+     * @param fps 帧率，0表示使用显示器刷新率
+     */
+    void setMaxFps(double fps);
+    double maxFps() const { return m_maxFps; }
+
+    /**
+     * @brief 实际使用的显示帧率上限
+     */
+    double effectiveMaxFps() const;
+
+    /**
+     * @brief 按上次调用以来的计数更新帧率（由界面按秒调用）
+     */
+    void updateRates();
+    double receivedFps() const { return m_receivedFps; }
+    double displayedFps() const { return m_displayedFps; }
+
+    qint64 framesReceived() const { return m_framesReceived; }
+    qint64 framesDisplayed() const { return m_framesDisplayed; }
+    qint64 framesSkipped() const { return m_framesSkipped; }
+
+public slots:
+    /**
+     * @brief 收到新帧
+     */
+    void frameReceived();
+
+signals:
+    /**
+     * @brief 需要显示最新帧
+     */
+    void displayFrame();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void onTimeout();
+
+private:
+    /**
+     * @brief 有待显示的帧且目标可见时，立即显示或定时显示
+     */
+    void schedule();
+    void deliver();
+    bool isTargetVisible() const;
+
+    QPointer<QWidget> m_target;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    double m_maxFps;
+    bool m_pending;             ///< 有未显示的新帧
+    qint64 m_lastDisplayNs;     ///< 上次显示时间（m_clock 纳秒）
+
+    qint64 m_framesReceived;
+    qint64 m_framesDisplayed;
+    qint64 m_framesSkipped;     ///< 被更新的帧覆盖而未显示的帧数
+
+    // 帧率统计
+    QElapsedTimer m_rateClock;
+    qint64 m_rateReceived;
+    qint64 m_rateDisplayed;
+    double m_receivedFps;
+    double m_displayedFps;
+
+    CMetricsRegistry::Metric* m_metricDisplayed;
+    CMetricsRegistry::Metric* m_metricSkipped;
+};
+
+#endif // DISPLAYSCHEDULER_H
@@ -0,0 +1,182 @@
+#include "framebuffer.h"
+#include <QDebug>
+#include <new>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief CFrameBuffer构造函数
+ */
+CFrameBuffer::CFrameBuffer()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_capacity(0)
+    , m_mappedSize(0)
+    , m_pageMode(PAGES_NONE)
+{
+}
+
+/**
+ * @brief CFrameBuffer析构函数
+ */
+CFrameBuffer::~CFrameBuffer()
+{
+    release();
+}
+
+/**
+ * @brief 分配缓冲区
+ * @param size 字节数
+ * @return 成功返回true
+ */
+bool CFrameBuffer::allocate(qint64 size)
+{
+    release();
+    if (size <= 0) {
+        return false;
+    }
+
+#ifdef Q_OS_UNIX
+    const qint64 pageSize = qMax<qint64>(4096, sysconf(_SC_PAGESIZE));
+    void *address = MAP_FAILED;
+
+#if defined(Q_OS_LINUX) && defined(MAP_HUGETLB)
+    // 预留大页：长度必须是大页的整数倍，池中没有空闲大页时映射失败
+    if (size >= HUGE_PAGE_SIZE) {
+        const qint64 hugeSize = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        address = mmap(nullptr, size_t(hugeSize), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (address != MAP_FAILED) {
+            m_mappedSize = hugeSize;
+            m_pageMode = PAGES_HUGETLB;
+        }
+    }
+#endif
+
+    if (address == MAP_FAILED) {
+        const qint64 mappedSize = (size + pageSize - 1) / pageSize * pageSize;
+        address = mmap(nullptr, size_t(mappedSize), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (address == MAP_FAILED) {
+            qDebug() << "❌ 帧缓冲映射失败：" << size << "字节";
+            m_pageMode = PAGES_NONE;
+            return false;
+        }
+        m_mappedSize = mappedSize;
+        m_pageMode = adviseHugePages(address, mappedSize) ? PAGES_TRANSPARENT : PAGES_NORMAL;
+    }
+
+    m_data = static_cast<char*>(address);
+#else
+    m_data = new (std::nothrow) char[size_t(size)]();
+    if (m_data == nullptr) {
+        qDebug() << "❌ 帧缓冲分配失败：" << size << "字节";
+        return false;
+    }
+    m_mappedSize = 0;
+    m_pageMode = PAGES_HEAP;
+#endif
+
+    m_size = size;
+    m_capacity = size;
+    return true;
+}
+
+/**
+ * @brief 调整为指定大小，同一容量档内复用原缓冲
+ * @param size 字节数
+ * @return 成功返回true
+ */
+bool CFrameBuffer::reserve(qint64 size)
+{
+    if (size <= 0) {
+        return false;
+    }
+
+    const qint64 wanted = sizeClass(size);
+    if (m_data != nullptr && m_capacity >= size && m_capacity <= 2 * wanted) {
+        m_size = size;
+        return true;
+    }
+
+    if (!allocate(wanted)) {
+        return false;
+    }
+    m_size = size;
+    return true;
+}
+
+/**
+ * @brief 释放缓冲区
+ */
+void CFrameBuffer::release()
+{
+    if (m_data != nullptr) {
+#ifdef Q_OS_UNIX
+        munmap(m_data, size_t(m_mappedSize));
+#else
+        delete[] m_data;
+#endif
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_capacity = 0;
+    m_mappedSize = 0;
+    m_pageMode = PAGES_NONE;
+}
+
+/**
+ * @brief 分页方式名称
+ */
+QString CFrameBuffer::pageModeName(PageMode mode)
+{
+    switch (mode) {
+    case PAGES_HEAP:        return "堆内存";
+    case PAGES_NORMAL:      return "普通页";
+    case PAGES_TRANSPARENT: return "透明大页";
+    case PAGES_HUGETLB:     return "预留大页";
+    default:                return "未分配";
+    }
+}
+
+/**
+ * @brief 建议内核对已分配的内存使用透明大页
+ */
+bool CFrameBuffer::adviseHugePages(void *address, qint64 size)
+{
+#if defined(Q_OS_LINUX) && defined(MADV_HUGEPAGE)
+    // madvise 要求起始地址按页对齐，只取其中按大页对齐的部分
+    const quintptr begin = (quintptr(address) + HUGE_PAGE_SIZE - 1) & ~quintptr(HUGE_PAGE_SIZE - 1);
+    const quintptr end = (quintptr(address) + quintptr(size)) & ~quintptr(HUGE_PAGE_SIZE - 1);
+    if (address == nullptr || end <= begin) {
+        return false;
+    }
+    return madvise(reinterpret_cast<void*>(begin), size_t(end - begin), MADV_HUGEPAGE) == 0;
+#else
+    Q_UNUSED(address);
+    Q_UNUSED(size);
+    return false;
+#endif
+}
+
+/**
+ * @brief 容量档位
+ */
+qint64 CFrameBuffer::sizeClass(qint64 size)
+{
+    if (size <= MIN_SIZE_CLASS) {
+        return MIN_SIZE_CLASS;
+    }
+
+    // 2^bits < size <= 2^(bits+1)，区间内按 2^bits / 4 取整
+    int bits = 0;
+    while ((qint64(1) << (bits + 1)) < size) {
+        ++bits;
+    }
+    const qint64 step = qint64(1) << (bits - 2);
+    return (size + step - 1) / step * step;
+}
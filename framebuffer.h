@@ -0,0 +1,97 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <QtGlobal>
+#include <QString>
+
+/**
+ * @class CFrameBuffer
+ * @brief 大帧缓冲区（mmap分配，优先使用大页）
+ *
+ * 几百MB的帧缓冲按4KB页映射时，整帧拷贝和扫描会产生大量TLB缺失。
+ * Linux下依次尝试：
+ * 1. MAP_HUGETLB：预留的大页（需配置 vm.nr_hugepages，通常不可用）
+ * 2. 普通匿名映射 + madvise(MADV_HUGEPAGE)：透明大页（THP为madvise或always模式时生效）
+ * 其他Unix平台使用普通匿名映射，非Unix平台退回 new[]。
+ *
+ * 匿名映射的内存已清零，且在首次访问时才真正分配物理页。
+ *
+ * reserve 按 sizeClass 分档分配容量：帧大小在同一档内变化（或来回切换）时复用原映射，
+ * 只有跨档时才重新分配。
+ */
+class CFrameBuffer
+{
+public:
+    /**
+     * @enum PageMode
+     * @brief 实际使用的分页方式
+     */
+    enum PageMode {
+        PAGES_NONE,         ///< 未分配
+        PAGES_HEAP,         ///< 堆内存（new[]）
+        PAGES_NORMAL,       ///< 普通页映射
+        PAGES_TRANSPARENT,  ///< 透明大页（madvise）
+        PAGES_HUGETLB       ///< 预留大页
+    };
+
+    static const qint64 HUGE_PAGE_SIZE = 2 * 1024 * 1024;  ///< 大页大小（x86-64默认2MB）
+    static const qint64 MIN_SIZE_CLASS = 64 * 1024;         ///< 最小容量档
+
+    CFrameBuffer();
+    ~CFrameBuffer();
+
+    /**
+     * @brief 分配缓冲区（释放原有缓冲），内容为0
+     * @param size 字节数
+     * @return 分配失败返回false，此时缓冲区为空
+     */
+    bool allocate(qint64 size);
+
+    /**
+     * @brief 调整为指定大小，容量足够且不超过所需档位两倍时复用原缓冲（内容保留）
+     * @param size 字节数
+     * @return 需要重新分配且分配失败时返回false，此时缓冲区为空
+     */
+    bool reserve(qint64 size);
+
+    /**
+     * @brief 释放缓冲区
+     */
+    void release();
+
+    char* data() const { return m_data; }
+    qint64 size() const { return m_size; }
+    qint64 capacity() const { return m_capacity; }
+    bool isNull() const { return m_data == nullptr; }
+    PageMode pageMode() const { return m_pageMode; }
+
+    /**
+     * @brief 分页方式名称（日志用）
+     */
+    static QString pageModeName(PageMode mode);
+
+    /**
+     * @brief 建议内核对已分配的内存使用透明大页
+     *
+     * 用于不由本类分配的大缓冲（如解析器的组帧缓冲）：只对其中按大页对齐的部分生效，
+     * 不足一个大页或非Linux平台时什么也不做。
+     * @return madvise 成功返回true
+     */
+    static bool adviseHugePages(void *address, qint64 size);
+
+    /**
+     * @brief 容量档位：不小于size的最小档，每个2的幂区间分4档，浪费不超过25%
+     */
+    static qint64 sizeClass(qint64 size);
+
+private:
+    Q_DISABLE_COPY(CFrameBuffer)
+
+    char *m_data;
+    qint64 m_size;
+    qint64 m_capacity;      ///< 可用字节数（>= m_size）
+    qint64 m_mappedSize;    ///< 映射长度（按页或大页向上取整），堆内存时为0
+    PageMode m_pageMode;
+};
+
+#endif // FRAMEBUFFER_H
@@ -0,0 +1,554 @@
+#include "frameparser.h"
+#include "framebuffer.h"
+#include <QDebug>
+#include <cstring>
+#include <limits>
+
+/**
+ * @brief CFrameParser构造函数
+ * @param parent 父对象指针
+ */
+CFrameParser::CFrameParser(QObject *parent)
+    : QObject(parent)
+    , m_expectedSize(0)
+    , m_protocol(PROTOCOL_AUTO)
+    , m_protocolLock(PROTOCOL_AUTO)
+    , m_autoGeometry(true)
+    , m_invalidGeometryLogged(false)
+    , m_state(STATE_BOUNDARY)
+    , m_headerFill(0)
+    , m_headerTarget(FrameProtocol::LEGACY_HEADER_SIZE)
+    , m_inResync(false)
+    , m_payloadFilled(0)
+    , m_payloadTarget(0)
+    , m_skipRemaining(0)
+    , m_skipPayloadSize(0)
+    , m_framesCompleted(0)
+    , m_framesDropped(0)
+    , m_resyncCount(0)
+    , m_droppedBytes(0)
+    , m_bytesConsumed(0)
+    , m_heartbeatsReceived(0)
+{
+}
+
+/**
+ * @brief 设置期望的单帧图像数据大小
+ * @param size 字节数，必须大于0
+ *
+ * 大小变化时丢弃正在组装的帧并重新识别协议
+ */
+void CFrameParser::setExpectedPayloadSize(qint64 size)
+{
+    if (size <= 0 || size == m_expectedSize) {
+        return;
+    }
+    if (size > FrameProtocol::MAX_PAYLOAD_SIZE) {
+        qDebug() << "❌ 单帧大小" << size << "字节超过上限" << FrameProtocol::MAX_PAYLOAD_SIZE << "字节，保持原设置";
+        return;
+    }
+
+    m_expectedSize = int(size);
+    reset();
+}
+
+/**
+ * @brief 固定协议
+ * @param mode 协议，PROTOCOL_AUTO 表示自动识别
+ */
+void CFrameParser::setProtocolLock(ProtocolMode mode)
+{
+    m_protocolLock = mode;
+    reset();
+}
+
+/**
+ * @brief 清除解析状态和协议锁定（固定协议时恢复为固定协议）
+ */
+void CFrameParser::reset()
+{
+    m_state = STATE_BOUNDARY;
+    m_protocol = m_protocolLock;
+    m_headerFill = 0;
+    m_headerTarget = FrameProtocol::LEGACY_HEADER_SIZE;
+    m_inResync = false;
+    m_payloadFilled = 0;
+    m_payloadTarget = 0;
+    m_skipRemaining = 0;
+    m_skipPayloadSize = 0;
+    m_sizeDigits.clear();
+    m_assemblyInfo = FrameInfo();
+}
+
+/**
+ * @brief 从数据流中间开始接收
+ */
+void CFrameParser::resynchronize()
+{
+    const ProtocolMode protocol = m_protocol;
+    reset();
+    if (protocol == PROTOCOL_HEADER) {
+        // 主动切换不计入失步次数
+        m_protocol = PROTOCOL_HEADER;
+        m_inResync = true;
+        m_state = STATE_RESYNC;
+    }
+}
+
+/**
+ * @brief 清零统计计数
+ */
+void CFrameParser::resetStatistics()
+{
+    m_framesCompleted = 0;
+    m_framesDropped = 0;
+    m_resyncCount = 0;
+    m_droppedBytes = 0;
+    m_bytesConsumed = 0;
+    m_heartbeatsReceived = 0;
+}
+
+/**
+ * @brief 输入一段字节流并切分帧
+ * @param data 数据指针
+ * @param size 字节数
+ */
+void CFrameParser::feed(const char *data, qint64 size)
+{
+    if (size <= 0) {
+        return;
+    }
+
+    m_bytesConsumed += size;
+
+    if (m_expectedSize <= 0) {
+        m_droppedBytes += size;
+        return;
+    }
+
+    const char *p = data;
+    const char *end = data + size;
+
+    // 本段数据到达的时间，第一次需要时才读取时钟
+    qint64 arrivalNs = 0;
+    qint64 arrivalWallUs = 0;
+
+    while (p < end) {
+        switch (m_state) {
+        case STATE_PAYLOAD: {
+            // 图像数据直接拷贝到组帧缓冲；旧版帧头声明的数据比期望大小多出的部分丢弃
+            const qint64 n = qMin<qint64>(m_payloadTarget - m_payloadFilled, end - p);
+            const qint64 keep = qBound<qint64>(0, m_expectedSize - m_payloadFilled, n);
+            memcpy(m_assembly.data() + m_payloadFilled, p, size_t(keep));
+            m_droppedBytes += n - keep;
+            m_payloadFilled += int(n);
+            p += n;
+            if (m_payloadFilled == m_payloadTarget) {
+                completeFrame();
+            }
+            break;
+        }
+
+        case STATE_SKIP: {
+            const qint64 n = qMin<qint64>(m_skipRemaining, end - p);
+            m_skipRemaining -= n;
+            m_droppedBytes += n;
+            p += n;
+            if (m_skipRemaining == 0) {
+                m_state = STATE_BOUNDARY;
+                m_framesDropped++;
+                emit frameDropped(m_skipPayloadSize);
+            }
+            break;
+        }
+
+        case STATE_RESYNC: {
+            // 查找 7E 7E；数据末尾的单个 7E 交给帧边界暂存，与下一段数据一起判断
+            const char *scan = p;
+            const char *sync = nullptr;
+            while (scan < end) {
+                const char *hit = static_cast<const char*>(
+                    memchr(scan, FrameProtocol::SYNC_BYTE, size_t(end - scan)));
+                if (!hit) {
+                    break;
+                }
+                if (hit + 1 == end || static_cast<unsigned char>(hit[1]) == FrameProtocol::SYNC_BYTE) {
+                    sync = hit;
+                    break;
+                }
+                scan = hit + 1;
+            }
+
+            const char *stop = sync ? sync : end;
+            m_droppedBytes += stop - p;
+            p = stop;
+            if (sync) {
+                m_state = STATE_BOUNDARY;
+            }
+            break;
+        }
+
+        case STATE_SIZE_COMMAND:
+            // 数字可能分多段到达，遇到非数字字节或位数已满时才结束指令
+            while (p < end && *p >= '0' && *p <= '9' && m_sizeDigits.size() < SIZE_COMMAND_MAX_DIGITS) {
+                m_sizeDigits.append(*p++);
+            }
+            if (p < end || m_sizeDigits.size() >= SIZE_COMMAND_MAX_DIGITS) {
+                // 紧随数字的回车换行是指令结束符，不计入后续数据
+                while (p < end && (*p == '\r' || *p == '\n')) {
+                    ++p;
+                }
+                finishSizeCommand();
+            }
+            break;
+
+        case STATE_BOUNDARY:
+        default: {
+            if (m_headerFill == 0) {
+                // 新一帧的第一个字节
+                if (arrivalNs == 0) {
+                    arrivalNs = FrameProtocol::monotonicNanos();
+                    arrivalWallUs = FrameProtocol::wallClockMicros();
+                }
+                m_assemblyInfo = FrameInfo();
+                m_assemblyInfo.firstByteNs = arrivalNs;
+                m_assemblyInfo.firstByteWallUs = arrivalWallUs;
+            }
+
+            const qint64 n = qMin<qint64>(m_headerTarget - m_headerFill, end - p);
+            memcpy(m_header + m_headerFill, p, size_t(n));
+            m_headerFill += int(n);
+            p += n;
+            if (m_headerFill == m_headerTarget) {
+                processBoundary();
+            }
+            break;
+        }
+        }
+    }
+}
+
+/**
+ * @brief 结束未收到结束符的size=指令
+ */
+void CFrameParser::flushSizeCommand()
+{
+    if (m_state == STATE_SIZE_COMMAND) {
+        finishSizeCommand();
+    }
+}
+
+/**
+ * @brief 根据帧边界暂存的6个字节判断协议并进入下一状态
+ */
+void CFrameParser::processBoundary()
+{
+    if (m_headerTarget > FrameProtocol::LEGACY_HEADER_SIZE) {
+        processExtendedHeader();
+        return;
+    }
+
+    const QByteArray prefix = FrameProtocol::sizeCommandPrefix();
+
+    // size=N 指令
+    if (memcmp(m_header, prefix.constData(), size_t(prefix.size())) == 0) {
+        m_sizeDigits.clear();
+        const char next = m_header[prefix.size()];
+        m_headerFill = 0;
+        m_state = STATE_SIZE_COMMAND;
+        if (next >= '0' && next <= '9') {
+            m_sizeDigits.append(next);
+        } else {
+            finishSizeCommand();
+        }
+        return;
+    }
+
+    // 自动识别时以是否出现同步头确定协议；已锁定为原始数据后不再检查，
+    // 避免图像内容恰好以 7E 7E 开头时误判为帧头
+    const bool checkSync = (m_protocol != PROTOCOL_RAW);
+
+    // 扩展帧头：按帧头中的长度字段继续暂存
+    if (checkSync && FrameProtocol::hasExtendedMagic(m_header, m_headerFill)) {
+        const int headerSize = (static_cast<unsigned char>(m_header[4]) << 8)
+                             | static_cast<unsigned char>(m_header[5]);
+        if (headerSize >= FrameProtocol::EXT_HEADER_MIN_SIZE && headerSize <= FrameProtocol::MAX_HEADER_SIZE) {
+            m_protocol = PROTOCOL_HEADER;
+            m_headerTarget = headerSize;
+            return;
+        }
+
+        // 长度字段无效：视为失步，从同步头之后继续查找
+        m_protocol = PROTOCOL_HEADER;
+        if (!m_inResync) {
+            m_inResync = true;
+            m_resyncCount++;
+            qDebug() << QString("⚠️ 帧解析：扩展帧头长度%1无效，开始重同步").arg(headerSize);
+        }
+        dropStagedBytes(2);
+        return;
+    }
+
+    if (checkSync && FrameProtocol::hasSync(m_header, m_headerFill)) {
+        if (m_inResync) {
+            qDebug() << "🔗 帧解析：重新找到帧头，恢复同步";
+            m_inResync = false;
+        }
+        m_protocol = PROTOCOL_HEADER;
+
+        const int frameSize = parseFrameSize(m_header, m_expectedSize);
+        const int payloadSize = frameSize - FrameProtocol::LEGACY_HEADER_SIZE;
+        m_headerFill = 0;
+
+        if (payloadSize == m_expectedSize) {
+            beginPayload(0);
+        } else if (payloadSize > 0 && payloadSize >= m_expectedSize - FrameProtocol::LEGACY_HEADER_SIZE
+                   && payloadSize <= m_expectedSize + LEGACY_SIZE_TOLERANCE) {
+            // 旧版发送端的16位长度与期望大小相近：按声明长度接收，不足补零、多余截断
+            // （原接收逻辑按声明长度读取后丢弃大小不符的帧，这里改为接收，见 parseFrameSize）
+            qDebug() << QString("🔧 帧解析：帧头声明数据大小%1，期望%2，按期望大小补齐/截断")
+                        .arg(payloadSize).arg(m_expectedSize);
+            beginPayload(0, payloadSize);
+        } else {
+            qDebug() << QString("❌ 帧解析：帧头声明数据大小%1，期望%2，丢弃该帧")
+                        .arg(payloadSize).arg(m_expectedSize);
+            beginSkip(payloadSize);
+        }
+        return;
+    }
+
+    if (m_protocol == PROTOCOL_HEADER) {
+        // 帧头模式下帧边界不是同步头：失步，开始重同步
+        if (!m_inResync) {
+            m_inResync = true;
+            m_resyncCount++;
+            qDebug() << "⚠️ 帧解析：帧边界未找到 7E 7E，开始重同步";
+        }
+
+        for (int i = 1; i < m_headerFill - 1; ++i) {
+            if (FrameProtocol::hasSync(m_header + i, m_headerFill - i)) {
+                dropStagedBytes(i);
+                return;
+            }
+        }
+
+        if (static_cast<unsigned char>(m_header[m_headerFill - 1]) == FrameProtocol::SYNC_BYTE) {
+            dropStagedBytes(m_headerFill - 1);
+        } else {
+            dropStagedBytes(m_headerFill);
+            m_state = STATE_RESYNC;
+        }
+        return;
+    }
+
+    // 原始数据：暂存的字节就是图像数据的开头
+    m_protocol = PROTOCOL_RAW;
+    beginPayload(m_headerFill);
+}
+
+/**
+ * @brief 扩展帧头暂存完成：读取帧序号、时间戳和负载长度
+ */
+void CFrameParser::processExtendedHeader()
+{
+    FrameProtocol::ExtendedHeader header;
+    const bool valid = FrameProtocol::readExtendedHeader(m_header, m_headerFill, header);
+    m_headerFill = 0;
+    m_headerTarget = FrameProtocol::LEGACY_HEADER_SIZE;
+
+    if (m_inResync) {
+        qDebug() << "🔗 帧解析：重新找到帧头，恢复同步";
+        m_inResync = false;
+    }
+
+    if (!valid) {
+        // processBoundary 已检查过标识和长度，这里不应失败
+        m_state = STATE_BOUNDARY;
+        return;
+    }
+
+    // 只有帧头没有负载：心跳，留在帧边界等待下一帧
+    if (header.payloadSize == 0) {
+        m_heartbeatsReceived++;
+        m_state = STATE_BOUNDARY;
+        emit heartbeatReceived(header.sequence, header.timestampUs);
+        return;
+    }
+
+    m_assemblyInfo.hasExtendedHeader = true;
+    m_assemblyInfo.sequence = header.sequence;
+    m_assemblyInfo.senderTimestampUs = header.timestampUs;
+    if (header.hasUsableGeometry()) {
+        m_assemblyInfo.width = int(header.width);
+        m_assemblyInfo.height = int(header.height);
+        m_assemblyInfo.channels = int(header.channels);
+    } else if (header.hasGeometry() && !m_invalidGeometryLogged) {
+        // 超出范围的几何不采用，保持当前分辨率（只提示一次）
+        m_invalidGeometryLogged = true;
+        qDebug() << QString("⚠️ 帧解析：帧头几何 %1×%2×%3 超出支持范围（宽高1-%4，通道1-%5），忽略几何信息")
+                    .arg(header.width).arg(header.height).arg(header.channels)
+                    .arg(FrameProtocol::MAX_IMAGE_DIMENSION).arg(FrameProtocol::MAX_IMAGE_CHANNELS);
+    }
+
+    if (header.payloadSize == quint64(m_expectedSize)) {
+        beginPayload(0);
+    } else if (m_autoGeometry && header.hasUsableGeometry()) {
+        // 帧头自带几何：直接采用新大小，组帧缓冲按容量分档复用
+        qDebug() << QString("📐 帧解析：帧头几何 %1×%2×%3，单帧大小 %4 → %5 字节")
+                    .arg(header.width).arg(header.height).arg(header.channels)
+                    .arg(m_expectedSize).arg(header.payloadSize);
+        m_expectedSize = int(header.payloadSize);
+        beginPayload(0);
+    } else {
+        qDebug() << QString("❌ 帧解析：扩展帧头声明数据大小%1，期望%2，丢弃该帧（序号%3）")
+                    .arg(header.payloadSize).arg(m_expectedSize).arg(header.sequence);
+        beginSkip(qint64(qMin<quint64>(header.payloadSize, quint64(std::numeric_limits<qint64>::max()))));
+    }
+}
+
+/**
+ * @brief 丢弃一帧声明大小与期望不符的数据
+ * @param payloadSize 帧头声明的数据大小
+ */
+void CFrameParser::beginSkip(qint64 payloadSize)
+{
+    m_skipPayloadSize = int(qBound<qint64>(0, payloadSize, std::numeric_limits<int>::max()));
+    m_skipRemaining = qMax<qint64>(0, payloadSize);
+    m_state = STATE_SKIP;
+    if (m_skipRemaining == 0) {
+        m_state = STATE_BOUNDARY;
+        m_framesDropped++;
+        emit frameDropped(m_skipPayloadSize);
+    }
+}
+
+/**
+ * @brief 开始接收一帧图像数据
+ * @param alreadyStaged 帧边界暂存区中属于本帧数据的字节数
+ * @param streamSize 流中属于本帧的数据字节数，0表示等于期望大小
+ */
+void CFrameParser::beginPayload(int alreadyStaged, int streamSize)
+{
+    m_payloadTarget = streamSize > 0 ? streamSize : m_expectedSize;
+
+    // 接收方（如转发队列）仍持有上一帧缓冲时直接换一块新内存，
+    // 避免写时复制把即将被覆盖的旧数据整帧拷贝一遍
+    // 容量按档分配：帧大小在当前档内变化时只调整大小，不重新分配
+    const qint64 sizeClass = qMin(CFrameBuffer::sizeClass(m_expectedSize), FrameProtocol::MAX_PAYLOAD_SIZE);
+    if (!m_assembly.isDetached() || m_assembly.capacity() < m_expectedSize
+        || m_assembly.capacity() > 2 * sizeClass) {
+        m_assembly = QByteArray();
+        m_assembly.reserve(int(sizeClass));
+        // 大帧组帧缓冲建议使用透明大页，减少整帧写入和拷贝时的TLB缺失
+        CFrameBuffer::adviseHugePages(m_assembly.data(), m_assembly.capacity());
+    }
+    m_assembly.resize(m_expectedSize);
+
+    const int take = qMin(alreadyStaged, m_expectedSize);
+    if (take > 0) {
+        memcpy(m_assembly.data(), m_header, size_t(take));
+        memmove(m_header, m_header + take, size_t(m_headerFill - take));
+        m_headerFill -= take;
+    }
+
+    m_payloadFilled = take;
+    m_state = STATE_PAYLOAD;
+
+    if (m_payloadFilled == m_payloadTarget) {
+        completeFrame();
+    }
+}
+
+/**
+ * @brief 完成一帧：交换组帧缓冲和输出缓冲，发射 frameReady
+ */
+void CFrameParser::completeFrame()
+{
+    // 声明的数据比期望大小少：剩余部分补零
+    if (m_payloadFilled < m_expectedSize) {
+        memset(m_assembly.data() + m_payloadFilled, 0, size_t(m_expectedSize - m_payloadFilled));
+    }
+
+    m_completed.swap(m_assembly);
+    m_completedInfo = m_assemblyInfo;
+    m_completedInfo.completeNs = FrameProtocol::monotonicNanos();
+    m_payloadFilled = 0;
+    m_state = STATE_BOUNDARY;
+    m_framesCompleted++;
+
+    emit frameReady(m_completed, m_completedInfo);
+}
+
+/**
+ * @brief 结束size=指令并更新期望大小
+ */
+void CFrameParser::finishSizeCommand()
+{
+    bool ok = false;
+    const int size = m_sizeDigits.toInt(&ok);
+    m_sizeDigits.clear();
+    m_state = STATE_BOUNDARY;
+
+    if (!ok || size <= 0 || size > FrameProtocol::MAX_PAYLOAD_SIZE) {
+        qDebug() << "⚠️ 帧解析：无效的size=指令";
+        return;
+    }
+
+    m_expectedSize = size;
+    m_payloadFilled = 0;
+    emit sizeCommandReceived(size);
+}
+
+/**
+ * @brief 从帧边界暂存区头部丢弃字节
+ * @param count 丢弃的字节数
+ */
+void CFrameParser::dropStagedBytes(int count)
+{
+    count = qBound(0, count, m_headerFill);
+    memmove(m_header, m_header + count, size_t(m_headerFill - count));
+    m_headerFill -= count;
+    m_droppedBytes += count;
+}
+
+/**
+ * @brief 从6字节帧头推断整帧大小（含帧头）
+ * @param header 帧头数据
+ * @param expectedPayloadSize 期望的图像数据大小
+ * @return 整帧字节数
+ */
+int CFrameParser::parseFrameSize(const char *header, int expectedPayloadSize)
+{
+    const unsigned char *h = reinterpret_cast<const unsigned char*>(header);
+    const int headerSize = FrameProtocol::LEGACY_HEADER_SIZE;
+
+    // 字节2-5：大端序32位负载长度（tcpimg-sender 及新版发送端）
+    const quint32 payload32 = (quint32(h[2]) << 24) | (quint32(h[3]) << 16)
+                            | (quint32(h[4]) << 8) | quint32(h[5]);
+    if (payload32 == quint32(expectedPayloadSize)) {
+        return expectedPayloadSize + headerSize;
+    }
+
+    // 旧版发送端的16位长度字段：方案1 byte4-5大端，方案2 byte2-3大端，方案3 byte4-5小端
+    const int candidates[3] = {
+        (h[4] << 8) | h[5],
+        (h[2] << 8) | h[3],
+        (h[5] << 8) | h[4]
+    };
+
+    // 16位字段恰好等于期望大小：发送端写的是负载长度而不是整帧长度
+    for (int i = 0; i < 3; ++i) {
+        if (candidates[i] == expectedPayloadSize) {
+            return expectedPayloadSize + headerSize;
+        }
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        if (candidates[i] > expectedPayloadSize && candidates[i] <= expectedPayloadSize + LEGACY_SIZE_TOLERANCE) {
+            return candidates[i];
+        }
+    }
+
+    // 方案4：使用预设的图像大小
+    return expectedPayloadSize + headerSize;
+}
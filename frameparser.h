@@ -0,0 +1,252 @@
+#ifndef FRAMEPARSER_H
+#define FRAMEPARSER_H
+
+#include <QObject>
+#include <QByteArray>
+#include "frameprotocol.h"
+
+/**
+ * @class CFrameParser
+ * @brief 图像数据流解析器
+ *
+ * 从TCP字节流中切分出完整图像帧，与网络层解耦，便于复用和性能测试。
+ * 支持三种协议（见 frameprotocol.h）：
+ * - 原始数据：每 expectedPayloadSize 字节为一帧
+ * - 7E 7E 帧头：6字节帧头 + 图像数据，帧大小由 parseFrameSize 推断
+ * - 扩展帧头：7E 7E A5 5A 开头的变长帧头，携带帧序号和发送时间戳；
+ *   版本2帧头还携带图像几何，开启 setAutoGeometry 时按帧头切换期望大小，无需预先配置分辨率
+ * - size=指令：在帧边界收到 "size=N" 时更新期望大小；指令在第一个非数字字节处结束，
+ *   发送端发完指令即等待应答时由接收方调用 flushSizeCommand 结束
+ * - 心跳：负载为0的扩展帧头，发射 heartbeatReceived，不计入帧
+ *
+ * 协议在复位后的第一帧自动识别并锁定；帧头模式下帧边界未出现 7E 7E 时
+ * 进入重同步，丢弃字节直到找到下一个同步头。
+ *
+ * 图像数据直接从输入拷贝到组帧缓冲，整帧完成后与输出缓冲交换，
+ * 稳定运行时不再分配内存。组帧缓冲按 CFrameBuffer::sizeClass 分档预留容量，
+ * 帧大小在同一档内变化时也不重新分配。
+ *
+ * 每帧记录收到第一个字节和组帧完成的时间（见 FrameInfo），用于端到端延迟统计；
+ * 时钟在每次 feed 中最多读取一次，不在逐字节路径上计时。
+ */
+class CFrameParser : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum ProtocolMode
+     * @brief 当前锁定的协议
+     */
+    enum ProtocolMode {
+        PROTOCOL_AUTO,      ///< 未锁定，下一帧自动识别
+        PROTOCOL_RAW,       ///< 原始数据（无帧头）
+        PROTOCOL_HEADER     ///< 7E 7E 帧头（含扩展帧头）
+    };
+
+    /**
+     * @struct FrameInfo
+     * @brief 帧的元数据和接收时间戳
+     */
+    struct FrameInfo
+    {
+        bool hasExtendedHeader = false; ///< 是否为扩展帧头（以下两个字段仅此时有效）
+        quint64 sequence = 0;           ///< 发送端帧序号
+        qint64 senderTimestampUs = 0;   ///< 发送时间戳（Unix纪元微秒）
+        qint64 firstByteNs = 0;         ///< 收到第一个字节的单调时钟时间（纳秒）
+        qint64 firstByteWallUs = 0;     ///< 收到第一个字节的墙上时间（Unix纪元微秒）
+        qint64 completeNs = 0;          ///< 组帧完成的单调时钟时间（纳秒）
+        int width = 0;                  ///< 帧头携带的图像几何（版本2扩展帧头），没有时为0
+        int height = 0;
+        int channels = 0;
+
+        bool hasGeometry() const { return width > 0 && height > 0 && channels > 0; }
+    };
+
+    explicit CFrameParser(QObject *parent = nullptr);
+
+    /**
+     * @brief 设置期望的单帧图像数据大小（字节），超过 FrameProtocol::MAX_PAYLOAD_SIZE 时忽略
+     */
+    void setExpectedPayloadSize(qint64 size);
+    qint64 expectedPayloadSize() const { return m_expectedSize; }
+
+    /**
+     * @brief 清除解析状态和自动识别的协议（保留期望大小、固定协议和统计）
+     * 用于重新连接或分辨率变化后
+     */
+    void reset();
+
+    /**
+     * @brief 从数据流中间开始接收（如切换到已连接的备用链路）
+     *
+     * 当前协议为帧头模式时丢弃未完成的帧，从下一个 7E 7E 同步头开始组帧；
+     * 原始数据没有帧边界标记，等同于 reset()
+     */
+    void resynchronize();
+
+    /**
+     * @brief 清零统计计数
+     */
+    void resetStatistics();
+
+    /**
+     * @brief 输入一段字节流
+     * @param data 数据指针
+     * @param size 字节数
+     *
+     * 每解析出一帧同步发射 frameReady 或 frameDropped
+     */
+    void feed(const char *data, qint64 size);
+    void feed(const QByteArray &data) { feed(data.constData(), data.size()); }
+
+    /**
+     * @brief 结束尚未遇到结束符的size=指令
+     *
+     * "size=N" 没有固定的结束符，数字可能分在两次读取中，不能以数据段结尾作为指令结束；
+     * 发送端发完指令后等待 "OK" 不再发送数据，接收方在短暂空闲后调用本函数结束指令
+     */
+    void flushSizeCommand();
+    bool sizeCommandPending() const { return m_state == STATE_SIZE_COMMAND; }
+
+    /**
+     * @brief 最近一次完成的帧数据
+     */
+    const QByteArray& frame() const { return m_completed; }
+
+    /**
+     * @brief 最近一次完成的帧的元数据
+     */
+    const FrameInfo& frameInfo() const { return m_completedInfo; }
+
+    ProtocolMode protocolMode() const { return m_protocol; }
+
+    /**
+     * @brief 固定协议，不再自动识别
+     * @param mode PROTOCOL_AUTO 恢复自动识别；PROTOCOL_RAW 时图像内容以 7E 7E 开头也不会误判为帧头
+     *
+     * 立即重置解析状态，reset() 之后仍保持该协议
+     */
+    void setProtocolLock(ProtocolMode mode);
+    ProtocolMode protocolLock() const { return m_protocolLock; }
+
+    /**
+     * @brief 是否按扩展帧头中的图像几何自动切换期望大小（默认开启）
+     *
+     * 开启时，帧头声明的大小与期望不符但几何信息与负载大小一致的帧照常接收，
+     * 期望大小随之更新（不复位解析状态）；帧的几何见 FrameInfo
+     */
+    void setAutoGeometry(bool enabled) { m_autoGeometry = enabled; }
+    bool autoGeometry() const { return m_autoGeometry; }
+
+    // 统计信息
+    qint64 framesCompleted() const { return m_framesCompleted; }
+    qint64 framesDropped() const { return m_framesDropped; }
+    qint64 resyncCount() const { return m_resyncCount; }
+    qint64 droppedBytes() const { return m_droppedBytes; }
+    qint64 bytesConsumed() const { return m_bytesConsumed; }
+    qint64 heartbeatsReceived() const { return m_heartbeatsReceived; }
+
+    /**
+     * @brief 从6字节帧头推断整帧大小（含帧头）
+     * @param header 帧头数据（至少6字节，以 7E 7E 开头）
+     * @param expectedPayloadSize 期望的图像数据大小
+     * @return 整帧字节数
+     *
+     * 字节2-5按大端序32位负载长度解析且等于期望大小时直接采用；
+     * 否则依次尝试字节4-5大端、字节2-3大端、字节4-5小端：等于期望大小时视为负载长度，
+     * 落在 (期望大小, 期望大小+LEGACY_SIZE_TOLERANCE] 内时视为整帧长度（负载按期望大小补零或截断），
+     * 都不符合时按 期望大小+6 处理
+     *
+     * 与原 CTCPImg::parseFrameSize 的区别：原逻辑把 [期望大小, 期望大小+100] 内的16位值一律当作整帧长度，
+     * 负载不等于期望大小的帧读取后丢弃；这里16位值等于期望大小时按负载长度接收，
+     * 其余落在范围内的帧补零或截断后接收，不再丢弃
+     */
+    static int parseFrameSize(const char *header, int expectedPayloadSize);
+
+    static const int LEGACY_SIZE_TOLERANCE = 100;   ///< 旧版16位长度字段允许超出期望大小的字节数
+
+signals:
+    /**
+     * @brief 完整帧就绪
+     * @param payload 图像数据（不含帧头），仅保证在信号处理期间有效；
+     *                接收方保留副本时会在下一帧写入前自动分离
+     * @param info 帧序号和接收时间戳
+     */
+    void frameReady(const QByteArray &payload, const CFrameParser::FrameInfo &info);
+
+    /**
+     * @brief 帧被丢弃（帧头声明的大小与期望不符）
+     * @param payloadSize 帧头声明的数据大小
+     */
+    void frameDropped(int payloadSize);
+
+    /**
+     * @brief 收到size=指令
+     * @param size 指令中的帧大小
+     */
+    void sizeCommandReceived(int size);
+
+    /**
+     * @brief 收到心跳（负载为0的扩展帧头）
+     * @param sequence 心跳序号
+     * @param timestampUs 发送时间戳（Unix纪元微秒）
+     */
+    void heartbeatReceived(quint64 sequence, qint64 timestampUs);
+
+private:
+    enum State {
+        STATE_BOUNDARY,     ///< 帧边界，暂存帧头字节以判断协议
+        STATE_PAYLOAD,      ///< 接收图像数据
+        STATE_SKIP,         ///< 丢弃无效帧的数据
+        STATE_RESYNC,       ///< 查找下一个 7E 7E 同步头
+        STATE_SIZE_COMMAND  ///< 读取size=指令中的数字
+    };
+
+    static const int SIZE_COMMAND_MAX_DIGITS = 10;  ///< size=指令最多的数字位数（MAX_PAYLOAD_SIZE 为10位）
+
+    void processBoundary();
+    void processExtendedHeader();
+    void beginSkip(qint64 payloadSize);
+    /**
+     * @brief 开始接收一帧图像数据
+     * @param alreadyStaged 帧边界暂存区中属于本帧数据的字节数
+     * @param streamSize 流中属于本帧的数据字节数，0表示等于期望大小
+     */
+    void beginPayload(int alreadyStaged, int streamSize = 0);
+    void completeFrame();
+    void finishSizeCommand();
+    void dropStagedBytes(int count);
+
+    int m_expectedSize;             ///< 不超过 MAX_PAYLOAD_SIZE，int 足够
+    ProtocolMode m_protocol;
+    ProtocolMode m_protocolLock;    ///< 固定协议，PROTOCOL_AUTO 表示自动识别
+    bool m_autoGeometry;            ///< 按帧头几何切换期望大小
+    bool m_invalidGeometryLogged;   ///< 已提示过超出范围的帧头几何
+    State m_state;
+
+    char m_header[FrameProtocol::MAX_HEADER_SIZE];  ///< 帧边界暂存字节
+    int m_headerFill;
+    int m_headerTarget;         ///< 帧边界需要暂存的字节数（扩展帧头时为其长度）
+    bool m_inResync;            ///< 正在重同步（同一次失步只计数一次）
+
+    QByteArray m_assembly;      ///< 组帧缓冲
+    QByteArray m_completed;     ///< 最近完成的帧
+    int m_payloadFilled;
+    int m_payloadTarget;        ///< 本帧在流中的数据字节数（旧版帧头可能与期望大小不同）
+    qint64 m_skipRemaining;
+    int m_skipPayloadSize;
+    QByteArray m_sizeDigits;
+
+    FrameInfo m_assemblyInfo;   ///< 正在组装的帧的元数据
+    FrameInfo m_completedInfo;  ///< 最近完成的帧的元数据
+
+    qint64 m_framesCompleted;
+    qint64 m_framesDropped;
+    qint64 m_resyncCount;
+    qint64 m_droppedBytes;
+    qint64 m_bytesConsumed;
+    qint64 m_heartbeatsReceived;
+};
+
+#endif // FRAMEPARSER_H
@@ -0,0 +1,280 @@
+#ifndef FRAMEPROTOCOL_H
+#define FRAMEPROTOCOL_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QtEndian>
+#include <chrono>
+
+/**
+ * @file frameprotocol.h
+ * @brief 图像传输协议公共定义
+ *
+ * 收发两端共用的协议常量与帧头编解码函数，支持四种传输协议：
+ * - 原始数据模式：直接发送 WIDTH × HEIGHT × CHANLE 字节图像数据
+ * - 帧头模式：7E 7E + 4字节大端序负载长度 + 图像数据
+ * - 扩展帧头模式：7E 7E A5 5A + 帧头长度 + 版本 + 帧序号 + 发送时间戳 + 负载长度 + 图像几何 + 图像数据
+ * - size=模式：发送端先发送 "size=N"，收到 "OK" 后再发送N字节图像数据
+ *
+ * 接收端每收到一帧都会回复 "OK"，发送端可据此做流控，也可直接丢弃。
+ * 帧头和扩展帧头模式下，双方可在帧边界插入心跳（负载为0的扩展帧头，见 writeHeartbeat）
+ */
+namespace FrameProtocol
+{
+    /**
+     * @enum TransportMode
+     * @brief 发送端使用的传输协议
+     */
+    enum TransportMode {
+        TRANSPORT_RAW,          ///< 原始数据模式（无帧头）
+        TRANSPORT_HEADER,       ///< 7E 7E 帧头模式
+        TRANSPORT_SIZE_COMMAND, ///< size=N 握手模式
+        TRANSPORT_EXTENDED      ///< 7E 7E A5 5A 扩展帧头模式（带帧序号和发送时间戳）
+    };
+
+    const unsigned char SYNC_BYTE = 0x7E;   ///< 帧头同步字节（连续两个）
+    const int LEGACY_HEADER_SIZE = 6;       ///< 7E 7E 帧头长度（字节）
+
+    /**
+     * 单帧负载上限：接收端在一个QByteArray中组帧，Qt5的QByteArray最大约2GB，
+     * 留出分配头部后取2047MB（可容纳8192×8192×8通道×16位的1GB帧）
+     */
+    const qint64 MAX_PAYLOAD_SIZE = 2047LL * 1024 * 1024;
+
+    const int MAX_IMAGE_DIMENSION = 8192;   ///< 图像宽度、高度上限（与手动设置分辨率的范围一致）
+    const int MAX_IMAGE_CHANNELS = 8;       ///< 通道数上限
+
+    /**
+     * @brief 图像几何是否在接收端支持的范围内
+     * @return 宽、高在 1-MAX_IMAGE_DIMENSION，通道数在 1-MAX_IMAGE_CHANNELS，且单帧不超过 MAX_PAYLOAD_SIZE
+     */
+    inline bool isValidGeometry(qint64 width, qint64 height, qint64 channels)
+    {
+        return width > 0 && width <= MAX_IMAGE_DIMENSION
+            && height > 0 && height <= MAX_IMAGE_DIMENSION
+            && channels > 0 && channels <= MAX_IMAGE_CHANNELS
+            && width * height * channels <= MAX_PAYLOAD_SIZE;
+    }
+
+    /*
+     * 扩展帧头（所有字段大端序）：
+     *   偏移  长度  字段
+     *   0     2     7E 7E      同步头
+     *   2     2     A5 5A      扩展标识（旧帧头此处为负载长度高16位，不可能取该值）
+     *   4     2     headerSize 帧头总长度，接收端据此跳过未知的新增字段
+     *   6     2     version    帧头版本
+     *   8     8     sequence   帧序号
+     *   16    8     timestamp  发送时间戳（Unix纪元微秒）
+     *   24    8     payload    负载（图像数据）字节数
+     *   -- 以下为版本2新增（帧头长度 >= 48 时有效）--
+     *   32    4     width      图像宽度（0表示未知）
+     *   36    4     height     图像高度
+     *   40    2     channels   通道数
+     *   42    2     bits       每通道位数（目前只支持8）
+     *   44    4     reserved   保留，填0
+     *
+     * 接收端按帧头长度跳过不认识的字段，版本1（32字节）帧头仍可接收，只是没有几何信息。
+     */
+    const unsigned char EXT_MAGIC_0 = 0xA5; ///< 扩展标识第1字节
+    const unsigned char EXT_MAGIC_1 = 0x5A; ///< 扩展标识第2字节
+    const int EXT_HEADER_MIN_SIZE = 32;     ///< 版本1扩展帧头长度（接收端接受的最小长度）
+    const int EXT_HEADER_SIZE = 48;         ///< 当前版本扩展帧头长度
+    const quint16 EXT_HEADER_VERSION = 2;   ///< 当前扩展帧头版本
+    const int MAX_HEADER_SIZE = 256;        ///< 接收端接受的最大帧头长度
+
+    /**
+     * @struct ExtendedHeader
+     * @brief 扩展帧头字段
+     */
+    struct ExtendedHeader
+    {
+        quint16 headerSize = EXT_HEADER_SIZE;
+        quint16 version = EXT_HEADER_VERSION;
+        quint64 sequence = 0;
+        qint64 timestampUs = 0;
+        quint64 payloadSize = 0;
+        quint32 width = 0;          ///< 版本2：图像几何和像素格式，0表示未知
+        quint32 height = 0;
+        quint16 channels = 0;
+        quint16 bitsPerSample = 0;
+
+        /**
+         * @brief 是否携带与负载大小一致的图像几何信息（8位）
+         */
+        bool hasGeometry() const
+        {
+            return headerSize >= EXT_HEADER_SIZE && width > 0 && height > 0 && channels > 0
+                && (bitsPerSample == 0 || bitsPerSample == 8)
+                && quint64(width) * height * channels == payloadSize;
+        }
+
+        /**
+         * @brief 携带的图像几何是否可以采用（一致且在 isValidGeometry 范围内，如 1×N 的超长帧不可用）
+         */
+        bool hasUsableGeometry() const
+        {
+            return hasGeometry() && isValidGeometry(width, height, channels);
+        }
+    };
+
+    /**
+     * @brief 获取size=指令前缀
+     */
+    inline QByteArray sizeCommandPrefix() { return QByteArrayLiteral("size="); }
+
+    /**
+     * @brief 获取接收端确认应答
+     */
+    inline QByteArray ackToken() { return QByteArrayLiteral("OK"); }
+
+    /**
+     * @brief 写入6字节帧头：7E 7E + 大端序32位负载长度
+     * @param out 输出缓冲区（至少6字节）
+     * @param payloadSize 负载（图像数据）字节数
+     */
+    inline void writeLegacyHeader(char* out, quint32 payloadSize)
+    {
+        out[0] = static_cast<char>(SYNC_BYTE);
+        out[1] = static_cast<char>(SYNC_BYTE);
+        out[2] = static_cast<char>((payloadSize >> 24) & 0xFF);
+        out[3] = static_cast<char>((payloadSize >> 16) & 0xFF);
+        out[4] = static_cast<char>((payloadSize >> 8) & 0xFF);
+        out[5] = static_cast<char>(payloadSize & 0xFF);
+    }
+
+    /**
+     * @brief 写入扩展帧头
+     * @param out 输出缓冲区（至少 header.headerSize 字节，超出已知字段的部分填0）
+     * @param header 帧头字段
+     */
+    inline void writeExtendedHeader(char* out, const ExtendedHeader& header)
+    {
+        uchar* p = reinterpret_cast<uchar*>(out);
+        p[0] = SYNC_BYTE;
+        p[1] = SYNC_BYTE;
+        p[2] = EXT_MAGIC_0;
+        p[3] = EXT_MAGIC_1;
+        qToBigEndian<quint16>(header.headerSize, p + 4);
+        qToBigEndian<quint16>(header.version, p + 6);
+        qToBigEndian<quint64>(header.sequence, p + 8);
+        qToBigEndian<qint64>(header.timestampUs, p + 16);
+        qToBigEndian<quint64>(header.payloadSize, p + 24);
+        int written = EXT_HEADER_MIN_SIZE;
+        if (header.headerSize >= EXT_HEADER_SIZE) {
+            qToBigEndian<quint32>(header.width, p + 32);
+            qToBigEndian<quint32>(header.height, p + 36);
+            qToBigEndian<quint16>(header.channels, p + 40);
+            qToBigEndian<quint16>(header.bitsPerSample, p + 42);
+            written = 44;
+        }
+        for (int i = written; i < header.headerSize; ++i) {
+            p[i] = 0;
+        }
+    }
+
+    /**
+     * @brief 读取扩展帧头
+     * @param in 帧头数据
+     * @param size 可用字节数
+     * @param header 输出的帧头字段
+     * @return 标识和长度有效且数据完整时返回true
+     */
+    inline bool readExtendedHeader(const char* in, int size, ExtendedHeader& header)
+    {
+        if (size < EXT_HEADER_MIN_SIZE) {
+            return false;
+        }
+        const uchar* p = reinterpret_cast<const uchar*>(in);
+        if (p[0] != SYNC_BYTE || p[1] != SYNC_BYTE || p[2] != EXT_MAGIC_0 || p[3] != EXT_MAGIC_1) {
+            return false;
+        }
+        header.headerSize = qFromBigEndian<quint16>(p + 4);
+        header.version = qFromBigEndian<quint16>(p + 6);
+        header.sequence = qFromBigEndian<quint64>(p + 8);
+        header.timestampUs = qFromBigEndian<qint64>(p + 16);
+        header.payloadSize = qFromBigEndian<quint64>(p + 24);
+        if (header.headerSize < EXT_HEADER_MIN_SIZE || header.headerSize > MAX_HEADER_SIZE || size < header.headerSize) {
+            return false;
+        }
+        if (header.headerSize >= EXT_HEADER_SIZE) {
+            header.width = qFromBigEndian<quint32>(p + 32);
+            header.height = qFromBigEndian<quint32>(p + 36);
+            header.channels = qFromBigEndian<quint16>(p + 40);
+            header.bitsPerSample = qFromBigEndian<quint16>(p + 42);
+        } else {
+            header.width = header.height = 0;
+            header.channels = header.bitsPerSample = 0;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 判断数据起始处是否为扩展帧头标识（至少需要4字节）
+     */
+    inline bool hasExtendedMagic(const char* data, qint64 size)
+    {
+        return size >= 4
+            && static_cast<unsigned char>(data[0]) == SYNC_BYTE
+            && static_cast<unsigned char>(data[1]) == SYNC_BYTE
+            && static_cast<unsigned char>(data[2]) == EXT_MAGIC_0
+            && static_cast<unsigned char>(data[3]) == EXT_MAGIC_1;
+    }
+
+    /*
+     * 心跳：只有扩展帧头、负载长度为0的消息（32字节，不带图像几何）。
+     * 发送端空闲时发送，接收端据此区分"发送端暂时没有图像"和"链路已断"；
+     * 接收端也可以向发送端发送同样的心跳。心跳只能出现在帧边界，
+     * 原始数据和size=协议没有帧边界标记，不使用心跳
+     */
+    const int HEARTBEAT_SIZE = EXT_HEADER_MIN_SIZE; ///< 心跳消息长度
+
+    /**
+     * @brief 写入心跳消息
+     * @param out 输出缓冲区（至少 HEARTBEAT_SIZE 字节）
+     * @param sequence 心跳序号
+     * @param timestampUs 发送时间戳（Unix纪元微秒）
+     */
+    inline void writeHeartbeat(char* out, quint64 sequence, qint64 timestampUs)
+    {
+        ExtendedHeader header;
+        header.headerSize = HEARTBEAT_SIZE;
+        header.sequence = sequence;
+        header.timestampUs = timestampUs;
+        header.payloadSize = 0;
+        writeExtendedHeader(out, header);
+    }
+
+    /**
+     * @brief 当前墙上时间（Unix纪元微秒），用于扩展帧头的发送时间戳
+     *
+     * 跨主机比较时要求两端时钟已同步（NTP/PTP）
+     */
+    inline qint64 wallClockMicros()
+    {
+        using namespace std::chrono;
+        return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief 单调时钟（纳秒），用于进程内各阶段耗时
+     */
+    inline qint64 monotonicNanos()
+    {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief 判断数据起始处是否为7E 7E同步头
+     * @param data 数据指针
+     * @param size 可用字节数
+     */
+    inline bool hasSync(const char* data, qint64 size)
+    {
+        return size >= 2
+            && static_cast<unsigned char>(data[0]) == SYNC_BYTE
+            && static_cast<unsigned char>(data[1]) == SYNC_BYTE;
+    }
+}
+
+#endif // FRAMEPROTOCOL_H
@@ -0,0 +1,334 @@
+#include "framerelay.h"
+#include <QDebug>
+
+const qint64 CFrameRelay::WRITE_SLICE;
+const qint64 CFrameRelay::WRITE_LOW_WATER;
+
+namespace
+{
+    /**
+     * @brief 以无缓冲模式接受连接的服务器
+     *
+     * 无缓冲的 QTcpSocket 写入时直接交给内核，只有内核未接收的剩余部分才进入
+     * Qt 的发送缓冲；配合分片写入，帧数据基本不会在用户态再复制一次
+     */
+    class CUnbufferedTcpServer : public QTcpServer
+    {
+    public:
+        explicit CUnbufferedTcpServer(QObject *parent) : QTcpServer(parent) {}
+
+    protected:
+        void incomingConnection(qintptr socketDescriptor) override
+        {
+            QTcpSocket* socket = new QTcpSocket(this);
+            if (socket->setSocketDescriptor(socketDescriptor, QAbstractSocket::ConnectedState,
+                                            QIODevice::ReadWrite | QIODevice::Unbuffered)) {
+                addPendingConnection(socket);
+            } else {
+                delete socket;
+            }
+        }
+    };
+}
+
+/**
+ * @brief CFrameRelay构造函数
+ * @param parent 父对象指针
+ */
+CFrameRelay::CFrameRelay(QObject *parent)
+    : QObject(parent)
+    , m_server(nullptr)
+    , m_relaySequence(0)
+{
+    CMetricsRegistry& registry = CMetricsRegistry::instance();
+    m_metricClients = registry.gauge("tcpimg_relay_clients", "帧转发服务当前客户端数");
+    m_metricFramesSent = registry.counter("tcpimg_relay_frames_sent_total", "帧转发服务写出的帧数（按客户端累计）");
+    m_metricFramesDropped = registry.counter("tcpimg_relay_frames_dropped_total", "慢速客户端队列满而丢弃的帧数");
+    m_metricDisconnects = registry.counter("tcpimg_relay_slow_disconnects_total", "因队列满被断开的客户端数");
+    m_metricQueueDepth = registry.gauge("tcpimg_relay_queue_depth_max", "各客户端排队帧数的最大值");
+}
+
+/**
+ * @brief CFrameRelay析构函数
+ */
+CFrameRelay::~CFrameRelay()
+{
+    stop();
+}
+
+/**
+ * @brief 开始监听
+ * @param config 转发配置
+ * @return 成功返回true
+ */
+bool CFrameRelay::start(const Config& config)
+{
+    stop();
+
+    m_config = config;
+    m_config.maxQueueFrames = qMax(1, m_config.maxQueueFrames);
+    m_server = new CUnbufferedTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this, &CFrameRelay::onNewConnection);
+
+    if (!m_server->listen(m_config.address, m_config.port)) {
+        m_errorString = m_server->errorString();
+        qDebug() << "❌ 帧转发服务启动失败：" << m_errorString;
+        delete m_server;
+        m_server = nullptr;
+        return false;
+    }
+
+    qDebug() << QString("📡 帧转发服务已启动：%1:%2，每客户端队列%3帧，慢速客户端%4")
+                .arg(m_config.address.toString()).arg(m_server->serverPort())
+                .arg(m_config.maxQueueFrames)
+                .arg(m_config.policy == POLICY_DISCONNECT ? "断开" : "丢弃旧帧");
+    return true;
+}
+
+/**
+ * @brief 停止监听并断开所有客户端
+ */
+void CFrameRelay::stop()
+{
+    const QList<QTcpSocket*> sockets = m_clients.keys();
+    m_clients.clear();
+    for (QTcpSocket* socket : sockets) {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+    m_metricClients->set(0);
+    m_metricQueueDepth->set(0);
+
+    if (m_server) {
+        m_server->close();
+        m_server->deleteLater();
+        m_server = nullptr;
+    }
+}
+
+/**
+ * @brief 转发一帧给所有客户端
+ * @param payload 图像数据
+ * @param info 帧元数据
+ */
+void CFrameRelay::publish(const QByteArray& payload, const CFrameParser::FrameInfo& info)
+{
+    if (m_clients.isEmpty()) {
+        return;
+    }
+
+    // 帧头只生成一次，与图像数据一起被所有客户端共享
+    OutgoingFrame frame;
+    frame.payload = payload;
+    switch (m_config.transport) {
+    case FrameProtocol::TRANSPORT_HEADER:
+        frame.header.resize(FrameProtocol::LEGACY_HEADER_SIZE);
+        FrameProtocol::writeLegacyHeader(frame.header.data(), quint32(payload.size()));
+        break;
+    case FrameProtocol::TRANSPORT_EXTENDED: {
+        FrameProtocol::ExtendedHeader header;
+        header.sequence = info.hasExtendedHeader ? info.sequence : m_relaySequence;
+        header.timestampUs = info.hasExtendedHeader ? info.senderTimestampUs : info.firstByteWallUs;
+        header.payloadSize = quint64(payload.size());
+        if (info.hasGeometry()) {
+            header.width = quint32(info.width);
+            header.height = quint32(info.height);
+            header.channels = quint16(info.channels);
+            header.bitsPerSample = 8;
+        }
+        frame.header.resize(header.headerSize);
+        FrameProtocol::writeExtendedHeader(frame.header.data(), header);
+        break;
+    }
+    case FrameProtocol::TRANSPORT_RAW:
+    default:
+        break;
+    }
+    m_relaySequence++;
+
+    QList<QTcpSocket*> slowClients;
+    int maxDepth = 0;
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        ClientState& state = it.value();
+        if (state.queue.size() >= m_config.maxQueueFrames) {
+            if (m_config.policy == POLICY_DISCONNECT) {
+                slowClients.append(it.key());
+                continue;
+            }
+            state.queue.dequeue();
+            state.framesDropped++;
+            m_metricFramesDropped->increment();
+        }
+        state.queue.enqueue(frame);
+        pumpClient(it.key(), state);
+        maxDepth = qMax(maxDepth, state.queue.size());
+    }
+    m_metricQueueDepth->set(maxDepth);
+
+    for (QTcpSocket* socket : slowClients) {
+        m_metricDisconnects->increment();
+        dropClient(socket, QString("队列已满（%1帧）").arg(m_config.maxQueueFrames));
+    }
+}
+
+/**
+ * @brief 在发送缓冲低于水位时继续写出分片
+ * @param socket 客户端套接字
+ * @param state 客户端状态
+ */
+void CFrameRelay::pumpClient(QTcpSocket* socket, ClientState& state)
+{
+    while (socket->bytesToWrite() < WRITE_LOW_WATER) {
+        if (!state.sending) {
+            if (state.queue.isEmpty()) {
+                return;
+            }
+            state.current = state.queue.dequeue();
+            state.currentOffset = 0;
+            state.sending = true;
+        }
+
+        // 帧头和图像数据分别按偏移写出，不拼接成新缓冲
+        const qint64 headerSize = state.current.header.size();
+        const qint64 frameSize = headerSize + state.current.payload.size();
+        const char* source;
+        qint64 available;
+        if (state.currentOffset < headerSize) {
+            source = state.current.header.constData() + state.currentOffset;
+            available = headerSize - state.currentOffset;
+        } else {
+            source = state.current.payload.constData() + (state.currentOffset - headerSize);
+            available = frameSize - state.currentOffset;
+        }
+
+        const qint64 written = socket->write(source, qMin(available, WRITE_SLICE));
+        if (written <= 0) {
+            return;
+        }
+        state.currentOffset += written;
+
+        if (state.currentOffset >= frameSize) {
+            state.current = OutgoingFrame();  // 释放对共享缓冲的引用
+            state.sending = false;
+            state.framesSent++;
+            m_metricFramesSent->increment();
+        }
+    }
+}
+
+/**
+ * @brief 断开客户端
+ * @param socket 客户端套接字
+ * @param reason 原因（用于日志）
+ */
+void CFrameRelay::dropClient(QTcpSocket* socket, const QString& reason)
+{
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end()) {
+        return;
+    }
+
+    qDebug() << QString("⚠️ 帧转发：断开客户端 %1，%2（已发送%3帧，丢弃%4帧）")
+                .arg(it->address).arg(reason).arg(it->framesSent).arg(it->framesDropped);
+    m_clients.erase(it);
+    m_metricClients->set(m_clients.size());
+
+    socket->disconnect(this);
+    socket->abort();
+    socket->deleteLater();
+}
+
+/**
+ * @brief 接受新客户端
+ */
+void CFrameRelay::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        ClientState state;
+        state.address = QString("%1:%2").arg(socket->peerAddress().toString()).arg(socket->peerPort());
+        m_clients.insert(socket, state);
+        m_metricClients->set(m_clients.size());
+
+        connect(socket, &QTcpSocket::bytesWritten, this, &CFrameRelay::onClientBytesWritten);
+        connect(socket, &QTcpSocket::readyRead, this, &CFrameRelay::onClientReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &CFrameRelay::onClientDisconnected);
+
+        qDebug() << "📡 帧转发：新客户端" << state.address << "，当前" << m_clients.size() << "个";
+    }
+}
+
+/**
+ * @brief 套接字写出后继续发送
+ */
+void CFrameRelay::onClientBytesWritten()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    auto it = m_clients.find(socket);
+    if (it != m_clients.end()) {
+        pumpClient(socket, it.value());
+    }
+}
+
+/**
+ * @brief 丢弃下游客户端的应答（如每帧的"OK"）
+ */
+void CFrameRelay::onClientReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (socket) {
+        socket->readAll();
+    }
+}
+
+/**
+ * @brief 客户端断开
+ */
+void CFrameRelay::onClientDisconnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end()) {
+        return;
+    }
+
+    qDebug() << QString("📡 帧转发：客户端 %1 已断开（已发送%2帧，丢弃%3帧）")
+                .arg(it->address).arg(it->framesSent).arg(it->framesDropped);
+    m_clients.erase(it);
+    m_metricClients->set(m_clients.size());
+    socket->deleteLater();
+}
+
+/**
+ * @brief 解析策略名称
+ */
+bool CFrameRelay::parsePolicy(const QString& name, SlowClientPolicy& policy)
+{
+    const QString lower = name.toLower();
+    if (lower == "drop") {
+        policy = POLICY_DROP_OLDEST;
+    } else if (lower == "disconnect") {
+        policy = POLICY_DISCONNECT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 解析协议名称
+ */
+bool CFrameRelay::parseTransport(const QString& name, FrameProtocol::TransportMode& transport)
+{
+    const QString lower = name.toLower();
+    if (lower == "raw") {
+        transport = FrameProtocol::TRANSPORT_RAW;
+    } else if (lower == "7e" || lower == "header") {
+        transport = FrameProtocol::TRANSPORT_HEADER;
+    } else if (lower == "ext") {
+        transport = FrameProtocol::TRANSPORT_EXTENDED;
+    } else {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,150 @@
+#ifndef FRAMERELAY_H
+#define FRAMERELAY_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QByteArray>
+#include <QQueue>
+#include <QHash>
+#include "frameprotocol.h"
+#include "frameparser.h"
+#include "metricsregistry.h"
+
+/**
+ * @class CFrameRelay
+ * @brief 帧转发服务（一路输入，多路输出）
+ *
+ * 接收端把收到的每一帧交给转发服务，再由它作为TCP服务器转发给多个下游客户端
+ * （查看器、分析程序等），用于只允许一个连接的相机。
+ *
+ * - 所有客户端共享同一份帧数据（QByteArray 引用计数），入队不拷贝
+ * - 每个客户端有独立的有界队列，慢速客户端按策略丢弃最旧的帧或断开连接，
+ *   不影响其他客户端和接收端
+ * - 数据按分片写入套接字，仅在套接字待发送字节低于水位时继续写，
+ *   帧数据不会整帧复制进每个客户端的发送缓冲
+ * - 下游协议可选原始数据、7E 7E 帧头或扩展帧头（默认，保留发送端帧序号和时间戳）
+ */
+class CFrameRelay : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum SlowClientPolicy
+     * @brief 客户端队列满时的处理策略
+     */
+    enum SlowClientPolicy {
+        POLICY_DROP_OLDEST,     ///< 丢弃队列中最旧的帧
+        POLICY_DISCONNECT       ///< 断开该客户端
+    };
+
+    /**
+     * @struct Config
+     * @brief 转发服务配置
+     */
+    struct Config
+    {
+        quint16 port = 17778;
+        QHostAddress address = QHostAddress::Any;
+        int maxQueueFrames = 4;     ///< 每个客户端最多排队的帧数（不含正在发送的帧）
+        SlowClientPolicy policy = POLICY_DROP_OLDEST;
+        FrameProtocol::TransportMode transport = FrameProtocol::TRANSPORT_EXTENDED;
+    };
+
+    explicit CFrameRelay(QObject *parent = nullptr);
+    ~CFrameRelay();
+
+    /**
+     * @brief 开始监听
+     * @return 成功返回true
+     */
+    bool start(const Config& config);
+
+    /**
+     * @brief 停止监听并断开所有客户端
+     */
+    void stop();
+
+    bool isListening() const { return m_server && m_server->isListening(); }
+    QString errorString() const { return m_errorString; }
+    int clientCount() const { return m_clients.size(); }
+    const Config& config() const { return m_config; }
+
+    /**
+     * @brief 转发一帧给所有客户端
+     * @param payload 图像数据（共享引用，不拷贝）
+     * @param info 帧元数据，用于填写扩展帧头
+     */
+    void publish(const QByteArray& payload, const CFrameParser::FrameInfo& info);
+
+    /**
+     * @brief 解析策略名称（drop / disconnect）
+     * @return 成功返回true
+     */
+    static bool parsePolicy(const QString& name, SlowClientPolicy& policy);
+
+    /**
+     * @brief 解析协议名称（raw / 7e / ext）
+     * @return 成功返回true
+     */
+    static bool parseTransport(const QString& name, FrameProtocol::TransportMode& transport);
+
+private slots:
+    void onNewConnection();
+    void onClientBytesWritten();
+    void onClientReadyRead();
+    void onClientDisconnected();
+
+private:
+    /**
+     * @brief 待发送的一帧：帧头和图像数据都是共享缓冲
+     */
+    struct OutgoingFrame
+    {
+        QByteArray header;
+        QByteArray payload;
+    };
+
+    /**
+     * @brief 单个下游客户端状态
+     */
+    struct ClientState
+    {
+        QQueue<OutgoingFrame> queue;    ///< 排队帧
+        OutgoingFrame current;          ///< 正在发送的帧
+        qint64 currentOffset = 0;       ///< 当前帧已写出字节（帧头+数据）
+        bool sending = false;           ///< 是否有正在发送的帧
+        qint64 framesSent = 0;
+        qint64 framesDropped = 0;
+        QString address;
+    };
+
+    /**
+     * @brief 在发送缓冲低于水位时继续写出分片
+     */
+    void pumpClient(QTcpSocket* socket, ClientState& state);
+
+    /**
+     * @brief 按策略断开慢速客户端
+     */
+    void dropClient(QTcpSocket* socket, const QString& reason);
+
+    static const qint64 WRITE_SLICE = 256 * 1024;       ///< 每次写入套接字的最大字节数
+    static const qint64 WRITE_LOW_WATER = 512 * 1024;   ///< 待发送字节低于此值时继续写
+
+    Config m_config;
+    QTcpServer* m_server;
+    QHash<QTcpSocket*, ClientState> m_clients;
+    quint64 m_relaySequence;        ///< 无上游帧序号时使用的转发帧序号
+    QString m_errorString;
+
+    CMetricsRegistry::Metric* m_metricClients;
+    CMetricsRegistry::Metric* m_metricFramesSent;
+    CMetricsRegistry::Metric* m_metricFramesDropped;
+    CMetricsRegistry::Metric* m_metricDisconnects;
+    CMetricsRegistry::Metric* m_metricQueueDepth;
+};
+
+#endif // FRAMERELAY_H
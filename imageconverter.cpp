@@ -0,0 +1,107 @@
+#include "imageconverter.h"
+#include <cstring>
+
+/**
+ * @brief 获取通道数对应的显示格式
+ * @param channels 通道数
+ * @return 显示用的QImage格式
+ */
+QImage::Format CImageConverter::displayFormat(int channels)
+{
+    switch (channels) {
+        case 3:
+            return QImage::Format_RGB888;
+        case 4:
+            return QImage::Format_RGBA8888;
+        default:
+            // 1通道直接显示；2、5-8通道提取第一通道显示为灰度图像
+            return QImage::Format_Grayscale8;
+    }
+}
+
+/**
+ * @brief 判断该通道数是否需要提取单通道显示
+ */
+bool CImageConverter::needsChannelExtraction(int channels)
+{
+    return channels != 1 && channels != 3 && channels != 4;
+}
+
+/**
+ * @brief 转换原始数据为显示图像
+ */
+bool CImageConverter::convertToDisplayImage(const char *data, int width, int height, int channels, QImage &target)
+{
+    return convertRegion(data, width, height, channels, QRect(0, 0, width, height), target);
+}
+
+/**
+ * @brief 只转换原始数据中的一个矩形区域
+ *
+ * QImage扫描行按4字节对齐，宽度×通道数不是4的倍数时不能整块拷贝，
+ * 因此逐行写入目标图像
+ */
+bool CImageConverter::convertRegion(const char *data, int width, int height, int channels,
+                                    const QRect &region, QImage &target)
+{
+    if (data == nullptr || width <= 0 || height <= 0 || channels <= 0) {
+        return false;
+    }
+
+    const QRect rect = region & QRect(0, 0, width, height);
+    if (rect.isEmpty()) {
+        return false;
+    }
+
+    const QImage::Format format = displayFormat(channels);
+    if (target.width() != rect.width() || target.height() != rect.height() || target.format() != format) {
+        target = QImage(rect.width(), rect.height(), format);
+        if (target.isNull()) {
+            return false;
+        }
+    }
+
+    const qint64 srcRowBytes = qint64(width) * channels;
+    const uchar *src = reinterpret_cast<const uchar*>(data)
+                       + rect.top() * srcRowBytes + qint64(rect.left()) * channels;
+    const int rowPixels = rect.width();
+
+    if (needsChannelExtraction(channels)) {
+        for (int y = 0; y < rect.height(); ++y) {
+            extractChannel(src + y * srcRowBytes, target.scanLine(y), rowPixels, channels, 0);
+        }
+    } else {
+        for (int y = 0; y < rect.height(); ++y) {
+            memcpy(target.scanLine(y), src + y * srcRowBytes, size_t(rowPixels) * channels);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief 从交织的多通道数据中提取单个通道
+ */
+void CImageConverter::extractChannel(const uchar *src, uchar *dst, int pixels, int channels, int channel)
+{
+    src += channel;
+
+    if (channels == 2) {
+        // 2tap 是最常见的情况，按4像素展开减少循环开销
+        int i = 0;
+        for (; i + 4 <= pixels; i += 4) {
+            dst[i]     = src[2 * i];
+            dst[i + 1] = src[2 * i + 2];
+            dst[i + 2] = src[2 * i + 4];
+            dst[i + 3] = src[2 * i + 6];
+        }
+        for (; i < pixels; ++i) {
+            dst[i] = src[2 * i];
+        }
+        return;
+    }
+
+    for (int i = 0; i < pixels; ++i) {
+        dst[i] = src[qint64(i) * channels];
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef IMAGECONVERTER_H
+#define IMAGECONVERTER_H
+
+#include <QImage>
+
+/**
+ * @class CImageConverter
+ * @brief 原始图像数据到显示图像的转换工具
+ *
+ * 将接收到的 宽度 × 高度 × 通道数 字节数据转换为可显示的QImage：
+ * - 1通道：8位灰度
+ * - 3通道：RGB888
+ * - 4通道：RGBA8888
+ * - 2、5-8通道：提取第一通道显示为灰度图像
+ *
+ * 数据直接写入目标图像的扫描行，目标图像尺寸和格式不变时复用其内存
+ */
+class CImageConverter
+{
+public:
+    /**
+     * @brief 获取通道数对应的显示格式
+     * @param channels 通道数
+     * @return 显示用的QImage格式
+     */
+    static QImage::Format displayFormat(int channels);
+
+    /**
+     * @brief 判断该通道数是否需要提取单通道显示
+     */
+    static bool needsChannelExtraction(int channels);
+
+    /**
+     * @brief 转换原始数据为显示图像
+     * @param data 原始图像数据（宽度 × 高度 × 通道数字节，逐行紧密排列）
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @param channels 通道数
+     * @param target 输出图像，尺寸和格式匹配且未被共享时复用内存
+     * @return 转换成功返回true
+     */
+    static bool convertToDisplayImage(const char *data, int width, int height, int channels, QImage &target);
+
+    /**
+     * @brief 只转换原始数据中的一个矩形区域（分块显示）
+     * @param data 原始图像数据（整帧）
+     * @param width 整帧宽度
+     * @param height 整帧高度
+     * @param channels 通道数
+     * @param region 要转换的区域，超出整帧的部分被裁掉
+     * @param target 输出图像（区域大小），尺寸和格式匹配且未被共享时复用内存
+     * @return 转换成功返回true
+     */
+    static bool convertRegion(const char *data, int width, int height, int channels,
+                              const QRect &region, QImage &target);
+
+    /**
+     * @brief 从交织的多通道数据中提取单个通道
+     * @param src 源数据
+     * @param dst 目标数据（pixels字节）
+     * @param pixels 像素数
+     * @param channels 源数据通道数
+     * @param channel 要提取的通道序号（从0开始）
+     */
+    static void extractChannel(const uchar *src, uchar *dst, int pixels, int channels, int channel = 0);
+};
+
+#endif // IMAGECONVERTER_H
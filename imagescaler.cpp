@@ -0,0 +1,245 @@
+#include "imagescaler.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TCPIMG_HAVE_SSE2 1
+#endif
+
+/**
+ * @brief 判断格式是否支持快速缩小
+ */
+bool CImageScaler::isSupportedFormat(QImage::Format format)
+{
+    switch (format) {
+    case QImage::Format_Grayscale8:
+    case QImage::Format_Alpha8:
+    case QImage::Format_RGB888:
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+    case QImage::Format_RGBX8888:
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBA8888_Premultiplied:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief 缩小一半
+ */
+bool CImageScaler::downscale2x(const QImage &src, QImage &dst)
+{
+    if (src.isNull() || !isSupportedFormat(src.format())) {
+        return false;
+    }
+
+    const int dstWidth = (src.width() + 1) / 2;
+    const int dstHeight = (src.height() + 1) / 2;
+    if (dst.width() != dstWidth || dst.height() != dstHeight || dst.format() != src.format()) {
+        dst = QImage(dstWidth, dstHeight, src.format());
+        if (dst.isNull()) {
+            return false;
+        }
+    }
+
+    downscale2x(src.constBits(), src.bytesPerLine(), src.width(), src.height(),
+                dst.bits(), dst.bytesPerLine(), src.depth() / 8);
+    return true;
+}
+
+/**
+ * @brief 逐像素实现
+ */
+void CImageScaler::downscale2xScalar(const uchar *src, int srcStride, int srcWidth, int srcHeight,
+                                     uchar *dst, int dstStride, int bytesPerPixel)
+{
+    const int dstWidth = (srcWidth + 1) / 2;
+    const int dstHeight = (srcHeight + 1) / 2;
+
+    for (int y = 0; y < dstHeight; ++y) {
+        const uchar *row0 = src + qint64(2 * y) * srcStride;
+        const uchar *row1 = src + qint64(qMin(2 * y + 1, srcHeight - 1)) * srcStride;
+        uchar *out = dst + qint64(y) * dstStride;
+
+        for (int x = 0; x < dstWidth; ++x) {
+            const int x0 = 2 * x * bytesPerPixel;
+            const int x1 = qMin(2 * x + 1, srcWidth - 1) * bytesPerPixel;
+            for (int c = 0; c < bytesPerPixel; ++c) {
+                out[x * bytesPerPixel + c] = uchar((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+            }
+        }
+    }
+}
+
+#ifdef TCPIMG_HAVE_SSE2
+/**
+ * @brief 单字节像素一行：每次32个输入字节 → 16个输出像素
+ * @return 已处理的输出像素数
+ */
+static int downscaleRowGray8Sse2(const uchar *row0, const uchar *row1, uchar *out, int pairs)
+{
+    const __m128i lowMask = _mm_set1_epi16(0x00FF);
+    const __m128i rounding = _mm_set1_epi16(2);
+
+    int x = 0;
+    for (; x + 16 <= pairs; x += 16) {
+        const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * x));
+        const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * x + 16));
+        const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * x));
+        const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * x + 16));
+
+        // 偶数列与奇数列各取到16位，四个像素相加后 (+2)>>2
+        __m128i sum0 = _mm_add_epi16(_mm_and_si128(a0, lowMask), _mm_srli_epi16(a0, 8));
+        sum0 = _mm_add_epi16(sum0, _mm_add_epi16(_mm_and_si128(b0, lowMask), _mm_srli_epi16(b0, 8)));
+        __m128i sum1 = _mm_add_epi16(_mm_and_si128(a1, lowMask), _mm_srli_epi16(a1, 8));
+        sum1 = _mm_add_epi16(sum1, _mm_add_epi16(_mm_and_si128(b1, lowMask), _mm_srli_epi16(b1, 8)));
+
+        sum0 = _mm_srli_epi16(_mm_add_epi16(sum0, rounding), 2);
+        sum1 = _mm_srli_epi16(_mm_add_epi16(sum1, rounding), 2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), _mm_packus_epi16(sum0, sum1));
+    }
+    return x;
+}
+
+/**
+ * @brief 四字节像素一行：每次16个输入字节（4像素）→ 2个输出像素
+ * @return 已处理的输出像素数
+ */
+static int downscaleRowRgba32Sse2(const uchar *row0, const uchar *row1, uchar *out, int pairs)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi16(2);
+
+    int x = 0;
+    for (; x + 2 <= pairs; x += 2) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 8 * x));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 8 * x));
+
+        // 每个通道扩展到16位：lo = 像素0、1，hi = 像素2、3（上下两行已相加）
+        const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+        const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+        // 左右相邻像素相加：低64位分别为 像素0+1、像素2+3
+        const __m128i loSum = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+        const __m128i hiSum = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+        __m128i sum = _mm_unpacklo_epi64(loSum, hiSum);
+        sum = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 4 * x), _mm_packus_epi16(sum, zero));
+    }
+    return x;
+}
+#endif
+
+/**
+ * @brief 缩小一半（原始数据接口）
+ */
+void CImageScaler::downscale2x(const uchar *src, int srcStride, int srcWidth, int srcHeight,
+                               uchar *dst, int dstStride, int bytesPerPixel)
+{
+#ifdef TCPIMG_HAVE_SSE2
+    if (bytesPerPixel == 1 || bytesPerPixel == 4) {
+        const int dstWidth = (srcWidth + 1) / 2;
+        const int dstHeight = (srcHeight + 1) / 2;
+        const int pairs = srcWidth / 2;     // 右侧有完整像素对的输出列数
+
+        for (int y = 0; y < dstHeight; ++y) {
+            const uchar *row0 = src + qint64(2 * y) * srcStride;
+            const uchar *row1 = src + qint64(qMin(2 * y + 1, srcHeight - 1)) * srcStride;
+            uchar *out = dst + qint64(y) * dstStride;
+
+            const int done = (bytesPerPixel == 1) ? downscaleRowGray8Sse2(row0, row1, out, pairs)
+                                                  : downscaleRowRgba32Sse2(row0, row1, out, pairs);
+
+            // 行尾（含奇数宽度的最后一列）逐像素处理
+            for (int x = done; x < dstWidth; ++x) {
+                const int x0 = 2 * x * bytesPerPixel;
+                const int x1 = qMin(2 * x + 1, srcWidth - 1) * bytesPerPixel;
+                for (int c = 0; c < bytesPerPixel; ++c) {
+                    out[x * bytesPerPixel + c] = uchar((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+                }
+            }
+        }
+        return;
+    }
+#endif
+
+    downscale2xScalar(src, srcStride, srcWidth, srcHeight, dst, dstStride, bytesPerPixel);
+}
+
+/**
+ * @brief CImagePyramid构造函数
+ */
+CImagePyramid::CImagePyramid()
+    : m_levels(MAX_LEVELS)
+    , m_validLevels(0)
+    , m_maxLevel(0)
+{
+}
+
+/**
+ * @brief 设置第0层图像，已生成的各层失效（缓冲保留复用）
+ */
+void CImagePyramid::setBase(const QImage &image)
+{
+    m_base = image;
+    m_validLevels = 0;
+
+    m_maxLevel = 0;
+    int width = image.width();
+    int height = image.height();
+    while ((width > 1 || height > 1) && m_maxLevel < MAX_LEVELS) {
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        m_maxLevel++;
+    }
+}
+
+/**
+ * @brief 清空并释放各层缓冲
+ */
+void CImagePyramid::clear()
+{
+    m_base = QImage();
+    m_levels = QVector<QImage>(MAX_LEVELS);
+    m_validLevels = 0;
+    m_maxLevel = 0;
+}
+
+/**
+ * @brief 获取指定层，尚未生成时从上一层生成
+ */
+const QImage& CImagePyramid::level(int level)
+{
+    level = qBound(0, level, m_maxLevel);
+    if (level == 0) {
+        return m_base;
+    }
+
+    for (int i = m_validLevels + 1; i <= level; ++i) {
+        const QImage &source = (i == 1) ? m_base : m_levels[i - 2];
+        QImage &target = m_levels[i - 1];
+        if (!CImageScaler::downscale2x(source, target)) {
+            // 不支持的格式退回Qt平滑缩放
+            target = source.scaled((source.width() + 1) / 2, (source.height() + 1) / 2,
+                                   Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+    }
+    m_validLevels = qMax(m_validLevels, level);
+    return m_levels[level - 1];
+}
+
+/**
+ * @brief 缩放比例对应的层号
+ */
+int CImagePyramid::levelForScale(double scale) const
+{
+    if (scale >= 1.0 || scale <= 0.0) {
+        return 0;
+    }
+    const int level = int(std::floor(std::log2(1.0 / scale)));
+    return qBound(0, level, m_maxLevel);
+}
@@ -0,0 +1,100 @@
+#ifndef IMAGESCALER_H
+#define IMAGESCALER_H
+
+#include <QImage>
+#include <QVector>
+
+/**
+ * @class CImageScaler
+ * @brief 快速图像缩小（2×2区域平均）
+ *
+ * 每次把宽高各缩小一半，每个输出像素取对应2×2像素的平均值（四舍五入）。
+ * 支持每像素1、3、4字节的格式（灰度、RGB888、RGB32/RGBA8888等）；
+ * 1字节和4字节格式在支持SSE2的平台上每次处理16字节，其余情况逐像素计算。
+ * 奇数宽高时最后一列/行与自身平均。
+ */
+class CImageScaler
+{
+public:
+    /**
+     * @brief 判断格式是否支持快速缩小
+     */
+    static bool isSupportedFormat(QImage::Format format);
+
+    /**
+     * @brief 缩小一半
+     * @param src 源图像
+     * @param dst 输出图像，尺寸和格式匹配且未被共享时复用内存
+     * @return 格式不支持或源图像为空时返回false
+     */
+    static bool downscale2x(const QImage &src, QImage &dst);
+
+    /**
+     * @brief 缩小一半（原始数据接口）
+     * @param src 源数据
+     * @param srcStride 源数据每行字节数
+     * @param srcWidth 源宽度
+     * @param srcHeight 源高度
+     * @param dst 目标数据（(srcWidth+1)/2 × (srcHeight+1)/2 像素）
+     * @param dstStride 目标每行字节数
+     * @param bytesPerPixel 每像素字节数（1、3或4）
+     */
+    static void downscale2x(const uchar *src, int srcStride, int srcWidth, int srcHeight,
+                            uchar *dst, int dstStride, int bytesPerPixel);
+
+    /**
+     * @brief 逐像素实现（SIMD路径的参照，也用于行尾）
+     */
+    static void downscale2xScalar(const uchar *src, int srcStride, int srcWidth, int srcHeight,
+                                  uchar *dst, int dstStride, int bytesPerPixel);
+};
+
+/**
+ * @class CImagePyramid
+ * @brief 多分辨率图像金字塔（按需生成）
+ *
+ * 第0层为原图，第n层宽高为原图的 1/2^n。新帧到达时只标记失效，
+ * 某一层第一次被请求时才从上一层生成；各层缓冲在帧间复用，稳态下不分配内存。
+ */
+class CImagePyramid
+{
+public:
+    static const int MAX_LEVELS = 12;   ///< 最多层数（8192 → 2）
+
+    CImagePyramid();
+
+    /**
+     * @brief 设置第0层图像（共享数据，不拷贝），已生成的各层失效
+     */
+    void setBase(const QImage &image);
+
+    /**
+     * @brief 清空
+     */
+    void clear();
+
+    /**
+     * @brief 获取指定层，尚未生成时从上一层生成
+     * @param level 层号，超出范围时返回最小的一层
+     */
+    const QImage& level(int level);
+
+    /**
+     * @brief 缩放比例对应的层号：不小于目标尺寸的最小一层
+     * @param scale 相对原图的缩放比例（<1为缩小）
+     */
+    int levelForScale(double scale) const;
+
+    /**
+     * @brief 第0层图像
+     */
+    const QImage& base() const { return m_base; }
+
+private:
+    QImage m_base;
+    QVector<QImage> m_levels;   ///< 第1层起的各层缓冲
+    int m_validLevels;          ///< 已为当前帧生成的层数（不含第0层）
+    int m_maxLevel;             ///< 当前帧可用的最大层号
+};
+
+#endif // IMAGESCALER_H
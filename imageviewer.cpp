@@ -0,0 +1,257 @@
+#include "imageviewer.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <cmath>
+
+/**
+ * @brief CImageViewer构造函数
+ * @param parent 父控件指针
+ */
+CImageViewer::CImageViewer(QWidget *parent)
+    : QLabel(parent)
+    , m_zoomFactor(1.0)
+    , m_quality(QUALITY_AREA)
+    , m_cacheRequested(false)
+{
+}
+
+/**
+ * @brief 与调用方交换图像缓冲并显示
+ * @param image 输入新帧，返回时为上一帧的缓冲
+ */
+void CImageViewer::swapImage(QImage &image)
+{
+    // 先释放金字塔对旧帧的引用，调用方拿回的缓冲才不会因共享而在写入时被复制
+    m_pyramid.setBase(QImage());
+    m_tiles.clear();
+    m_image.swap(image);
+    frameChanged();
+}
+
+/**
+ * @brief 显示图像
+ * @param image 图像
+ */
+void CImageViewer::setImage(const QImage &image)
+{
+    m_tiles.clear();
+    m_image = image;
+    frameChanged();
+}
+
+/**
+ * @brief 分块显示原始帧数据
+ * @param data 原始图像数据
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param channels 通道数
+ */
+bool CImageViewer::setFrameData(const QByteArray &data, int width, int height, int channels)
+{
+    // 整帧图像及其金字塔不再使用，释放内存
+    m_image = QImage();
+    m_pyramid.clear();
+
+    if (!m_tiles.setFrame(data, width, height, channels)) {
+        clearImage();
+        return false;
+    }
+    frameChanged();
+    return true;
+}
+
+/**
+ * @brief 清除图像
+ */
+void CImageViewer::clearImage()
+{
+    m_image = QImage();
+    m_pyramid.clear();
+    m_tiles.clear();
+    m_scaledCache = QImage();
+    m_cacheRequested = false;
+    update();
+}
+
+/**
+ * @brief 设置缩放因子
+ * @param factor 缩放因子
+ */
+void CImageViewer::setZoomFactor(double factor)
+{
+    if (factor <= 0.0 || qFuzzyCompare(factor, m_zoomFactor)) {
+        return;
+    }
+
+    m_zoomFactor = factor;
+    m_scaledCache = QImage();
+    m_cacheRequested = true;
+
+    if (hasImage()) {
+        resize(scaledSize());
+        update();
+    }
+}
+
+/**
+ * @brief 设置缩放质量
+ * @param quality 缩放质量
+ */
+void CImageViewer::setScaleQuality(ScaleQuality quality)
+{
+    if (quality == m_quality) {
+        return;
+    }
+
+    m_quality = quality;
+    m_scaledCache = QImage();
+    m_cacheRequested = true;
+    update();
+}
+
+/**
+ * @brief 显示文本并清除图像
+ * @param text 文本
+ */
+void CImageViewer::setText(const QString &text)
+{
+    clearImage();
+    QLabel::setText(text);
+}
+
+/**
+ * @brief 建议大小：有图像时为缩放后的图像大小
+ */
+QSize CImageViewer::sizeHint() const
+{
+    return hasImage() ? scaledSize() : QLabel::sizeHint();
+}
+
+/**
+ * @brief 新帧到达后调整控件大小并请求重绘
+ */
+void CImageViewer::frameChanged()
+{
+    // 旧帧的缩放缓存失效；缩放未变时新帧直接按变换绘制，不再生成缓存
+    m_scaledCache = QImage();
+    m_cacheRequested = false;
+    m_pyramid.setBase(m_image);
+
+    if (!text().isEmpty()) {
+        QLabel::clear();
+    }
+
+    if (hasImage() && size() != scaledSize()) {
+        resize(scaledSize());
+    }
+    update();
+}
+
+/**
+ * @brief 缩放后的图像大小
+ */
+QSize CImageViewer::scaledSize() const
+{
+    const QSize size = imageSize();
+    return QSize(qMax(1, qRound(size.width() * m_zoomFactor)),
+                 qMax(1, qRound(size.height() * m_zoomFactor)));
+}
+
+/**
+ * @brief 绘制事件
+ * @param event 绘制事件，只重绘其中的可见区域
+ */
+void CImageViewer::paintEvent(QPaintEvent *event)
+{
+    if (!hasImage()) {
+        QLabel::paintEvent(event);
+        return;
+    }
+
+    QPainter painter(this);
+    const QRect exposed = event->rect();
+
+    // 分块显示：滚动区域只暴露视口内的部分，只处理这部分分块，不生成整帧缓存
+    if (isTiled()) {
+        paintTiles(painter, exposed);
+        return;
+    }
+    const QSize targetSize = scaledSize();
+
+    // 原始大小：直接贴图
+    if (targetSize == m_image.size()) {
+        painter.drawImage(exposed.topLeft(), m_image, exposed);
+        return;
+    }
+
+    // 缩放或质量刚变化：生成一次缩放缓存，后续滚动、遮挡重绘直接贴图
+    if (m_cacheRequested) {
+        m_scaledCache = QImage(targetSize, QImage::Format_ARGB32_Premultiplied);
+        m_scaledCache.fill(Qt::transparent);
+        QPainter cachePainter(&m_scaledCache);
+        drawScaled(cachePainter, targetSize);
+        cachePainter.end();
+        m_cacheRequested = false;
+    }
+    if (!m_scaledCache.isNull()) {
+        painter.drawImage(exposed.topLeft(), m_scaledCache, exposed);
+        return;
+    }
+
+    // 新帧：按变换只绘制可见区域，不生成整帧缩放图
+    drawScaled(painter, targetSize);
+}
+
+/**
+ * @brief 按当前缩放质量绘制图像
+ * @param painter 画笔
+ * @param targetSize 目标大小
+ */
+void CImageViewer::drawScaled(QPainter &painter, const QSize &targetSize)
+{
+    const QImage *source = &m_image;
+    if (m_quality == QUALITY_AREA && m_zoomFactor < 1.0) {
+        // 先取不小于目标尺寸的金字塔层，剩余不到2倍的缩小交给双线性
+        source = &m_pyramid.level(m_pyramid.levelForScale(m_zoomFactor));
+    }
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, m_quality != QUALITY_NEAREST);
+    painter.drawImage(QRect(QPoint(0, 0), targetSize), *source);
+}
+
+/**
+ * @brief 分块显示：只绘制与可见区域相交的分块
+ * @param painter 画笔
+ * @param exposed 需要重绘的控件区域
+ */
+void CImageViewer::paintTiles(QPainter &painter, const QRect &exposed)
+{
+    const double zoom = m_zoomFactor;
+
+    // 可见区域换算到原图坐标，四周多取一个像素避免取整漏掉边缘分块
+    const QRect sourceRect = QRect(QPoint(int(std::floor(exposed.left() / zoom)) - 1,
+                                          int(std::floor(exposed.top() / zoom)) - 1),
+                                   QPoint(int(std::ceil((exposed.right() + 1) / zoom)),
+                                          int(std::ceil((exposed.bottom() + 1) / zoom))))
+                             & QRect(QPoint(0, 0), m_tiles.size());
+    if (sourceRect.isEmpty()) {
+        return;
+    }
+
+    const int tileSize = CTiledFrame::TILE_SIZE;
+    const double sampleScale = (m_quality == QUALITY_AREA) ? zoom : 1.0;
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, m_quality != QUALITY_NEAREST);
+
+    for (int row = sourceRect.top() / tileSize; row <= sourceRect.bottom() / tileSize; ++row) {
+        for (int column = sourceRect.left() / tileSize; column <= sourceRect.right() / tileSize; ++column) {
+            // 分块边界按同一规则取整，相邻分块在目标上首尾相接，不留缝隙
+            const QRect rect = m_tiles.tileRect(column, row);
+            const QRect target(QPoint(qRound(rect.left() * zoom), qRound(rect.top() * zoom)),
+                               QPoint(qRound((rect.right() + 1) * zoom) - 1, qRound((rect.bottom() + 1) * zoom) - 1));
+            if (target.isEmpty()) {
+                continue;
+            }
+            painter.drawImage(target, m_tiles.tile(column, row, sampleScale));
+        }
+    }
+}
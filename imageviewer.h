@@ -0,0 +1,127 @@
+#ifndef IMAGEVIEWER_H
+#define IMAGEVIEWER_H
+
+#include <QLabel>
+#include <QImage>
+#include "imagescaler.h"
+#include "tiledframe.h"
+
+class QPainter;
+
+/**
+ * @class CImageViewer
+ * @brief 图像显示控件
+ *
+ * 直接在 paintEvent 中按缩放因子绘制 QImage，替代 QLabel::setPixmap：
+ * - 不做 QPixmap::fromImage 转换，也不为每帧生成缩放后的像素图
+ * - 新帧通过 swapImage 与调用方交换缓冲，调用方下一帧复用旧缓冲，稳态下不分配内存
+ * - 缩放因子变化后首次绘制时生成一次平滑缩放缓存，之后的重绘（滚动、遮挡）直接贴图；
+ *   新帧到达时缓存失效，按绘制变换直接绘制可见区域
+ * - 只在新帧或缩放变化时请求重绘
+ * - 缩小时可选缩放质量：最近邻（最快）、区域平均（默认，从按需生成的金字塔中取
+ *   不小于目标尺寸的一层再做剩余缩放，兼顾速度和抗锯齿）、双线性（直接从原图平滑缩放）
+ * - 大帧（≥ TILED_MIN_PIXELS）通过 setFrameData 分块显示：不做整帧转换和整帧缩放，
+ *   每次绘制只转换、缩放与可见区域相交的分块，平移和缩放的开销与视口大小相关而非帧大小
+ *
+ * 仍是 QLabel，无图像时显示文本（状态提示、诊断信息），setText 会清除当前图像。
+ */
+class CImageViewer : public QLabel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum ScaleQuality
+     * @brief 缩放质量
+     */
+    enum ScaleQuality {
+        QUALITY_NEAREST,    ///< 最近邻
+        QUALITY_AREA,       ///< 金字塔区域平均 + 双线性
+        QUALITY_BILINEAR    ///< 原图双线性
+    };
+
+    static const int TILED_MIN_PIXELS = 2048 * 2048;   ///< 建议分块显示的最小像素数
+
+    explicit CImageViewer(QWidget *parent = nullptr);
+
+    /**
+     * @brief 与调用方交换图像缓冲并显示
+     * @param image 输入新帧；返回时为上一帧的缓冲（首次为空图像）
+     */
+    void swapImage(QImage &image);
+
+    /**
+     * @brief 显示图像（共享数据，不拷贝）
+     */
+    void setImage(const QImage &image);
+
+    /**
+     * @brief 分块显示原始帧数据（共享数据，不拷贝），绘制时只转换可见分块
+     * @return 数据不足一帧时返回false，当前图像被清除
+     */
+    bool setFrameData(const QByteArray &data, int width, int height, int channels);
+
+    /**
+     * @brief 清除图像，恢复文本显示
+     */
+    void clearImage();
+
+    bool hasImage() const { return !m_image.isNull() || !m_tiles.isNull(); }
+    bool isTiled() const { return !m_tiles.isNull(); }
+    QSize imageSize() const { return isTiled() ? m_tiles.size() : m_image.size(); }
+
+    /**
+     * @brief 当前图像；分块显示时为整帧转换结果（按需转换，开销较大）
+     */
+    QImage image() const { return isTiled() ? m_tiles.toImage() : m_image; }
+
+    /**
+     * @brief 设置缩放因子，控件大小随之调整
+     */
+    void setZoomFactor(double factor);
+    double zoomFactor() const { return m_zoomFactor; }
+
+    /**
+     * @brief 设置缩放质量
+     */
+    void setScaleQuality(ScaleQuality quality);
+    ScaleQuality scaleQuality() const { return m_quality; }
+
+    /**
+     * @brief 显示文本并清除图像
+     */
+    void setText(const QString &text);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    /**
+     * @brief 新帧到达后调整控件大小并请求重绘
+     */
+    void frameChanged();
+
+    QSize scaledSize() const;
+
+    /**
+     * @brief 按当前缩放质量把图像绘制到 (0,0)-targetSize
+     */
+    void drawScaled(QPainter &painter, const QSize &targetSize);
+
+    /**
+     * @brief 分块显示：只绘制与可见区域相交的分块
+     */
+    void paintTiles(QPainter &painter, const QRect &exposed);
+
+    QImage m_image;             ///< 当前帧
+    QImage m_scaledCache;       ///< 缩放变化后生成的平滑缩放缓存
+    CImagePyramid m_pyramid;    ///< 当前帧的多分辨率金字塔（区域平均时按需生成）
+    CTiledFrame m_tiles;        ///< 分块显示的当前帧
+    double m_zoomFactor;        ///< 缩放因子
+    ScaleQuality m_quality;     ///< 缩放质量
+    bool m_cacheRequested;      ///< 缩放已变化，下次绘制时生成缓存
+};
+
+#endif // IMAGEVIEWER_H
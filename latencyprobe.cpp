@@ -0,0 +1,465 @@
+#include "latencyprobe.h"
+#include <QStringList>
+#include "frameprotocol.h"
+#include <QtAlgorithms>
+#include <algorithm>
+
+namespace {
+
+const char PROBE_PREFIX[] = "#PROBE ";
+const int PROBE_PREFIX_SIZE = sizeof(PROBE_PREFIX) - 1;
+
+/**
+ * @brief 微秒转为易读的时间文本
+ */
+QString formatMicros(qint64 micros)
+{
+    if (micros < 1000) {
+        return QString("%1µs").arg(micros);
+    }
+    if (micros < 1000000) {
+        return QString("%1ms").arg(micros / 1000.0, 0, 'g', 3);
+    }
+    return QString("%1s").arg(micros / 1e6, 0, 'g', 3);
+}
+
+} // namespace
+
+/**
+ * @brief CLatencyProbe构造函数
+ */
+CLatencyProbe::CLatencyProbe()
+    : m_running(false)
+    , m_matchBySequence(false)
+    , m_nextSequence(1)
+    , m_sent(0)
+    , m_replied(0)
+    , m_timeouts(0)
+    , m_unmatched(0)
+    , m_lastUs(0)
+    , m_minUs(0)
+    , m_maxUs(0)
+    , m_sumUs(0)
+    , m_window(WINDOW)
+    , m_next(0)
+    , m_filled(0)
+{
+    m_histogram.fill(0, HISTOGRAM_BUCKETS);
+    m_clock.start();
+}
+
+/**
+ * @brief 开始探测
+ * @param config 配置
+ * @param errorString 失败原因
+ * @return 配置有效返回true
+ */
+bool CLatencyProbe::start(const Config& config, QString* errorString)
+{
+    QString error;
+    QRegularExpression pattern(config.responsePattern);
+    if (config.intervalMs < 1) {
+        error = "发送间隔至少为1毫秒";
+    } else if (config.timeoutMs < 1) {
+        error = "应答超时至少为1毫秒";
+    } else if (config.maxInFlight < 1 || config.maxInFlight > MAX_IN_FLIGHT) {
+        error = QString("未应答请求数应在 1-%1 之间").arg(MAX_IN_FLIGHT);
+    } else if (config.mode == MODE_REQUEST && config.request.isEmpty()) {
+        error = "请求内容为空";
+    } else if (config.mode == MODE_REQUEST && !pattern.isValid()) {
+        error = QString("应答正则无效：%1").arg(pattern.errorString());
+    }
+    if (!error.isEmpty()) {
+        if (errorString) {
+            *errorString = error;
+        }
+        return false;
+    }
+
+    m_config = config;
+    m_pattern = pattern;
+    m_matchBySequence = pattern.namedCaptureGroups().contains("seq");
+
+    m_nextSequence = 1;
+    m_pending.clear();
+    m_order.clear();
+    m_buffer.clear();
+    m_sent = 0;
+    m_replied = 0;
+    m_timeouts = 0;
+    m_unmatched = 0;
+    m_lastUs = 0;
+    m_minUs = 0;
+    m_maxUs = 0;
+    m_sumUs = 0;
+    m_next = 0;
+    m_filled = 0;
+    m_histogram.fill(0);
+
+    m_running = true;
+    return true;
+}
+
+/**
+ * @brief 停止探测
+ */
+void CLatencyProbe::stop()
+{
+    m_running = false;
+    m_pending.clear();
+    m_order.clear();
+    m_buffer.clear();
+}
+
+/**
+ * @brief 请求已全部发出并都已应答或超时
+ */
+bool CLatencyProbe::isComplete() const
+{
+    return m_config.count > 0 && m_sent >= m_config.count && m_pending.isEmpty();
+}
+
+/**
+ * @brief 生成下一个请求并记录发送时刻
+ * @return 请求内容，不能发送时为空
+ */
+QByteArray CLatencyProbe::nextRequest()
+{
+    if (!m_running || m_pending.size() >= m_config.maxInFlight
+        || (m_config.count > 0 && m_sent >= m_config.count)) {
+        return QByteArray();
+    }
+
+    const quint64 sequence = m_nextSequence++;
+    QByteArray request;
+    if (m_config.mode == MODE_TIMESTAMP) {
+        request = probeMessage(sequence, FrameProtocol::wallClockMicros());
+    } else {
+        request = m_config.request;
+        request.replace("{seq}", QByteArray::number(sequence));
+    }
+
+    m_pending.insert(sequence, m_clock.nsecsElapsed());
+    m_order.enqueue(sequence);
+    m_sent++;
+    return request;
+}
+
+/**
+ * @brief 输入收到的数据
+ * @param data 数据
+ */
+void CLatencyProbe::feed(const QByteArray& data)
+{
+    if (!m_running || data.isEmpty()) {
+        return;
+    }
+
+    const qint64 now = m_clock.nsecsElapsed();
+    if (m_config.mode == MODE_REQUEST && m_config.responsePattern.isEmpty()) {
+        // 不区分应答内容：一次读到的数据算作最早请求的应答，没有未应答请求时是应答的后续分段
+        const quint64 sequence = oldestPending();
+        if (sequence != 0) {
+            complete(sequence, now);
+        }
+        return;
+    }
+
+    m_buffer.append(data);
+    if (m_config.mode == MODE_TIMESTAMP) {
+        matchProbes(now);
+    } else {
+        matchPattern(now);
+    }
+    if (m_buffer.size() > MAX_BUFFER) {
+        m_buffer = m_buffer.right(MAX_BUFFER);
+    }
+}
+
+/**
+ * @brief 把超过应答超时的请求计为超时
+ * @return 新增的超时数
+ */
+int CLatencyProbe::expire()
+{
+    const qint64 deadline = m_clock.nsecsElapsed() - qint64(m_config.timeoutMs) * 1000000;
+    int expired = 0;
+    while (!m_order.isEmpty()) {
+        QHash<quint64, qint64>::iterator it = m_pending.find(m_order.head());
+        if (it == m_pending.end()) {
+            m_order.dequeue();
+            continue;
+        }
+        if (it.value() > deadline) {
+            break;
+        }
+        m_pending.erase(it);
+        m_order.dequeue();
+        m_timeouts++;
+        expired++;
+    }
+    return expired;
+}
+
+/**
+ * @brief 当前统计
+ */
+CLatencyProbe::Stats CLatencyProbe::stats() const
+{
+    Stats stats;
+    stats.running = m_running;
+    stats.sent = m_sent;
+    stats.replied = m_replied;
+    stats.timeouts = m_timeouts;
+    stats.unmatched = m_unmatched;
+    stats.inFlight = m_pending.size();
+    stats.windowCount = m_filled;
+    stats.minUs = m_minUs;
+    stats.maxUs = m_maxUs;
+    stats.lastUs = m_lastUs;
+    stats.histogram = m_histogram;
+    if (m_replied > 0) {
+        stats.meanUs = double(m_sumUs) / m_replied;
+    }
+    if (m_filled == 0) {
+        return stats;
+    }
+
+    QVector<qint64> sorted(m_window.mid(0, m_filled));
+    std::sort(sorted.begin(), sorted.end());
+    const int n = sorted.size();
+    auto percentile = [&sorted, n](double p) {
+        return sorted[qBound(0, int(p * (n - 1) + 0.5), n - 1)];
+    };
+    stats.p50Us = percentile(0.50);
+    stats.p90Us = percentile(0.90);
+    stats.p99Us = percentile(0.99);
+    return stats;
+}
+
+/**
+ * @brief 生成多行统计文本
+ * @param stats 统计
+ * @return 请求计数、RTT分位数和直方图
+ */
+QString CLatencyProbe::formatStats(const Stats& stats)
+{
+    QString text = QString("延迟探测：已发 %1，应答 %2，超时 %3，未匹配 %4，等待中 %5\n")
+                   .arg(stats.sent).arg(stats.replied).arg(stats.timeouts)
+                   .arg(stats.unmatched).arg(stats.inFlight);
+    if (stats.replied == 0) {
+        return text;
+    }
+
+    text += QString("RTT：最近 %1 | min %2 | p50 %3 | p90 %4 | p99 %5 | max %6 | 平均 %7 (近%8次)\n")
+            .arg(formatMicros(stats.lastUs))
+            .arg(formatMicros(stats.minUs))
+            .arg(formatMicros(stats.p50Us))
+            .arg(formatMicros(stats.p90Us))
+            .arg(formatMicros(stats.p99Us))
+            .arg(formatMicros(stats.maxUs))
+            .arg(formatMicros(qint64(stats.meanUs + 0.5)))
+            .arg(stats.windowCount);
+
+    // 直方图：只列出有数据的桶
+    QStringList buckets;
+    for (int i = 0; i < stats.histogram.size(); ++i) {
+        if (stats.histogram[i] > 0) {
+            buckets << QString("%1:%2%")
+                       .arg(histogramLabel(i))
+                       .arg(stats.histogram[i] * 100.0 / stats.replied, 0, 'f', 1);
+        }
+    }
+    text += QString("RTT分布：%1\n").arg(buckets.join("  "));
+    return text;
+}
+
+/**
+ * @brief 直方图桶的范围说明
+ * @param bucket 桶序号
+ */
+QString CLatencyProbe::histogramLabel(int bucket)
+{
+    if (bucket <= 0) {
+        return QString("<1µs");
+    }
+    const qint64 lower = qint64(1) << (bucket - 1);
+    if (bucket >= HISTOGRAM_BUCKETS - 1) {
+        return QString("≥%1").arg(formatMicros(lower));
+    }
+    return QString("%1-%2").arg(formatMicros(lower)).arg(formatMicros(lower << 1));
+}
+
+/**
+ * @brief 时间戳探测消息
+ * @param sequence 序号
+ * @param timestampUs 发送时刻（微秒）
+ */
+QByteArray CLatencyProbe::probeMessage(quint64 sequence, qint64 timestampUs)
+{
+    QByteArray message(PROBE_PREFIX, PROBE_PREFIX_SIZE);
+    message += QByteArray::number(sequence);
+    message += ' ';
+    message += QByteArray::number(timestampUs);
+    message += '\n';
+    return message;
+}
+
+/**
+ * @brief 解析请求文本中的转义
+ * @param text 文本（非转义部分按UTF-8编码）
+ * @return 字节内容
+ */
+QByteArray CLatencyProbe::unescape(const QString& text)
+{
+    QByteArray result;
+    const QByteArray utf8 = text.toUtf8();
+    for (int i = 0; i < utf8.size(); ++i) {
+        const char c = utf8[i];
+        if (c != '\\' || i + 1 >= utf8.size()) {
+            result += c;
+            continue;
+        }
+
+        const char next = utf8[i + 1];
+        bool ok = false;
+        switch (next) {
+        case 'r':  result += '\r'; ++i; break;
+        case 'n':  result += '\n'; ++i; break;
+        case 't':  result += '\t'; ++i; break;
+        case '0':  result += '\0'; ++i; break;
+        case '\\': result += '\\'; ++i; break;
+        case 'x': {
+            const int value = utf8.mid(i + 2, 2).toInt(&ok, 16);
+            if (ok && value >= 0 && i + 3 < utf8.size()) {
+                result += char(value);
+                i += 3;
+            } else {
+                result += c;
+            }
+            break;
+        }
+        default:
+            result += c;
+            break;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 匹配到请求的应答：记录RTT
+ * @param sequence 请求序号
+ * @param nowNs 收到应答的时刻
+ */
+void CLatencyProbe::complete(quint64 sequence, qint64 nowNs)
+{
+    const qint64 sentNs = m_pending.take(sequence);
+    const qint64 micros = qMax<qint64>(0, nowNs - sentNs) / 1000;
+
+    m_minUs = (m_replied == 0) ? micros : qMin(m_minUs, micros);
+    m_maxUs = qMax(m_maxUs, micros);
+    m_sumUs += micros;
+    m_lastUs = micros;
+    m_replied++;
+
+    m_window[m_next] = micros;
+    m_next = (m_next + 1) % WINDOW;
+    if (m_filled < WINDOW) {
+        m_filled++;
+    }
+    m_histogram[bucketIndex(micros)]++;
+}
+
+/**
+ * @brief 时间戳探测：解析回显的探测消息，按序号匹配
+ * @param nowNs 当前时刻
+ */
+void CLatencyProbe::matchProbes(qint64 nowNs)
+{
+    int consumed = 0;
+    forever {
+        const int start = m_buffer.indexOf(PROBE_PREFIX, consumed);
+        if (start < 0) {
+            // 末尾可能是被分段截断的前缀
+            consumed = qMax(consumed, m_buffer.size() - (PROBE_PREFIX_SIZE - 1));
+            break;
+        }
+        const int end = m_buffer.indexOf('\n', start);
+        if (end < 0) {
+            consumed = start;
+            break;
+        }
+
+        const QByteArray fields = m_buffer.mid(start + PROBE_PREFIX_SIZE, end - start - PROBE_PREFIX_SIZE);
+        bool ok = false;
+        const quint64 sequence = fields.split(' ').first().toULongLong(&ok);
+        if (ok && m_pending.contains(sequence)) {
+            complete(sequence, nowNs);
+        } else {
+            m_unmatched++;
+        }
+        consumed = end + 1;
+    }
+    m_buffer.remove(0, consumed);
+}
+
+/**
+ * @brief 自定义请求：在缓冲中查找应答
+ * @param nowNs 当前时刻
+ */
+void CLatencyProbe::matchPattern(qint64 nowNs)
+{
+    // Latin-1 解码保证字符位置与字节位置一致
+    const QString text = QString::fromLatin1(m_buffer);
+    int consumed = 0;
+    forever {
+        const QRegularExpressionMatch match = m_pattern.match(text, consumed);
+        if (!match.hasMatch() || match.capturedEnd() <= match.capturedStart()) {
+            break;
+        }
+        consumed = match.capturedEnd();
+
+        quint64 sequence = 0;
+        if (m_matchBySequence) {
+            bool ok = false;
+            sequence = match.captured("seq").toULongLong(&ok);
+            if (!ok || !m_pending.contains(sequence)) {
+                sequence = 0;
+            }
+        } else {
+            sequence = oldestPending();
+        }
+
+        if (sequence != 0) {
+            complete(sequence, nowNs);
+        } else {
+            m_unmatched++;
+        }
+    }
+    m_buffer.remove(0, consumed);
+}
+
+/**
+ * @brief 按发送顺序最早的未应答请求
+ * @return 请求序号，没有时返回0
+ */
+quint64 CLatencyProbe::oldestPending()
+{
+    while (!m_order.isEmpty() && !m_pending.contains(m_order.head())) {
+        m_order.dequeue();
+    }
+    return m_order.isEmpty() ? 0 : m_order.head();
+}
+
+/**
+ * @brief RTT所在的直方图桶
+ */
+int CLatencyProbe::bucketIndex(qint64 micros)
+{
+    if (micros <= 0) {
+        return 0;
+    }
+    const int bucket = 64 - qCountLeadingZeroBits(quint64(micros));
+    return qMin(bucket, int(HISTOGRAM_BUCKETS) - 1);
+}
@@ -0,0 +1,201 @@
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include <QQueue>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QMetaType>
+
+/**
+ * @class CLatencyProbe
+ * @brief 网络调试器的请求/应答延迟探测
+ *
+ * 按固定间隔发出请求，在收到的数据中找到对应的应答，记录往返时间（RTT）：
+ * - 时间戳探测：发送 "#PROBE <序号> <发送时刻微秒>\n"，对端原样回显
+ *   （如调试器自己的回显服务器），按序号匹配应答
+ * - 自定义请求：发送用户给定的指令（{seq} 替换为序号），应答用正则匹配；
+ *   正则含命名分组 seq 时按序号匹配，否则按发送顺序匹配最早未应答的请求，
+ *   正则为空时收到任意数据即视为最早请求的应答
+ *
+ * RTT 以本机单调时钟计算，不依赖两端时钟同步。超时未应答的请求计为超时，
+ * 之后再到达的应答计为无法匹配。分位数取最近 WINDOW 个样本，直方图为累计值。
+ * 所有接口都在调用者线程中使用（调试器在界面线程中驱动）。
+ */
+class CLatencyProbe
+{
+public:
+    /**
+     * @enum Mode
+     * @brief 探测方式
+     */
+    enum Mode {
+        MODE_TIMESTAMP,     ///< 时间戳探测消息，对端回显
+        MODE_REQUEST        ///< 自定义请求，按正则匹配应答
+    };
+
+    /**
+     * @struct Config
+     * @brief 探测配置
+     */
+    struct Config
+    {
+        Mode mode = MODE_TIMESTAMP;
+        int intervalMs = 100;           ///< 发送间隔
+        int count = 0;                  ///< 请求总数，0表示直到停止
+        int timeoutMs = 2000;           ///< 应答超时
+        int maxInFlight = 1;            ///< 最多同时未应答的请求数，1为一问一答
+        QByteArray request;             ///< MODE_REQUEST 的请求内容，{seq} 替换为序号
+        QString responsePattern;        ///< MODE_REQUEST 的应答正则，空表示任意数据
+    };
+
+    /**
+     * @struct Stats
+     * @brief 探测统计（时间单位：微秒）
+     */
+    struct Stats
+    {
+        bool running = false;
+        qint64 sent = 0;                ///< 已发出的请求数
+        qint64 replied = 0;             ///< 收到应答的请求数
+        qint64 timeouts = 0;            ///< 超时的请求数
+        qint64 unmatched = 0;           ///< 无法匹配到请求的应答数
+        int inFlight = 0;               ///< 当前未应答的请求数
+        int windowCount = 0;            ///< 分位数使用的样本数
+        qint64 minUs = 0;
+        qint64 p50Us = 0;
+        qint64 p90Us = 0;
+        qint64 p99Us = 0;
+        qint64 maxUs = 0;
+        double meanUs = 0.0;
+        qint64 lastUs = 0;              ///< 最近一次应答的RTT
+        QVector<qint64> histogram;      ///< 累计直方图，第i桶为 [2^(i-1), 2^i) 微秒
+    };
+
+    static const int WINDOW = 4096;                 ///< 分位数使用的最近样本数
+    static const int HISTOGRAM_BUCKETS = 32;        ///< 直方图桶数
+    static const int MAX_IN_FLIGHT = 1024;          ///< 同时未应答的请求数上限
+    static const int MAX_BUFFER = 64 * 1024;        ///< 未匹配的接收数据最多保留的字节数
+
+    CLatencyProbe();
+
+    /**
+     * @brief 开始探测（清空之前的统计）
+     * @param config 配置
+     * @param errorString 配置无效时的原因
+     * @return 配置无效（如正则错误）时返回false
+     */
+    bool start(const Config& config, QString* errorString = nullptr);
+
+    /**
+     * @brief 停止探测，未应答的请求不再计入超时
+     */
+    void stop();
+
+    bool isRunning() const { return m_running; }
+    const Config& config() const { return m_config; }
+
+    /**
+     * @brief 请求已全部发出并都已应答或超时
+     */
+    bool isComplete() const;
+
+    /**
+     * @brief 生成下一个请求并记录发送时刻
+     * @return 达到总数或未应答请求已满时为空
+     */
+    QByteArray nextRequest();
+
+    /**
+     * @brief 输入收到的数据（可以是任意分段）
+     */
+    void feed(const QByteArray& data);
+
+    /**
+     * @brief 把超过应答超时的请求计为超时
+     * @return 本次新增的超时数
+     */
+    int expire();
+
+    /**
+     * @brief 当前统计
+     */
+    Stats stats() const;
+
+    /**
+     * @brief 生成多行统计文本（含直方图）
+     */
+    static QString formatStats(const Stats& stats);
+
+    /**
+     * @brief 直方图桶的范围说明，如 "1-2ms"
+     */
+    static QString histogramLabel(int bucket);
+
+    /**
+     * @brief 时间戳探测消息
+     * @param sequence 序号
+     * @param timestampUs 发送时刻（Unix纪元微秒，仅供对端记录）
+     */
+    static QByteArray probeMessage(quint64 sequence, qint64 timestampUs);
+
+    /**
+     * @brief 解析请求文本中的转义：\r \n \t \\ 和 \xHH
+     */
+    static QByteArray unescape(const QString& text);
+
+private:
+    /**
+     * @brief 匹配到请求的应答：记录RTT
+     */
+    void complete(quint64 sequence, qint64 nowNs);
+
+    /**
+     * @brief 时间戳探测：从缓冲中解析回显的探测消息
+     */
+    void matchProbes(qint64 nowNs);
+
+    /**
+     * @brief 自定义请求：在缓冲中查找应答
+     */
+    void matchPattern(qint64 nowNs);
+
+    /**
+     * @brief 按发送顺序最早的未应答请求
+     * @return 没有时返回0
+     */
+    quint64 oldestPending();
+
+    static int bucketIndex(qint64 micros);
+
+    Config m_config;
+    bool m_running;
+    QElapsedTimer m_clock;
+    QRegularExpression m_pattern;
+    bool m_matchBySequence;                 ///< 应答正则含 seq 分组
+
+    quint64 m_nextSequence;
+    QHash<quint64, qint64> m_pending;       ///< 未应答的请求：序号 → 发送时刻（纳秒）
+    QQueue<quint64> m_order;                ///< 请求的发送顺序（已应答的在出队时跳过）
+    QByteArray m_buffer;                    ///< 未匹配完的接收数据
+
+    qint64 m_sent;
+    qint64 m_replied;
+    qint64 m_timeouts;
+    qint64 m_unmatched;
+    qint64 m_lastUs;
+    qint64 m_minUs;
+    qint64 m_maxUs;
+    qint64 m_sumUs;
+    QVector<qint64> m_window;               ///< 最近样本的环形缓冲
+    int m_next;
+    int m_filled;
+    QVector<qint64> m_histogram;
+};
+
+Q_DECLARE_METATYPE(CLatencyProbe::Stats)
+
+#endif // LATENCYPROBE_H
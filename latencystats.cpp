@@ -0,0 +1,296 @@
+#include "latencystats.h"
+#include <QFile>
+#include <QTextStream>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QDateTime>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QStringConverter>
+#endif
+#include <algorithm>
+
+/**
+ * @brief CLatencyStats构造函数
+ * @param windowSize 滚动窗口大小（帧）
+ */
+CLatencyStats::CLatencyStats(int windowSize)
+    : m_windowSize(qMax(1, windowSize))
+{
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        m_stages[i].window.resize(m_windowSize);
+        m_stages[i].histogram.fill(0, HISTOGRAM_BUCKETS);
+    }
+}
+
+/**
+ * @brief 记录一个样本
+ * @param stage 阶段
+ * @param micros 耗时（微秒）
+ */
+void CLatencyStats::record(Stage stage, qint64 micros)
+{
+    if (stage < 0 || stage >= STAGE_COUNT) {
+        return;
+    }
+
+    StageData& data = m_stages[stage];
+    micros = qMax<qint64>(0, micros);
+
+    data.window[data.next] = micros;
+    data.next = (data.next + 1) % m_windowSize;
+    if (data.filled < m_windowSize) {
+        data.filled++;
+    }
+    data.totalCount++;
+    data.totalSum += micros;
+    data.histogram[bucketIndex(micros)]++;
+}
+
+/**
+ * @brief 清空所有样本
+ */
+void CLatencyStats::reset()
+{
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        m_stages[i].next = 0;
+        m_stages[i].filled = 0;
+        m_stages[i].totalCount = 0;
+        m_stages[i].totalSum = 0;
+        m_stages[i].histogram.fill(0);
+    }
+}
+
+/**
+ * @brief 计算阶段统计摘要
+ * @param stage 阶段
+ * @return 滚动窗口内的分位数和均值
+ */
+CLatencyStats::Summary CLatencyStats::summary(Stage stage) const
+{
+    Summary result;
+    if (stage < 0 || stage >= STAGE_COUNT) {
+        return result;
+    }
+
+    const StageData& data = m_stages[stage];
+    result.windowCount = data.filled;
+    result.totalCount = data.totalCount;
+    result.totalSum = data.totalSum;
+    if (data.filled == 0) {
+        return result;
+    }
+
+    // 窗口未写满时有效样本位于 [0, filled)，写满后整个缓冲都有效，顺序不影响分位数
+    QVector<qint64> sorted(data.window.mid(0, data.filled));
+    std::sort(sorted.begin(), sorted.end());
+
+    const int n = sorted.size();
+    auto percentile = [&sorted, n](double p) {
+        const int index = qBound(0, int(p * (n - 1) + 0.5), n - 1);
+        return sorted[index];
+    };
+
+    double sum = 0.0;
+    for (qint64 value : sorted) {
+        sum += double(value);
+    }
+
+    result.p50 = percentile(0.50);
+    result.p90 = percentile(0.90);
+    result.p99 = percentile(0.99);
+    result.max = sorted[n - 1];
+    result.mean = sum / n;
+    return result;
+}
+
+/**
+ * @brief 获取阶段名称
+ * @param stage 阶段
+ */
+QString CLatencyStats::stageName(Stage stage)
+{
+    switch (stage) {
+    case STAGE_NETWORK: return "网络";
+    case STAGE_RECEIVE: return "接收";
+    case STAGE_CONVERT: return "转换";
+    case STAGE_DISPLAY: return "显示";
+    case STAGE_PAINT:   return "绘制";
+    case STAGE_TOTAL:   return "总计";
+    default:            return "未知";
+    }
+}
+
+/**
+ * @brief 获取阶段英文标识
+ * @param stage 阶段
+ */
+QString CLatencyStats::stageKey(Stage stage)
+{
+    switch (stage) {
+    case STAGE_NETWORK: return "network";
+    case STAGE_RECEIVE: return "receive";
+    case STAGE_CONVERT: return "convert";
+    case STAGE_DISPLAY: return "display";
+    case STAGE_PAINT:   return "paint";
+    case STAGE_TOTAL:   return "total";
+    default:            return "unknown";
+    }
+}
+
+/**
+ * @brief 生成多行统计文本
+ * @return 每个阶段一行：p50/p90/p99/max/平均值（毫秒）
+ */
+QString CLatencyStats::summaryText() const
+{
+    QString text;
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        const Stage stage = static_cast<Stage>(i);
+        const Summary s = summary(stage);
+        if (!text.isEmpty()) {
+            text += "\n";
+        }
+        if (s.windowCount == 0) {
+            text += QString("%1：无数据").arg(stageName(stage));
+            continue;
+        }
+        text += QString("%1：p50 %2 ms | p90 %3 ms | p99 %4 ms | max %5 ms | 平均 %6 ms（%7帧）")
+                .arg(stageName(stage))
+                .arg(s.p50 / 1000.0, 0, 'f', 2)
+                .arg(s.p90 / 1000.0, 0, 'f', 2)
+                .arg(s.p99 / 1000.0, 0, 'f', 2)
+                .arg(s.max / 1000.0, 0, 'f', 2)
+                .arg(s.mean / 1000.0, 0, 'f', 2)
+                .arg(s.windowCount);
+    }
+    return text;
+}
+
+/**
+ * @brief 导出为JSON对象
+ * @return 包含窗口大小和各阶段摘要、直方图的JSON对象
+ */
+QJsonObject CLatencyStats::toJson() const
+{
+    QJsonObject root;
+    root["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["unit"] = "us";
+    root["window_size"] = m_windowSize;
+
+    QJsonArray stages;
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        const Stage stage = static_cast<Stage>(i);
+        const Summary s = summary(stage);
+
+        QJsonObject obj;
+        obj["stage"] = stageName(stage);
+        obj["window_count"] = s.windowCount;
+        obj["total_count"] = double(s.totalCount);
+        obj["p50"] = double(s.p50);
+        obj["p90"] = double(s.p90);
+        obj["p99"] = double(s.p99);
+        obj["max"] = double(s.max);
+        obj["mean"] = s.mean;
+
+        // 直方图只输出非空桶：{"le": 桶上界（微秒）, "count": 累计次数}
+        QJsonArray buckets;
+        const QVector<qint64>& histogram = m_stages[i].histogram;
+        for (int b = 0; b < histogram.size(); ++b) {
+            if (histogram[b] == 0) {
+                continue;
+            }
+            QJsonObject bucket;
+            bucket["le"] = double(qint64(1) << b);
+            bucket["count"] = double(histogram[b]);
+            buckets.append(bucket);
+        }
+        obj["histogram"] = buckets;
+        stages.append(obj);
+    }
+    root["stages"] = stages;
+    return root;
+}
+
+/**
+ * @brief 导出为CSV文本
+ * @return 摘要表和直方图表，单位微秒
+ */
+QString CLatencyStats::toCsv() const
+{
+    QString csv;
+    csv += "stage,window_count,total_count,p50_us,p90_us,p99_us,max_us,mean_us\n";
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        const Stage stage = static_cast<Stage>(i);
+        const Summary s = summary(stage);
+        csv += QString("%1,%2,%3,%4,%5,%6,%7,%8\n")
+               .arg(stageName(stage))
+               .arg(s.windowCount)
+               .arg(s.totalCount)
+               .arg(s.p50)
+               .arg(s.p90)
+               .arg(s.p99)
+               .arg(s.max)
+               .arg(s.mean, 0, 'f', 1);
+    }
+
+    csv += "\nstage,bucket_le_us,count\n";
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        const QVector<qint64>& histogram = m_stages[i].histogram;
+        for (int b = 0; b < histogram.size(); ++b) {
+            if (histogram[b] > 0) {
+                csv += QString("%1,%2,%3\n")
+                       .arg(stageName(static_cast<Stage>(i)))
+                       .arg(qint64(1) << b)
+                       .arg(histogram[b]);
+            }
+        }
+    }
+    return csv;
+}
+
+/**
+ * @brief 导出到文件
+ * @param fileName 文件路径
+ * @param errorString 失败时的错误信息
+ * @return 成功返回true
+ */
+bool CLatencyStats::exportToFile(const QString& fileName, QString* errorString) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+
+    if (fileName.endsWith(".json", Qt::CaseInsensitive)) {
+        file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+    } else {
+        QTextStream out(&file);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        out.setCodec("UTF-8");  // Qt 5中设置UTF-8编码
+#else
+        out.setEncoding(QStringConverter::Utf8);  // Qt 6中设置UTF-8编码
+#endif
+        out << toCsv();
+    }
+
+    file.close();
+    return true;
+}
+
+/**
+ * @brief 计算样本所在的直方图桶
+ * @param micros 耗时（微秒）
+ * @return 桶序号：0 表示小于1微秒，i 表示 [2^(i-1), 2^i)，超出范围归入最后一桶
+ */
+int CLatencyStats::bucketIndex(qint64 micros)
+{
+    int index = 0;
+    while (micros > 0 && index < HISTOGRAM_BUCKETS - 1) {
+        micros >>= 1;
+        index++;
+    }
+    return index;
+}
@@ -0,0 +1,134 @@
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+
+/**
+ * @class CLatencyStats
+ * @brief 端到端延迟统计
+ *
+ * 按阶段记录每帧耗时（微秒），提供滚动窗口内的分位数和累计直方图：
+ * - 网络：发送时间戳 → 收到第一个字节（仅扩展帧头，需两端时钟同步）
+ * - 接收：收到第一个字节 → 组帧完成
+ * - 转换：组帧完成 → 转换为显示图像（含显示调度器合并刷新的等待；
+ *   大帧分块显示时分块在绘制中按需转换，不计入本阶段）
+ * - 显示：转换完成 → 交给显示控件（含适应窗口计算）
+ * - 绘制：交给显示控件 → 显示控件收到绘制事件
+ * - 总计：发送时间戳（无扩展帧头时为收到第一个字节）→ 绘制
+ *
+ * 记录操作只写入环形缓冲和直方图计数，分位数在查询时计算，
+ * 界面按秒刷新时开销可以忽略。
+ */
+class CLatencyStats
+{
+public:
+    /**
+     * @enum Stage
+     * @brief 延迟统计阶段
+     */
+    enum Stage {
+        STAGE_NETWORK,      ///< 网络传输
+        STAGE_RECEIVE,      ///< 接收组帧
+        STAGE_CONVERT,      ///< 图像转换
+        STAGE_DISPLAY,      ///< 更新显示
+        STAGE_PAINT,        ///< 等待绘制
+        STAGE_TOTAL,        ///< 端到端
+        STAGE_COUNT
+    };
+
+    /**
+     * @struct Summary
+     * @brief 单个阶段的统计摘要（单位：微秒）
+     */
+    struct Summary
+    {
+        int windowCount = 0;    ///< 滚动窗口内的样本数
+        qint64 totalCount = 0;  ///< 累计样本数
+        qint64 totalSum = 0;    ///< 累计样本总和
+        qint64 p50 = 0;
+        qint64 p90 = 0;
+        qint64 p99 = 0;
+        qint64 max = 0;
+        double mean = 0.0;
+    };
+
+    static const int DEFAULT_WINDOW = 2048;     ///< 默认滚动窗口大小（帧）
+    static const int HISTOGRAM_BUCKETS = 32;    ///< 直方图桶数，第i桶为 [2^(i-1), 2^i) 微秒
+
+    explicit CLatencyStats(int windowSize = DEFAULT_WINDOW);
+
+    /**
+     * @brief 记录一个样本
+     * @param stage 阶段
+     * @param micros 耗时（微秒），负值视为时钟误差，记为0
+     */
+    void record(Stage stage, qint64 micros);
+
+    /**
+     * @brief 清空所有样本
+     */
+    void reset();
+
+    /**
+     * @brief 计算阶段统计摘要
+     */
+    Summary summary(Stage stage) const;
+
+    /**
+     * @brief 获取阶段的累计直方图
+     */
+    const QVector<qint64>& histogram(Stage stage) const { return m_stages[stage].histogram; }
+
+    /**
+     * @brief 获取阶段名称
+     */
+    static QString stageName(Stage stage);
+
+    /**
+     * @brief 获取阶段英文标识（用于导出指标的标签）
+     */
+    static QString stageKey(Stage stage);
+
+    /**
+     * @brief 生成多行统计文本（用于提示和日志）
+     */
+    QString summaryText() const;
+
+    /**
+     * @brief 导出为JSON对象（含各阶段摘要和直方图）
+     */
+    QJsonObject toJson() const;
+
+    /**
+     * @brief 导出为CSV文本（每阶段一行摘要，随后为直方图）
+     */
+    QString toCsv() const;
+
+    /**
+     * @brief 导出到文件，扩展名为 .json 时写JSON，否则写CSV
+     * @param fileName 文件路径
+     * @param errorString 失败时的错误信息
+     * @return 成功返回true
+     */
+    bool exportToFile(const QString& fileName, QString* errorString = nullptr) const;
+
+private:
+    struct StageData
+    {
+        QVector<qint64> window;     ///< 滚动窗口环形缓冲
+        int next = 0;               ///< 下一个写入位置
+        int filled = 0;             ///< 已写入样本数（不超过窗口大小）
+        qint64 totalCount = 0;
+        qint64 totalSum = 0;
+        QVector<qint64> histogram;  ///< 累计直方图
+    };
+
+    static int bucketIndex(qint64 micros);
+
+    int m_windowSize;
+    StageData m_stages[STAGE_COUNT];
+};
+
+#endif // LATENCYSTATS_H
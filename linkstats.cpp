@@ -0,0 +1,307 @@
+#include "linkstats.h"
+#include <QStringList>
+#include <QtAlgorithms>
+
+/**
+ * @brief CLinkStats构造函数
+ */
+CLinkStats::CLinkStats()
+    : m_lastArrivalNs(0)
+    , m_lastGapUs(-1)
+    , m_window(WINDOW_SECONDS)
+    , m_next(0)
+    , m_filled(0)
+{
+    m_counters.rxBytes.store(0);
+    m_counters.rxPackets.store(0);
+    m_counters.txBytes.store(0);
+    m_counters.txPackets.store(0);
+    m_counters.jitterSumUs.store(0);
+    m_counters.jitterCount.store(0);
+    for (int i = 0; i < SIZE_BUCKETS; ++i) {
+        m_counters.sizes[i].store(0);
+    }
+    for (int i = 0; i < GAP_BUCKETS; ++i) {
+        m_counters.gaps[i].store(0);
+    }
+    m_snapshot.sizeHistogram.fill(0, SIZE_BUCKETS);
+    m_clock.start();
+}
+
+/**
+ * @brief 记录收到一个包
+ * @param bytes 字节数
+ */
+void CLinkStats::recordReceived(qint64 bytes)
+{
+    m_counters.rxBytes.fetch_add(bytes, std::memory_order_relaxed);
+    m_counters.rxPackets.fetch_add(1, std::memory_order_relaxed);
+    m_counters.sizes[sizeBucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+
+    // 多个线程同时到达时各自与最近一次到达比较，间隔之和仍等于总时长
+    const qint64 now = qMax<qint64>(1, m_clock.nsecsElapsed());
+    const qint64 previous = m_lastArrivalNs.exchange(now, std::memory_order_relaxed);
+    if (previous <= 0) {
+        return;
+    }
+    const qint64 gapUs = qMax<qint64>(0, now - previous) / 1000;
+    m_counters.gaps[gapBucket(gapUs)].fetch_add(1, std::memory_order_relaxed);
+
+    const qint64 previousGap = m_lastGapUs.exchange(gapUs, std::memory_order_relaxed);
+    if (previousGap >= 0) {
+        m_counters.jitterSumUs.fetch_add(qAbs(gapUs - previousGap), std::memory_order_relaxed);
+        m_counters.jitterCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief 记录发送
+ * @param bytes 字节数
+ * @param packets 包数
+ */
+void CLinkStats::recordSent(qint64 bytes, qint64 packets)
+{
+    if (bytes != 0) {
+        m_counters.txBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    if (packets != 0) {
+        m_counters.txPackets.fetch_add(packets, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief 读取累计计数
+ */
+CLinkStats::Totals CLinkStats::load() const
+{
+    Totals totals;
+    totals.rxBytes = m_counters.rxBytes.load(std::memory_order_relaxed);
+    totals.rxPackets = m_counters.rxPackets.load(std::memory_order_relaxed);
+    totals.txBytes = m_counters.txBytes.load(std::memory_order_relaxed);
+    totals.txPackets = m_counters.txPackets.load(std::memory_order_relaxed);
+    totals.jitterSumUs = m_counters.jitterSumUs.load(std::memory_order_relaxed);
+    totals.jitterCount = m_counters.jitterCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < SIZE_BUCKETS; ++i) {
+        totals.sizes[i] = m_counters.sizes[i].load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < GAP_BUCKETS; ++i) {
+        totals.gaps[i] = m_counters.gaps[i].load(std::memory_order_relaxed);
+    }
+    totals.elapsedMs = m_clock.elapsed();
+    return totals;
+}
+
+/**
+ * @brief 取样并计算滑动窗口统计
+ * @return 统计结果
+ */
+CLinkStats::Snapshot CLinkStats::sample()
+{
+    const Totals current = load();
+
+    // 本秒增量存入环形窗口
+    Totals& delta = m_window[m_next];
+    delta.rxBytes = current.rxBytes - m_previous.rxBytes;
+    delta.rxPackets = current.rxPackets - m_previous.rxPackets;
+    delta.txBytes = current.txBytes - m_previous.txBytes;
+    delta.txPackets = current.txPackets - m_previous.txPackets;
+    delta.jitterSumUs = current.jitterSumUs - m_previous.jitterSumUs;
+    delta.jitterCount = current.jitterCount - m_previous.jitterCount;
+    for (int i = 0; i < SIZE_BUCKETS; ++i) {
+        delta.sizes[i] = current.sizes[i] - m_previous.sizes[i];
+    }
+    for (int i = 0; i < GAP_BUCKETS; ++i) {
+        delta.gaps[i] = current.gaps[i] - m_previous.gaps[i];
+    }
+    delta.elapsedMs = qMax<qint64>(1, current.elapsedMs - m_previous.elapsedMs);
+    m_previous = current;
+    m_next = (m_next + 1) % WINDOW_SECONDS;
+    m_filled = qMin(m_filled + 1, int(WINDOW_SECONDS));
+
+    // 汇总窗口
+    Snapshot snapshot;
+    snapshot.sizeHistogram.fill(0, SIZE_BUCKETS);
+    Totals sum;
+    for (int n = 0; n < m_filled; ++n) {
+        const Totals& second = m_window[n];
+        const double seconds = second.elapsedMs / 1000.0;
+        snapshot.peakRxBytesPerSec = qMax(snapshot.peakRxBytesPerSec, second.rxBytes / seconds);
+        snapshot.peakTxBytesPerSec = qMax(snapshot.peakTxBytesPerSec, second.txBytes / seconds);
+
+        sum.rxBytes += second.rxBytes;
+        sum.rxPackets += second.rxPackets;
+        sum.txBytes += second.txBytes;
+        sum.txPackets += second.txPackets;
+        sum.jitterSumUs += second.jitterSumUs;
+        sum.jitterCount += second.jitterCount;
+        sum.elapsedMs += second.elapsedMs;
+        for (int i = 0; i < SIZE_BUCKETS; ++i) {
+            snapshot.sizeHistogram[i] += second.sizes[i];
+        }
+        for (int i = 0; i < GAP_BUCKETS; ++i) {
+            sum.gaps[i] += second.gaps[i];
+        }
+    }
+
+    const double windowSeconds = sum.elapsedMs / 1000.0;
+    const double lastSeconds = delta.elapsedMs / 1000.0;
+    snapshot.windowSeconds = windowSeconds;
+    snapshot.rxBytesPerSec = sum.rxBytes / windowSeconds;
+    snapshot.txBytesPerSec = sum.txBytes / windowSeconds;
+    snapshot.rxPacketsPerSec = sum.rxPackets / windowSeconds;
+    snapshot.txPacketsPerSec = sum.txPackets / windowSeconds;
+    snapshot.lastRxBytesPerSec = delta.rxBytes / lastSeconds;
+    snapshot.lastTxBytesPerSec = delta.txBytes / lastSeconds;
+    snapshot.rxPackets = sum.rxPackets;
+    snapshot.jitterUs = sum.jitterCount > 0 ? double(sum.jitterSumUs) / sum.jitterCount : 0.0;
+
+    // 到达间隔分位数：取所在桶的上界
+    qint64 gapCount = 0;
+    for (int i = 0; i < GAP_BUCKETS; ++i) {
+        gapCount += sum.gaps[i];
+    }
+    if (gapCount > 0) {
+        const qint64 rank50 = (gapCount * 50 + 99) / 100;
+        const qint64 rank90 = (gapCount * 90 + 99) / 100;
+        const qint64 rank99 = (gapCount * 99 + 99) / 100;
+        qint64 seen = 0;
+        for (int i = 0; i < GAP_BUCKETS; ++i) {
+            if (sum.gaps[i] == 0) {
+                continue;
+            }
+            const qint64 before = seen;
+            seen += sum.gaps[i];
+            const qint64 upper = gapBucketUpper(i);
+            if (before < rank50 && seen >= rank50) {
+                snapshot.gapP50Us = upper;
+            }
+            if (before < rank90 && seen >= rank90) {
+                snapshot.gapP90Us = upper;
+            }
+            if (before < rank99 && seen >= rank99) {
+                snapshot.gapP99Us = upper;
+            }
+            snapshot.gapMaxUs = upper;
+        }
+    }
+
+    m_snapshot = snapshot;
+    return snapshot;
+}
+
+/**
+ * @brief 清空窗口
+ */
+void CLinkStats::reset()
+{
+    m_previous = load();
+    m_window = QVector<Totals>(WINDOW_SECONDS);
+    m_next = 0;
+    m_filled = 0;
+    m_lastArrivalNs.store(0, std::memory_order_relaxed);
+    m_lastGapUs.store(-1, std::memory_order_relaxed);
+    m_snapshot = Snapshot();
+    m_snapshot.sizeHistogram.fill(0, SIZE_BUCKETS);
+}
+
+/**
+ * @brief 生成多行统计文本
+ * @param snapshot 统计
+ */
+QString CLinkStats::formatSnapshot(const Snapshot& snapshot)
+{
+    if (snapshot.windowSeconds <= 0.0) {
+        return QString("实时速率：无数据\n");
+    }
+
+    QString text;
+    text += QString("实时速率（%1秒窗口）：接收 %2 KB/s %3 包/s，发送 %4 KB/s %5 包/s\n")
+            .arg(snapshot.windowSeconds, 0, 'f', 0)
+            .arg(snapshot.rxBytesPerSec / 1024.0, 0, 'f', 1)
+            .arg(snapshot.rxPacketsPerSec, 0, 'f', 0)
+            .arg(snapshot.txBytesPerSec / 1024.0, 0, 'f', 1)
+            .arg(snapshot.txPacketsPerSec, 0, 'f', 0);
+    text += QString("最近一秒：接收 %1 KB/s，发送 %2 KB/s；峰值：接收 %3 KB/s，发送 %4 KB/s\n")
+            .arg(snapshot.lastRxBytesPerSec / 1024.0, 0, 'f', 1)
+            .arg(snapshot.lastTxBytesPerSec / 1024.0, 0, 'f', 1)
+            .arg(snapshot.peakRxBytesPerSec / 1024.0, 0, 'f', 1)
+            .arg(snapshot.peakTxBytesPerSec / 1024.0, 0, 'f', 1);
+
+    if (snapshot.rxPackets > 1) {
+        text += QString("到达间隔：p50 ≤%1 ms | p90 ≤%2 ms | p99 ≤%3 ms | max ≤%4 ms | 抖动 %5 ms\n")
+                .arg(snapshot.gapP50Us / 1000.0, 0, 'f', 3)
+                .arg(snapshot.gapP90Us / 1000.0, 0, 'f', 3)
+                .arg(snapshot.gapP99Us / 1000.0, 0, 'f', 3)
+                .arg(snapshot.gapMaxUs / 1000.0, 0, 'f', 3)
+                .arg(snapshot.jitterUs / 1000.0, 0, 'f', 3);
+    }
+
+    // 包大小分布：只列出有数据的桶
+    if (snapshot.rxPackets > 0) {
+        QStringList buckets;
+        for (int i = 0; i < snapshot.sizeHistogram.size(); ++i) {
+            if (snapshot.sizeHistogram[i] > 0) {
+                buckets << QString("%1B:%2%")
+                           .arg(sizeBucketLabel(i))
+                           .arg(snapshot.sizeHistogram[i] * 100.0 / snapshot.rxPackets, 0, 'f', 1);
+            }
+        }
+        text += QString("包大小分布：%1\n").arg(buckets.join("  "));
+    }
+    return text;
+}
+
+/**
+ * @brief 包大小桶的范围说明
+ * @param bucket 桶序号
+ */
+QString CLinkStats::sizeBucketLabel(int bucket)
+{
+    const qint64 lower = qint64(1) << bucket;
+    if (bucket >= SIZE_BUCKETS - 1) {
+        return QString("≥%1").arg(lower);
+    }
+    if (bucket == 0) {
+        return QString("1");
+    }
+    return QString("%1-%2").arg(lower).arg((lower << 1) - 1);
+}
+
+/**
+ * @brief 包大小所在的桶
+ */
+int CLinkStats::sizeBucket(qint64 bytes)
+{
+    if (bytes <= 1) {
+        return 0;
+    }
+    const int log2 = 63 - qCountLeadingZeroBits(quint64(bytes));
+    return qMin(log2, int(SIZE_BUCKETS) - 1);
+}
+
+/**
+ * @brief 到达间隔所在的桶：0-3微秒各一桶，之后每个2的幂分4个等宽子桶
+ */
+int CLinkStats::gapBucket(qint64 micros)
+{
+    if (micros < 4) {
+        return int(qMax<qint64>(0, micros));
+    }
+    const int log2 = 63 - qCountLeadingZeroBits(quint64(micros));
+    const int sub = int((micros >> (log2 - 2)) & 3);
+    return qMin((log2 - 1) * 4 + sub, int(GAP_BUCKETS) - 1);
+}
+
+/**
+ * @brief 到达间隔桶的上界（微秒）
+ */
+qint64 CLinkStats::gapBucketUpper(int bucket)
+{
+    if (bucket < 4) {
+        return bucket;
+    }
+    const int log2 = bucket / 4 + 1;
+    const int sub = bucket % 4;
+    const qint64 width = qint64(1) << (log2 - 2);
+    return (qint64(4 + sub) << (log2 - 2)) + width - 1;
+}
@@ -0,0 +1,145 @@
+#ifndef LINKSTATS_H
+#define LINKSTATS_H
+
+#include <QString>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <atomic>
+
+/**
+ * @class CLinkStats
+ * @brief 网络调试器的实时吞吐量和包到达间隔统计
+ *
+ * 记录接口（recordReceived / recordSent）可以在任意线程调用，只做几次
+ * 无锁原子加法（memory_order_relaxed）：收发字节数和包数、包大小直方图、
+ * 包到达间隔直方图和相邻间隔差（抖动）。
+ *
+ * 所属线程每秒调用一次 sample()，把累计计数的增量存入按秒的环形窗口，
+ * 得到滑动窗口内的收发速率、峰值速率、包大小分布和到达间隔分位数。
+ * 服务器模式下多个客户端的包一起计算到达间隔，反映的是整条链路的突发和停顿。
+ */
+class CLinkStats
+{
+public:
+    static const int WINDOW_SECONDS = 10;   ///< 滑动窗口长度（秒）
+    static const int SIZE_BUCKETS = 24;     ///< 包大小直方图桶数，第i桶为 [2^i, 2^(i+1)) 字节，最后一桶含更大的包
+    static const int GAP_BUCKETS = 128;     ///< 到达间隔直方图桶数（微秒，每个2的幂分4个子桶）
+
+    /**
+     * @struct Snapshot
+     * @brief 滑动窗口统计
+     */
+    struct Snapshot
+    {
+        double windowSeconds = 0.0;     ///< 实际覆盖的时长
+        double rxBytesPerSec = 0.0;     ///< 窗口平均接收速率
+        double txBytesPerSec = 0.0;
+        double rxPacketsPerSec = 0.0;
+        double txPacketsPerSec = 0.0;
+        double peakRxBytesPerSec = 0.0; ///< 窗口内最高的一秒
+        double peakTxBytesPerSec = 0.0;
+        double lastRxBytesPerSec = 0.0; ///< 最近一秒
+        double lastTxBytesPerSec = 0.0;
+        qint64 rxPackets = 0;           ///< 窗口内的接收包数
+        qint64 gapP50Us = 0;            ///< 到达间隔分位数（微秒）
+        qint64 gapP90Us = 0;
+        qint64 gapP99Us = 0;
+        qint64 gapMaxUs = 0;
+        double jitterUs = 0.0;          ///< 相邻到达间隔之差的平均绝对值（微秒）
+        QVector<qint64> sizeHistogram;  ///< 窗口内的接收包大小分布
+    };
+
+    CLinkStats();
+
+    /**
+     * @brief 记录收到一个包（任意线程）
+     * @param bytes 字节数
+     */
+    void recordReceived(qint64 bytes);
+
+    /**
+     * @brief 记录发送（任意线程）
+     * @param bytes 写入网络的字节数
+     * @param packets 完整发出的包数
+     */
+    void recordSent(qint64 bytes, qint64 packets);
+
+    /**
+     * @brief 取样：把上次取样以来的增量加入窗口并计算统计（所属线程，每秒一次）
+     */
+    Snapshot sample();
+
+    /**
+     * @brief 最近一次取样的结果
+     */
+    const Snapshot& lastSnapshot() const { return m_snapshot; }
+
+    /**
+     * @brief 清空窗口（累计计数不清零，以当前值为新起点）
+     */
+    void reset();
+
+    /**
+     * @brief 生成多行统计文本
+     */
+    static QString formatSnapshot(const Snapshot& snapshot);
+
+    /**
+     * @brief 包大小桶的范围说明，如 "64-127"
+     */
+    static QString sizeBucketLabel(int bucket);
+
+private:
+    /**
+     * @brief 累计计数（原子）
+     */
+    struct Counters
+    {
+        std::atomic<qint64> rxBytes;
+        std::atomic<qint64> rxPackets;
+        std::atomic<qint64> txBytes;
+        std::atomic<qint64> txPackets;
+        std::atomic<qint64> jitterSumUs;
+        std::atomic<qint64> jitterCount;
+        std::atomic<qint64> sizes[SIZE_BUCKETS];
+        std::atomic<qint64> gaps[GAP_BUCKETS];
+    };
+
+    /**
+     * @brief 累计计数的普通副本，也用作每秒增量
+     */
+    struct Totals
+    {
+        qint64 rxBytes = 0;
+        qint64 rxPackets = 0;
+        qint64 txBytes = 0;
+        qint64 txPackets = 0;
+        qint64 jitterSumUs = 0;
+        qint64 jitterCount = 0;
+        qint64 sizes[SIZE_BUCKETS] = {};
+        qint64 gaps[GAP_BUCKETS] = {};
+        qint64 elapsedMs = 0;
+    };
+
+    Totals load() const;
+
+    static int sizeBucket(qint64 bytes);
+    static int gapBucket(qint64 micros);
+    static qint64 gapBucketUpper(int bucket);
+
+    Counters m_counters;
+    std::atomic<qint64> m_lastArrivalNs;    ///< 上一个包的到达时刻（单调时钟），0表示还没有
+    std::atomic<qint64> m_lastGapUs;        ///< 上一个到达间隔，-1表示还没有
+    QElapsedTimer m_clock;
+
+    Totals m_previous;                      ///< 上次取样时的累计值
+    QVector<Totals> m_window;               ///< 每秒增量的环形窗口
+    int m_next;
+    int m_filled;
+    Snapshot m_snapshot;
+};
+
+Q_DECLARE_METATYPE(CLinkStats::Snapshot)
+
+#endif // LINKSTATS_H
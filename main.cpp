@@ -1,10 +1,69 @@
 #include "dialog.h"
+#include "metricsserver.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+
+    // 可选：--metrics-port N 在本机开启 http://127.0.0.1:N/metrics 指标服务
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption metricsPortOption("metrics-port", "在本机指定端口提供Prometheus格式指标（默认关闭）", "port");
+    QCommandLineOption shmRingOption("shm-ring", "把接收到的帧导出到指定名称的共享内存环（仅Unix，默认关闭）", "name");
+    QCommandLineOption shmSlotsOption("shm-slots", "共享内存环槽位数（默认8）", "count",
+                                      QString::number(CSharedFrameRing::DEFAULT_SLOTS));
+    QCommandLineOption relayPortOption("relay-port", "在指定端口把接收到的帧转发给多个下游客户端（默认关闭）", "port");
+    QCommandLineOption relayQueueOption("relay-queue", "每个下游客户端最多排队的帧数（默认4）", "frames", "4");
+    QCommandLineOption relayPolicyOption("relay-policy", "下游客户端队列满时：drop 丢弃最旧帧 / disconnect 断开（默认drop）", "policy", "drop");
+    QCommandLineOption relayProtocolOption("relay-protocol", "转发协议：raw / 7e / ext（默认ext）", "protocol", "ext");
+    QCommandLineOption displayFpsOption("display-fps", "图像显示帧率上限，0表示使用显示器刷新率（默认0）", "fps", "0");
+    parser.addOption(metricsPortOption);
+    parser.addOption(shmRingOption);
+    parser.addOption(shmSlotsOption);
+    parser.addOption(relayPortOption);
+    parser.addOption(relayQueueOption);
+    parser.addOption(relayPolicyOption);
+    parser.addOption(relayProtocolOption);
+    parser.addOption(displayFpsOption);
+    parser.process(a);
+
+    CMetricsServer metricsServer;
+    if (parser.isSet(metricsPortOption)) {
+        bool ok = false;
+        const int port = parser.value(metricsPortOption).toInt(&ok);
+        if (ok && port > 0 && port <= 65535) {
+            metricsServer.start(quint16(port));
+        } else {
+            qDebug() << "❌ 无效的指标服务端口：" << parser.value(metricsPortOption);
+        }
+    }
+
     Dialog w;
+    if (parser.isSet(displayFpsOption)) {
+        w.setDisplayRateLimit(parser.value(displayFpsOption).toDouble());
+    }
+    if (parser.isSet(shmRingOption)) {
+        w.tcpImg().enableSharedFrameRing(parser.value(shmRingOption), parser.value(shmSlotsOption).toInt());
+    }
+    if (parser.isSet(relayPortOption)) {
+        CFrameRelay::Config relayConfig;
+        bool ok = false;
+        const int port = parser.value(relayPortOption).toInt(&ok);
+        if (!ok || port <= 0 || port > 65535) {
+            qDebug() << "❌ 无效的帧转发端口：" << parser.value(relayPortOption);
+        } else if (!CFrameRelay::parsePolicy(parser.value(relayPolicyOption), relayConfig.policy)) {
+            qDebug() << "❌ 无效的慢速客户端策略：" << parser.value(relayPolicyOption);
+        } else if (!CFrameRelay::parseTransport(parser.value(relayProtocolOption), relayConfig.transport)) {
+            qDebug() << "❌ 无效的转发协议：" << parser.value(relayProtocolOption);
+        } else {
+            relayConfig.port = quint16(port);
+            relayConfig.maxQueueFrames = parser.value(relayQueueOption).toInt();
+            w.tcpImg().enableFrameRelay(relayConfig);
+        }
+    }
     w.show();
 
     return a.exec();
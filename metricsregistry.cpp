@@ -0,0 +1,139 @@
+#include "metricsregistry.h"
+#include <QMutexLocker>
+#include <QSet>
+
+/**
+ * @brief 获取全局注册表
+ * @return 进程内唯一的注册表实例
+ */
+CMetricsRegistry& CMetricsRegistry::instance()
+{
+    static CMetricsRegistry registry;
+    return registry;
+}
+
+/**
+ * @brief 析构函数，释放全部指标
+ */
+CMetricsRegistry::~CMetricsRegistry()
+{
+    qDeleteAll(m_metrics);
+    m_metrics.clear();
+}
+
+/**
+ * @brief 注册（或获取已注册的）计数器
+ */
+CMetricsRegistry::Metric* CMetricsRegistry::counter(const QString& name, const QString& help, const QString& labels)
+{
+    return registerMetric(METRIC_COUNTER, name, help, labels);
+}
+
+/**
+ * @brief 注册（或获取已注册的）仪表
+ */
+CMetricsRegistry::Metric* CMetricsRegistry::gauge(const QString& name, const QString& help, const QString& labels)
+{
+    return registerMetric(METRIC_GAUGE, name, help, labels);
+}
+
+/**
+ * @brief 注册指标，同名同标签的指标只创建一次
+ * 多个对象（如主备接收端）注册同一指标时共享同一个计数值
+ */
+CMetricsRegistry::Metric* CMetricsRegistry::registerMetric(MetricType type, const QString& name,
+                                                           const QString& help, const QString& labels)
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (Metric* metric : m_metrics) {
+        if (metric->m_name == name && metric->m_labels == labels) {
+            return metric;
+        }
+    }
+
+    Metric* metric = new Metric(type, name, labels, help);
+    m_metrics.append(metric);
+    return metric;
+}
+
+/**
+ * @brief 添加采集回调
+ */
+void CMetricsRegistry::addCollector(const void* owner, const Collector& collector)
+{
+    QMutexLocker locker(&m_mutex);
+    CollectorEntry entry;
+    entry.owner = owner;
+    entry.collector = collector;
+    m_collectors.append(entry);
+}
+
+/**
+ * @brief 移除所有者的全部采集回调
+ */
+void CMetricsRegistry::removeCollectors(const void* owner)
+{
+    QMutexLocker locker(&m_mutex);
+    for (int i = m_collectors.size() - 1; i >= 0; --i) {
+        if (m_collectors[i].owner == owner) {
+            m_collectors.removeAt(i);
+        }
+    }
+}
+
+/**
+ * @brief 导出全部指标为Prometheus文本格式（exposition format 0.0.4）
+ * @return 文本，同名指标连续输出并共用一组HELP/TYPE
+ */
+QString CMetricsRegistry::render() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QString out;
+    out.reserve(4096);
+
+    QSet<QString> rendered;
+    for (int i = 0; i < m_metrics.size(); ++i) {
+        const Metric* first = m_metrics[i];
+        if (rendered.contains(first->m_name)) {
+            continue;
+        }
+        rendered.insert(first->m_name);
+
+        appendHeader(out, first->m_name,
+                     first->m_type == METRIC_COUNTER ? "counter" : "gauge", first->m_help);
+        for (int j = i; j < m_metrics.size(); ++j) {
+            const Metric* metric = m_metrics[j];
+            if (metric->m_name != first->m_name) {
+                continue;
+            }
+            out += metric->m_name;
+            if (!metric->m_labels.isEmpty()) {
+                out += "{" + metric->m_labels + "}";
+            }
+            out += " " + QString::number(metric->value()) + "\n";
+        }
+    }
+
+    for (const CollectorEntry& entry : m_collectors) {
+        entry.collector(out);
+    }
+
+    return out;
+}
+
+/**
+ * @brief 输出一个指标的HELP和TYPE行
+ * @param out 输出文本
+ * @param name 指标名
+ * @param type counter / gauge / summary
+ * @param help 说明（换行和反斜杠按格式要求转义）
+ */
+void CMetricsRegistry::appendHeader(QString& out, const QString& name, const QString& type, const QString& help)
+{
+    QString escaped = help;
+    escaped.replace("\\", "\\\\").replace("\n", "\\n");
+    out += "# HELP " + name + " " + escaped + "\n";
+    out += "# TYPE " + name + " " + type + "\n";
+}
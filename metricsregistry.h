@@ -0,0 +1,123 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <atomic>
+#include <functional>
+
+/**
+ * @class CMetricsRegistry
+ * @brief 进程内指标注册表（Prometheus文本格式）
+ *
+ * 各子系统在初始化时注册计数器/仪表并保存返回的指针，热路径上只做一次
+ * 无锁原子加法（memory_order_relaxed），不加锁、不分配内存、不查表。
+ * 注册和导出在冷路径上加锁进行。
+ *
+ * 分位数、速率等需要在抓取时计算的指标通过采集回调输出，
+ * 回调在导出线程（指标服务所在线程）中执行。
+ */
+class CMetricsRegistry
+{
+public:
+    /**
+     * @enum MetricType
+     * @brief 指标类型
+     */
+    enum MetricType {
+        METRIC_COUNTER,     ///< 单调递增计数器
+        METRIC_GAUGE        ///< 可增可减的仪表
+    };
+
+    /**
+     * @class Metric
+     * @brief 单个指标，值为64位原子整数
+     */
+    class Metric
+    {
+    public:
+        void add(qint64 delta) { m_value.fetch_add(delta, std::memory_order_relaxed); }
+        void increment() { add(1); }
+        void set(qint64 value) { m_value.store(value, std::memory_order_relaxed); }
+        qint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+    private:
+        friend class CMetricsRegistry;
+        Metric(MetricType type, const QString& name, const QString& labels, const QString& help)
+            : m_type(type), m_name(name), m_labels(labels), m_help(help), m_value(0) {}
+
+        MetricType m_type;
+        QString m_name;             ///< 指标名（同名指标共享HELP/TYPE）
+        QString m_labels;           ///< 标签，如 subsystem="debugger"，可为空
+        QString m_help;
+        std::atomic<qint64> m_value;
+    };
+
+    /**
+     * @brief 采集回调：向输出追加Prometheus文本格式的指标行（含HELP/TYPE）
+     */
+    typedef std::function<void(QString& out)> Collector;
+
+    /**
+     * @brief 获取全局注册表
+     */
+    static CMetricsRegistry& instance();
+
+    ~CMetricsRegistry();
+
+    /**
+     * @brief 注册（或获取已注册的）计数器
+     * @param name 指标名，应以 _total 结尾
+     * @param help 说明
+     * @param labels 标签（不含花括号），可为空
+     * @return 指标指针，生命周期与注册表相同
+     */
+    Metric* counter(const QString& name, const QString& help, const QString& labels = QString());
+
+    /**
+     * @brief 注册（或获取已注册的）仪表
+     */
+    Metric* gauge(const QString& name, const QString& help, const QString& labels = QString());
+
+    /**
+     * @brief 添加采集回调
+     * @param owner 所有者，用于移除
+     * @param collector 回调函数
+     */
+    void addCollector(const void* owner, const Collector& collector);
+
+    /**
+     * @brief 移除所有者的全部采集回调（所有者析构前必须调用）
+     */
+    void removeCollectors(const void* owner);
+
+    /**
+     * @brief 导出全部指标为Prometheus文本格式
+     */
+    QString render() const;
+
+    /**
+     * @brief 输出一个指标的HELP和TYPE行
+     */
+    static void appendHeader(QString& out, const QString& name, const QString& type, const QString& help);
+
+private:
+    CMetricsRegistry() {}
+    CMetricsRegistry(const CMetricsRegistry&);
+    CMetricsRegistry& operator=(const CMetricsRegistry&);
+
+    Metric* registerMetric(MetricType type, const QString& name, const QString& help, const QString& labels);
+
+    struct CollectorEntry
+    {
+        const void* owner;
+        Collector collector;
+    };
+
+    mutable QMutex m_mutex;
+    QList<Metric*> m_metrics;
+    QList<CollectorEntry> m_collectors;
+};
+
+#endif // METRICSREGISTRY_H
@@ -0,0 +1,166 @@
+#include "metricsserver.h"
+#include "metricsregistry.h"
+#include <QDebug>
+
+/**
+ * @brief CMetricsServer构造函数
+ * @param parent 父对象指针
+ */
+CMetricsServer::CMetricsServer(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &CMetricsServer::onNewConnection);
+}
+
+/**
+ * @brief CMetricsServer析构函数
+ */
+CMetricsServer::~CMetricsServer()
+{
+    stop();
+}
+
+/**
+ * @brief 开始监听
+ * @param port 端口
+ * @param address 监听地址
+ * @return 成功返回true
+ */
+bool CMetricsServer::start(quint16 port, const QHostAddress& address)
+{
+    if (m_server.isListening()) {
+        stop();
+    }
+
+    if (!m_server.listen(address, port)) {
+        qDebug() << "❌ 指标服务启动失败：" << m_server.errorString();
+        return false;
+    }
+
+    qDebug() << QString("📈 指标服务已启动：http://%1:%2/metrics")
+                .arg(address.toString()).arg(m_server.serverPort());
+    return true;
+}
+
+/**
+ * @brief 停止监听并断开所有连接
+ */
+void CMetricsServer::stop()
+{
+    m_server.close();
+
+    const QList<QTcpSocket*> sockets = m_requests.keys();
+    m_requests.clear();
+    for (QTcpSocket* socket : sockets) {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+}
+
+/**
+ * @brief 接受新连接
+ */
+void CMetricsServer::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server.nextPendingConnection()) {
+        m_requests.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, &CMetricsServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &CMetricsServer::onDisconnected);
+    }
+}
+
+/**
+ * @brief 累积请求数据，收到完整请求头后处理
+ */
+void CMetricsServer::onReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket || !m_requests.contains(socket)) {
+        return;
+    }
+
+    QByteArray& request = m_requests[socket];
+    request.append(socket->readAll());
+
+    const int headerEnd = request.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        if (request.size() > MAX_REQUEST_SIZE) {
+            sendResponse(socket, "431 Request Header Fields Too Large", "text/plain", "request too large\n");
+        }
+        return;
+    }
+
+    const int lineEnd = request.indexOf("\r\n");
+    const QByteArray requestLine = request.left(lineEnd);
+    handleRequest(socket, requestLine);
+}
+
+/**
+ * @brief 连接断开，释放套接字
+ */
+void CMetricsServer::onDisconnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+    m_requests.remove(socket);
+    socket->deleteLater();
+}
+
+/**
+ * @brief 根据请求行生成响应
+ * @param socket 客户端连接
+ * @param requestLine 请求行，如 "GET /metrics HTTP/1.1"
+ */
+void CMetricsServer::handleRequest(QTcpSocket* socket, const QByteArray& requestLine)
+{
+    const QList<QByteArray> parts = requestLine.split(' ');
+    if (parts.size() < 2) {
+        sendResponse(socket, "400 Bad Request", "text/plain", "bad request\n");
+        return;
+    }
+
+    const QByteArray method = parts[0];
+    QByteArray path = parts[1];
+    const int query = path.indexOf('?');
+    if (query >= 0) {
+        path.truncate(query);
+    }
+
+    if (method != "GET" && method != "HEAD") {
+        sendResponse(socket, "405 Method Not Allowed", "text/plain", "method not allowed\n");
+        return;
+    }
+
+    if (path == "/metrics") {
+        const QByteArray body = CMetricsRegistry::instance().render().toUtf8();
+        sendResponse(socket, "200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                     method == "HEAD" ? QByteArray() : body);
+    } else if (path == "/") {
+        sendResponse(socket, "200 OK", "text/plain; charset=utf-8", "TCPImg metrics: /metrics\n");
+    } else {
+        sendResponse(socket, "404 Not Found", "text/plain", "not found\n");
+    }
+}
+
+/**
+ * @brief 发送HTTP响应并关闭连接
+ */
+void CMetricsServer::sendResponse(QTcpSocket* socket, const QByteArray& status,
+                                  const QByteArray& contentType, const QByteArray& body)
+{
+    m_requests.remove(socket);
+
+    QByteArray response;
+    response.reserve(body.size() + 128);
+    response += "HTTP/1.1 " + status + "\r\n";
+    response += "Content-Type: " + contentType + "\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+
+    socket->write(response);
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,66 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QHash>
+#include <QByteArray>
+
+/**
+ * @class CMetricsServer
+ * @brief 内置的极简HTTP指标服务
+ *
+ * 监听本机地址，对 GET /metrics 返回 CMetricsRegistry 导出的
+ * Prometheus文本格式指标，其他路径返回404。每个请求处理后关闭连接。
+ *
+ * 服务运行在创建它的线程的事件循环中，抓取时才执行指标采集，
+ * 未被抓取时不产生任何开销。
+ */
+class CMetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CMetricsServer(QObject *parent = nullptr);
+    ~CMetricsServer();
+
+    /**
+     * @brief 开始监听
+     * @param port 端口
+     * @param address 监听地址，默认仅本机
+     * @return 成功返回true
+     */
+    bool start(quint16 port, const QHostAddress& address = QHostAddress::LocalHost);
+
+    /**
+     * @brief 停止监听并断开所有连接
+     */
+    void stop();
+
+    bool isListening() const { return m_server.isListening(); }
+    quint16 serverPort() const { return m_server.serverPort(); }
+    QString errorString() const { return m_server.errorString(); }
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    /**
+     * @brief 根据请求行生成响应并关闭连接
+     */
+    void handleRequest(QTcpSocket* socket, const QByteArray& requestLine);
+
+    void sendResponse(QTcpSocket* socket, const QByteArray& status,
+                      const QByteArray& contentType, const QByteArray& body);
+
+    static const int MAX_REQUEST_SIZE = 8192;   ///< 请求头最大长度（字节）
+
+    QTcpServer m_server;
+    QHash<QTcpSocket*, QByteArray> m_requests;  ///< 各连接已收到的请求数据
+};
+
+#endif // METRICSSERVER_H
@@ -0,0 +1,188 @@
+#include "networkdiagnostics.h"
+#include <QNetworkProxy>
+#include <QDebug>
+
+/**
+ * @brief CNetworkDiagnostics构造函数
+ * @param parent 父对象指针
+ */
+CNetworkDiagnostics::CNetworkDiagnostics(QObject *parent)
+    : QObject(parent)
+    , m_timeoutTimer(this)
+    , m_pending(0)
+    , m_succeeded(0)
+    , m_minRttMs(0.0)
+    , m_maxRttMs(0.0)
+    , m_sumRttMs(0.0)
+{
+    m_timeoutTimer.setSingleShot(true);
+    connect(&m_timeoutTimer, &QTimer::timeout, this, &CNetworkDiagnostics::onTimeout);
+}
+
+CNetworkDiagnostics::~CNetworkDiagnostics()
+{
+    releaseSockets();
+}
+
+/**
+ * @brief 开始诊断
+ * @param host 目标主机
+ * @param port 目标端口
+ * @param probeCount 并行探测路数
+ * @param timeoutMs 超时时间（毫秒）
+ */
+void CNetworkDiagnostics::start(const QString &host, int port, int probeCount, int timeoutMs)
+{
+    cancel();
+
+    const int total = qBound(1, probeCount, 16);
+    m_pending = total;
+    m_succeeded = 0;
+    m_minRttMs = 0.0;
+    m_maxRttMs = 0.0;
+    m_sumRttMs = 0.0;
+
+    qDebug() << QString("🔍 开始连通性探测：%1:%2，%3路并行，超时%4ms")
+                .arg(host).arg(port).arg(total).arg(timeoutMs);
+
+    // 所有探测同时发起，共用一个计时起点
+    m_clock.start();
+    for (int i = 0; i < total; ++i) {
+        QTcpSocket *socket = new QTcpSocket(this);
+        socket->setProxy(QNetworkProxy::NoProxy);
+        socket->setProperty("probeIndex", i);
+        m_sockets.append(socket);
+
+        connect(socket, &QTcpSocket::connected, this, &CNetworkDiagnostics::onProbeConnected);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+        connect(socket, &QTcpSocket::errorOccurred, this, &CNetworkDiagnostics::onProbeError);
+#else
+        connect(socket, SIGNAL(error(QAbstractSocket::SocketError)),
+                this, SLOT(onProbeError(QAbstractSocket::SocketError)));
+#endif
+    }
+    m_timeoutTimer.start(qMax(100, timeoutMs));
+
+    // 连接建立前不会进入事件循环，这里逐个发起不影响计时
+    for (QTcpSocket *socket : m_sockets) {
+        socket->connectToHost(host, quint16(port));
+    }
+}
+
+/**
+ * @brief 取消正在进行的诊断
+ */
+void CNetworkDiagnostics::cancel()
+{
+    m_timeoutTimer.stop();
+    releaseSockets();
+    m_pending = 0;
+}
+
+/**
+ * @brief 套接字错误的诊断说明
+ */
+QString CNetworkDiagnostics::describeSocketError(QAbstractSocket::SocketError error, const QString &errorString)
+{
+    switch (error) {
+        case QAbstractSocket::ConnectionRefusedError:
+            return "❌ 连接被拒绝 - 服务端可能未启动或端口未监听";
+        case QAbstractSocket::HostNotFoundError:
+            return "❌ 主机未找到 - 请检查IP地址是否正确";
+        case QAbstractSocket::SocketTimeoutError:
+            return "❌ 连接超时 - 网络可能不通或服务端响应慢";
+        case QAbstractSocket::NetworkError:
+            return "❌ 网络错误 - 请检查网络连接";
+        default:
+            return QString("❌ 连接失败 - %1").arg(errorString);
+    }
+}
+
+/**
+ * @brief 探测连接建立
+ */
+void CNetworkDiagnostics::onProbeConnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (socket) {
+        completeProbe(socket, true, "✅ 可以建立TCP连接");
+    }
+}
+
+/**
+ * @brief 探测出错
+ * @param error 套接字错误
+ */
+void CNetworkDiagnostics::onProbeError(QAbstractSocket::SocketError error)
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (socket) {
+        completeProbe(socket, false, describeSocketError(error, socket->errorString()));
+    }
+}
+
+/**
+ * @brief 诊断超时，未完成的探测计为失败
+ */
+void CNetworkDiagnostics::onTimeout()
+{
+    // completeProbe 会修改 m_sockets，先复制一份
+    const QList<QTcpSocket*> sockets = m_sockets;
+    for (QTcpSocket *socket : sockets) {
+        if (socket) {
+            completeProbe(socket, false, describeSocketError(QAbstractSocket::SocketTimeoutError, QString()));
+        }
+    }
+}
+
+/**
+ * @brief 记录一路探测结果
+ * @param socket 探测套接字
+ * @param success 是否成功
+ * @param message 结果说明
+ */
+void CNetworkDiagnostics::completeProbe(QTcpSocket *socket, bool success, const QString &message)
+{
+    const int index = m_sockets.indexOf(socket);
+    if (index < 0 || m_pending <= 0) {
+        return;
+    }
+
+    const double rttMs = m_clock.nsecsElapsed() / 1e6;
+    m_sockets[index] = nullptr;
+    socket->disconnect(this);
+    socket->abort();
+    socket->deleteLater();
+
+    if (success) {
+        m_minRttMs = (m_succeeded == 0) ? rttMs : qMin(m_minRttMs, rttMs);
+        m_maxRttMs = qMax(m_maxRttMs, rttMs);
+        m_sumRttMs += rttMs;
+        m_succeeded++;
+    }
+    m_pending--;
+    emit probeFinished(index, success, rttMs, message);
+
+    if (m_pending == 0) {
+        m_timeoutTimer.stop();
+        const int total = m_sockets.size();
+        m_sockets.clear();
+        emit finished(m_succeeded, total, m_minRttMs,
+                      m_succeeded > 0 ? m_sumRttMs / m_succeeded : 0.0, m_maxRttMs);
+    }
+}
+
+/**
+ * @brief 关闭并释放所有探测套接字
+ */
+void CNetworkDiagnostics::releaseSockets()
+{
+    for (QTcpSocket *socket : m_sockets) {
+        if (socket) {
+            socket->disconnect(this);
+            socket->abort();
+            socket->deleteLater();
+        }
+    }
+    m_sockets.clear();
+}
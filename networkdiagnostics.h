@@ -0,0 +1,100 @@
+#ifndef NETWORKDIAGNOSTICS_H
+#define NETWORKDIAGNOSTICS_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QTcpSocket>
+
+/**
+ * @class CNetworkDiagnostics
+ * @brief 异步网络连通性诊断
+ *
+ * 对目标地址同时发起多路TCP连接探测，测量每一路的连接建立耗时（连接RTT），
+ * 每完成一路发射一次 probeFinished，全部完成或超时后发射 finished。
+ * 全程基于信号槽，不调用 waitForConnected，可以放在工作线程中运行
+ * （CTCPImg 将其移入专用线程，诊断期间界面和帧显示不受影响）。
+ *
+ * 对象必须在所属线程中使用：跨线程调用 start 需通过队列连接或
+ * QMetaObject::invokeMethod(..., Qt::QueuedConnection)。
+ */
+class CNetworkDiagnostics : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int DEFAULT_PROBE_COUNT = 3;       ///< 默认并行探测路数
+    static const int DEFAULT_TIMEOUT_MS = 3000;     ///< 默认单次诊断超时（毫秒）
+
+    explicit CNetworkDiagnostics(QObject *parent = nullptr);
+    ~CNetworkDiagnostics();
+
+    /**
+     * @brief 套接字错误的诊断说明
+     */
+    static QString describeSocketError(QAbstractSocket::SocketError error, const QString &errorString);
+
+public slots:
+    /**
+     * @brief 开始诊断，上一次未完成的诊断被取消
+     * @param host 目标主机（IP或主机名）
+     * @param port 目标端口
+     * @param probeCount 并行探测路数
+     * @param timeoutMs 超时时间（毫秒），超时未完成的探测计为失败
+     */
+    void start(const QString &host, int port, int probeCount, int timeoutMs);
+
+    /**
+     * @brief 取消正在进行的诊断，不再发射信号
+     */
+    void cancel();
+
+signals:
+    /**
+     * @brief 单路探测完成
+     * @param index 探测序号（从0开始）
+     * @param success 是否成功建立连接
+     * @param rttMs 连接建立耗时（毫秒），失败时为发起到失败的耗时
+     * @param message 结果说明
+     */
+    void probeFinished(int index, bool success, double rttMs, const QString &message);
+
+    /**
+     * @brief 全部探测完成
+     * @param succeeded 成功路数
+     * @param total 总路数
+     * @param minRttMs 成功探测的最小连接RTT（毫秒），无成功时为0
+     * @param avgRttMs 平均连接RTT（毫秒）
+     * @param maxRttMs 最大连接RTT（毫秒）
+     */
+    void finished(int succeeded, int total, double minRttMs, double avgRttMs, double maxRttMs);
+
+private slots:
+    void onProbeConnected();
+    void onProbeError(QAbstractSocket::SocketError error);
+    void onTimeout();
+
+private:
+    /**
+     * @brief 记录一路探测结果，全部完成时发射 finished
+     */
+    void completeProbe(QTcpSocket *socket, bool success, const QString &message);
+
+    /**
+     * @brief 关闭并释放所有探测套接字
+     */
+    void releaseSockets();
+
+    QList<QTcpSocket*> m_sockets;   ///< 进行中的探测（完成后置空）
+    QTimer m_timeoutTimer;          ///< 诊断超时
+    QElapsedTimer m_clock;          ///< 探测发起时刻起计时
+    int m_pending;                  ///< 未完成的探测数
+    int m_succeeded;                ///< 成功的探测数
+    double m_minRttMs;
+    double m_maxRttMs;
+    double m_sumRttMs;
+};
+
+#endif // NETWORKDIAGNOSTICS_H
@@ -0,0 +1,303 @@
+#include "packetlogmodel.h"
+#include <QDateTime>
+#include <QDebug>
+
+/**
+ * @brief CPacketLogModel构造函数
+ * @param parent 父对象指针
+ */
+CPacketLogModel::CPacketLogModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_ring(DEFAULT_MAX_ENTRIES)
+    , m_head(0)
+    , m_count(0)
+    , m_bytes(0)
+    , m_maxBytes(DEFAULT_MAX_BYTES)
+    , m_pendingBytes(0)
+    , m_flushTimer(this)
+    , m_nextSerial(0)
+    , m_evicted(0)
+    , m_format(CDataFormatter::FORMAT_RAW_TEXT)
+    , m_showTimestamp(true)
+    , m_summaryCache(1024)
+{
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &CPacketLogModel::flushPending);
+}
+
+/**
+ * @brief 设置显示格式
+ * @param format 显示格式
+ */
+void CPacketLogModel::setDisplayFormat(CDataFormatter::DataDisplayFormat format)
+{
+    if (format == m_format) {
+        return;
+    }
+    m_format = format;
+    m_summaryCache.clear();
+    if (m_count > 0) {
+        emit dataChanged(index(0), index(m_count - 1), QVector<int>() << Qt::DisplayRole);
+    }
+}
+
+/**
+ * @brief 设置是否显示时间戳
+ * @param show 是否显示
+ */
+void CPacketLogModel::setShowTimestamp(bool show)
+{
+    if (show == m_showTimestamp) {
+        return;
+    }
+    m_showTimestamp = show;
+    m_summaryCache.clear();
+    if (m_count > 0) {
+        emit dataChanged(index(0), index(m_count - 1), QVector<int>() << Qt::DisplayRole);
+    }
+}
+
+/**
+ * @brief 记录接收的数据
+ */
+void CPacketLogModel::appendReceived(const QByteArray &data, const QString &source, qint64 timestampMs)
+{
+    enqueue(ENTRY_RECEIVED, data, source, timestampMs);
+}
+
+/**
+ * @brief 记录发送的数据
+ */
+void CPacketLogModel::appendSent(const QByteArray &data, const QString &target, qint64 timestampMs)
+{
+    enqueue(ENTRY_SENT, data, target, timestampMs);
+}
+
+/**
+ * @brief 记录状态信息
+ */
+void CPacketLogModel::appendEvent(const QString &text)
+{
+    enqueue(ENTRY_EVENT, text.toUtf8(), QString());
+}
+
+/**
+ * @brief 清空全部记录
+ */
+void CPacketLogModel::clear()
+{
+    beginResetModel();
+    m_ring = QVector<Entry>(m_ring.size());
+    m_head = 0;
+    m_count = 0;
+    m_bytes = 0;
+    m_pending.clear();
+    m_pendingBytes = 0;
+    m_summaryCache.clear();
+    endResetModel();
+    m_flushTimer.stop();
+}
+
+/**
+ * @brief 加入待插入队列
+ * @param kind 记录类型
+ * @param data 原始数据
+ * @param address 来源或目标地址
+ * @param timestampMs 记录时间，0表示当前时间
+ */
+void CPacketLogModel::enqueue(EntryKind kind, const QByteArray &data, const QString &address, qint64 timestampMs)
+{
+    Entry entry;
+    entry.kind = kind;
+    entry.timestampMs = timestampMs > 0 ? timestampMs : QDateTime::currentMSecsSinceEpoch();
+    entry.serial = m_nextSerial++;
+    entry.address = address;
+    entry.data = data;
+
+    m_pendingBytes += data.size();
+    m_pending.append(entry);
+
+    // 一批内就已超出上限的部分不会显示，直接丢弃，队列本身也保持有界
+    while (m_pending.size() > m_ring.size()
+           || (m_pending.size() > 1 && m_pendingBytes > m_maxBytes)) {
+        m_pendingBytes -= m_pending.first().data.size();
+        m_pending.removeFirst();
+        ++m_evicted;
+    }
+
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start(FLUSH_INTERVAL_MS);
+    }
+}
+
+/**
+ * @brief 从头部丢弃记录
+ * @param count 丢弃的条数
+ */
+void CPacketLogModel::dropOldest(int count)
+{
+    for (int i = 0; i < count && m_count > 0; ++i) {
+        Entry &entry = m_ring[m_head];
+        m_bytes -= entry.data.size();
+        m_summaryCache.remove(entry.serial);
+        entry = Entry();
+        m_head = (m_head + 1) % m_ring.size();
+        --m_count;
+        ++m_evicted;
+    }
+}
+
+/**
+ * @brief 把待插入的记录批量插入模型
+ *
+ * 先按上限从头部移除旧记录，再一次性插入整批新记录，
+ * 视图每批只收到一次删除和一次插入通知
+ */
+void CPacketLogModel::flushPending()
+{
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    const int capacity = m_ring.size();
+    const int added = m_pending.size();
+
+    int excess = qMax(0, m_count + added - capacity);
+    qint64 bytes = m_bytes + m_pendingBytes;
+    for (int i = 0; i < excess; ++i) {
+        bytes -= entryAt(i).data.size();
+    }
+    while (excess < m_count && bytes > m_maxBytes) {
+        bytes -= entryAt(excess).data.size();
+        ++excess;
+    }
+    if (excess > 0) {
+        beginRemoveRows(QModelIndex(), 0, excess - 1);
+        dropOldest(excess);
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count + added - 1);
+    for (const Entry &entry : m_pending) {
+        m_ring[(m_head + m_count) % capacity] = entry;
+        ++m_count;
+    }
+    m_bytes += m_pendingBytes;
+    m_pending.clear();
+    m_pendingBytes = 0;
+    endInsertRows();
+
+    emit rowsFlushed(added);
+}
+
+/**
+ * @brief 行数
+ */
+int CPacketLogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+/**
+ * @brief 行数据：显示角色只格式化被请求的行
+ */
+QVariant CPacketLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_count) {
+        return QVariant();
+    }
+
+    const Entry &entry = entryAt(index.row());
+    switch (role) {
+        case Qt::DisplayRole: {
+            if (QString *cached = m_summaryCache.object(entry.serial)) {
+                return *cached;
+            }
+            QString summary = formatSummary(entry);
+            m_summaryCache.insert(entry.serial, new QString(summary));
+            return summary;
+        }
+        case Qt::ToolTipRole:
+            return entry.address;
+        case RawDataRole:
+            return entry.data;
+        case KindRole:
+            return int(entry.kind);
+        default:
+            return QVariant();
+    }
+}
+
+/**
+ * @brief 生成摘要行
+ * @param entry 记录
+ */
+QString CPacketLogModel::formatSummary(const Entry &entry) const
+{
+    QString summary;
+    if (m_showTimestamp) {
+        summary = QString("[%1] ").arg(QDateTime::fromMSecsSinceEpoch(entry.timestampMs).toString("hh:mm:ss.zzz"));
+    }
+
+    if (entry.kind == ENTRY_EVENT) {
+        return summary + QString::fromUtf8(entry.data);
+    }
+
+    const QString direction = (entry.kind == ENTRY_RECEIVED) ? "<<<" : ">>>";
+    summary += QString("%1 %2%3字节  ").arg(direction)
+               .arg(entry.address.isEmpty() ? QString() : entry.address + "  ")
+               .arg(entry.data.size());
+
+    // 混合和JSON格式是多段或结构化内容，摘要行只显示十六进制或文本预览
+    const QByteArray preview = entry.data.left(PREVIEW_BYTES);
+    QString text;
+    switch (m_format) {
+        case CDataFormatter::FORMAT_HEX:
+        case CDataFormatter::FORMAT_MIXED:
+            text = m_formatter.toHexFormat(preview, PREVIEW_BYTES, false);
+            break;
+        case CDataFormatter::FORMAT_BINARY:
+        case CDataFormatter::FORMAT_ASCII:
+            text = formatPayload(preview);
+            break;
+        default:
+            text = QString::fromUtf8(preview);
+            break;
+    }
+    summary += text.simplified();
+    if (entry.data.size() > PREVIEW_BYTES) {
+        summary += " …";
+    }
+    return summary;
+}
+
+/**
+ * @brief 按当前格式格式化数据
+ * @param data 原始数据
+ */
+QString CPacketLogModel::formatPayload(const QByteArray &data) const
+{
+    return m_formatter.formatData(data, m_format, false);
+}
+
+/**
+ * @brief 按当前格式完整格式化一行
+ * @param row 行号
+ */
+QString CPacketLogModel::detailText(int row) const
+{
+    if (row < 0 || row >= m_count) {
+        return QString();
+    }
+
+    const Entry &entry = entryAt(row);
+    const QString time = QDateTime::fromMSecsSinceEpoch(entry.timestampMs).toString("yyyy-MM-dd hh:mm:ss.zzz");
+    if (entry.kind == ENTRY_EVENT) {
+        return QString("[%1] %2").arg(time, QString::fromUtf8(entry.data));
+    }
+
+    const QString header = (entry.kind == ENTRY_RECEIVED)
+            ? QString("<<< 接收来自 %1 (%2 字节)").arg(entry.address).arg(entry.data.size())
+            : QString(">>> 发送 (%1 字节)").arg(entry.data.size());
+    return QString("[%1] %2:\n%3").arg(time, header, formatPayload(entry.data));
+}
@@ -0,0 +1,186 @@
+#ifndef PACKETLOGMODEL_H
+#define PACKETLOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QList>
+#include <QTimer>
+#include <QCache>
+#include "dataformatter.h"
+
+/**
+ * @class CPacketLogModel
+ * @brief 网络调试收发记录（列表模型）
+ *
+ * 替代逐包向 QTextEdit 追加格式化文本的做法，高包率下界面不再卡死、内存不再无限增长：
+ * - 收发数据按原始字节保存在有界环形缓冲中，超过条数或字节数上限时丢弃最旧的记录
+ * - 新记录先进入待插入队列，按约30Hz批量插入模型，视图每批只更新一次
+ * - 每行只显示一行摘要（时间、方向、来源、字节数和前 PREVIEW_BYTES 字节的预览），
+ *   视图只为可见行调用 data()，按当前显示格式即时格式化，结果按记录缓存
+ * - 完整内容由 detailText() 按需格式化（如选中某行时）
+ *
+ * 时间戳在记录时保存，延迟格式化不影响显示的时间
+ */
+class CPacketLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum EntryKind
+     * @brief 记录类型
+     */
+    enum EntryKind {
+        ENTRY_RECEIVED,     ///< 接收的数据
+        ENTRY_SENT,         ///< 发送的数据
+        ENTRY_EVENT         ///< 状态信息（文本保存在 data 中）
+    };
+
+    /**
+     * @enum Roles
+     * @brief 附加数据角色
+     */
+    enum Roles {
+        RawDataRole = Qt::UserRole + 1,     ///< 原始字节（QByteArray）
+        KindRole                            ///< 记录类型（EntryKind）
+    };
+
+    static const int DEFAULT_MAX_ENTRIES = 20000;                   ///< 默认最多保留的记录数
+    static const qint64 DEFAULT_MAX_BYTES = 64LL * 1024 * 1024;     ///< 默认最多保留的数据字节数
+    static const int FLUSH_INTERVAL_MS = 33;                        ///< 批量插入间隔（约30Hz）
+    static const int PREVIEW_BYTES = 48;                            ///< 摘要行预览的字节数
+
+    explicit CPacketLogModel(QObject *parent = nullptr);
+
+    /**
+     * @brief 保留上限（记录数、数据字节数）
+     */
+    int maxEntries() const { return m_ring.size(); }
+    qint64 maxBytes() const { return m_maxBytes; }
+
+    /**
+     * @brief 设置显示格式，所有行按新格式重新格式化
+     */
+    void setDisplayFormat(CDataFormatter::DataDisplayFormat format);
+    CDataFormatter::DataDisplayFormat displayFormat() const { return m_format; }
+
+    /**
+     * @brief 设置是否在摘要行前显示时间戳
+     */
+    void setShowTimestamp(bool show);
+    bool showTimestamp() const { return m_showTimestamp; }
+
+    /**
+     * @brief 记录接收的数据
+     * @param data 原始数据（共享，不拷贝）
+     * @param source 来源地址
+     * @param timestampMs 记录时间（Unix纪元毫秒），0表示当前时间（导入抓包文件时用包的时间）
+     */
+    void appendReceived(const QByteArray &data, const QString &source, qint64 timestampMs = 0);
+
+    /**
+     * @brief 记录发送的数据
+     * @param data 原始数据
+     * @param target 目标地址，可为空
+     * @param timestampMs 记录时间（Unix纪元毫秒），0表示当前时间
+     */
+    void appendSent(const QByteArray &data, const QString &target = QString(), qint64 timestampMs = 0);
+
+    /**
+     * @brief 记录状态信息
+     */
+    void appendEvent(const QString &text);
+
+    /**
+     * @brief 清空全部记录（包括待插入的记录）
+     */
+    void clear();
+
+    /**
+     * @brief 按当前格式完整格式化一行
+     * @param row 行号
+     * @return 行号无效时为空
+     */
+    QString detailText(int row) const;
+
+    /**
+     * @brief 累计记录数（含已丢弃的）
+     */
+    qint64 totalEntries() const { return m_nextSerial; }
+
+    /**
+     * @brief 因超过上限被丢弃的记录数
+     */
+    qint64 evictedEntries() const { return m_evicted; }
+
+    /**
+     * @brief 当前保留的数据字节数（含待插入的记录）
+     */
+    qint64 retainedBytes() const { return m_bytes + m_pendingBytes; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+signals:
+    /**
+     * @brief 一批记录已插入模型
+     * @param added 本批插入的行数
+     */
+    void rowsFlushed(int added);
+
+private slots:
+    /**
+     * @brief 把待插入的记录批量插入模型
+     */
+    void flushPending();
+
+private:
+    struct Entry
+    {
+        EntryKind kind = ENTRY_EVENT;
+        qint64 timestampMs = 0;     ///< 记录时间（Unix纪元毫秒）
+        quint64 serial = 0;         ///< 记录序号，用作格式化缓存的键
+        QString address;
+        QByteArray data;
+    };
+
+    void enqueue(EntryKind kind, const QByteArray &data, const QString &address, qint64 timestampMs = 0);
+    const Entry &entryAt(int row) const { return m_ring[(m_head + row) % m_ring.size()]; }
+
+    /**
+     * @brief 从头部丢弃记录（调用方负责通知视图）
+     */
+    void dropOldest(int count);
+
+    /**
+     * @brief 生成摘要行
+     */
+    QString formatSummary(const Entry &entry) const;
+
+    /**
+     * @brief 按当前格式格式化数据，不加时间戳
+     */
+    QString formatPayload(const QByteArray &data) const;
+
+    QVector<Entry> m_ring;          ///< 环形缓冲，容量即最大记录数
+    int m_head;                     ///< 最旧记录的位置
+    int m_count;                    ///< 模型中的记录数
+    qint64 m_bytes;                 ///< 模型中记录的数据字节数
+    qint64 m_maxBytes;
+
+    QList<Entry> m_pending;         ///< 待插入的记录
+    qint64 m_pendingBytes;
+    QTimer m_flushTimer;
+
+    quint64 m_nextSerial;
+    qint64 m_evicted;
+
+    CDataFormatter::DataDisplayFormat m_format;
+    bool m_showTimestamp;
+    mutable CDataFormatter m_formatter;
+    mutable QCache<quint64, QString> m_summaryCache;   ///< 可见行的摘要缓存
+};
+
+#endif // PACKETLOGMODEL_H
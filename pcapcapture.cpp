@@ -0,0 +1,1051 @@
+#include "pcapcapture.h"
+#include <QMutexLocker>
+#include <QDateTime>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+const quint32 BLOCK_SECTION_HEADER = 0x0A0D0D0A;
+const quint32 BLOCK_INTERFACE = 0x00000001;
+const quint32 BLOCK_SIMPLE_PACKET = 0x00000003;
+const quint32 BLOCK_ENHANCED_PACKET = 0x00000006;
+const quint32 BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+
+const quint16 OPTION_END = 0;
+const quint16 OPTION_IF_NAME = 2;
+const quint16 OPTION_SHB_USERAPPL = 4;
+const quint16 OPTION_IF_TSRESOL = 9;
+const quint16 OPTION_EPB_FLAGS = 2;
+
+const quint8 TCP_FIN = 0x01;
+const quint8 TCP_SYN = 0x02;
+const quint8 TCP_PSH = 0x08;
+const quint8 TCP_ACK = 0x10;
+
+const int IPV4_HEADER = 20;
+const int IPV6_HEADER = 40;
+const int TCP_HEADER = 20;
+const int EPB_FIXED = 28;               ///< 增强包块的固定部分（含块类型和长度）
+const int EPB_TRAILER = 8 + 4 + 4;      ///< epb_flags 选项、选项结束和块尾长度
+
+/**
+ * @brief 追加一个 pcapng 选项（小端，按4字节对齐）
+ */
+void appendOption(QByteArray& body, quint16 code, const QByteArray& value)
+{
+    char header[4];
+    qToLittleEndian<quint16>(code, header);
+    qToLittleEndian<quint16>(quint16(value.size()), header + 2);
+    body.append(header, 4);
+    body.append(value);
+    body.append(QByteArray((4 - value.size() % 4) % 4, '\0'));
+}
+
+/**
+ * @brief 组成完整的块：类型 | 总长度 | 内容 | 总长度
+ */
+QByteArray makeBlock(quint32 type, const QByteArray& body)
+{
+    const quint32 length = quint32(body.size() + 12);
+    QByteArray block(int(length), Qt::Uninitialized);
+    qToLittleEndian<quint32>(type, block.data());
+    qToLittleEndian<quint32>(length, block.data() + 4);
+    memcpy(block.data() + 8, body.constData(), size_t(body.size()));
+    qToLittleEndian<quint32>(length, block.data() + length - 4);
+    return block;
+}
+
+/**
+ * @brief IPv4头校验和
+ */
+quint16 ipv4Checksum(const uchar* header)
+{
+    quint32 sum = 0;
+    for (int i = 0; i < IPV4_HEADER; i += 2) {
+        sum += quint32(header[i] << 8 | header[i + 1]);
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return quint16(~sum);
+}
+
+/**
+ * @brief 地址和端口的显示文本
+ */
+QString endpointText(const QHostAddress& address, quint16 port)
+{
+    if (address.protocol() == QAbstractSocket::IPv6Protocol) {
+        return QString("[%1]:%2").arg(address.toString()).arg(port);
+    }
+    return QString("%1:%2").arg(address.toString()).arg(port);
+}
+
+} // namespace
+
+/**
+ * @brief 从已连接的套接字生成连接地址
+ * @param socket 套接字
+ */
+CPcapWriter::Flow CPcapWriter::Flow::fromSocket(const QAbstractSocket* socket)
+{
+    Flow flow;
+    if (!socket) {
+        return flow;
+    }
+    flow.localAddress = socket->localAddress();
+    flow.localPort = socket->localPort();
+    flow.peerAddress = socket->peerAddress();
+    flow.peerPort = socket->peerPort();
+
+    const Q_IPV6ADDR local = flow.localAddress.toIPv6Address();
+    const Q_IPV6ADDR peer = flow.peerAddress.toIPv6Address();
+    char ports[4];
+    qToBigEndian<quint16>(flow.localPort, ports);
+    qToBigEndian<quint16>(flow.peerPort, ports + 2);
+    flow.key.reserve(36);
+    flow.key.append(reinterpret_cast<const char*>(local.c), 16);
+    flow.key.append(reinterpret_cast<const char*>(peer.c), 16);
+    flow.key.append(ports, 4);
+    return flow;
+}
+
+/**
+ * @brief CPcapWriter构造函数
+ * @param parent 父对象指针
+ */
+CPcapWriter::CPcapWriter(QObject *parent)
+    : QObject(parent)
+    , m_thread(new QThread(this))
+    , m_worker(nullptr)
+    , m_flushTimer(this)
+    , m_open(false)
+    , m_queuedBytes(0)
+    , m_baseUs(0)
+{
+    m_worker = new CPcapWriterWorker(&m_queuedBytes);
+    m_thread->setObjectName("tcpimg-pcap");
+    m_worker->moveToThread(m_thread);
+    connect(m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &CPcapWriterWorker::failed, this, &CPcapWriter::onWorkerFailed);
+    m_thread->start();
+
+    m_flushTimer.setInterval(FLUSH_INTERVAL_MS);
+    connect(&m_flushTimer, &QTimer::timeout, this, &CPcapWriter::flush);
+}
+
+/**
+ * @brief 析构函数：写完数据后停止写入线程
+ */
+CPcapWriter::~CPcapWriter()
+{
+    close();
+    m_thread->quit();
+    m_thread->wait();
+}
+
+/**
+ * @brief 创建抓包文件
+ * @param fileName 文件路径
+ * @param errorString 失败原因
+ * @return 成功返回true
+ */
+bool CPcapWriter::open(const QString& fileName, QString* errorString)
+{
+    close();
+
+    QString error;
+    QMetaObject::invokeMethod(m_worker, "openFile", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(QString, error),
+                              Q_ARG(QString, fileName), Q_ARG(QByteArray, fileHeader()));
+    if (!error.isEmpty()) {
+        if (errorString) {
+            *errorString = error;
+        }
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_stats = Stats();
+    m_stats.open = true;
+    m_stats.fileName = fileName;
+    m_stats.fileBytes = fileHeader().size();
+    m_flows.clear();
+    m_buffer.clear();
+    m_buffer.reserve(FLUSH_BYTES + SEGMENT_SIZE + 256);
+    m_baseUs = QDateTime::currentMSecsSinceEpoch() * 1000;
+    m_clock.start();
+    m_open.store(true);
+    locker.unlock();
+
+    m_flushTimer.start();
+    qDebug() << "📼 开始抓包：" << fileName;
+    return true;
+}
+
+/**
+ * @brief 写完缓冲并关闭文件
+ */
+void CPcapWriter::close()
+{
+    if (!isOpen()) {
+        return;
+    }
+    m_flushTimer.stop();
+
+    QMutexLocker locker(&m_mutex);
+    m_open.store(false);
+    queueBuffer();
+    m_flows.clear();
+    m_stats.open = false;
+    const Stats stats = m_stats;
+    locker.unlock();
+
+    // 队列按顺序执行：返回时之前排队的数据都已写入
+    QMetaObject::invokeMethod(m_worker, "closeFile", Qt::BlockingQueuedConnection);
+    qDebug() << "📼 抓包结束：" << formatStats(stats);
+}
+
+/**
+ * @brief 连接建立：写入合成的三次握手
+ * @param flow 连接
+ * @param localIsClient 本机是否为发起方
+ */
+void CPcapWriter::openFlow(const Flow& flow, bool localIsClient)
+{
+    if (!isOpen() || !flow.isValid()) {
+        return;
+    }
+
+    const qint64 timestamp = nowUs();
+    QMutexLocker locker(&m_mutex);
+    if (!isOpen()) {
+        return;
+    }
+    bool created = false;
+    FlowState& state = flowState(flow, &created);
+    if (!created) {
+        return;
+    }
+
+    // 初始序号为0，握手后数据从相对序号1开始
+    state.localSeq = 0;
+    state.peerSeq = 0;
+    const Direction first = localIsClient ? DIRECTION_OUTBOUND : DIRECTION_INBOUND;
+    const Direction second = localIsClient ? DIRECTION_INBOUND : DIRECTION_OUTBOUND;
+    appendSegment(state, first, TCP_SYN, nullptr, 0, timestamp);
+    appendSegment(state, second, TCP_SYN | TCP_ACK, nullptr, 0, timestamp);
+    appendSegment(state, first, TCP_ACK, nullptr, 0, timestamp);
+}
+
+/**
+ * @brief 记录一段收发数据
+ * @param flow 连接
+ * @param direction 方向
+ * @param data 负载
+ * @param size 负载字节数
+ */
+void CPcapWriter::record(const Flow& flow, Direction direction, const char* data, int size)
+{
+    if (!isOpen() || size <= 0 || !flow.isValid()) {
+        return;
+    }
+
+    const qint64 timestamp = nowUs();
+    QMutexLocker locker(&m_mutex);
+    if (!isOpen()) {
+        return;
+    }
+    FlowState& state = flowState(flow);
+
+    // 写入跟不上：丢弃但推进序号，分析时能看出缺失的位置
+    if (m_queuedBytes.load(std::memory_order_relaxed) + m_buffer.size() > MAX_QUEUED_BYTES) {
+        quint32& seq = (direction == DIRECTION_INBOUND) ? state.peerSeq : state.localSeq;
+        seq += quint32(size);
+        m_stats.dropped++;
+        return;
+    }
+
+    for (int offset = 0; offset < size; offset += SEGMENT_SIZE) {
+        const int length = qMin(int(SEGMENT_SIZE), size - offset);
+        appendSegment(state, direction, TCP_PSH | TCP_ACK, data + offset, length, timestamp);
+    }
+    m_stats.packets++;
+    m_stats.payloadBytes += size;
+
+    if (m_buffer.size() >= FLUSH_BYTES) {
+        queueBuffer();
+    }
+}
+
+/**
+ * @brief 连接关闭：写入合成的FIN
+ * @param flow 连接
+ */
+void CPcapWriter::closeFlow(const Flow& flow)
+{
+    if (!isOpen() || !flow.isValid()) {
+        return;
+    }
+
+    const qint64 timestamp = nowUs();
+    QMutexLocker locker(&m_mutex);
+    QHash<QByteArray, FlowState>::iterator it = m_flows.find(flow.key);
+    if (!isOpen() || it == m_flows.end()) {
+        return;
+    }
+
+    appendSegment(*it, DIRECTION_OUTBOUND, TCP_FIN | TCP_ACK, nullptr, 0, timestamp);
+    appendSegment(*it, DIRECTION_INBOUND, TCP_FIN | TCP_ACK, nullptr, 0, timestamp);
+    appendSegment(*it, DIRECTION_OUTBOUND, TCP_ACK, nullptr, 0, timestamp);
+    m_flows.erase(it);
+}
+
+/**
+ * @brief 抓包统计
+ */
+CPcapWriter::Stats CPcapWriter::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+/**
+ * @brief 格式化抓包统计
+ * @param stats 统计
+ */
+QString CPcapWriter::formatStats(const Stats& stats)
+{
+    QString text = QString("%1 包，%2 MB")
+                   .arg(stats.packets)
+                   .arg(stats.fileBytes / (1024.0 * 1024.0), 0, 'f', 1);
+    if (stats.dropped > 0) {
+        text += QString("，写入跟不上丢弃 %1 包").arg(stats.dropped);
+    }
+    return text;
+}
+
+/**
+ * @brief 定时把缓冲交给写入线程
+ */
+void CPcapWriter::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    queueBuffer();
+}
+
+/**
+ * @brief 写文件失败：关闭并通知
+ * @param message 错误信息
+ */
+void CPcapWriter::onWorkerFailed(const QString& message)
+{
+    qDebug() << "❌ 抓包文件写入失败：" << message;
+    close();
+    emit failed(message);
+}
+
+/**
+ * @brief 查找或创建连接状态
+ * @param flow 连接
+ * @param created 是否新建
+ */
+CPcapWriter::FlowState& CPcapWriter::flowState(const Flow& flow, bool* created)
+{
+    QHash<QByteArray, FlowState>::iterator it = m_flows.find(flow.key);
+    if (created) {
+        *created = (it == m_flows.end());
+    }
+    if (it != m_flows.end()) {
+        return *it;
+    }
+
+    // 两端都是IPv4（含IPv4映射的IPv6地址）时写IPv4头，否则写IPv6头
+    FlowState state;
+    bool localIsIPv4 = false;
+    bool peerIsIPv4 = false;
+    state.local4 = flow.localAddress.toIPv4Address(&localIsIPv4);
+    state.peer4 = flow.peerAddress.toIPv4Address(&peerIsIPv4);
+    state.ipv6 = !(localIsIPv4 && peerIsIPv4);
+    state.localPort = flow.localPort;
+    state.peerPort = flow.peerPort;
+    state.local6 = flow.localAddress.toIPv6Address();
+    state.peer6 = flow.peerAddress.toIPv6Address();
+    return *m_flows.insert(flow.key, state);
+}
+
+/**
+ * @brief 编码一个增强包块到缓冲
+ * @param state 连接状态
+ * @param direction 方向
+ * @param flags TCP标志
+ * @param data 负载（可为空）
+ * @param size 负载字节数
+ * @param timestampUs 时间戳（Unix纪元微秒）
+ */
+void CPcapWriter::appendSegment(FlowState& state, Direction direction, quint8 flags,
+                                const char* data, int size, qint64 timestampUs)
+{
+    const bool inbound = (direction == DIRECTION_INBOUND);
+    const int ipHeader = state.ipv6 ? IPV6_HEADER : IPV4_HEADER;
+    const int packetLength = ipHeader + TCP_HEADER + size;
+    const int padded = (packetLength + 3) & ~3;
+    const int blockLength = EPB_FIXED + padded + EPB_TRAILER;
+
+    const int start = m_buffer.size();
+    m_buffer.resize(start + blockLength);
+    char* block = m_buffer.data() + start;
+    uchar* packet = reinterpret_cast<uchar*>(block + EPB_FIXED);
+
+    // 增强包块：接口0，微秒时间戳
+    qToLittleEndian<quint32>(BLOCK_ENHANCED_PACKET, block);
+    qToLittleEndian<quint32>(quint32(blockLength), block + 4);
+    qToLittleEndian<quint32>(0, block + 8);
+    qToLittleEndian<quint32>(quint32(quint64(timestampUs) >> 32), block + 12);
+    qToLittleEndian<quint32>(quint32(quint64(timestampUs)), block + 16);
+    qToLittleEndian<quint32>(quint32(packetLength), block + 20);
+    qToLittleEndian<quint32>(quint32(packetLength), block + 24);
+
+    // IP头
+    if (state.ipv6) {
+        qToBigEndian<quint32>(0x60000000, packet);
+        qToBigEndian<quint16>(quint16(TCP_HEADER + size), packet + 4);
+        packet[6] = 6;      // TCP
+        packet[7] = 64;
+        memcpy(packet + 8, inbound ? state.peer6.c : state.local6.c, 16);
+        memcpy(packet + 24, inbound ? state.local6.c : state.peer6.c, 16);
+    } else {
+        packet[0] = 0x45;
+        packet[1] = 0;
+        qToBigEndian<quint16>(quint16(packetLength), packet + 2);
+        qToBigEndian<quint16>(state.ipId++, packet + 4);
+        qToBigEndian<quint16>(0x4000, packet + 6);     // DF
+        packet[8] = 64;
+        packet[9] = 6;      // TCP
+        packet[10] = 0;
+        packet[11] = 0;
+        qToBigEndian<quint32>(inbound ? state.peer4 : state.local4, packet + 12);
+        qToBigEndian<quint32>(inbound ? state.local4 : state.peer4, packet + 16);
+        qToBigEndian<quint16>(ipv4Checksum(packet), packet + 10);
+    }
+
+    // TCP头：序号按方向累加，确认号为另一方向的下一个序号
+    uchar* tcp = packet + ipHeader;
+    quint32& seq = inbound ? state.peerSeq : state.localSeq;
+    const quint32 ack = inbound ? state.localSeq : state.peerSeq;
+    qToBigEndian<quint16>(inbound ? state.peerPort : state.localPort, tcp);
+    qToBigEndian<quint16>(inbound ? state.localPort : state.peerPort, tcp + 2);
+    qToBigEndian<quint32>(seq, tcp + 4);
+    qToBigEndian<quint32>((flags & TCP_ACK) ? ack : 0, tcp + 8);
+    tcp[12] = quint8((TCP_HEADER / 4) << 4);
+    tcp[13] = flags;
+    qToBigEndian<quint16>(0xFFFF, tcp + 14);
+    qToBigEndian<quint16>(0, tcp + 16);                // 校验和不计算
+    qToBigEndian<quint16>(0, tcp + 18);
+    if (size > 0) {
+        memcpy(tcp + TCP_HEADER, data, size_t(size));
+    }
+    memset(tcp + TCP_HEADER + size, 0, size_t(padded - packetLength));
+    seq += quint32(size) + ((flags & (TCP_SYN | TCP_FIN)) ? 1 : 0);
+
+    // epb_flags：bit0-1 为方向，1入站 2出站
+    char* options = block + EPB_FIXED + padded;
+    qToLittleEndian<quint16>(OPTION_EPB_FLAGS, options);
+    qToLittleEndian<quint16>(4, options + 2);
+    qToLittleEndian<quint32>(inbound ? 1 : 2, options + 4);
+    qToLittleEndian<quint32>(OPTION_END, options + 8);
+    qToLittleEndian<quint32>(quint32(blockLength), options + 12);
+
+    m_stats.fileBytes += blockLength;
+}
+
+/**
+ * @brief 把缓冲交给写入线程
+ */
+void CPcapWriter::queueBuffer()
+{
+    if (m_buffer.isEmpty()) {
+        return;
+    }
+
+    m_queuedBytes.fetch_add(m_buffer.size(), std::memory_order_relaxed);
+    QMetaObject::invokeMethod(m_worker, "write", Qt::QueuedConnection, Q_ARG(QByteArray, m_buffer));
+    m_buffer = QByteArray();
+    m_buffer.reserve(FLUSH_BYTES + SEGMENT_SIZE + 256);
+}
+
+/**
+ * @brief 当前时间
+ * @return Unix纪元微秒
+ */
+qint64 CPcapWriter::nowUs() const
+{
+    return m_baseUs + m_clock.nsecsElapsed() / 1000;
+}
+
+/**
+ * @brief 节头块和接口描述块
+ */
+QByteArray CPcapWriter::fileHeader()
+{
+    QByteArray section(16, '\0');
+    qToLittleEndian<quint32>(BYTE_ORDER_MAGIC, section.data());
+    qToLittleEndian<quint16>(1, section.data() + 4);           // 版本 1.0
+    qToLittleEndian<quint16>(0, section.data() + 6);
+    qToLittleEndian<quint64>(~quint64(0), section.data() + 8); // 节长度未知
+    appendOption(section, OPTION_SHB_USERAPPL, QByteArray("TCPImg network debugger"));
+    appendOption(section, OPTION_END, QByteArray());
+
+    QByteArray description(8, '\0');
+    qToLittleEndian<quint16>(quint16(LINKTYPE_RAW), description.data());
+    qToLittleEndian<quint32>(0, description.data() + 4);         // 不截断
+    appendOption(description, OPTION_IF_NAME, QByteArray("tcpimg-debugger"));
+    appendOption(description, OPTION_IF_TSRESOL, QByteArray(1, char(6)));
+    appendOption(description, OPTION_END, QByteArray());
+
+    return makeBlock(BLOCK_SECTION_HEADER, section) + makeBlock(BLOCK_INTERFACE, description);
+}
+
+/**
+ * @brief CPcapWriterWorker构造函数
+ * @param queuedBytes 排队字节数（写完后扣减）
+ * @param parent 父对象指针
+ */
+CPcapWriterWorker::CPcapWriterWorker(std::atomic<qint64>* queuedBytes, QObject *parent)
+    : QObject(parent)
+    , m_file(nullptr)
+    , m_queuedBytes(queuedBytes)
+{
+}
+
+/**
+ * @brief 创建文件并写入文件头
+ * @param fileName 文件路径
+ * @param header 文件头
+ * @return 失败原因
+ */
+QString CPcapWriterWorker::openFile(const QString& fileName, const QByteArray& header)
+{
+    closeFile();
+
+    m_file = new QFile(fileName, this);
+    if (!m_file->open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || m_file->write(header) != header.size()) {
+        const QString error = QString("无法创建抓包文件 %1：%2").arg(fileName, m_file->errorString());
+        delete m_file;
+        m_file = nullptr;
+        return error;
+    }
+    return QString();
+}
+
+/**
+ * @brief 写入一批数据
+ * @param data 编码好的块
+ */
+void CPcapWriterWorker::write(const QByteArray& data)
+{
+    m_queuedBytes->fetch_sub(data.size(), std::memory_order_relaxed);
+    if (!m_file) {
+        return;
+    }
+
+    if (m_file->write(data) != data.size()) {
+        const QString error = m_file->errorString();
+        delete m_file;
+        m_file = nullptr;
+        emit failed(error);
+    }
+}
+
+/**
+ * @brief 关闭文件
+ */
+void CPcapWriterWorker::closeFile()
+{
+    if (m_file) {
+        m_file->close();
+        delete m_file;
+        m_file = nullptr;
+    }
+}
+
+/**
+ * @brief CPcapReader构造函数
+ */
+CPcapReader::CPcapReader()
+    : m_pcapng(false)
+    , m_bigEndian(false)
+    , m_nanosecond(false)
+    , m_linkType(0)
+    , m_packetsRead(0)
+    , m_packetsSkipped(0)
+{
+}
+
+/**
+ * @brief 打开文件并识别格式
+ * @param fileName 文件路径
+ * @param errorString 失败原因
+ * @return 成功返回true
+ */
+bool CPcapReader::open(const QString& fileName, QString* errorString)
+{
+    close();
+    m_file.setFileName(fileName);
+
+    QString error;
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        error = QString("无法打开 %1：%2").arg(fileName, m_file.errorString());
+    } else {
+        const QByteArray magic = m_file.peek(4);
+        const quint32 value = magic.size() == 4 ? qFromLittleEndian<quint32>(magic.constData()) : 0;
+        if (value == BLOCK_SECTION_HEADER) {
+            m_pcapng = true;
+        } else if (value == 0xA1B2C3D4 || value == 0xA1B23C4D) {
+            m_bigEndian = false;
+            m_nanosecond = (value == 0xA1B23C4D);
+        } else if (value == 0xD4C3B2A1 || value == 0x4D3CB2A1) {
+            m_bigEndian = true;
+            m_nanosecond = (value == 0x4D3CB2A1);
+        } else {
+            error = QString("%1 不是 pcap 或 pcapng 文件").arg(fileName);
+        }
+
+        if (error.isEmpty() && !m_pcapng) {
+            const QByteArray header = m_file.read(24);
+            if (header.size() != 24) {
+                error = "pcap 文件头不完整";
+            } else {
+                m_linkType = int(read32(header.constData() + 20) & 0xFFFF);
+            }
+        }
+    }
+
+    if (!error.isEmpty()) {
+        m_file.close();
+        if (errorString) {
+            *errorString = error;
+        }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 关闭文件
+ */
+void CPcapReader::close()
+{
+    m_file.close();
+    m_pcapng = false;
+    m_bigEndian = false;
+    m_nanosecond = false;
+    m_linkType = 0;
+    m_interfaces.clear();
+    m_errorString.clear();
+    m_packetsRead = 0;
+    m_packetsSkipped = 0;
+}
+
+/**
+ * @brief 读取下一个带负载的包
+ * @param packet 输出
+ * @return 成功返回true
+ */
+bool CPcapReader::readNext(Packet& packet)
+{
+    QByteArray frame;
+    int linkType = 0;
+    qint64 timestampUs = 0;
+    CPcapWriter::Direction direction = CPcapWriter::DIRECTION_UNKNOWN;
+    while (readFrame(frame, linkType, timestampUs, direction)) {
+        m_packetsRead++;
+        if (decodeFrame(frame, linkType, packet)) {
+            packet.timestampUs = timestampUs;
+            packet.direction = direction;
+            return true;
+        }
+        m_packetsSkipped++;
+    }
+    return false;
+}
+
+/**
+ * @brief 读取下一个链路层帧
+ */
+bool CPcapReader::readFrame(QByteArray& frame, int& linkType, qint64& timestampUs, CPcapWriter::Direction& direction)
+{
+    if (!m_file.isOpen() || !m_errorString.isEmpty()) {
+        return false;
+    }
+    direction = CPcapWriter::DIRECTION_UNKNOWN;
+    if (m_pcapng) {
+        return readPcapngFrame(frame, linkType, timestampUs, direction);
+    }
+    return readPcapFrame(frame, linkType, timestampUs);
+}
+
+/**
+ * @brief 读取经典 pcap 的一条记录
+ */
+bool CPcapReader::readPcapFrame(QByteArray& frame, int& linkType, qint64& timestampUs)
+{
+    const QByteArray header = m_file.read(16);
+    if (header.isEmpty()) {
+        return false;
+    }
+    if (header.size() != 16) {
+        return fail("记录头不完整（文件被截断）");
+    }
+
+    const quint32 seconds = read32(header.constData());
+    const quint32 fraction = read32(header.constData() + 4);
+    const quint32 captured = read32(header.constData() + 8);
+    if (captured > quint32(MAX_RECORD_BYTES)) {
+        return fail(QString("记录长度异常：%1 字节").arg(captured));
+    }
+
+    frame = m_file.read(qint64(captured));
+    if (frame.size() != int(captured)) {
+        return fail("记录内容不完整（文件被截断）");
+    }
+    linkType = m_linkType;
+    timestampUs = qint64(seconds) * 1000000 + (m_nanosecond ? fraction / 1000 : fraction);
+    return true;
+}
+
+/**
+ * @brief 读取 pcapng 的下一个数据包块（跳过其他块）
+ */
+bool CPcapReader::readPcapngFrame(QByteArray& frame, int& linkType, qint64& timestampUs, CPcapWriter::Direction& direction)
+{
+    forever {
+        const QByteArray header = m_file.read(8);
+        if (header.isEmpty()) {
+            return false;
+        }
+        if (header.size() != 8) {
+            return fail("块头不完整（文件被截断）");
+        }
+
+        // 节头块的字节序由其中的字节序标记决定
+        const quint32 type = qFromLittleEndian<quint32>(header.constData());
+        if (type == BLOCK_SECTION_HEADER) {
+            const QByteArray magic = m_file.peek(4);
+            if (magic.size() != 4) {
+                return fail("节头块不完整");
+            }
+            m_bigEndian = (qFromLittleEndian<quint32>(magic.constData()) != BYTE_ORDER_MAGIC);
+        }
+
+        const quint32 length = read32(header.constData() + 4);
+        if (length < 12 || length % 4 != 0 || length > quint32(MAX_RECORD_BYTES)) {
+            return fail(QString("块长度异常：%1 字节").arg(length));
+        }
+        const QByteArray body = m_file.read(qint64(length) - 8);
+        if (body.size() != int(length) - 8) {
+            return fail("块内容不完整（文件被截断）");
+        }
+        const int bodySize = body.size() - 4;   // 去掉块尾长度
+        const char* data = body.constData();
+
+        switch (read32(header.constData())) {
+        case BLOCK_SECTION_HEADER:
+            if (!readSectionHeader(body.left(bodySize))) {
+                return false;
+            }
+            break;
+
+        case BLOCK_INTERFACE:
+            if (!readInterface(body.left(bodySize))) {
+                return false;
+            }
+            break;
+
+        case BLOCK_ENHANCED_PACKET: {
+            if (bodySize < 20) {
+                return fail("增强包块过短");
+            }
+            const quint32 interfaceId = read32(data);
+            const quint64 timestamp = (quint64(read32(data + 4)) << 32) | read32(data + 8);
+            const quint32 captured = read32(data + 12);
+            if (interfaceId >= quint32(m_interfaces.size()) || captured > quint32(bodySize - 20)) {
+                return fail("增强包块的接口或长度无效");
+            }
+            const Interface& source = m_interfaces[int(interfaceId)];
+            frame = body.mid(20, int(captured));
+            linkType = source.linkType;
+            timestampUs = toMicros(timestamp, source);
+
+            // 选项中的 epb_flags 方向标记
+            int offset = 20 + ((int(captured) + 3) & ~3);
+            while (offset + 4 <= bodySize) {
+                const quint16 code = read16(data + offset);
+                const quint16 size = read16(data + offset + 2);
+                if (code == OPTION_END || offset + 4 + size > bodySize) {
+                    break;
+                }
+                if (code == OPTION_EPB_FLAGS && size == 4) {
+                    const quint32 flags = read32(data + offset + 4) & 3;
+                    direction = (flags == 1) ? CPcapWriter::DIRECTION_INBOUND
+                              : (flags == 2) ? CPcapWriter::DIRECTION_OUTBOUND
+                                             : CPcapWriter::DIRECTION_UNKNOWN;
+                }
+                offset += 4 + ((size + 3) & ~3);
+            }
+            return true;
+        }
+
+        case BLOCK_SIMPLE_PACKET: {
+            if (bodySize < 4 || m_interfaces.isEmpty()) {
+                return fail("简单包块无效");
+            }
+            const int original = int(read32(data));
+            frame = body.mid(4, qMin(original, bodySize - 4));
+            linkType = m_interfaces.first().linkType;
+            timestampUs = 0;    // 简单包块不带时间戳
+            return true;
+        }
+
+        default:
+            break;  // 名称解析、统计等块与负载无关
+        }
+    }
+}
+
+/**
+ * @brief 解析节头块（新的节清空接口列表）
+ * @param body 块内容
+ */
+bool CPcapReader::readSectionHeader(const QByteArray& body)
+{
+    if (body.size() < 16) {
+        return fail("节头块过短");
+    }
+    if (read16(body.constData() + 4) != 1) {
+        return fail(QString("不支持的 pcapng 版本：%1").arg(read16(body.constData() + 4)));
+    }
+    m_interfaces.clear();
+    return true;
+}
+
+/**
+ * @brief 解析接口描述块
+ * @param body 块内容
+ * @return 时间戳精度超出范围时返回false（换算会溢出）
+ */
+bool CPcapReader::readInterface(const QByteArray& body)
+{
+    Interface description;
+    if (body.size() >= 8) {
+        description.linkType = read16(body.constData());
+    }
+
+    int offset = 8;
+    while (offset + 4 <= body.size()) {
+        const quint16 code = read16(body.constData() + offset);
+        const quint16 size = read16(body.constData() + offset + 2);
+        if (code == OPTION_END || offset + 4 + size > body.size()) {
+            break;
+        }
+        if (code == OPTION_IF_TSRESOL && size >= 1) {
+            const quint8 resolution = quint8(body[offset + 4]);
+            description.binaryResolution = (resolution & 0x80) != 0;
+            description.exponent = resolution & 0x7F;
+            // 十进制 10^19、二进制 2^63 以内才能用64位整数换算
+            if (description.exponent > (description.binaryResolution ? 63 : 19)) {
+                return fail(QString("接口时间戳精度无效：%1^-%2")
+                            .arg(description.binaryResolution ? 2 : 10)
+                            .arg(description.exponent));
+            }
+        }
+        offset += 4 + ((size + 3) & ~3);
+    }
+    m_interfaces.append(description);
+    return true;
+}
+
+/**
+ * @brief 从链路层帧中取出TCP/UDP负载
+ * @param frame 帧
+ * @param linkType 链路类型
+ * @param packet 输出地址和负载
+ */
+bool CPcapReader::decodeFrame(const QByteArray& frame, int linkType, Packet& packet)
+{
+    const uchar* data = reinterpret_cast<const uchar*>(frame.constData());
+    const int size = frame.size();
+    int offset = 0;
+    quint16 etherType = 0;
+
+    switch (linkType) {
+    case 1:     // 以太网
+        if (size < 14) {
+            return false;
+        }
+        etherType = qFromBigEndian<quint16>(data + 12);
+        offset = 14;
+        while ((etherType == 0x8100 || etherType == 0x88A8) && offset + 4 <= size) {
+            etherType = qFromBigEndian<quint16>(data + offset + 2);
+            offset += 4;
+        }
+        break;
+    case 0:     // BSD loopback（协议族为抓包主机字节序）
+    case 108:   // OpenBSD loopback
+        offset = 4;
+        break;
+    case 101:   // 裸IP
+    case 228:   // IPv4
+    case 229:   // IPv6
+        break;
+    case 113:   // Linux cooked capture
+        if (size < 16) {
+            return false;
+        }
+        etherType = qFromBigEndian<quint16>(data + 14);
+        offset = 16;
+        break;
+    case 276:   // Linux cooked capture v2
+        if (size < 20) {
+            return false;
+        }
+        etherType = qFromBigEndian<quint16>(data);
+        offset = 20;
+        break;
+    default:
+        return false;
+    }
+    if (etherType != 0 && etherType != 0x0800 && etherType != 0x86DD) {
+        return false;
+    }
+    if (offset >= size) {
+        return false;
+    }
+
+    // IP头
+    const uchar* ip = data + offset;
+    const int available = size - offset;
+    int protocol = 0;
+    int transport = 0;      // 传输层头相对 ip 的偏移
+    int ipEnd = available;  // IP包结束位置（不含以太网填充）
+    QHostAddress source;
+    QHostAddress destination;
+
+    const int version = ip[0] >> 4;
+    if (version == 4) {
+        const int headerLength = (ip[0] & 0x0F) * 4;
+        if (available < 20 || headerLength < 20 || headerLength > available) {
+            return false;
+        }
+        const int totalLength = qFromBigEndian<quint16>(ip + 2);
+        if ((qFromBigEndian<quint16>(ip + 6) & 0x3FFF) != 0) {
+            return false;   // 分片
+        }
+        if (totalLength >= headerLength) {  // 网卡分段卸载时总长度可能为0
+            ipEnd = qMin(available, totalLength);
+        }
+        protocol = ip[9];
+        transport = headerLength;
+        source = QHostAddress(qFromBigEndian<quint32>(ip + 12));
+        destination = QHostAddress(qFromBigEndian<quint32>(ip + 16));
+    } else if (version == 6) {
+        if (available < 40) {
+            return false;
+        }
+        const int payloadLength = qFromBigEndian<quint16>(ip + 4);
+        if (payloadLength > 0) {
+            ipEnd = qMin(available, 40 + payloadLength);
+        }
+        protocol = ip[6];
+        transport = 40;
+        // 跳过逐跳、路由和目的选项扩展头；分片的包跳过
+        while ((protocol == 0 || protocol == 43 || protocol == 60) && transport + 8 <= ipEnd) {
+            protocol = ip[transport];
+            transport += (ip[transport + 1] + 1) * 8;
+        }
+        source = QHostAddress(ip + 8);
+        destination = QHostAddress(ip + 24);
+    } else {
+        return false;
+    }
+
+    // 传输层
+    int payload = 0;
+    if (protocol == 6) {
+        if (transport + 20 > ipEnd) {
+            return false;
+        }
+        payload = transport + (ip[transport + 12] >> 4) * 4;
+    } else if (protocol == 17) {
+        payload = transport + 8;
+    } else {
+        return false;
+    }
+    if (payload >= ipEnd) {
+        return false;   // 没有负载（握手、纯确认等）
+    }
+
+    packet.udp = (protocol == 17);
+    packet.source = endpointText(source, qFromBigEndian<quint16>(ip + transport));
+    packet.destination = endpointText(destination, qFromBigEndian<quint16>(ip + transport + 2));
+    packet.payload = frame.mid(offset + payload, ipEnd - payload);
+    return true;
+}
+
+/**
+ * @brief 按文件字节序读取16位整数
+ */
+quint16 CPcapReader::read16(const char* data) const
+{
+    return m_bigEndian ? qFromBigEndian<quint16>(data) : qFromLittleEndian<quint16>(data);
+}
+
+/**
+ * @brief 按文件字节序读取32位整数
+ */
+quint32 CPcapReader::read32(const char* data) const
+{
+    return m_bigEndian ? qFromBigEndian<quint32>(data) : qFromLittleEndian<quint32>(data);
+}
+
+/**
+ * @brief 接口时间戳转为微秒
+ * @param timestamp 时间戳（接口单位）
+ * @param description 接口
+ */
+qint64 CPcapReader::toMicros(quint64 timestamp, const Interface& description) const
+{
+    if (description.binaryResolution) {
+        const int shift = qMin(description.exponent, 63);
+        const quint64 seconds = timestamp >> shift;
+        const quint64 fraction = timestamp & ((quint64(1) << shift) - 1);
+        return qint64(seconds * 1000000 + quint64(double(fraction) * 1e6 / double(quint64(1) << shift)));
+    }
+
+    quint64 scale = 1;
+    for (int i = 6; i < description.exponent; ++i) {
+        scale *= 10;
+    }
+    if (description.exponent >= 6) {
+        return qint64(timestamp / scale);
+    }
+    for (int i = description.exponent; i < 6; ++i) {
+        timestamp *= 10;
+    }
+    return qint64(timestamp);
+}
+
+/**
+ * @brief 记录错误并停止读取
+ * @param message 错误信息
+ * @return 总是false
+ */
+bool CPcapReader::fail(const QString& message)
+{
+    m_errorString = message;
+    qDebug() << "❌ 抓包文件解析失败：" << message;
+    return false;
+}
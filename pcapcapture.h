@@ -0,0 +1,342 @@
+#ifndef PCAPCAPTURE_H
+#define PCAPCAPTURE_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QFile>
+#include <QHash>
+#include <QVector>
+#include <QByteArray>
+#include <QString>
+#include <QHostAddress>
+#include <QAbstractSocket>
+#include <atomic>
+
+class CPcapWriterWorker;
+
+/**
+ * @class CPcapWriter
+ * @brief 网络调试器收发数据的 pcapng 抓包文件写入
+ *
+ * 调试器收发的是TCP负载，写入时为每段数据合成IPv4/IPv6和TCP头（链路类型 RAW），
+ * Wireshark 可以直接按TCP流分析：
+ * - 每个连接维护两个方向的序号，连接开始和结束时写入合成的三次握手和FIN
+ * - 每个包带 epb_flags 方向标记（入站/出站），时间戳精度为微秒
+ * - TCP校验和填0（Wireshark 默认不校验），IPv4头校验和正常计算
+ *
+ * record() 可以在任意线程调用（服务器工作线程直接记录），只在锁内把包编码进内存缓冲；
+ * 缓冲满 FLUSH_BYTES 或每 FLUSH_INTERVAL_MS 交给写入线程写文件。写入跟不上、
+ * 排队数据超过 MAX_QUEUED_BYTES 时丢弃新包（序号照常推进，Wireshark 中显示为未抓到的分段）。
+ */
+class CPcapWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum Direction
+     * @brief 数据方向（相对本机）
+     */
+    enum Direction {
+        DIRECTION_INBOUND,      ///< 收到的数据
+        DIRECTION_OUTBOUND,     ///< 发出的数据
+        DIRECTION_UNKNOWN       ///< 未知（仅导入其他工具的抓包文件时）
+    };
+
+    /**
+     * @struct Flow
+     * @brief 一个TCP连接的两端地址
+     */
+    struct Flow
+    {
+        QHostAddress localAddress;
+        quint16 localPort = 0;
+        QHostAddress peerAddress;
+        quint16 peerPort = 0;
+        QByteArray key;                 ///< 连接的唯一标识（由 fromSocket 生成）
+
+        bool isValid() const { return !key.isEmpty(); }
+
+        /**
+         * @brief 从已连接的套接字生成
+         */
+        static Flow fromSocket(const QAbstractSocket* socket);
+    };
+
+    /**
+     * @struct Stats
+     * @brief 抓包统计
+     */
+    struct Stats
+    {
+        bool open = false;
+        QString fileName;
+        qint64 packets = 0;             ///< 记录的数据包数（大包拆成多个分段时仍计一个）
+        qint64 payloadBytes = 0;        ///< 记录的负载字节数
+        qint64 fileBytes = 0;           ///< 写入文件的字节数（含排队中的）
+        qint64 dropped = 0;             ///< 写入跟不上时丢弃的数据包数
+    };
+
+    static const int FLUSH_BYTES = 1024 * 1024;                 ///< 缓冲满此大小时交给写入线程
+    static const int FLUSH_INTERVAL_MS = 500;                   ///< 缓冲最长停留时间
+    static const qint64 MAX_QUEUED_BYTES = 64 * 1024 * 1024;    ///< 排队未写入的字节数上限
+    static const int SEGMENT_SIZE = 65000;                      ///< 单个合成TCP分段的最大负载
+    static const int LINKTYPE_RAW = 101;                        ///< 链路类型：裸IP
+
+    explicit CPcapWriter(QObject *parent = nullptr);
+    ~CPcapWriter();
+
+    /**
+     * @brief 创建抓包文件（已打开时先关闭之前的文件）
+     * @param fileName 文件路径
+     * @param errorString 失败原因
+     * @return 文件无法创建时返回false
+     */
+    bool open(const QString& fileName, QString* errorString = nullptr);
+
+    /**
+     * @brief 写完缓冲中的数据并关闭文件（统计保留到下次打开）
+     */
+    void close();
+
+    bool isOpen() const { return m_open.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 连接建立：写入合成的三次握手（任意线程）
+     * @param flow 连接
+     * @param localIsClient 本机是否为发起连接的一方
+     */
+    void openFlow(const Flow& flow, bool localIsClient);
+
+    /**
+     * @brief 记录一段收发数据（任意线程）
+     * @param flow 连接，之前没有 openFlow 时从当前位置开始（无握手）
+     * @param direction 方向
+     * @param data 负载
+     * @param size 负载字节数
+     */
+    void record(const Flow& flow, Direction direction, const char* data, int size);
+    void record(const Flow& flow, Direction direction, const QByteArray& data)
+    {
+        record(flow, direction, data.constData(), data.size());
+    }
+
+    /**
+     * @brief 连接关闭：写入合成的FIN（任意线程）
+     */
+    void closeFlow(const Flow& flow);
+
+    Stats stats() const;
+
+    /**
+     * @brief 格式化抓包统计（一行）
+     */
+    static QString formatStats(const Stats& stats);
+
+signals:
+    /**
+     * @brief 写文件失败（文件已关闭）
+     * @param message 错误信息
+     */
+    void failed(const QString& message);
+
+private slots:
+    /**
+     * @brief 定时把缓冲交给写入线程
+     */
+    void flush();
+
+    void onWorkerFailed(const QString& message);
+
+private:
+    /**
+     * @brief 单个连接的合成头状态
+     */
+    struct FlowState
+    {
+        quint32 localSeq = 1;           ///< 本机方向的下一个序号
+        quint32 peerSeq = 1;            ///< 对端方向的下一个序号
+        quint16 ipId = 0;
+        quint16 localPort = 0;
+        quint16 peerPort = 0;
+        bool ipv6 = false;
+        quint32 local4 = 0;
+        quint32 peer4 = 0;
+        Q_IPV6ADDR local6;
+        Q_IPV6ADDR peer6;
+    };
+
+    /**
+     * @brief 查找或创建连接状态（锁内调用）
+     * @param created 是否新建
+     */
+    FlowState& flowState(const Flow& flow, bool* created = nullptr);
+
+    /**
+     * @brief 编码一个增强包块到缓冲（锁内调用）
+     */
+    void appendSegment(FlowState& state, Direction direction, quint8 flags,
+                       const char* data, int size, qint64 timestampUs);
+
+    /**
+     * @brief 把缓冲交给写入线程（锁内调用）
+     */
+    void queueBuffer();
+
+    /**
+     * @brief 当前时间（Unix纪元微秒，单调递增）
+     */
+    qint64 nowUs() const;
+
+    /**
+     * @brief 节头块和接口描述块
+     */
+    static QByteArray fileHeader();
+
+    QThread* m_thread;
+    CPcapWriterWorker* m_worker;
+    QTimer m_flushTimer;
+
+    mutable QMutex m_mutex;                 ///< 保护以下成员（缓冲、连接状态、统计）
+    std::atomic<bool> m_open;
+    std::atomic<qint64> m_queuedBytes;      ///< 已交给写入线程、尚未写完的字节数
+    QByteArray m_buffer;
+    QHash<QByteArray, FlowState> m_flows;
+    Stats m_stats;
+
+    QElapsedTimer m_clock;
+    qint64 m_baseUs;                        ///< 打开文件时的Unix纪元微秒
+};
+
+/**
+ * @class CPcapWriterWorker
+ * @brief 抓包文件的写入线程对象，公共槽函数只能通过队列调用
+ */
+class CPcapWriterWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CPcapWriterWorker(std::atomic<qint64>* queuedBytes, QObject *parent = nullptr);
+
+public slots:
+    /**
+     * @brief 创建文件并写入文件头
+     * @return 失败原因，成功时为空
+     */
+    QString openFile(const QString& fileName, const QByteArray& header);
+    void write(const QByteArray& data);
+    void closeFile();
+
+signals:
+    void failed(const QString& message);
+
+private:
+    QFile* m_file;
+    std::atomic<qint64>* m_queuedBytes;
+};
+
+/**
+ * @class CPcapReader
+ * @brief 读取 pcap / pcapng 抓包文件中的TCP和UDP负载
+ *
+ * 顺序流式读取，内存占用与文件大小无关。支持经典 pcap（微秒/纳秒，两种字节序）和
+ * pcapng（多节、多接口、if_tsresol、epb_flags 方向），链路类型支持以太网（含VLAN）、
+ * 裸IP、BSD loopback 和 Linux cooked capture（SLL/SLL2）。
+ * 分片的IP包、非TCP/UDP包和没有负载的包跳过。
+ */
+class CPcapReader
+{
+public:
+    /**
+     * @struct Packet
+     * @brief 一个带负载的数据包
+     */
+    struct Packet
+    {
+        qint64 timestampUs = 0;         ///< Unix纪元微秒
+        CPcapWriter::Direction direction = CPcapWriter::DIRECTION_UNKNOWN;
+        QString source;                 ///< "IP:端口"
+        QString destination;
+        bool udp = false;
+        QByteArray payload;
+    };
+
+    static const int MAX_RECORD_BYTES = 64 * 1024 * 1024;  ///< 单条记录上限，超出视为文件损坏
+
+    CPcapReader();
+
+    /**
+     * @brief 打开文件并识别格式
+     * @return 文件无法读取或不是抓包文件时返回false
+     */
+    bool open(const QString& fileName, QString* errorString = nullptr);
+    void close();
+
+    /**
+     * @brief 读取下一个带负载的包
+     * @return 文件结束或出错时返回false（出错时 errorString() 非空）
+     */
+    bool readNext(Packet& packet);
+
+    QString errorString() const { return m_errorString; }
+    qint64 position() const { return m_file.pos(); }
+    qint64 size() const { return m_file.size(); }
+    qint64 packetsRead() const { return m_packetsRead; }
+    qint64 packetsSkipped() const { return m_packetsSkipped; }
+
+private:
+    /**
+     * @brief 接口描述（pcapng）
+     */
+    struct Interface
+    {
+        int linkType = 0;
+        bool binaryResolution = false;  ///< 时间戳单位为 2^-exponent 秒
+        int exponent = 6;               ///< 时间戳单位为 10^-exponent 秒
+    };
+
+    /**
+     * @brief 读取下一个数据包记录（链路层帧）
+     */
+    bool readFrame(QByteArray& frame, int& linkType, qint64& timestampUs, CPcapWriter::Direction& direction);
+
+    bool readPcapFrame(QByteArray& frame, int& linkType, qint64& timestampUs);
+    bool readPcapngFrame(QByteArray& frame, int& linkType, qint64& timestampUs, CPcapWriter::Direction& direction);
+
+    /**
+     * @brief 解析节头块，确定字节序
+     */
+    bool readSectionHeader(const QByteArray& body);
+
+    /**
+     * @brief 解析接口描述块，拒绝超出范围的时间戳精度
+     */
+    bool readInterface(const QByteArray& body);
+
+    /**
+     * @brief 从链路层帧中取出TCP/UDP负载
+     * @return 不是带负载的TCP/UDP包时返回false
+     */
+    static bool decodeFrame(const QByteArray& frame, int linkType, Packet& packet);
+
+    quint16 read16(const char* data) const;
+    quint32 read32(const char* data) const;
+    qint64 toMicros(quint64 timestamp, const Interface& description) const;
+    bool fail(const QString& message);
+
+    QFile m_file;
+    bool m_pcapng;
+    bool m_bigEndian;
+    bool m_nanosecond;                  ///< 经典 pcap 的纳秒时间戳
+    int m_linkType;                     ///< 经典 pcap 的链路类型
+    QVector<Interface> m_interfaces;    ///< 当前节的接口（pcapng）
+    QString m_errorString;
+    qint64 m_packetsRead;
+    qint64 m_packetsSkipped;
+};
+
+#endif // PCAPCAPTURE_H
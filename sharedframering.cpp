@@ -0,0 +1,470 @@
+#include "sharedframering.h"
+#include <QDebug>
+#include <atomic>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <signal.h>
+#include <cerrno>
+#endif
+
+namespace
+{
+    const qint64 RING_HEADER_SIZE = 4096;   ///< 环头区域大小
+    const qint64 SLOT_HEADER_SIZE = 64;     ///< 槽位头大小（一个缓存行）
+    const qint64 SLOT_ALIGN = 4096;         ///< 槽位对齐（页大小）
+    const int MIN_SLOTS = 2;
+    const int MAX_SLOTS = 256;
+
+    /**
+     * @brief 共享内存起始处的环头
+     */
+    struct RingHeader
+    {
+        quint32 magic;
+        quint32 version;
+        quint32 slotCount;
+        quint32 writerPid;                  ///< 写入方进程号（判断同名共享内存是否为遗留）
+        quint64 slotStride;                 ///< 相邻槽位起始地址之差
+        quint64 slotCapacity;               ///< 单帧最大字节数
+        std::atomic<quint64> latestFrame;   ///< 最新已发布帧号
+        std::atomic<quint32> closed;        ///< 写入方已关闭
+    };
+
+    /**
+     * @brief 槽位头，随后紧跟图像数据
+     */
+    struct SlotHeader
+    {
+        std::atomic<quint64> sequence;      ///< seqlock计数：奇数表示正在写入
+        quint64 frameNumber;
+        quint64 senderSequence;
+        qint64 timestampUs;
+        quint32 width;
+        quint32 height;
+        quint32 channels;
+        quint32 payloadSize;
+    };
+
+    static_assert(sizeof(RingHeader) <= RING_HEADER_SIZE, "RingHeader too large");
+    static_assert(sizeof(SlotHeader) <= SLOT_HEADER_SIZE, "SlotHeader too large");
+    static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared memory requires lock-free 64-bit atomics");
+
+    inline RingHeader* ringHeader(char* base) { return reinterpret_cast<RingHeader*>(base); }
+
+    inline QByteArray shmName(const QString& name)
+    {
+        return (name.startsWith('/') ? name : "/" + name).toLocal8Bit();
+    }
+}
+
+/**
+ * @brief CSharedFrameRing构造函数
+ */
+CSharedFrameRing::CSharedFrameRing()
+    : m_writer(false)
+    , m_base(nullptr)
+    , m_mappedSize(0)
+    , m_nextFrame(1)
+{
+}
+
+/**
+ * @brief CSharedFrameRing析构函数
+ */
+CSharedFrameRing::~CSharedFrameRing()
+{
+    close();
+}
+
+/**
+ * @brief 创建共享内存环（写入方）
+ * @param name 共享内存名
+ * @param slotCount 槽位数
+ * @param slotCapacity 单帧最大字节数
+ * @return 成功返回true
+ */
+bool CSharedFrameRing::create(const QString& name, int slotCount, qint64 slotCapacity)
+{
+    close();
+
+    if (slotCount < MIN_SLOTS || slotCount > MAX_SLOTS || slotCapacity <= 0) {
+        m_errorString = QString("无效的参数：槽位数%1（%2-%3），容量%4字节")
+                        .arg(slotCount).arg(MIN_SLOTS).arg(MAX_SLOTS).arg(slotCapacity);
+        return false;
+    }
+
+#ifdef Q_OS_UNIX
+    const qint64 stride = (SLOT_HEADER_SIZE + slotCapacity + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN;
+    const qint64 totalSize = RING_HEADER_SIZE + stride * slotCount;
+    const QByteArray posixName = shmName(name);
+
+    int fd = shm_open(posixName.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST) {
+        // 同名共享内存只有确认是遗留的（写入方已退出或已关闭）才删除重建，
+        // 不能从仍在运行的写入方手中抢走（它的读取方会停在被删除的旧内存上）
+        QString reason;
+        if (!isStale(posixName, &reason)) {
+            m_errorString = QString("共享内存 %1 已存在：%2").arg(QString::fromLocal8Bit(posixName), reason);
+            return false;
+        }
+        qDebug() << QString("🧹 删除遗留的共享内存帧环 %1（%2）").arg(QString::fromLocal8Bit(posixName), reason);
+        shm_unlink(posixName.constData());
+        fd = shm_open(posixName.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0) {
+        m_errorString = QString("shm_open失败：%1").arg(strerror(errno));
+        return false;
+    }
+
+    if (ftruncate(fd, off_t(totalSize)) != 0) {
+        m_errorString = QString("ftruncate失败：%1").arg(strerror(errno));
+        ::close(fd);
+        shm_unlink(posixName.constData());
+        return false;
+    }
+
+    const bool mapped = mapRegion(fd, totalSize, true);
+    ::close(fd);
+    if (!mapped) {
+        shm_unlink(posixName.constData());
+        return false;
+    }
+
+    // ftruncate 得到的内存已清零，槽位序列号初始为0（空槽）
+    RingHeader* header = ringHeader(m_base);
+    header->version = RING_VERSION;
+    header->slotCount = quint32(slotCount);
+    header->slotStride = quint64(stride);
+    header->slotCapacity = quint64(slotCapacity);
+    header->latestFrame.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+    header->writerPid = quint32(getpid());
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = RING_MAGIC;  // 最后写入标识，读取方据此判断初始化完成
+
+    m_name = name;
+    m_writer = true;
+    m_nextFrame = 1;
+    qDebug() << QString("🧩 共享内存帧环已创建：%1，%2个槽位 × %3字节（共%4 MB）")
+                .arg(QString::fromLocal8Bit(posixName)).arg(slotCount).arg(slotCapacity)
+                .arg(totalSize / (1024.0 * 1024.0), 0, 'f', 1);
+    return true;
+#else
+    Q_UNUSED(name);
+    m_errorString = "共享内存帧环仅支持Unix平台";
+    return false;
+#endif
+}
+
+/**
+ * @brief 打开已存在的共享内存环（读取方）
+ * @param name 共享内存名
+ * @return 成功返回true
+ */
+bool CSharedFrameRing::open(const QString& name)
+{
+    close();
+
+#ifdef Q_OS_UNIX
+    const QByteArray posixName = shmName(name);
+    const int fd = shm_open(posixName.constData(), O_RDONLY, 0);
+    if (fd < 0) {
+        m_errorString = QString("shm_open失败：%1").arg(strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < RING_HEADER_SIZE) {
+        m_errorString = "共享内存大小无效";
+        ::close(fd);
+        return false;
+    }
+
+    const bool mapped = mapRegion(fd, qint64(st.st_size), false);
+    ::close(fd);
+    if (!mapped) {
+        return false;
+    }
+
+    const RingHeader* header = ringHeader(m_base);
+    const bool valid = header->magic == RING_MAGIC && header->version == RING_VERSION
+                    && header->slotCount >= quint32(MIN_SLOTS) && header->slotCount <= quint32(MAX_SLOTS)
+                    && qint64(RING_HEADER_SIZE + header->slotStride * header->slotCount) <= m_mappedSize;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid) {
+        m_errorString = "共享内存不是帧环或版本不匹配";
+        close();
+        return false;
+    }
+
+    m_name = name;
+    m_writer = false;
+    return true;
+#else
+    Q_UNUSED(name);
+    m_errorString = "共享内存帧环仅支持Unix平台";
+    return false;
+#endif
+}
+
+/**
+ * @brief 判断已存在的同名共享内存是否为遗留
+ * @param posixName 共享内存名（以'/'开头）
+ * @param reason 输出：判断依据
+ * @return 写入方已关闭、已退出或内存不可用时返回true
+ */
+bool CSharedFrameRing::isStale(const QByteArray& posixName, QString* reason)
+{
+#ifdef Q_OS_UNIX
+    const int fd = shm_open(posixName.constData(), O_RDONLY, 0);
+    if (fd < 0) {
+        // 期间已被删除：按遗留处理，重新创建时 O_EXCL 仍会检查
+        const int error = errno;
+        *reason = QString("无法打开：%1").arg(strerror(error));
+        return error == ENOENT;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < RING_HEADER_SIZE) {
+        ::close(fd);
+        *reason = "大小不足一个环头，读取方无法使用";
+        return true;
+    }
+
+    void* address = mmap(nullptr, size_t(RING_HEADER_SIZE), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        *reason = QString("无法映射：%1").arg(strerror(errno));
+        return false;
+    }
+
+    const RingHeader* header = static_cast<const RingHeader*>(address);
+    const bool isRing = header->magic == RING_MAGIC;
+    const bool closed = header->closed.load(std::memory_order_acquire) != 0;
+    const pid_t pid = pid_t(header->writerPid);
+    munmap(address, size_t(RING_HEADER_SIZE));
+
+    // kill(pid, 0) 不发信号，只检查进程是否存在（EPERM 表示存在但属于其他用户）
+    const bool writerAlive = pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+
+    if (isRing && closed) {
+        *reason = "写入方已关闭";
+        return true;
+    }
+    if (pid > 0 && !writerAlive) {
+        *reason = QString("写入方进程 %1 已退出").arg(pid);
+        return true;
+    }
+    if (writerAlive) {
+        *reason = QString("正在被进程 %1 写入，请使用其他名称").arg(pid);
+        return false;
+    }
+    if (isRing) {
+        *reason = "旧版本帧环，没有写入方进程号";
+        return true;
+    }
+    *reason = "不是帧环，请使用其他名称";
+    return false;
+#else
+    Q_UNUSED(posixName);
+    *reason = "共享内存帧环仅支持Unix平台";
+    return false;
+#endif
+}
+
+/**
+ * @brief 解除映射；写入方同时标记环已关闭并删除共享内存名
+ */
+void CSharedFrameRing::close()
+{
+    if (!m_base) {
+        return;
+    }
+
+#ifdef Q_OS_UNIX
+    if (m_writer) {
+        ringHeader(m_base)->closed.store(1, std::memory_order_release);
+        shm_unlink(shmName(m_name).constData());
+        qDebug() << "🧩 共享内存帧环已关闭：" << m_name;
+    }
+    munmap(m_base, size_t(m_mappedSize));
+#endif
+
+    m_base = nullptr;
+    m_mappedSize = 0;
+    m_writer = false;
+}
+
+/**
+ * @brief 槽位数
+ */
+int CSharedFrameRing::slotCount() const
+{
+    return m_base ? int(ringHeader(m_base)->slotCount) : 0;
+}
+
+/**
+ * @brief 单帧最大字节数
+ */
+qint64 CSharedFrameRing::slotCapacity() const
+{
+    return m_base ? qint64(ringHeader(m_base)->slotCapacity) : 0;
+}
+
+/**
+ * @brief 发布一帧
+ * @param data 图像数据
+ * @param size 字节数
+ * @param meta 元数据
+ * @return 成功返回true
+ */
+bool CSharedFrameRing::publish(const char* data, qint64 size, const FrameMeta& meta)
+{
+    if (!m_base || !m_writer || size < 0 || size > slotCapacity()) {
+        return false;
+    }
+
+    RingHeader* header = ringHeader(m_base);
+    const quint64 frameNumber = m_nextFrame++;
+    const int slot = slotForFrame(frameNumber);
+    SlotHeader* slotHeader = reinterpret_cast<SlotHeader*>(slotBase(slot));
+
+    // seqlock：置为奇数 → 写数据 → 置为偶数
+    const quint64 sequence = slotHeader->sequence.load(std::memory_order_relaxed);
+    slotHeader->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slotHeader->frameNumber = frameNumber;
+    slotHeader->senderSequence = meta.senderSequence;
+    slotHeader->timestampUs = meta.timestampUs;
+    slotHeader->width = meta.width;
+    slotHeader->height = meta.height;
+    slotHeader->channels = meta.channels;
+    slotHeader->payloadSize = quint32(size);
+    memcpy(slotBase(slot) + SLOT_HEADER_SIZE, data, size_t(size));
+
+    slotHeader->sequence.store(sequence + 2, std::memory_order_release);
+    header->latestFrame.store(frameNumber, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief 已发布的最新帧号
+ */
+quint64 CSharedFrameRing::latestFrameNumber() const
+{
+    return m_base ? ringHeader(m_base)->latestFrame.load(std::memory_order_acquire) : 0;
+}
+
+/**
+ * @brief 写入方是否已关闭此环
+ */
+bool CSharedFrameRing::isClosedByWriter() const
+{
+    return m_base && ringHeader(m_base)->closed.load(std::memory_order_acquire) != 0;
+}
+
+/**
+ * @brief 帧号对应的槽位
+ */
+int CSharedFrameRing::slotForFrame(quint64 frameNumber) const
+{
+    const int count = slotCount();
+    return (count > 0 && frameNumber > 0) ? int((frameNumber - 1) % quint64(count)) : 0;
+}
+
+/**
+ * @brief 开始零拷贝读取一个槽位
+ */
+bool CSharedFrameRing::beginRead(int slot, quint64& sequence, FrameMeta& meta, const char*& payload) const
+{
+    if (!m_base || slot < 0 || slot >= slotCount()) {
+        return false;
+    }
+
+    const SlotHeader* slotHeader = reinterpret_cast<const SlotHeader*>(slotBase(slot));
+    sequence = slotHeader->sequence.load(std::memory_order_acquire);
+    if (sequence == 0 || (sequence & 1)) {
+        return false;
+    }
+
+    meta.frameNumber = slotHeader->frameNumber;
+    meta.senderSequence = slotHeader->senderSequence;
+    meta.timestampUs = slotHeader->timestampUs;
+    meta.width = slotHeader->width;
+    meta.height = slotHeader->height;
+    meta.channels = slotHeader->channels;
+    meta.payloadSize = qMin<quint32>(slotHeader->payloadSize, quint32(slotCapacity()));
+    payload = slotBase(slot) + SLOT_HEADER_SIZE;
+    return true;
+}
+
+/**
+ * @brief 结束读取并校验槽位未被覆盖
+ */
+bool CSharedFrameRing::endRead(int slot, quint64 sequence) const
+{
+    if (!m_base || slot < 0 || slot >= slotCount()) {
+        return false;
+    }
+
+    const SlotHeader* slotHeader = reinterpret_cast<const SlotHeader*>(slotBase(slot));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slotHeader->sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+/**
+ * @brief 拷贝读取指定帧
+ */
+bool CSharedFrameRing::readFrame(quint64 frameNumber, FrameMeta& meta, QByteArray& out) const
+{
+    const int slot = slotForFrame(frameNumber);
+    quint64 sequence = 0;
+    const char* payload = nullptr;
+    if (!beginRead(slot, sequence, meta, payload) || meta.frameNumber != frameNumber) {
+        return false;
+    }
+
+    out.resize(int(meta.payloadSize));
+    memcpy(out.data(), payload, meta.payloadSize);
+    return endRead(slot, sequence);
+}
+
+/**
+ * @brief 映射共享内存
+ * @param fd 文件描述符
+ * @param size 映射大小
+ * @param writable 是否可写
+ */
+bool CSharedFrameRing::mapRegion(int fd, qint64 size, bool writable)
+{
+#ifdef Q_OS_UNIX
+    void* addr = mmap(nullptr, size_t(size), writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                      MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        m_errorString = QString("mmap失败：%1").arg(strerror(errno));
+        return false;
+    }
+    m_base = static_cast<char*>(addr);
+    m_mappedSize = size;
+    return true;
+#else
+    Q_UNUSED(fd);
+    Q_UNUSED(size);
+    Q_UNUSED(writable);
+    return false;
+#endif
+}
+
+/**
+ * @brief 槽位起始地址
+ */
+char* CSharedFrameRing::slotBase(int slot) const
+{
+    return m_base + RING_HEADER_SIZE + qint64(ringHeader(m_base)->slotStride) * slot;
+}
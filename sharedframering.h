@@ -0,0 +1,150 @@
+#ifndef SHAREDFRAMERING_H
+#define SHAREDFRAMERING_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QByteArray>
+
+/**
+ * @class CSharedFrameRing
+ * @brief POSIX共享内存帧环形缓冲（单写多读）
+ *
+ * 接收端把每个完整帧写入命名共享内存中的环形槽位，本机其他进程（检测算法等）
+ * 映射同一块内存即可直接读取图像，无需另建TCP连接，也不经过额外拷贝。
+ *
+ * 每个槽位带一个序列计数器（seqlock）：写入前置为奇数，写完置为偶数。
+ * 读取方在读前、读后各取一次计数，两次相同且为偶数说明期间未被覆盖；
+ * 写入方从不等待读取方，读取方处理太慢时只会丢帧，不会拖慢接收。
+ *
+ * 共享内存布局：
+ *   [RingHeader 4KB][Slot 0: SlotHeader 64B + 数据][Slot 1]...
+ * 每个槽位按4KB对齐。帧号从1开始全局递增，槽位 = (帧号 - 1) % 槽位数。
+ *
+ * 仅支持 Q_OS_UNIX（shm_open/mmap），其他平台 create/open 返回false。
+ */
+class CSharedFrameRing
+{
+public:
+    /**
+     * @struct FrameMeta
+     * @brief 帧元数据
+     */
+    struct FrameMeta
+    {
+        quint64 frameNumber = 0;    ///< 环内帧号（从1开始，由写入方分配）
+        quint64 senderSequence = 0; ///< 发送端帧序号（扩展帧头，无则为0）
+        qint64 timestampUs = 0;     ///< 组帧完成的墙上时间（Unix纪元微秒）
+        quint32 width = 0;
+        quint32 height = 0;
+        quint32 channels = 0;
+        quint32 payloadSize = 0;    ///< 图像数据字节数
+    };
+
+    static const int DEFAULT_SLOTS = 8;         ///< 默认槽位数
+    static const quint32 RING_MAGIC = 0x47524654;  ///< "TFRG"
+    static const quint32 RING_VERSION = 1;
+
+    CSharedFrameRing();
+    ~CSharedFrameRing();
+
+    /**
+     * @brief 创建共享内存环（写入方）
+     * @param name 共享内存名（不以'/'开头时自动补上）
+     * @param slotCount 槽位数（2-256）
+     * @param slotCapacity 单帧最大字节数
+     * @return 成功返回true
+     *
+     * 同名共享内存已存在时，只有写入方已关闭或进程已退出（上次异常退出遗留）才删除重建；
+     * 仍有进程在写入时返回false，不抢占其他接收端的帧环
+     */
+    bool create(const QString& name, int slotCount, qint64 slotCapacity);
+
+    /**
+     * @brief 打开已存在的共享内存环（读取方，只读映射）
+     */
+    bool open(const QString& name);
+
+    /**
+     * @brief 解除映射；写入方同时标记环已关闭并删除共享内存名
+     */
+    void close();
+
+    bool isOpen() const { return m_base != nullptr; }
+    bool isWriter() const { return m_writer; }
+    QString name() const { return m_name; }
+    QString errorString() const { return m_errorString; }
+    int slotCount() const;
+    qint64 slotCapacity() const;
+
+    /**
+     * @brief 发布一帧（写入方）
+     * @param data 图像数据
+     * @param size 字节数，不能超过槽位容量
+     * @param meta 元数据（frameNumber 和 payloadSize 由本函数填写）
+     * @return 成功返回true
+     */
+    bool publish(const char* data, qint64 size, const FrameMeta& meta);
+
+    /**
+     * @brief 已发布的最新帧号（0表示尚无帧）
+     */
+    quint64 latestFrameNumber() const;
+
+    /**
+     * @brief 写入方是否已关闭此环（读取方应关闭后重新打开）
+     */
+    bool isClosedByWriter() const;
+
+    /**
+     * @brief 帧号对应的槽位
+     */
+    int slotForFrame(quint64 frameNumber) const;
+
+    /**
+     * @brief 开始零拷贝读取一个槽位
+     * @param slot 槽位
+     * @param sequence 输出：读取开始时的槽位序列号，交给 endRead 校验
+     * @param meta 输出：帧元数据
+     * @param payload 输出：指向共享内存中图像数据的指针
+     * @return 槽位正在写入或为空时返回false
+     *
+     * 在 endRead 返回true之前，payload 中的数据都可能被写入方覆盖
+     */
+    bool beginRead(int slot, quint64& sequence, FrameMeta& meta, const char*& payload) const;
+
+    /**
+     * @brief 结束读取并校验
+     * @return 读取期间槽位未被覆盖返回true，否则本次读取的数据无效
+     */
+    bool endRead(int slot, quint64 sequence) const;
+
+    /**
+     * @brief 拷贝读取指定帧（便捷接口）
+     * @param frameNumber 帧号
+     * @param meta 输出元数据
+     * @param out 输出图像数据
+     * @return 该帧仍在环中且读取完整返回true
+     */
+    bool readFrame(quint64 frameNumber, FrameMeta& meta, QByteArray& out) const;
+
+private:
+    CSharedFrameRing(const CSharedFrameRing&);
+    CSharedFrameRing& operator=(const CSharedFrameRing&);
+
+    bool mapRegion(int fd, qint64 size, bool writable);
+
+    /**
+     * @brief 判断已存在的同名共享内存是否为遗留（可以删除重建）
+     */
+    static bool isStale(const QByteArray& posixName, QString* reason);
+    char* slotBase(int slot) const;
+
+    QString m_name;
+    QString m_errorString;
+    bool m_writer;
+    char* m_base;           ///< 映射起始地址
+    qint64 m_mappedSize;    ///< 映射大小
+    quint64 m_nextFrame;    ///< 写入方下一个帧号
+};
+
+#endif // SHAREDFRAMERING_H
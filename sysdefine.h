@@ -44,7 +44,7 @@
  * 系统最大支持：8bit 8通道
  * - 位深度：8位 (0-255)
  * - 最大通道数：8通道
- * - 内存限制：单图像最大50MB
+ * - 内存限制：单图像最大2047MB（FrameProtocol::MAX_PAYLOAD_SIZE，受QByteArray容量限制）
  * 
  * 多通道图像显示：
  * - 1通道：直接显示灰度
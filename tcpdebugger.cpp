@@ -1,6 +1,8 @@
 #include "tcpdebugger.h"
 #include <QDebug>
 #include <QApplication>
+#include <QMetaMethod>
+#include <algorithm>
 
 /**
  * @brief 构造函数
@@ -12,6 +14,9 @@ CTCPDebugger::CTCPDebugger(QObject *parent)
     , m_connectionState(STATE_DISCONNECTED)
     , m_clientSocket(nullptr)
     , m_server(nullptr)
+    , m_watchedClient(0)
+    , m_verifyTraffic(false)
+    , m_echoMode(false)
     , m_dataFormatter(nullptr)
     , m_displayFormat(CDataFormatter::FORMAT_RAW_TEXT)
     , m_showTimestamp(true)
@@ -21,7 +26,15 @@ CTCPDebugger::CTCPDebugger(QObject *parent)
     , m_totalPacketsReceived(0)
     , m_totalPacketsSent(0)
     , m_statsTimer(nullptr)
+    , m_probeTimer(nullptr)
+    , m_capture(nullptr)
 {
+    CMetricsRegistry& registry = CMetricsRegistry::instance();
+    m_metricBytesReceived = registry.counter("tcpimg_debugger_bytes_received_total", "网络调试器接收字节数");
+    m_metricBytesSent = registry.counter("tcpimg_debugger_bytes_sent_total", "网络调试器发送字节数");
+    m_metricPacketsReceived = registry.counter("tcpimg_debugger_packets_received_total", "网络调试器接收包数");
+    m_metricPacketsSent = registry.counter("tcpimg_debugger_packets_sent_total", "网络调试器发送包数");
+
     initializeComponents();
     qDebug() << "TCP网络调试器初始化完成";
 }
@@ -34,6 +47,10 @@ CTCPDebugger::~CTCPDebugger()
     stop();
     cleanupConnections();
     
+    // 服务器工作线程会写入 m_linkStats：在成员析构前删除服务器（含等待 deleteLater 的），等线程退出
+    qDeleteAll(findChildren<CDebugServer*>(QString(), Qt::FindDirectChildrenOnly));
+    m_capture->close();
+    
     if (m_dataFormatter) {
         delete m_dataFormatter;
         m_dataFormatter = nullptr;
@@ -58,11 +75,23 @@ void CTCPDebugger::initializeComponents()
     // 创建数据格式化器
     m_dataFormatter = new CDataFormatter();
     
+    qRegisterMetaType<CLinkStats::Snapshot>();
+    qRegisterMetaType<CLatencyProbe::Stats>();
+    
     // 创建统计定时器
     m_statsTimer = new QTimer(this);
     m_statsTimer->setInterval(1000);  // 每秒更新一次统计
     connect(m_statsTimer, &QTimer::timeout, this, &CTCPDebugger::updateStats);
     
+    // 延迟探测定时器（毫秒级间隔，用精确定时器）
+    m_probeTimer = new QTimer(this);
+    m_probeTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_probeTimer, &QTimer::timeout, this, &CTCPDebugger::onProbeTimer);
+    
+    // 抓包文件（缓冲后在后台线程写入）
+    m_capture = new CPcapWriter(this);
+    connect(m_capture, &CPcapWriter::failed, this, &CTCPDebugger::captureFailed);
+    
     qDebug() << "TCP调试器组件初始化完成，已禁用网络代理";
 }
 
@@ -147,11 +176,17 @@ void CTCPDebugger::startServer(quint16 port, const QHostAddress& bindAddress)
         stop();
     }
     
-    // 创建服务器
-    m_server = new QTcpServer(this);
+    // 创建服务器（客户端分配到工作线程收发，界面线程只接收统计和被查看客户端的数据）
+    m_server = new CDebugServer(0, &m_linkStats, m_capture, this);
+    m_serverBaseline = CDebugServer::ClientStats();
+    m_watchedClient = 0;
+    m_server->setVerifyTraffic(m_verifyTraffic);
+    m_server->setEcho(m_echoMode);
     
-    // 连接新连接信号
-    connect(m_server, &QTcpServer::newConnection, this, &CTCPDebugger::onNewConnection);
+    connect(m_server, &CDebugServer::clientConnected, this, &CTCPDebugger::onServerClientConnected);
+    connect(m_server, &CDebugServer::clientDisconnected, this, &CTCPDebugger::onServerClientDisconnected);
+    connect(m_server, &CDebugServer::clientData, this, &CTCPDebugger::onServerClientData);
+    connect(m_server, &CDebugServer::statsUpdated, this, &CTCPDebugger::clientStatsUpdated);
     
     // 开始监听
     if (m_server->listen(bindAddress, port)) {
@@ -159,6 +194,7 @@ void CTCPDebugger::startServer(quint16 port, const QHostAddress& bindAddress)
         setConnectionState(STATE_LISTENING, QString("服务器监听在 %1:%2").arg(bindAddress.toString()).arg(port));
         
         qDebug() << "服务器开始监听" << bindAddress.toString() << ":" << port;
+        m_linkStats.reset();
         m_statsTimer->start();
     } else {
         setConnectionState(STATE_ERROR, QString("服务器启动失败：%1").arg(m_server->errorString()));
@@ -174,6 +210,8 @@ void CTCPDebugger::stop()
     if (m_statsTimer && m_statsTimer->isActive()) {
         m_statsTimer->stop();
     }
+    finishLatencyProbe("连接已停止");
+    m_capture->closeFlow(m_captureFlow);
     
     if (m_workMode == MODE_CLIENT && m_clientSocket) {
         m_clientSocket->disconnectFromHost();
@@ -183,13 +221,7 @@ void CTCPDebugger::stop()
     }
     
     if (m_workMode == MODE_SERVER && m_server) {
-        // 断开所有客户端连接
-        for (QTcpSocket* socket : m_clientSockets) {
-            socket->disconnectFromHost();
-            socket->deleteLater();
-        }
-        m_clientSockets.clear();
-        
+        // 停止监听；客户端套接字随工作线程一起释放
         m_server->close();
     }
     
@@ -208,28 +240,12 @@ qint64 CTCPDebugger::sendData(const QByteArray& data)
 {
     qint64 totalSent = 0;
     
-    if (m_workMode == MODE_CLIENT && m_clientSocket && m_clientSocket->state() == QAbstractSocket::ConnectedState) {
-        qint64 sent = m_clientSocket->write(data);
-        m_clientSocket->flush();
-        if (sent > 0) {
-            totalSent = sent;
-            m_totalBytesSent += sent;
-            m_totalPacketsSent++;
-        }
-    } else if (m_workMode == MODE_SERVER) {
-        // 服务器模式：向所有连接的客户端发送数据
-        for (QTcpSocket* socket : m_clientSockets) {
-            if (socket->state() == QAbstractSocket::ConnectedState) {
-                qint64 sent = socket->write(data);
-                socket->flush();
-                if (sent > 0) {
-                    totalSent += sent;
-                    m_totalBytesSent += sent;
-                }
-            }
-        }
-        if (totalSent > 0) {
-            m_totalPacketsSent++;
+    if (m_workMode == MODE_CLIENT && m_clientSocket) {
+        totalSent = writeToServer(data);
+    } else if (m_workMode == MODE_SERVER && m_server) {
+        // 服务器模式：所有客户端共享同一份数据，由工作线程写出并计数
+        if (m_server->broadcast(data) > 0) {
+            totalSent = data.size();
         }
     }
     
@@ -275,7 +291,10 @@ QString CTCPDebugger::getConnectionStats() const
         stats += QString("目标地址：%1:%2\n").arg(m_currentHost).arg(m_currentPort);
     } else {
         stats += QString("监听端口：%1\n").arg(m_currentPort);
-        stats += QString("已连接客户端：%1\n").arg(m_clientSockets.size());
+        stats += QString("已连接客户端：%1\n").arg(m_server ? m_server->clientCount() : 0);
+        if (m_server) {
+            return stats + serverStats() + CLinkStats::formatSnapshot(m_linkStats.lastSnapshot());
+        }
     }
     
     stats += QString("总接收字节：%1\n").arg(m_totalBytesReceived);
@@ -290,11 +309,20 @@ QString CTCPDebugger::getConnectionStats() const
         if (duration > 0) {
             double rxRate = m_totalBytesReceived / static_cast<double>(duration);
             double txRate = m_totalBytesSent / static_cast<double>(duration);
-            stats += QString("平均接收速率：%.2f 字节/秒\n").arg(rxRate);
-            stats += QString("平均发送速率：%.2f 字节/秒\n").arg(txRate);
+            stats += QString("平均接收速率：%1 字节/秒\n").arg(rxRate, 0, 'f', 2);
+            stats += QString("平均发送速率：%1 字节/秒\n").arg(txRate, 0, 'f', 2);
         }
     }
     
+    stats += CLinkStats::formatSnapshot(m_linkStats.lastSnapshot());
+    
+    const CLatencyProbe::Stats probeStats = m_latencyProbe.stats();
+    if (probeStats.sent > 0) {
+        stats += CLatencyProbe::formatStats(probeStats);
+    }
+    if (m_capture->isOpen()) {
+        stats += QString("抓包：%1\n").arg(CPcapWriter::formatStats(m_capture->stats()));
+    }
     return stats;
 }
 
@@ -421,6 +449,207 @@ bool CTCPDebugger::getShowTimestamp() const
     return m_showTimestamp;
 }
 
+/**
+ * @brief 服务器模式下各客户端的统计
+ * @return 客户端统计列表
+ */
+QList<CDebugServer::ClientStats> CTCPDebugger::getClientStats() const
+{
+    return m_server ? m_server->clients() : QList<CDebugServer::ClientStats>();
+}
+
+/**
+ * @brief 服务器模式下是否显示所有客户端的数据
+ * @param watchAll 是否显示全部
+ */
+void CTCPDebugger::setWatchAllClients(bool watchAll)
+{
+    if (m_server) {
+        m_server->setWatchAll(watchAll);
+    }
+}
+
+/**
+ * @brief 服务器模式下显示指定客户端的数据
+ * @param clientId 客户端编号，0表示不显示任何客户端
+ */
+void CTCPDebugger::setWatchedClient(quint64 clientId)
+{
+    if (!m_server || clientId == m_watchedClient) {
+        return;
+    }
+    if (m_watchedClient != 0) {
+        m_server->setWatched(m_watchedClient, false);
+    }
+    m_watchedClient = clientId;
+    if (clientId != 0) {
+        m_server->setWatched(clientId, true);
+    }
+}
+
+/**
+ * @brief 服务器模式下向指定客户端发送数据
+ * @param clientId 客户端编号
+ * @param data 数据
+ * @return 成功排队的字节数，-1表示失败
+ */
+qint64 CTCPDebugger::sendToClient(quint64 clientId, const QByteArray& data)
+{
+    if (!m_server || !m_server->sendTo(clientId, data)) {
+        return -1;
+    }
+    return data.size();
+}
+
+/**
+ * @brief 服务器模式下断开指定客户端
+ * @param clientId 客户端编号
+ */
+void CTCPDebugger::disconnectClient(quint64 clientId)
+{
+    if (m_server) {
+        m_server->disconnectClient(clientId);
+    }
+}
+
+/**
+ * @brief 服务器模式下是否校验流量发生器数据
+ * @param verify 是否校验
+ */
+void CTCPDebugger::setVerifyTraffic(bool verify)
+{
+    m_verifyTraffic = verify;
+    if (m_server) {
+        m_server->setVerifyTraffic(verify);
+    }
+}
+
+/**
+ * @brief 回显模式
+ * @param echo 是否回显
+ */
+void CTCPDebugger::setEchoMode(bool echo)
+{
+    m_echoMode = echo;
+    if (m_server) {
+        m_server->setEcho(echo);
+    }
+    qDebug() << "回显模式：" << (echo ? "开启" : "关闭");
+}
+
+/**
+ * @brief 开始延迟探测
+ * @param config 探测配置
+ * @param errorString 失败原因
+ * @return 成功开始返回true
+ */
+bool CTCPDebugger::startLatencyProbe(const CLatencyProbe::Config& config, QString* errorString)
+{
+    if (m_workMode != MODE_CLIENT || m_connectionState != STATE_CONNECTED) {
+        if (errorString) {
+            *errorString = "延迟探测需要先以客户端模式连接到对端";
+        }
+        return false;
+    }
+    
+    finishLatencyProbe("重新开始");
+    if (!m_latencyProbe.start(config, errorString)) {
+        return false;
+    }
+    
+    m_probeTimer->start(config.intervalMs);
+    qDebug() << QString("⏱️ 延迟探测开始：%1，间隔 %2 ms，超时 %3 ms")
+                .arg(config.mode == CLatencyProbe::MODE_TIMESTAMP ? "时间戳探测" : "自定义请求")
+                .arg(config.intervalMs).arg(config.timeoutMs);
+    onProbeTimer();  // 第一个请求立即发出
+    return true;
+}
+
+/**
+ * @brief 停止延迟探测
+ */
+void CTCPDebugger::stopLatencyProbe()
+{
+    finishLatencyProbe("手动停止");
+}
+
+/**
+ * @brief 开始抓包
+ * @param fileName 文件路径
+ * @param errorString 失败原因
+ * @return 成功开始返回true
+ */
+bool CTCPDebugger::startCapture(const QString& fileName, QString* errorString)
+{
+    if (!m_capture->open(fileName, errorString)) {
+        return false;
+    }
+    
+    // 客户端已连接时从当前位置开始记录（合成握手，序号从头开始）
+    if (m_workMode == MODE_CLIENT && m_connectionState == STATE_CONNECTED && m_clientSocket) {
+        m_captureFlow = CPcapWriter::Flow::fromSocket(m_clientSocket);
+        m_capture->openFlow(m_captureFlow, true);
+    }
+    return true;
+}
+
+/**
+ * @brief 停止抓包
+ */
+void CTCPDebugger::stopCapture()
+{
+    m_capture->close();
+}
+
+/**
+ * @brief 服务器模式的统计信息：累计收发和速率最高的客户端
+ * @return 统计信息字符串
+ */
+QString CTCPDebugger::serverStats() const
+{
+    const CDebugServer::ClientStats total = m_server->totals();
+    QString stats;
+    stats += QString("总接收字节：%1\n").arg(total.bytesReceived - m_serverBaseline.bytesReceived);
+    stats += QString("总发送字节：%1\n").arg(total.bytesSent - m_serverBaseline.bytesSent);
+    stats += QString("总接收包数：%1\n").arg(total.packetsReceived - m_serverBaseline.packetsReceived);
+    stats += QString("总发送包数：%1\n").arg(total.packetsSent - m_serverBaseline.packetsSent);
+    stats += QString("接收速率：%1 KB/s，发送速率：%2 KB/s\n")
+             .arg(total.rxBytesPerSec / 1024.0, 0, 'f', 1)
+             .arg(total.txBytesPerSec / 1024.0, 0, 'f', 1);
+    if (total.messagesDropped > m_serverBaseline.messagesDropped) {
+        stats += QString("发送队列满丢弃：%1\n").arg(total.messagesDropped - m_serverBaseline.messagesDropped);
+    }
+    if (m_verifyTraffic) {
+        CTrafficVerifier::Result integrity = total.integrity;
+        integrity -= m_serverBaseline.integrity;
+        stats += QString("数据校验：%1 包%2\n").arg(integrity.packets)
+                 .arg(integrity.isClean() ? QString("，无错误")
+                      : QString("，丢失 %1，乱序 %2，校验错 %3，帧错 %4")
+                        .arg(integrity.lostPackets).arg(integrity.reorderedPackets)
+                        .arg(integrity.checksumErrors).arg(integrity.framingErrors));
+    }
+    
+    // 接收速率最高的几个客户端
+    QList<CDebugServer::ClientStats> clients = m_server->clients();
+    const int shown = qMin(SERVER_STATS_TOP_CLIENTS, clients.size());
+    std::partial_sort(clients.begin(), clients.begin() + shown, clients.end(),
+                      [](const CDebugServer::ClientStats& a, const CDebugServer::ClientStats& b) {
+                          return a.rxBytesPerSec > b.rxBytesPerSec;
+                      });
+    for (int i = 0; i < shown; ++i) {
+        const CDebugServer::ClientStats& client = clients[i];
+        stats += QString("  #%1 %2  接收 %3 KB/s  发送 %4 KB/s  共 %5/%6 字节\n")
+                 .arg(client.id)
+                 .arg(client.address)
+                 .arg(client.rxBytesPerSec / 1024.0, 0, 'f', 1)
+                 .arg(client.txBytesPerSec / 1024.0, 0, 'f', 1)
+                 .arg(client.bytesReceived)
+                 .arg(client.bytesSent);
+    }
+    
+    return stats;
+}
+
 /**
  * @brief 清空统计信息
  */
@@ -431,6 +660,10 @@ void CTCPDebugger::clearStats()
     m_totalPacketsReceived = 0;
     m_totalPacketsSent = 0;
     m_connectionStartTime = QDateTime::currentDateTime();
+    if (m_server) {
+        m_serverBaseline = m_server->totals();
+    }
+    m_linkStats.reset();
     
     qDebug() << "统计信息已清空";
 }
@@ -442,8 +675,14 @@ void CTCPDebugger::onClientConnected()
 {
     setConnectionState(STATE_CONNECTED, QString("已连接到 %1:%2").arg(m_currentHost).arg(m_currentPort));
     m_connectionStartTime = QDateTime::currentDateTime();
+    m_linkStats.reset();
     m_statsTimer->start();
     
+    m_captureFlow = CPcapWriter::Flow::fromSocket(m_clientSocket);
+    if (m_capture->isOpen()) {
+        m_capture->openFlow(m_captureFlow, true);
+    }
+    
     qDebug() << "客户端连接成功";
 }
 
@@ -452,6 +691,8 @@ void CTCPDebugger::onClientConnected()
  */
 void CTCPDebugger::onClientDisconnected()
 {
+    finishLatencyProbe("连接已断开");
+    m_capture->closeFlow(m_captureFlow);
     setConnectionState(STATE_DISCONNECTED, "连接已断开");
     
     if (m_statsTimer && m_statsTimer->isActive()) {
@@ -557,46 +798,54 @@ void CTCPDebugger::onSocketError(QAbstractSocket::SocketError error)
 }
 
 /**
- * @brief 新连接到达槽函数（服务器模式）
+ * @brief 新客户端连接槽函数（服务器模式）
+ * @param clientId 客户端编号
+ * @param clientAddress 客户端地址
  */
-void CTCPDebugger::onNewConnection()
+void CTCPDebugger::onServerClientConnected(quint64 clientId, const QString& clientAddress)
 {
-    if (!m_server) {
-        return;
+    Q_UNUSED(clientId)
+    
+    if (m_connectionStartTime.isNull()) {
+        m_connectionStartTime = QDateTime::currentDateTime();
     }
     
-    while (m_server->hasPendingConnections()) {
-        QTcpSocket* clientSocket = m_server->nextPendingConnection();
-        
-        // 禁用代理，避免代理设置导致的连接问题
-        clientSocket->setProxy(QNetworkProxy::NoProxy);
-        
-        m_clientSockets.append(clientSocket);
-        
-        // 连接客户端信号槽
-        connect(clientSocket, &QTcpSocket::disconnected, this, [this, clientSocket]() {
-            QString clientAddr = getRemoteAddressInfo(clientSocket);
-            m_clientSockets.removeAll(clientSocket);
-            clientSocket->deleteLater();
-            
-            emit clientDisconnected(clientAddr);
-            qDebug() << "客户端断开连接：" << clientAddr;
-        });
-        
-        connect(clientSocket, &QTcpSocket::readyRead, this, &CTCPDebugger::onDataReceived);
-        // Qt 5.12兼容性：使用SIGNAL/SLOT宏
-        connect(clientSocket, SIGNAL(error(QAbstractSocket::SocketError)),
-                this, SLOT(onSocketError(QAbstractSocket::SocketError)));
-        
-        QString clientAddr = getRemoteAddressInfo(clientSocket);
-        emit newClientConnected(clientAddr);
-        
-        qDebug() << "新客户端连接：" << clientAddr;
-        
-        if (m_connectionStartTime.isNull()) {
-            m_connectionStartTime = QDateTime::currentDateTime();
-        }
+    // 数千个客户端同时连接时逐个打印日志本身就会拖慢界面，只在少量客户端时打印
+    if (m_server->clientCount() <= 16) {
+        qDebug() << "新客户端连接：" << clientAddress;
+    }
+    emit newClientConnected(clientAddress);
+}
+
+/**
+ * @brief 客户端断开连接槽函数（服务器模式）
+ * @param clientId 客户端编号
+ * @param clientAddress 客户端地址
+ */
+void CTCPDebugger::onServerClientDisconnected(quint64 clientId, const QString& clientAddress)
+{
+    if (clientId == m_watchedClient) {
+        m_watchedClient = 0;
     }
+    
+    if (m_server->clientCount() < 16) {
+        qDebug() << "客户端断开连接：" << clientAddress;
+    }
+    emit clientDisconnected(clientAddress);
+}
+
+/**
+ * @brief 客户端数据槽函数（服务器模式）
+ * @param clientId 客户端编号
+ * @param clientAddress 客户端地址
+ * @param data 原始数据
+ */
+void CTCPDebugger::onServerClientData(quint64 clientId, const QString& clientAddress, const QByteArray& data)
+{
+    Q_UNUSED(clientId)
+    
+    // 字节数和包数已由工作线程统计
+    publishReceivedData(data, clientAddress);
 }
 
 /**
@@ -604,8 +853,52 @@ void CTCPDebugger::onNewConnection()
  */
 void CTCPDebugger::updateStats()
 {
-    // 这里可以添加定期统计更新逻辑
-    // 当前版本主要用于保持统计时间的准确性
+    // 计数在收发路径上原子累加，这里每秒取样一次计算滑动窗口
+    emit linkStatsUpdated(m_linkStats.sample());
+    
+    if (m_latencyProbe.isRunning()) {
+        emit latencyProbeUpdated(m_latencyProbe.stats());
+    }
+}
+
+/**
+ * @brief 延迟探测定时器槽函数
+ */
+void CTCPDebugger::onProbeTimer()
+{
+    m_latencyProbe.expire();
+    if (m_latencyProbe.isComplete()) {
+        finishLatencyProbe("请求已全部完成");
+        return;
+    }
+    
+    // 未应答的请求已满时跳过本次，不补发
+    const QByteArray request = m_latencyProbe.nextRequest();
+    if (!request.isEmpty() && writeToServer(request) <= 0) {
+        finishLatencyProbe("发送失败");
+    }
+}
+
+/**
+ * @brief 结束延迟探测
+ * @param reason 结束原因
+ */
+void CTCPDebugger::finishLatencyProbe(const QString& reason)
+{
+    if (!m_latencyProbe.isRunning()) {
+        return;
+    }
+    
+    if (m_probeTimer) {
+        m_probeTimer->stop();
+    }
+    m_latencyProbe.stop();
+    
+    const CLatencyProbe::Stats stats = m_latencyProbe.stats();
+    qDebug() << QString("⏱️ 延迟探测结束（%1）：已发 %2，应答 %3，超时 %4，p50 %5 µs，p99 %6 µs")
+                .arg(reason).arg(stats.sent).arg(stats.replied).arg(stats.timeouts)
+                .arg(stats.p50Us).arg(stats.p99Us);
+    emit latencyProbeFinished(stats);
 }
 
 /**
@@ -619,14 +912,12 @@ void CTCPDebugger::cleanupConnections()
     }
     
     if (m_server) {
+        // 工作线程在服务器析构时退出；之后到达的客户端通知不再处理
+        m_server->disconnect(this);
         m_server->deleteLater();
         m_server = nullptr;
     }
-    
-    for (QTcpSocket* socket : m_clientSockets) {
-        socket->deleteLater();
-    }
-    m_clientSockets.clear();
+    m_watchedClient = 0;
 }
 
 /**
@@ -652,17 +943,63 @@ void CTCPDebugger::processReceivedData(QTcpSocket* socket, const QByteArray& dat
 {
     m_totalBytesReceived += data.size();
     m_totalPacketsReceived++;
+    m_metricBytesReceived->add(data.size());
+    m_metricPacketsReceived->increment();
+    m_linkStats.recordReceived(data.size());
+    if (m_capture->isOpen()) {
+        m_capture->record(m_captureFlow, CPcapWriter::DIRECTION_INBOUND, data);
+    }
     
-    // 格式化数据
-    QString formattedData = m_dataFormatter->formatData(data, m_displayFormat, m_showTimestamp);
+    // 探测期间先匹配应答再交给界面，RTT 不含格式化和显示的时间
+    m_latencyProbe.feed(data);
     
-    // 获取远程地址信息
-    QString remoteAddress = getRemoteAddressInfo(socket);
+    // 客户端模式的回显（探测期间不回显，避免与对端的回显服务器来回循环）
+    if (m_echoMode && !m_latencyProbe.isRunning()) {
+        writeToServer(data);
+    }
     
-    // 发射数据接收信号
-    emit dataReceived(data, formattedData, remoteAddress);
+    publishReceivedData(data, getRemoteAddressInfo(socket));
+}
+
+/**
+ * @brief 客户端模式写出数据并计入统计
+ * @param data 数据
+ * @return 写入的字节数，-1表示失败
+ */
+qint64 CTCPDebugger::writeToServer(const QByteArray& data)
+{
+    if (!m_clientSocket || m_clientSocket->state() != QAbstractSocket::ConnectedState) {
+        return -1;
+    }
     
-    qDebug() << QString("接收数据 [%1]: %2 字节").arg(remoteAddress).arg(data.size());
+    const qint64 sent = m_clientSocket->write(data);
+    m_clientSocket->flush();
+    if (sent > 0) {
+        m_totalBytesSent += sent;
+        m_totalPacketsSent++;
+        m_metricBytesSent->add(sent);
+        m_metricPacketsSent->increment();
+        m_linkStats.recordSent(sent, 1);
+        if (m_capture->isOpen()) {
+            m_capture->record(m_captureFlow, CPcapWriter::DIRECTION_OUTBOUND, data.constData(), int(sent));
+        }
+    }
+    return sent;
+}
+
+/**
+ * @brief 把收到的数据交给界面
+ * @param data 原始数据
+ * @param remoteAddress 远程地址
+ */
+void CTCPDebugger::publishReceivedData(const QByteArray& data, const QString& remoteAddress)
+{
+    // 发射数据接收信号（高包率下逐包格式化和打印日志的开销很大，没有接收方时不格式化）
+    emit packetReceived(data, remoteAddress);
+    if (isSignalConnected(QMetaMethod::fromSignal(&CTCPDebugger::dataReceived))) {
+        QString formattedData = m_dataFormatter->formatData(data, m_displayFormat, m_showTimestamp);
+        emit dataReceived(data, formattedData, remoteAddress);
+    }
 }
 
 /**
@@ -9,6 +9,11 @@
 #include <QNetworkInterface>
 #include <QNetworkProxy>
 #include "dataformatter.h"
+#include "metricsregistry.h"
+#include "debugserver.h"
+#include "linkstats.h"
+#include "latencyprobe.h"
+#include "pcapcapture.h"
 
 /**
  * @class CTCPDebugger
@@ -16,11 +21,13 @@
  * 
  * 提供通用的TCP网络调试功能，支持：
  * - TCP客户端连接模式
- * - TCP服务器监听模式
+ * - TCP服务器监听模式（多客户端，收发在工作线程中进行，见 CDebugServer）
  * - 多种数据格式显示
  * - 连接状态监控
  * - 数据发送功能
  * - 连接统计信息
+ * - 请求/应答延迟探测（客户端模式，见 CLatencyProbe）和回显模式
+ * - 收发数据抓包为 pcapng 文件（见 CPcapWriter）
  */
 class CTCPDebugger : public QObject
 {
@@ -146,6 +153,92 @@ public:
      */
     bool getShowTimestamp() const;
 
+    /**
+     * @brief 服务器模式下各客户端的统计（每秒更新）
+     * @return 非服务器模式或未监听时为空
+     */
+    QList<CDebugServer::ClientStats> getClientStats() const;
+
+    /**
+     * @brief 服务器模式下是否显示所有客户端的数据
+     * @param watchAll true显示全部；false只显示 setWatchedClient 指定的客户端（服务器启动时的默认值）
+     */
+    void setWatchAllClients(bool watchAll);
+
+    /**
+     * @brief 服务器模式下显示指定客户端的数据
+     * @param clientId 客户端编号，0表示不显示任何客户端（只统计）
+     */
+    void setWatchedClient(quint64 clientId);
+
+    /**
+     * @brief 服务器模式下向指定客户端发送数据
+     * @return 成功排队的字节数，-1表示失败
+     */
+    qint64 sendToClient(quint64 clientId, const QByteArray& data);
+
+    /**
+     * @brief 服务器模式下断开指定客户端
+     */
+    void disconnectClient(quint64 clientId);
+
+    /**
+     * @brief 服务器模式下是否按流量发生器的校验帧头检查收到的数据
+     * @param verify 是否校验，结果出现在统计信息中
+     */
+    void setVerifyTraffic(bool verify);
+    bool getVerifyTraffic() const { return m_verifyTraffic; }
+
+    /**
+     * @brief 回显模式：把收到的数据原样发回（服务器模式在工作线程中回显），作为延迟探测的对端
+     * @param echo 是否回显
+     */
+    void setEchoMode(bool echo);
+    bool getEchoMode() const { return m_echoMode; }
+
+    /**
+     * @brief 开始延迟探测（客户端模式，需已连接）
+     * @param config 探测配置
+     * @param errorString 失败原因
+     * @return 未连接或配置无效时返回false
+     */
+    bool startLatencyProbe(const CLatencyProbe::Config& config, QString* errorString = nullptr);
+
+    /**
+     * @brief 停止延迟探测（统计保留到下次开始）
+     */
+    void stopLatencyProbe();
+
+    /**
+     * @brief 是否正在延迟探测
+     */
+    bool isLatencyProbeRunning() const { return m_latencyProbe.isRunning(); }
+
+    /**
+     * @brief 延迟探测统计
+     */
+    CLatencyProbe::Stats getLatencyProbeStats() const { return m_latencyProbe.stats(); }
+
+    /**
+     * @brief 开始抓包：之后的收发数据写入 pcapng 文件（客户端和服务器模式均可）
+     * @param fileName 文件路径
+     * @param errorString 失败原因
+     * @return 文件无法创建时返回false
+     */
+    bool startCapture(const QString& fileName, QString* errorString = nullptr);
+
+    /**
+     * @brief 停止抓包并关闭文件
+     */
+    void stopCapture();
+
+    bool isCapturing() const { return m_capture->isOpen(); }
+
+    /**
+     * @brief 抓包统计
+     */
+    CPcapWriter::Stats getCaptureStats() const { return m_capture->stats(); }
+
 signals:
     /**
      * @brief 数据接收信号
@@ -155,6 +248,13 @@ signals:
      */
     void dataReceived(const QByteArray& data, const QString& formattedData, const QString& remoteAddress);
 
+    /**
+     * @brief 原始数据接收信号（不格式化，由接收方按需格式化）
+     * @param data 接收到的原始数据
+     * @param remoteAddress 远程地址信息
+     */
+    void packetReceived(const QByteArray& data, const QString& remoteAddress);
+
     /**
      * @brief 连接状态变化信号
      * @param state 新的连接状态
@@ -181,6 +281,35 @@ signals:
      */
     void clientDisconnected(const QString& clientAddress);
 
+    /**
+     * @brief 客户端统计已更新（服务器模式，每秒一次）
+     */
+    void clientStatsUpdated();
+
+    /**
+     * @brief 实时速率和到达间隔统计已更新（连接或监听期间每秒一次）
+     * @param snapshot 滑动窗口统计
+     */
+    void linkStatsUpdated(const CLinkStats::Snapshot& snapshot);
+
+    /**
+     * @brief 延迟探测统计已更新（探测期间每秒一次）
+     * @param stats 探测统计
+     */
+    void latencyProbeUpdated(const CLatencyProbe::Stats& stats);
+
+    /**
+     * @brief 延迟探测结束（请求全部完成、手动停止或连接断开）
+     * @param stats 最终统计
+     */
+    void latencyProbeFinished(const CLatencyProbe::Stats& stats);
+
+    /**
+     * @brief 抓包文件写入失败（抓包已停止）
+     * @param message 错误信息
+     */
+    void captureFailed(const QString& message);
+
 public slots:
     /**
      * @brief 清空统计信息
@@ -210,22 +339,46 @@ private slots:
     void onSocketError(QAbstractSocket::SocketError error);
 
     /**
-     * @brief 新连接到达槽函数（服务器模式）
+     * @brief 新客户端连接槽函数（服务器模式）
+     * @param clientId 客户端编号
+     * @param clientAddress 客户端地址
+     */
+    void onServerClientConnected(quint64 clientId, const QString& clientAddress);
+
+    /**
+     * @brief 客户端断开连接槽函数（服务器模式）
+     * @param clientId 客户端编号
+     * @param clientAddress 客户端地址
      */
-    void onNewConnection();
+    void onServerClientDisconnected(quint64 clientId, const QString& clientAddress);
+
+    /**
+     * @brief 客户端数据槽函数（服务器模式，只有被查看的客户端才会到达）
+     */
+    void onServerClientData(quint64 clientId, const QString& clientAddress, const QByteArray& data);
 
     /**
      * @brief 统计更新定时器槽函数
      */
     void updateStats();
 
+    /**
+     * @brief 延迟探测定时器槽函数：处理超时并发出下一个请求
+     */
+    void onProbeTimer();
+
 private:
+    static const int SERVER_STATS_TOP_CLIENTS = 5;  ///< 统计信息中列出的客户端数
+
     WorkMode m_workMode;                    ///< 当前工作模式
     ConnectionState m_connectionState;      ///< 当前连接状态
     
     QTcpSocket* m_clientSocket;             ///< 客户端套接字
-    QTcpServer* m_server;                   ///< 服务器对象
-    QList<QTcpSocket*> m_clientSockets;     ///< 已连接的客户端套接字列表（服务器模式）
+    CDebugServer* m_server;                 ///< 服务器对象（客户端在工作线程中收发）
+    quint64 m_watchedClient;                ///< 单独查看的客户端（0表示无）
+    bool m_verifyTraffic;                   ///< 是否校验流量发生器数据
+    bool m_echoMode;                        ///< 是否回显收到的数据
+    CDebugServer::ClientStats m_serverBaseline; ///< 清空统计时的服务器累计值
     
     CDataFormatter* m_dataFormatter;       ///< 数据格式化器
     CDataFormatter::DataDisplayFormat m_displayFormat;  ///< 当前显示格式
@@ -241,6 +394,17 @@ private:
     qint64 m_totalPacketsSent;             ///< 总发送包数
     QDateTime m_connectionStartTime;        ///< 连接开始时间
     QTimer* m_statsTimer;                   ///< 统计更新定时器
+    CLinkStats m_linkStats;                 ///< 滑动窗口速率、包大小和到达间隔统计（服务器工作线程也写入）
+    CLatencyProbe m_latencyProbe;           ///< 请求/应答延迟探测
+    QTimer* m_probeTimer;                   ///< 延迟探测发送定时器
+    CPcapWriter* m_capture;                 ///< 抓包文件（服务器工作线程也写入）
+    CPcapWriter::Flow m_captureFlow;        ///< 客户端模式的连接地址
+
+    // 运行指标（不随统计清零，见 metricsregistry.h）
+    CMetricsRegistry::Metric* m_metricBytesReceived;    ///< 接收字节数
+    CMetricsRegistry::Metric* m_metricBytesSent;        ///< 发送字节数
+    CMetricsRegistry::Metric* m_metricPacketsReceived;  ///< 接收包数
+    CMetricsRegistry::Metric* m_metricPacketsSent;      ///< 发送包数
 
     /**
      * @brief 初始化组件
@@ -266,6 +430,26 @@ private:
      */
     void processReceivedData(QTcpSocket* socket, const QByteArray& data);
 
+    /**
+     * @brief 客户端模式写出数据并计入统计
+     * @param data 数据
+     * @return 写入的字节数，-1表示失败
+     */
+    qint64 writeToServer(const QByteArray& data);
+
+    /**
+     * @brief 结束延迟探测并发出结束信号
+     * @param reason 结束原因（写入日志）
+     */
+    void finishLatencyProbe(const QString& reason);
+
+    /**
+     * @brief 把收到的数据交给界面（按需格式化）
+     * @param data 原始数据
+     * @param remoteAddress 远程地址
+     */
+    void publishReceivedData(const QByteArray& data, const QString& remoteAddress);
+
     /**
      * @brief 获取套接字的远程地址信息
      * @param socket 套接字
@@ -273,6 +457,12 @@ private:
      */
     QString getRemoteAddressInfo(QTcpSocket* socket);
 
+    /**
+     * @brief 服务器模式的统计信息
+     * @return 统计信息字符串
+     */
+    QString serverStats() const;
+
     /**
      * @brief 连接状态转换为字符串
      * @param state 连接状态
@@ -0,0 +1,754 @@
+/**
+ * @file tcpimg_bench.cpp
+ * @brief 接收与显示热路径微基准测试
+ *
+ * 不依赖网络，直接测量以下环节的 ns/次 和 字节/秒：
+ * - CFrameParser 数据流解析（原始数据、7E 7E 帧头、扩展帧头、重同步、size=指令）
+ * - CFrameParser::parseFrameSize 帧头大小推断
+ * - CImageConverter 通道提取与显示图像转换（showLabelImg 的转换部分）
+ * - QPixmap::fromImage 与适应窗口的 QPixmap::scaled（SmoothTransformation）
+ * - CImageViewer 的绘制路径：QPainter 按缩放变换直接绘制到窗口大小的目标
+ * - CDataFormatter::toHexFormat / toBinaryFormat / toAsciiFormat / toHexString / detectDataFormat
+ * - CLinkStats 收包记录（原子计数）与每秒取样
+ *
+ * 结果以JSON输出，便于在不同版本之间比对性能回归
+ */
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QSysInfo>
+#include <QThread>
+#include <QFile>
+#include <QImage>
+#include <QPixmap>
+#include <QPainter>
+#include <QSharedPointer>
+#include <QDebug>
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <vector>
+#include "frameparser.h"
+#include "imageconverter.h"
+#include "imagescaler.h"
+#include "tiledframe.h"
+#include "dataformatter.h"
+#include "linkstats.h"
+
+/**
+ * @struct BenchConfig
+ * @brief 基准测试运行参数
+ */
+struct BenchConfig
+{
+    int width = 1280;
+    int height = 1024;
+    int channels = 2;
+    int chunkSize = 64 * 1024;      ///< 模拟套接字每次读取的字节数
+    int framesPerStream = 8;        ///< 解析测试每次输入的帧数
+    int repeats = 5;                ///< 采样次数
+    int minSampleMs = 200;          ///< 每次采样的最短时间
+    int viewportWidth = 1280;       ///< 适应窗口测试的视口尺寸
+    int viewportHeight = 720;
+    QString filter;
+};
+
+/**
+ * @struct BenchCase
+ * @brief 单个基准测试项
+ */
+struct BenchCase
+{
+    QString name;
+    QString group;
+    qint64 bytesPerOp = 0;          ///< 每次操作处理的字节数，用于计算吞吐
+    qint64 framesPerOp = 0;         ///< 每次操作处理的帧数，用于计算 ns/帧
+    QJsonObject params;
+    std::function<void()> op;
+    std::function<QJsonObject()> counters;  ///< 测试结束后附加的计数信息（可选）
+};
+
+// 防止编译器优化掉无副作用的计算
+static volatile qint64 g_sink = 0;
+
+/**
+ * @brief 生成测试图像数据（渐变 + 少量噪声）
+ */
+static QByteArray makeImageData(qint64 size, int seed)
+{
+    QByteArray data(int(size), Qt::Uninitialized);
+    uchar *p = reinterpret_cast<uchar*>(data.data());
+    quint32 state = 0x9E3779B9u ^ quint32(seed);
+    for (qint64 i = 0; i < size; ++i) {
+        state = state * 1664525u + 1013904223u;
+        p[i] = uchar((i & 0xFF) ^ (state >> 28));
+    }
+    return data;
+}
+
+/**
+ * @brief 生成带 7E 7E 帧头的一帧
+ */
+static QByteArray makeHeaderFrame(const QByteArray &payload)
+{
+    QByteArray frame(FrameProtocol::LEGACY_HEADER_SIZE, Qt::Uninitialized);
+    FrameProtocol::writeLegacyHeader(frame.data(), quint32(payload.size()));
+    frame.append(payload);
+    return frame;
+}
+
+/**
+ * @brief 生成带扩展帧头的一帧
+ */
+static QByteArray makeExtendedFrame(const QByteArray &payload, quint64 sequence)
+{
+    FrameProtocol::ExtendedHeader header;
+    header.sequence = sequence;
+    header.timestampUs = FrameProtocol::wallClockMicros();
+    header.payloadSize = quint64(payload.size());
+    QByteArray frame(header.headerSize, Qt::Uninitialized);
+    FrameProtocol::writeExtendedHeader(frame.data(), header);
+    frame.append(payload);
+    return frame;
+}
+
+/**
+ * @brief 按固定块大小把整段数据输入解析器
+ */
+static void feedInChunks(CFrameParser &parser, const QByteArray &stream, int chunkSize)
+{
+    const char *p = stream.constData();
+    qint64 remaining = stream.size();
+    while (remaining > 0) {
+        const qint64 n = qMin<qint64>(remaining, chunkSize);
+        parser.feed(p, n);
+        p += n;
+        remaining -= n;
+    }
+}
+
+/**
+ * @brief 运行单个测试项并返回JSON结果
+ *
+ * 先校准每次采样的迭代次数使采样时间不少于 minSampleMs，
+ * 再进行 repeats 次采样，报告 ns/次 的最小值、中位数、平均值和最大值
+ */
+static QJsonObject runCase(const BenchCase &bench, const BenchConfig &config)
+{
+    QElapsedTimer timer;
+
+    // 预热并校准迭代次数
+    bench.op();
+    qint64 iterations = 1;
+    for (;;) {
+        timer.start();
+        for (qint64 i = 0; i < iterations; ++i) {
+            bench.op();
+        }
+        const qint64 elapsedNs = timer.nsecsElapsed();
+        if (elapsedNs >= qint64(config.minSampleMs) * 1000000 || iterations >= (qint64(1) << 30)) {
+            break;
+        }
+        // 按耗时比例放大，至少翻倍
+        const double scale = elapsedNs > 0 ? (config.minSampleMs * 1.2e6) / elapsedNs : 10.0;
+        iterations = qMax(iterations * 2, qint64(iterations * qMin(scale, 100.0)));
+    }
+
+    std::vector<double> samples;
+    samples.reserve(size_t(config.repeats));
+    for (int r = 0; r < config.repeats; ++r) {
+        timer.start();
+        for (qint64 i = 0; i < iterations; ++i) {
+            bench.op();
+        }
+        samples.push_back(double(timer.nsecsElapsed()) / iterations);
+    }
+
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double s : sorted) {
+        sum += s;
+    }
+    const double median = sorted[sorted.size() / 2];
+
+    QJsonObject nsPerOp;
+    nsPerOp["min"] = sorted.front();
+    nsPerOp["median"] = median;
+    nsPerOp["mean"] = sum / sorted.size();
+    nsPerOp["max"] = sorted.back();
+
+    QJsonObject result;
+    result["name"] = bench.name;
+    result["group"] = bench.group;
+    result["iterations_per_sample"] = double(iterations);
+    result["samples"] = config.repeats;
+    result["ns_per_op"] = nsPerOp;
+    if (!bench.params.isEmpty()) {
+        result["params"] = bench.params;
+    }
+    if (bench.bytesPerOp > 0) {
+        result["bytes_per_op"] = double(bench.bytesPerOp);
+        result["bytes_per_sec"] = bench.bytesPerOp * 1e9 / median;
+    }
+    if (bench.framesPerOp > 0) {
+        result["ns_per_frame"] = median / bench.framesPerOp;
+        result["frames_per_sec"] = bench.framesPerOp * 1e9 / median;
+    }
+    if (bench.counters) {
+        result["counters"] = bench.counters();
+    }
+
+    qDebug().noquote() << QString("⏱️  %1：%2 ns/次%3")
+                          .arg(bench.name, -36)
+                          .arg(median, 14, 'f', 1)
+                          .arg(bench.bytesPerOp > 0
+                               ? QString("，%1 MB/s").arg(bench.bytesPerOp * 1e9 / median / 1024.0 / 1024.0, 0, 'f', 1)
+                               : QString());
+    return result;
+}
+
+/**
+ * @brief 数据流解析测试项
+ */
+static void addParserCases(std::vector<BenchCase> &cases, const BenchConfig &config,
+                           CFrameParser &parser, qint64 &frameCount)
+{
+    const qint64 frameSize = qint64(config.width) * config.height * config.channels;
+
+    QByteArray rawStream;
+    QByteArray headerStream;
+    QByteArray extendedStream;
+    QByteArray resyncStream;
+    QByteArray sizeStream;
+    for (int f = 0; f < config.framesPerStream; ++f) {
+        const QByteArray payload = makeImageData(frameSize, f);
+        rawStream.append(payload);
+        headerStream.append(makeHeaderFrame(payload));
+        extendedStream.append(makeExtendedFrame(payload, quint64(f)));
+        sizeStream.append(FrameProtocol::sizeCommandPrefix() + QByteArray::number(frameSize));
+        sizeStream.append(payload);
+
+        // 每隔一帧插入一段不含同步头的垃圾数据，触发重同步
+        resyncStream.append(makeHeaderFrame(payload));
+        if (f % 2 == 1) {
+            QByteArray garbage(37 + f, char(0x5A));
+            garbage[5] = char(FrameProtocol::SYNC_BYTE);
+            resyncStream.append(garbage);
+        }
+    }
+
+    const QJsonObject common {
+        {"frame_bytes", double(frameSize)},
+        {"frames_per_op", config.framesPerStream},
+        {"chunk_bytes", config.chunkSize}
+    };
+
+    struct StreamCase { const char *name; QByteArray stream; };
+    const StreamCase streams[] = {
+        {"parser.raw", rawStream},
+        {"parser.header_7e7e", headerStream},
+        {"parser.header_extended", extendedStream},
+        {"parser.resync", resyncStream},
+    };
+
+    for (const StreamCase &sc : streams) {
+        BenchCase bench;
+        bench.name = sc.name;
+        bench.group = "parser";
+        bench.bytesPerOp = sc.stream.size();
+        bench.framesPerOp = config.framesPerStream;
+        bench.params = common;
+        const QByteArray stream = sc.stream;
+        const int chunk = config.chunkSize;
+        bench.op = [&parser, stream, chunk, frameSize]() {
+            parser.reset();
+            parser.setExpectedPayloadSize(int(frameSize));
+            feedInChunks(parser, stream, chunk);
+        };
+        bench.counters = [&parser, &frameCount]() {
+            QJsonObject c;
+            c["frames_completed"] = double(parser.framesCompleted());
+            c["frames_dropped"] = double(parser.framesDropped());
+            c["resyncs"] = double(parser.resyncCount());
+            c["dropped_bytes"] = double(parser.droppedBytes());
+            c["frames_emitted"] = double(frameCount);
+            return c;
+        };
+        cases.push_back(bench);
+    }
+
+    // size=指令：指令和图像数据分两次输入，与实际握手节奏一致
+    {
+        BenchCase bench;
+        bench.name = "parser.size_command";
+        bench.group = "parser";
+        bench.bytesPerOp = sizeStream.size();
+        bench.framesPerOp = config.framesPerStream;
+        bench.params = common;
+        const QByteArray command = FrameProtocol::sizeCommandPrefix() + QByteArray::number(frameSize);
+        const QByteArray payload = makeImageData(frameSize, 0);
+        const int frames = config.framesPerStream;
+        const int chunk = config.chunkSize;
+        bench.op = [&parser, command, payload, frames, chunk]() {
+            parser.reset();
+            for (int f = 0; f < frames; ++f) {
+                parser.feed(command);
+                parser.flushSizeCommand();  // 接收端在指令后的空闲时结束指令
+                feedInChunks(parser, payload, chunk);
+            }
+        };
+        cases.push_back(bench);
+    }
+}
+
+/**
+ * @brief 帧头大小推断测试项
+ */
+static void addFrameSizeCases(std::vector<BenchCase> &cases, const BenchConfig &config)
+{
+    const int expected = config.width * config.height * config.channels;
+
+    // 覆盖各个推断分支：32位负载长度、16位长度字段和回退到预设大小
+    static const int HEADER_COUNT = 64;
+    QByteArray headers(HEADER_COUNT * FrameProtocol::LEGACY_HEADER_SIZE, Qt::Uninitialized);
+    for (int i = 0; i < HEADER_COUNT; ++i) {
+        char *h = headers.data() + i * FrameProtocol::LEGACY_HEADER_SIZE;
+        const quint32 value = (i % 2 == 0) ? quint32(expected) : quint32(i * 977);
+        FrameProtocol::writeLegacyHeader(h, value);
+    }
+
+    BenchCase bench;
+    bench.name = "parser.parse_frame_size";
+    bench.group = "parser";
+    bench.params = QJsonObject{{"headers_per_op", HEADER_COUNT}};
+    bench.op = [headers, expected]() {
+        qint64 acc = 0;
+        const char *h = headers.constData();
+        for (int i = 0; i < HEADER_COUNT; ++i) {
+            acc += CFrameParser::parseFrameSize(h + i * FrameProtocol::LEGACY_HEADER_SIZE, expected);
+        }
+        g_sink = g_sink + acc;
+    };
+    cases.push_back(bench);
+}
+
+/**
+ * @brief 像素转换与缩放测试项
+ */
+static void addImageCases(std::vector<BenchCase> &cases, const BenchConfig &config)
+{
+    const int pixels = config.width * config.height;
+
+    // 通道提取（2tap 第一通道）
+    {
+        const QByteArray source = makeImageData(qint64(pixels) * 2, 1);
+        BenchCase bench;
+        bench.name = "convert.extract_channel_c2";
+        bench.group = "convert";
+        bench.bytesPerOp = source.size();
+        bench.framesPerOp = 1;
+        bench.params = QJsonObject{{"width", config.width}, {"height", config.height}, {"channels", 2}};
+        QSharedPointer<QByteArray> dst(new QByteArray(pixels, Qt::Uninitialized));
+        bench.op = [source, dst, pixels]() {
+            CImageConverter::extractChannel(reinterpret_cast<const uchar*>(source.constData()),
+                                            reinterpret_cast<uchar*>(dst->data()), pixels, 2, 0);
+            g_sink = g_sink + uchar(dst->at(pixels / 2));
+        };
+        cases.push_back(bench);
+    }
+
+    // 完整显示转换（各通道数）
+    const int channelList[] = {1, 2, 3, 4, 8};
+    for (int channels : channelList) {
+        const QByteArray source = makeImageData(qint64(pixels) * channels, channels);
+        BenchCase bench;
+        bench.name = QString("convert.display_image_c%1").arg(channels);
+        bench.group = "convert";
+        bench.bytesPerOp = source.size();
+        bench.framesPerOp = 1;
+        bench.params = QJsonObject{{"width", config.width}, {"height", config.height}, {"channels", channels}};
+        QSharedPointer<QImage> target(new QImage());
+        const int width = config.width;
+        const int height = config.height;
+        bench.op = [source, target, width, height, channels]() {
+            CImageConverter::convertToDisplayImage(source.constData(), width, height, channels, *target);
+            g_sink = g_sink + target->constScanLine(height / 2)[0];
+        };
+        cases.push_back(bench);
+    }
+
+    // QPixmap::fromImage 与适应窗口缩放（与 Dialog::fitImageToWindow 相同的参数）
+    QImage image;
+    const QByteArray source = makeImageData(qint64(pixels) * config.channels, 7);
+    CImageConverter::convertToDisplayImage(source.constData(), config.width, config.height, config.channels, image);
+
+    {
+        BenchCase bench;
+        bench.name = "display.pixmap_from_image";
+        bench.group = "display";
+        bench.bytesPerOp = qint64(image.bytesPerLine()) * image.height();
+        bench.framesPerOp = 1;
+        bench.params = QJsonObject{{"width", config.width}, {"height", config.height}};
+        bench.op = [image]() {
+            QPixmap pixmap = QPixmap::fromImage(image);
+            g_sink = g_sink + pixmap.width();
+        };
+        cases.push_back(bench);
+    }
+
+    {
+        const QPixmap pixmap = QPixmap::fromImage(image);
+        const double scaleX = double(config.viewportWidth) / pixmap.width();
+        const double scaleY = double(config.viewportHeight) / pixmap.height();
+        const double factor = qMax(0.1, qMin(5.0, qMin(scaleX, scaleY)));
+        const QSize scaledSize = pixmap.size() * factor;
+
+        BenchCase bench;
+        bench.name = "display.fit_to_window_smooth";
+        bench.group = "display";
+        bench.bytesPerOp = qint64(image.bytesPerLine()) * image.height();
+        bench.framesPerOp = 1;
+        bench.params = QJsonObject{
+            {"width", config.width}, {"height", config.height},
+            {"viewport_width", config.viewportWidth}, {"viewport_height", config.viewportHeight},
+            {"scale_factor", factor}
+        };
+        bench.op = [pixmap, scaledSize]() {
+            QPixmap scaled = pixmap.scaled(scaledSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            g_sink = g_sink + scaled.width();
+        };
+        cases.push_back(bench);
+
+        // CImageViewer 新帧的绘制方式：不生成缩放图，直接按变换绘制到目标（模拟窗口后备缓冲）
+        QSharedPointer<QImage> backing(new QImage(scaledSize, QImage::Format_ARGB32_Premultiplied));
+        BenchCase paint = bench;
+        paint.name = "display.viewer_paint_transform";
+        paint.op = [image, backing, scaledSize]() {
+            QPainter painter(backing.data());
+            painter.setRenderHint(QPainter::SmoothPixmapTransform);
+            painter.drawImage(QRect(QPoint(0, 0), scaledSize), image);
+            painter.end();
+            g_sink = g_sink + backing->constScanLine(0)[0];
+        };
+        cases.push_back(paint);
+
+        // 区域平均质量：金字塔逐级缩小（每帧重新生成到所需层）后绘制剩余缩放
+        QSharedPointer<CImagePyramid> pyramid(new CImagePyramid());
+        BenchCase area = bench;
+        area.name = "display.viewer_paint_pyramid";
+        area.op = [image, backing, scaledSize, pyramid, factor]() {
+            pyramid->setBase(image);
+            const QImage &level = pyramid->level(pyramid->levelForScale(factor));
+            QPainter painter(backing.data());
+            painter.setRenderHint(QPainter::SmoothPixmapTransform);
+            painter.drawImage(QRect(QPoint(0, 0), scaledSize), level);
+            painter.end();
+            g_sink = g_sink + backing->constScanLine(0)[0];
+        };
+        cases.push_back(area);
+    }
+
+    // 单级 2×2 区域平均（SIMD 与逐像素实现对比）
+    {
+        QSharedPointer<QImage> half(new QImage());
+        BenchCase simd;
+        simd.name = "display.downscale2x";
+        simd.group = "display";
+        simd.bytesPerOp = qint64(image.bytesPerLine()) * image.height();
+        simd.framesPerOp = 1;
+        simd.params = QJsonObject{{"width", config.width}, {"height", config.height}, {"simd", true}};
+        simd.op = [image, half]() {
+            CImageScaler::downscale2x(image, *half);
+            g_sink = g_sink + half->constScanLine(0)[0];
+        };
+        cases.push_back(simd);
+
+        QSharedPointer<QImage> halfScalar(new QImage((image.width() + 1) / 2, (image.height() + 1) / 2, image.format()));
+        BenchCase scalar = simd;
+        scalar.name = "display.downscale2x_scalar";
+        scalar.params = QJsonObject{{"width", config.width}, {"height", config.height}, {"simd", false}};
+        scalar.op = [image, halfScalar]() {
+            CImageScaler::downscale2xScalar(image.constBits(), image.bytesPerLine(), image.width(), image.height(),
+                                            halfScalar->bits(), halfScalar->bytesPerLine(), image.depth() / 8);
+            g_sink = g_sink + halfScalar->constScanLine(0)[0];
+        };
+        cases.push_back(scalar);
+    }
+
+    // 分块显示：新帧到达后只转换与视口相交的分块（100%缩放，视口位于图像左上角）
+    {
+        QSharedPointer<CTiledFrame> tiles(new CTiledFrame());
+        const int width = config.width;
+        const int height = config.height;
+        const int channels = config.channels;
+        const int lastColumn = (qMin(config.viewportWidth, width) - 1) / CTiledFrame::TILE_SIZE;
+        const int lastRow = (qMin(config.viewportHeight, height) - 1) / CTiledFrame::TILE_SIZE;
+
+        BenchCase bench;
+        bench.name = "display.tiled_viewport";
+        bench.group = "display";
+        bench.bytesPerOp = qint64(image.bytesPerLine()) * image.height();
+        bench.framesPerOp = 1;
+        bench.params = QJsonObject{
+            {"width", width}, {"height", height}, {"channels", channels},
+            {"viewport_width", config.viewportWidth}, {"viewport_height", config.viewportHeight},
+            {"tile_size", CTiledFrame::TILE_SIZE}
+        };
+        bench.op = [source, tiles, width, height, channels, lastColumn, lastRow]() {
+            tiles->setFrame(source, width, height, channels);
+            for (int row = 0; row <= lastRow; ++row) {
+                for (int column = 0; column <= lastColumn; ++column) {
+                    g_sink = g_sink + tiles->tile(column, row).constScanLine(0)[0];
+                }
+            }
+        };
+        cases.push_back(bench);
+    }
+}
+
+/**
+ * @brief 数据格式化测试项
+ */
+static void addFormatterCases(std::vector<BenchCase> &cases)
+{
+    const int sizes[] = {1024, 64 * 1024};
+    for (int size : sizes) {
+        const QByteArray data = makeImageData(size, size);
+
+        BenchCase hex;
+        hex.name = QString("formatter.hex_%1k").arg(size / 1024);
+        hex.group = "formatter";
+        hex.bytesPerOp = size;
+        hex.params = QJsonObject{{"bytes", size}, {"bytes_per_line", 16}, {"show_address", true}};
+        hex.op = [data]() {
+            CDataFormatter formatter;
+            g_sink = g_sink + formatter.toHexFormat(data, 16, true).size();
+        };
+        cases.push_back(hex);
+
+        BenchCase binary;
+        binary.name = QString("formatter.binary_%1k").arg(size / 1024);
+        binary.group = "formatter";
+        binary.bytesPerOp = size;
+        binary.params = QJsonObject{{"bytes", size}, {"bits_per_byte", 4}};
+        binary.op = [data]() {
+            CDataFormatter formatter;
+            g_sink = g_sink + formatter.toBinaryFormat(data, 4).size();
+        };
+        cases.push_back(binary);
+
+        BenchCase ascii;
+        ascii.name = QString("formatter.ascii_%1k").arg(size / 1024);
+        ascii.group = "formatter";
+        ascii.bytesPerOp = size;
+        ascii.params = QJsonObject{{"bytes", size}, {"show_non_printable", true}};
+        ascii.op = [data]() {
+            CDataFormatter formatter;
+            g_sink = g_sink + formatter.toAsciiFormat(data, true).size();
+        };
+        cases.push_back(ascii);
+
+        BenchCase hexString;
+        hexString.name = QString("formatter.hex_string_%1k").arg(size / 1024);
+        hexString.group = "formatter";
+        hexString.bytesPerOp = size;
+        hexString.params = QJsonObject{{"bytes", size}, {"spaced", true}};
+        hexString.op = [data]() {
+            g_sink = g_sink + CDataFormatter::toHexString(data, true).size();
+        };
+        cases.push_back(hexString);
+    }
+
+    // 大包十六进制显示：查表编码应接近内存带宽
+    const int largeSize = 4 * 1024 * 1024;
+    const QByteArray large = makeImageData(largeSize, largeSize);
+    BenchCase largeHex;
+    largeHex.name = "formatter.hex_4m";
+    largeHex.group = "formatter";
+    largeHex.bytesPerOp = largeSize;
+    largeHex.params = QJsonObject{{"bytes", largeSize}, {"bytes_per_line", 16}, {"show_address", true}};
+    largeHex.op = [large]() {
+        CDataFormatter formatter;
+        g_sink = g_sink + formatter.toHexFormat(large, 16, true).size();
+    };
+    cases.push_back(largeHex);
+
+    // 格式检测：大包抽样统计，耗时与数据大小无关
+    const int detectSizes[] = {4 * 1024, largeSize};
+    for (int size : detectSizes) {
+        const QByteArray data = (size == largeSize) ? large : makeImageData(size, size);
+        BenchCase detect;
+        detect.name = QString("formatter.detect_%1k").arg(size / 1024);
+        detect.group = "formatter";
+        detect.bytesPerOp = size;
+        detect.params = QJsonObject{{"bytes", size}, {"sampled", size > CDataFormatter::PROFILE_SAMPLE_THRESHOLD}};
+        detect.op = [data]() {
+            CDataFormatter formatter;
+            g_sink = g_sink + formatter.detectDataFormat(data);
+        };
+        cases.push_back(detect);
+    }
+}
+
+/**
+ * @brief 链路统计测试项：收包路径上的记录开销和每秒一次的取样开销
+ */
+static void addLinkStatsCases(std::vector<BenchCase> &cases)
+{
+    QSharedPointer<CLinkStats> stats(new CLinkStats());
+
+    BenchCase record;
+    record.name = "linkstats.record_received";
+    record.group = "linkstats";
+    record.bytesPerOp = 1024;
+    record.params = QJsonObject{{"bytes", 1024}};
+    record.op = [stats]() {
+        stats->recordReceived(1024);
+    };
+    cases.push_back(record);
+
+    BenchCase sample;
+    sample.name = "linkstats.sample";
+    sample.group = "linkstats";
+    sample.params = QJsonObject{{"window_seconds", int(CLinkStats::WINDOW_SECONDS)}};
+    sample.op = [stats]() {
+        stats->recordReceived(512);
+        g_sink = g_sink + stats->sample().rxPackets;
+    };
+    cases.push_back(sample);
+}
+
+/**
+ * @brief 主函数
+ */
+int main(int argc, char *argv[])
+{
+    // 无显示环境下也能创建QPixmap
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("tcpimg-bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("TCP图像接收热路径微基准测试，结果以JSON输出");
+    parser.addHelpOption();
+
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "JSON结果输出文件（默认输出到标准输出）", "file");
+    QCommandLineOption filterOption("filter", "只运行名称包含该字符串的测试项", "text");
+    QCommandLineOption widthOption(QStringList() << "W" << "width", "图像宽度（默认1280）", "pixels", "1280");
+    QCommandLineOption heightOption(QStringList() << "H" << "height", "图像高度（默认1024）", "pixels", "1024");
+    QCommandLineOption channelsOption(QStringList() << "c" << "channels", "通道数（默认2）", "count", "2");
+    QCommandLineOption chunkOption("chunk", "解析测试每次输入的字节数（默认65536）", "bytes", "65536");
+    QCommandLineOption repeatsOption("repeats", "采样次数（默认5）", "count", "5");
+    QCommandLineOption minTimeOption("min-time", "每次采样最短时间（毫秒，默认200）", "ms", "200");
+    QCommandLineOption listOption("list", "只列出测试项名称");
+
+    parser.addOption(outputOption);
+    parser.addOption(filterOption);
+    parser.addOption(widthOption);
+    parser.addOption(heightOption);
+    parser.addOption(channelsOption);
+    parser.addOption(chunkOption);
+    parser.addOption(repeatsOption);
+    parser.addOption(minTimeOption);
+    parser.addOption(listOption);
+    parser.process(app);
+
+    BenchConfig config;
+    config.width = parser.value(widthOption).toInt();
+    config.height = parser.value(heightOption).toInt();
+    config.channels = parser.value(channelsOption).toInt();
+    config.chunkSize = parser.value(chunkOption).toInt();
+    config.repeats = qMax(1, parser.value(repeatsOption).toInt());
+    config.minSampleMs = qMax(1, parser.value(minTimeOption).toInt());
+    config.filter = parser.value(filterOption);
+
+    if (config.width <= 0 || config.height <= 0 || config.channels <= 0 || config.chunkSize <= 0) {
+        qDebug() << "❌ 参数无效：分辨率、通道数和块大小必须为正数";
+        return 1;
+    }
+
+    // 解析器在所有解析测试项之间共用，统计帧完成信号
+    CFrameParser frameParser;
+    qint64 frameCount = 0;
+    QObject::connect(&frameParser, &CFrameParser::frameReady, [&frameCount](const QByteArray &payload) {
+        frameCount++;
+        g_sink = g_sink + payload.size();
+    });
+
+    std::vector<BenchCase> cases;
+    addParserCases(cases, config, frameParser, frameCount);
+    addFrameSizeCases(cases, config);
+    addImageCases(cases, config);
+    addFormatterCases(cases);
+    addLinkStatsCases(cases);
+
+    if (parser.isSet(listOption)) {
+        for (const BenchCase &bench : cases) {
+            printf("%s\n", qPrintable(bench.name));
+        }
+        return 0;
+    }
+
+    qDebug() << QString("🚀 开始基准测试：%1×%2×%3，采样%4次，每次≥%5ms")
+                .arg(config.width).arg(config.height).arg(config.channels)
+                .arg(config.repeats).arg(config.minSampleMs);
+
+    QJsonArray results;
+    for (const BenchCase &bench : cases) {
+        if (!config.filter.isEmpty() && !bench.name.contains(config.filter)) {
+            continue;
+        }
+        frameParser.resetStatistics();
+        frameCount = 0;
+        results.append(runCase(bench, config));
+    }
+
+    QJsonObject host;
+    host["cpu_arch"] = QSysInfo::currentCpuArchitecture();
+    host["os"] = QSysInfo::prettyProductName();
+    host["kernel"] = QSysInfo::kernelVersion();
+    host["logical_cores"] = QThread::idealThreadCount();
+
+    QJsonObject configJson;
+    configJson["width"] = config.width;
+    configJson["height"] = config.height;
+    configJson["channels"] = config.channels;
+    configJson["chunk_bytes"] = config.chunkSize;
+    configJson["frames_per_stream"] = config.framesPerStream;
+    configJson["repeats"] = config.repeats;
+    configJson["min_sample_ms"] = config.minSampleMs;
+    configJson["filter"] = config.filter;
+
+    QJsonObject root;
+    root["benchmark"] = QStringLiteral("tcpimg-bench");
+    root["schema_version"] = 1;
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["qt_version"] = QString(qVersion());
+    root["host"] = host;
+    root["config"] = configJson;
+    root["results"] = results;
+
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qDebug() << "❌ 无法写入结果文件：" << file.fileName();
+            return 1;
+        }
+        file.write(json);
+        qDebug() << "✅ 结果已写入：" << file.fileName();
+    } else {
+        fwrite(json.constData(), 1, size_t(json.size()), stdout);
+    }
+
+    return 0;
+}
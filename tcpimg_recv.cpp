@@ -0,0 +1,441 @@
+/**
+ * @file tcpimg_recv.cpp
+ * @brief 无界面图像接收端
+ *
+ * 在没有图形环境的边缘设备上运行 CTCPImg，不创建任何窗口部件，
+ * 也不做逐帧的图像转换和显示拷贝，只负责接收、统计和输出：
+ * - 连接参数、分辨率、传输协议可由命令行指定
+ * - 定期打印帧率、吞吐量、丢帧、重同步和延迟分位数
+ * - 输出：按间隔保存原始帧、共享内存帧环、帧转发、Prometheus指标、退出时导出延迟统计
+ * - 达到帧数或时长上限、或收到 SIGINT/SIGTERM 时打印汇总后退出
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <csignal>
+#include "ctcpimg.h"
+#include "metricsserver.h"
+
+namespace
+{
+    volatile std::sig_atomic_t g_stopRequested = 0;
+
+    void onStopSignal(int)
+    {
+        g_stopRequested = 1;
+    }
+}
+
+/**
+ * @struct ReceiverConfig
+ * @brief 接收端运行参数
+ */
+struct ReceiverConfig
+{
+    QString address = "127.0.0.1";
+    quint16 port = 8080;
+    int width = WIDTH;
+    int height = HEIGHT;
+    int channels = CHANLE;
+    CFrameParser::ProtocolMode protocol = CFrameParser::PROTOCOL_AUTO;
+    bool autoGeometry = true;       ///< 按扩展帧头中的几何自动切换分辨率
+    qint64 frameLimit = 0;          ///< 接收帧数上限，0表示不限
+    int duration = 0;               ///< 运行时长（秒），0表示不限
+    int statsInterval = 5;          ///< 统计输出间隔（秒）
+    int reconnectAttempts = -1;     ///< 最大连续重连次数，0不重连，-1不限
+    int reconnectMaxDelay = 2000;   ///< 重连等待时间上限（毫秒）
+    int connectTimeout = 2000;      ///< 单次连接超时（毫秒）
+    QVector<CTCPImg::Endpoint> backups; ///< 备用端点（按优先级）
+    bool standby = false;           ///< 预先建立备用连接
+    int stallTimeout = 0;           ///< 超过该时间未收到数据判定停滞（毫秒），0不检测
+    int frameTimeout = 0;           ///< 超过该时间未收到完整帧判定停滞（毫秒），0不检测
+    int heartbeatInterval = 0;      ///< 向发送端发送心跳的间隔（毫秒），0不发送
+    QString saveDir;                ///< 原始帧保存目录，空表示不保存
+    int saveEvery = 100;            ///< 每N帧保存一帧
+    QString latencyExport;          ///< 退出时导出延迟统计的文件
+};
+
+/**
+ * @class CHeadlessReceiver
+ * @brief 无界面接收端，负责统计输出和退出控制
+ */
+class CHeadlessReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CHeadlessReceiver(const ReceiverConfig &config, QObject *parent = nullptr)
+        : QObject(parent)
+        , m_config(config)
+        , m_framesSaved(0)
+        , m_lastFrames(0)
+        , m_lastBytes(0)
+        , m_lastDropped(0)
+        , m_lastResyncs(0)
+        , m_lastStalls(0)
+    {
+        m_tcpImg.setDisplayUpdateEnabled(false);
+        m_tcpImg.setProtocolLock(config.protocol);
+        m_tcpImg.setAutoGeometryEnabled(config.autoGeometry);
+        CTCPImg::ReconnectPolicy policy = m_tcpImg.reconnectPolicy();
+        policy.maxDelayMs = config.reconnectMaxDelay;
+        policy.connectTimeoutMs = config.connectTimeout;
+        m_tcpImg.setReconnectPolicy(policy);
+        m_tcpImg.setAutoReconnect(config.reconnectAttempts != 0, qMax(0, config.reconnectAttempts), config.reconnectMaxDelay);
+        CTCPImg::StallPolicy stall = m_tcpImg.stallPolicy();
+        stall.byteTimeoutMs = config.stallTimeout;
+        stall.frameTimeoutMs = config.frameTimeout;
+        stall.heartbeatIntervalMs = config.heartbeatInterval;
+        m_tcpImg.setStallPolicy(stall);
+
+        connect(&m_tcpImg.frameParser(), &CFrameParser::frameReady, this, &CHeadlessReceiver::onFrameReady);
+        connect(&m_statsTimer, &QTimer::timeout, this, &CHeadlessReceiver::printStats);
+        connect(&m_signalPoll, &QTimer::timeout, this, &CHeadlessReceiver::pollStopSignal);
+    }
+
+    CTCPImg& tcpImg() { return m_tcpImg; }
+
+    /**
+     * @brief 设置分辨率并开始连接
+     * @return 参数无效时返回false
+     */
+    bool start()
+    {
+        if (!m_tcpImg.setImageResolution(m_config.width, m_config.height, m_config.channels)) {
+            qDebug() << "❌ 分辨率设置失败";
+            return false;
+        }
+
+        if (!m_config.saveDir.isEmpty() && !QDir().mkpath(m_config.saveDir)) {
+            qDebug() << "❌ 无法创建保存目录：" << m_config.saveDir;
+            return false;
+        }
+
+        qDebug() << QString("📡 无界面接收端：%1:%2，%3×%4×%5，协议：%6")
+                    .arg(m_config.address).arg(m_config.port)
+                    .arg(m_config.width).arg(m_config.height).arg(m_config.channels)
+                    .arg(protocolName());
+
+        m_clock.start();
+        m_intervalClock.start();
+        if (m_config.statsInterval > 0) {
+            m_statsTimer.start(m_config.statsInterval * 1000);
+        }
+        if (m_config.duration > 0) {
+            QTimer::singleShot(m_config.duration * 1000, this, &CHeadlessReceiver::finish);
+        }
+        m_signalPoll.start(200);
+
+        m_tcpImg.setBackupEndpoints(m_config.backups);
+        m_tcpImg.start(m_config.address, m_config.port);
+        m_tcpImg.setStandbyEnabled(m_config.standby);
+        return true;
+    }
+
+private slots:
+    /**
+     * @brief 每帧回调：只做计数和按需保存
+     */
+    void onFrameReady(const QByteArray &payload, const CFrameParser::FrameInfo &info)
+    {
+        const qint64 frames = m_tcpImg.frameParser().framesCompleted();
+
+        if (!m_config.saveDir.isEmpty() && m_config.saveEvery > 0 && (frames - 1) % m_config.saveEvery == 0) {
+            const quint64 number = info.hasExtendedHeader ? info.sequence : quint64(frames);
+            // 帧头带几何时写入文件名，分辨率随帧变化时仍能还原图像
+            const QString geometry = info.hasGeometry()
+                ? QString("_%1x%2x%3").arg(info.width).arg(info.height).arg(info.channels) : QString();
+            QFile file(QString("%1/frame_%2%3.raw").arg(m_config.saveDir).arg(number, 8, 10, QChar('0')).arg(geometry));
+            if (file.open(QIODevice::WriteOnly) && file.write(payload) == payload.size()) {
+                m_framesSaved++;
+            } else {
+                qDebug() << "❌ 保存帧失败：" << file.fileName() << file.errorString();
+            }
+        }
+
+        if (m_config.frameLimit > 0 && frames >= m_config.frameLimit) {
+            // 在信号处理结束后退出，避免在解析器回调中销毁接收对象
+            QTimer::singleShot(0, this, &CHeadlessReceiver::finish);
+        }
+    }
+
+    /**
+     * @brief 输出周期统计
+     */
+    void printStats()
+    {
+        const CFrameParser &parser = m_tcpImg.frameParser();
+        const double seconds = qMax(m_intervalClock.restart(), qint64(1)) / 1000.0;
+
+        const qint64 frames = parser.framesCompleted();
+        const qint64 bytes = parser.bytesConsumed();
+        const qint64 dropped = parser.framesDropped();
+        const qint64 resyncs = parser.resyncCount();
+
+        const CLatencyStats::Summary receive = m_tcpImg.latencyStats().summary(CLatencyStats::STAGE_RECEIVE);
+        const CLatencyStats::Summary network = m_tcpImg.latencyStats().summary(CLatencyStats::STAGE_NETWORK);
+
+        QString line = QString("📊 %1 帧 | %2 FPS | %3 MB/s | 丢帧 +%4 | 重同步 +%5 | 接收 p50 %6 ms p99 %7 ms")
+                       .arg(frames)
+                       .arg((frames - m_lastFrames) / seconds, 0, 'f', 1)
+                       .arg((bytes - m_lastBytes) / seconds / 1024.0 / 1024.0, 0, 'f', 1)
+                       .arg(dropped - m_lastDropped)
+                       .arg(resyncs - m_lastResyncs)
+                       .arg(receive.p50 / 1000.0, 0, 'f', 2)
+                       .arg(receive.p99 / 1000.0, 0, 'f', 2);
+        if (network.windowCount > 0) {
+            line += QString(" | 网络 p50 %1 ms p99 %2 ms")
+                    .arg(network.p50 / 1000.0, 0, 'f', 2).arg(network.p99 / 1000.0, 0, 'f', 2);
+        }
+        if (m_tcpImg.stallCount() > m_lastStalls) {
+            line += QString(" | ⏱️ 停滞 +%1").arg(m_tcpImg.stallCount() - m_lastStalls);
+        }
+        if (m_tcpImg.getConnectionState() != QAbstractSocket::ConnectedState) {
+            line += m_tcpImg.isReconnecting() ? " | 🔄 重连中" : " | 🔌 未连接";
+        } else if (m_tcpImg.endpoints().size() > 1) {
+            const CTCPImg::Endpoint& endpoint = m_tcpImg.endpoints().value(m_tcpImg.activeEndpointIndex());
+            line += QString(" | 🔀 %1:%2%3").arg(endpoint.address).arg(endpoint.port)
+                    .arg(m_tcpImg.isStandbyReady() ? " 🛡️" : "");
+        }
+        qDebug().noquote() << line;
+
+        m_lastFrames = frames;
+        m_lastBytes = bytes;
+        m_lastDropped = dropped;
+        m_lastResyncs = resyncs;
+        m_lastStalls = m_tcpImg.stallCount();
+    }
+
+    /**
+     * @brief 检查是否收到终止信号
+     */
+    void pollStopSignal()
+    {
+        if (g_stopRequested) {
+            qDebug() << "🛑 收到终止信号";
+            finish();
+        }
+    }
+
+    /**
+     * @brief 打印汇总、导出延迟统计并退出
+     */
+    void finish()
+    {
+        if (!m_clock.isValid()) {
+            return;
+        }
+
+        const CFrameParser &parser = m_tcpImg.frameParser();
+        const double seconds = qMax(m_clock.elapsed(), qint64(1)) / 1000.0;
+        m_clock.invalidate();
+        m_statsTimer.stop();
+        m_signalPoll.stop();
+
+        qDebug() << "============================================";
+        qDebug() << QString("🏁 运行 %1 秒，接收 %2 帧（平均 %3 FPS，%4 MB/s）")
+                    .arg(seconds, 0, 'f', 1).arg(parser.framesCompleted())
+                    .arg(parser.framesCompleted() / seconds, 0, 'f', 1)
+                    .arg(parser.bytesConsumed() / seconds / 1024.0 / 1024.0, 0, 'f', 1);
+        qDebug() << QString("   丢帧 %1，重同步 %2，丢弃字节 %3，保存 %4 帧")
+                    .arg(parser.framesDropped()).arg(parser.resyncCount())
+                    .arg(parser.droppedBytes()).arg(m_framesSaved);
+        qDebug().noquote() << m_tcpImg.latencyStats().summaryText();
+
+        if (!m_config.latencyExport.isEmpty()) {
+            QString error;
+            if (m_tcpImg.latencyStats().exportToFile(m_config.latencyExport, &error)) {
+                qDebug() << "📤 延迟统计已导出：" << m_config.latencyExport;
+            } else {
+                qDebug() << "❌ 延迟统计导出失败：" << error;
+            }
+        }
+
+        QCoreApplication::quit();
+    }
+
+private:
+    QString protocolName() const
+    {
+        switch (m_config.protocol) {
+        case CFrameParser::PROTOCOL_RAW:    return "原始数据";
+        case CFrameParser::PROTOCOL_HEADER: return "7E 7E帧头（含扩展帧头）";
+        case CFrameParser::PROTOCOL_AUTO:
+        default:                            return "自动识别";
+        }
+    }
+
+    ReceiverConfig m_config;
+    CTCPImg m_tcpImg;
+    QTimer m_statsTimer;
+    QTimer m_signalPoll;
+    QElapsedTimer m_clock;
+    QElapsedTimer m_intervalClock;
+    qint64 m_framesSaved;
+
+    // 上次统计时的累计值
+    qint64 m_lastFrames;
+    qint64 m_lastBytes;
+    qint64 m_lastDropped;
+    qint64 m_lastResyncs;
+    qint64 m_lastStalls;
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("tcpimg-recv");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("无界面图像接收端：接收图像数据流并输出统计");
+    parser.addHelpOption();
+
+    QCommandLineOption addressOption(QStringList() << "a" << "address", "服务器地址（默认127.0.0.1）", "address", "127.0.0.1");
+    QCommandLineOption portOption(QStringList() << "p" << "port", "服务器端口（默认8080）", "port", "8080");
+    QCommandLineOption widthOption(QStringList() << "W" << "width", "图像宽度", "pixels", QString::number(WIDTH));
+    QCommandLineOption heightOption(QStringList() << "H" << "height", "图像高度", "pixels", QString::number(HEIGHT));
+    QCommandLineOption channelsOption(QStringList() << "c" << "channels", "通道数", "count", QString::number(CHANLE));
+    QCommandLineOption protocolOption("protocol", "传输协议：auto | raw | 7e | ext（默认auto，7e和ext等价）", "name", "auto");
+    QCommandLineOption fixedGeometryOption("fixed-geometry", "不按扩展帧头中的几何自动切换分辨率，始终使用 -W/-H/-c");
+    QCommandLineOption framesOption(QStringList() << "n" << "frames", "接收帧数上限，0表示不限", "count", "0");
+    QCommandLineOption durationOption(QStringList() << "d" << "duration", "运行时长（秒），0表示不限", "seconds", "0");
+    QCommandLineOption statsOption("stats", "统计输出间隔（秒），0表示关闭", "seconds", "5");
+    QCommandLineOption reconnectOption("reconnect", "最大连续重连次数，0表示不重连，-1表示不限（默认-1）", "count", "-1");
+    QCommandLineOption reconnectMaxDelayOption("reconnect-max-delay", "重连等待时间上限，首次重连约50ms，之后逐次加倍（默认2000）", "ms", "2000");
+    QCommandLineOption connectTimeoutOption("connect-timeout", "单次连接超时（默认2000）", "ms", "2000");
+    QCommandLineOption backupOption("backup", "备用端点 IP:端口（可重复或用逗号分隔，按优先级）", "endpoint");
+    QCommandLineOption standbyOption("standby", "预先与备用端点建立连接，主链路断开时立即接管");
+    QCommandLineOption stallTimeoutOption("stall-timeout", "连接未断开但超过该时间未收到数据时判定停滞并重连，0表示不检测（默认0）", "ms", "0");
+    QCommandLineOption frameTimeoutOption("frame-timeout", "超过该时间未收到完整帧时判定停滞并重连，0表示不检测（默认0）", "ms", "0");
+    QCommandLineOption heartbeatOption("heartbeat", "向发送端发送心跳的间隔，0表示不发送（默认0）", "ms", "0");
+    QCommandLineOption saveDirOption("save-dir", "保存原始帧的目录（默认不保存）", "dir");
+    QCommandLineOption saveEveryOption("save-every", "每N帧保存一帧（默认100）", "frames", "100");
+    QCommandLineOption latencyOption("latency-export", "退出时导出延迟统计（.csv 或 .json）", "file");
+    QCommandLineOption metricsPortOption("metrics-port", "在本机指定端口提供Prometheus格式指标", "port");
+    QCommandLineOption shmRingOption("shm-ring", "把接收到的帧导出到指定名称的共享内存环（仅Unix）", "name");
+    QCommandLineOption shmSlotsOption("shm-slots", "共享内存环槽位数（默认8）", "count",
+                                      QString::number(CSharedFrameRing::DEFAULT_SLOTS));
+    QCommandLineOption relayPortOption("relay-port", "在指定端口把接收到的帧转发给多个下游客户端", "port");
+    QCommandLineOption relayQueueOption("relay-queue", "每个下游客户端最多排队的帧数（默认4）", "frames", "4");
+    QCommandLineOption relayPolicyOption("relay-policy", "下游客户端队列满时：drop | disconnect（默认drop）", "policy", "drop");
+    QCommandLineOption relayProtocolOption("relay-protocol", "转发协议：raw | 7e | ext（默认ext）", "protocol", "ext");
+
+    parser.addOption(addressOption);
+    parser.addOption(portOption);
+    parser.addOption(widthOption);
+    parser.addOption(heightOption);
+    parser.addOption(channelsOption);
+    parser.addOption(protocolOption);
+    parser.addOption(fixedGeometryOption);
+    parser.addOption(framesOption);
+    parser.addOption(durationOption);
+    parser.addOption(statsOption);
+    parser.addOption(reconnectOption);
+    parser.addOption(reconnectMaxDelayOption);
+    parser.addOption(connectTimeoutOption);
+    parser.addOption(backupOption);
+    parser.addOption(standbyOption);
+    parser.addOption(stallTimeoutOption);
+    parser.addOption(frameTimeoutOption);
+    parser.addOption(heartbeatOption);
+    parser.addOption(saveDirOption);
+    parser.addOption(saveEveryOption);
+    parser.addOption(latencyOption);
+    parser.addOption(metricsPortOption);
+    parser.addOption(shmRingOption);
+    parser.addOption(shmSlotsOption);
+    parser.addOption(relayPortOption);
+    parser.addOption(relayQueueOption);
+    parser.addOption(relayPolicyOption);
+    parser.addOption(relayProtocolOption);
+    parser.process(app);
+
+    ReceiverConfig config;
+    config.address = parser.value(addressOption);
+    config.port = quint16(parser.value(portOption).toUInt());
+    config.width = parser.value(widthOption).toInt();
+    config.height = parser.value(heightOption).toInt();
+    config.channels = parser.value(channelsOption).toInt();
+    config.frameLimit = parser.value(framesOption).toLongLong();
+    config.duration = parser.value(durationOption).toInt();
+    config.statsInterval = parser.value(statsOption).toInt();
+    config.reconnectAttempts = parser.value(reconnectOption).toInt();
+    config.reconnectMaxDelay = parser.value(reconnectMaxDelayOption).toInt();
+    config.connectTimeout = parser.value(connectTimeoutOption).toInt();
+    config.standby = parser.isSet(standbyOption);
+    config.stallTimeout = parser.value(stallTimeoutOption).toInt();
+    config.frameTimeout = parser.value(frameTimeoutOption).toInt();
+    config.heartbeatInterval = parser.value(heartbeatOption).toInt();
+    if (!CTCPImg::parseEndpoints(parser.values(backupOption).join(','), config.backups)) {
+        return 1;
+    }
+    config.saveDir = parser.value(saveDirOption);
+    config.saveEvery = parser.value(saveEveryOption).toInt();
+    config.latencyExport = parser.value(latencyOption);
+    config.autoGeometry = !parser.isSet(fixedGeometryOption);
+
+    const QString protocol = parser.value(protocolOption).toLower();
+    if (protocol == "raw") {
+        config.protocol = CFrameParser::PROTOCOL_RAW;
+    } else if (protocol == "7e" || protocol == "header" || protocol == "ext") {
+        config.protocol = CFrameParser::PROTOCOL_HEADER;
+    } else if (protocol == "auto") {
+        config.protocol = CFrameParser::PROTOCOL_AUTO;
+    } else {
+        qDebug() << "❌ 未知协议：" << protocol;
+        return 1;
+    }
+
+    if (config.port == 0 || config.width <= 0 || config.height <= 0 || config.channels <= 0) {
+        qDebug() << "❌ 参数无效：端口、分辨率和通道数必须为正数";
+        return 1;
+    }
+
+    CMetricsServer metricsServer;
+    if (parser.isSet(metricsPortOption)) {
+        const int port = parser.value(metricsPortOption).toInt();
+        if (port <= 0 || port > 65535 || !metricsServer.start(quint16(port))) {
+            qDebug() << "❌ 指标服务启动失败：" << parser.value(metricsPortOption);
+            return 1;
+        }
+    }
+
+    CHeadlessReceiver receiver(config);
+
+    if (parser.isSet(shmRingOption)
+        && !receiver.tcpImg().enableSharedFrameRing(parser.value(shmRingOption), parser.value(shmSlotsOption).toInt())) {
+        return 1;
+    }
+
+    if (parser.isSet(relayPortOption)) {
+        CFrameRelay::Config relayConfig;
+        const int port = parser.value(relayPortOption).toInt();
+        if (port <= 0 || port > 65535
+            || !CFrameRelay::parsePolicy(parser.value(relayPolicyOption), relayConfig.policy)
+            || !CFrameRelay::parseTransport(parser.value(relayProtocolOption), relayConfig.transport)) {
+            qDebug() << "❌ 帧转发参数无效";
+            return 1;
+        }
+        relayConfig.port = quint16(port);
+        relayConfig.maxQueueFrames = parser.value(relayQueueOption).toInt();
+        if (!receiver.tcpImg().enableFrameRelay(relayConfig)) {
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+
+    if (!receiver.start()) {
+        return 1;
+    }
+
+    return app.exec();
+}
+
+#include "tcpimg_recv.moc"
@@ -0,0 +1,785 @@
+/**
+ * @file tcpimg_sender.cpp
+ * @brief 本地合成图像发送端（负载生成器）
+ *
+ * 作为TCP服务器监听端口，向连接进来的接收端（CTCPImg 客户端）持续发送合成图像，
+ * 用于在任意Linux主机上对接收端进行功能验证和压力测试，无需真实相机服务器。
+ *
+ * 支持特性：
+ * - 可配置分辨率、通道数、帧率
+ * - 测试图案：灰度渐变（ramp）、随机噪声（noise）、移动竖条（bar）
+ * - 传输协议：原始数据、7E 7E 帧头、扩展帧头（带帧序号和发送时间戳）、size=握手
+ * - 精确帧间隔：按绝对时间表调度，落后时跳帧而非累积延迟
+ * - 帧率设为0时进入饱和模式，按套接字发送缓冲水位连续推送，压满回环带宽
+ * - 慢速客户端按积压上限丢帧，不会拖慢其他客户端
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QHash>
+#include <QList>
+#include <QDebug>
+#include <cstring>
+#include "sysdefine.h"
+#include "frameprotocol.h"
+
+/**
+ * @struct SenderConfig
+ * @brief 发送端运行参数
+ */
+struct SenderConfig
+{
+    QHostAddress bindAddress = QHostAddress::Any;
+    quint16 port = 8080;
+    int width = WIDTH;
+    int height = HEIGHT;
+    int channels = CHANLE;
+    double fps = 20.0;                    ///< 目标帧率，0表示饱和发送
+    QString pattern = "ramp";             ///< ramp / noise / bar
+    FrameProtocol::TransportMode transport = FrameProtocol::TRANSPORT_RAW;
+    qint64 frameLimit = 0;                ///< 发送帧数上限，0表示不限
+    int statsInterval = 5;                ///< 统计输出间隔（秒）
+    int maxBacklogFrames = 4;             ///< 单客户端最大积压帧数，超出则丢帧
+    int sendBufferSize = 4 * 1024 * 1024; ///< 套接字发送缓冲区大小
+    int heartbeatIntervalMs = 0;          ///< 空闲时发送心跳的间隔（毫秒），0表示不发送
+};
+
+/**
+ * @class CFrameSender
+ * @brief 合成图像发送服务器
+ */
+class CFrameSender : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CFrameSender(const SenderConfig &config, QObject *parent = nullptr)
+        : QObject(parent)
+        , m_config(config)
+        , m_frameSize(qint64(config.width) * config.height * config.channels)
+        , m_barPosition(-1)
+        , m_frameIndex(0)
+        , m_nextDeadlineNs(0)
+        , m_heartbeatSequence(0)
+        , m_heartbeatLastFrames(0)
+        , m_finished(false)
+    {
+        m_stats = Stats();
+        m_intervalStats = Stats();
+
+        m_pacingTimer.setTimerType(Qt::PreciseTimer);
+        m_pacingTimer.setSingleShot(true);
+        connect(&m_pacingTimer, &QTimer::timeout, this, &CFrameSender::onPacingTick);
+
+        connect(&m_statsTimer, &QTimer::timeout, this, &CFrameSender::printStats);
+        connect(&m_heartbeatTimer, &QTimer::timeout, this, &CFrameSender::onHeartbeatTick);
+        connect(&m_server, &QTcpServer::newConnection, this, &CFrameSender::onNewConnection);
+    }
+
+    /**
+     * @brief 准备图案数据并开始监听
+     * @return 监听成功返回true
+     */
+    bool start()
+    {
+        if (m_frameSize <= 0 || m_frameSize > FrameProtocol::MAX_PAYLOAD_SIZE) {
+            qDebug() << "❌ 无效的帧大小：" << m_frameSize << "字节";
+            return false;
+        }
+
+        preparePattern();
+
+        if (!m_server.listen(m_config.bindAddress, m_config.port)) {
+            qDebug() << "❌ 监听失败：" << m_server.errorString();
+            return false;
+        }
+
+        qDebug() << QString("📡 发送端已启动：%1:%2")
+                    .arg(m_config.bindAddress.toString()).arg(m_server.serverPort());
+        qDebug() << QString("🖼️  图像参数：%1×%2×%3，单帧 %4 字节 (%5 MB)")
+                    .arg(m_config.width).arg(m_config.height).arg(m_config.channels)
+                    .arg(m_frameSize).arg(m_frameSize / 1024.0 / 1024.0, 0, 'f', 2);
+        qDebug() << QString("⚙️  图案：%1，协议：%2，帧率：%3")
+                    .arg(m_config.pattern).arg(transportName())
+                    .arg(m_config.fps > 0 ? QString::number(m_config.fps) + " FPS" : QString("饱和模式"));
+
+        m_clock.start();
+        m_intervalClock.start();
+        if (m_config.statsInterval > 0) {
+            m_statsTimer.start(m_config.statsInterval * 1000);
+        }
+        if (m_config.heartbeatIntervalMs > 0) {
+            // 心跳插在帧边界，只有带帧头的协议能区分心跳和图像数据
+            if (m_config.transport == FrameProtocol::TRANSPORT_HEADER
+                || m_config.transport == FrameProtocol::TRANSPORT_EXTENDED) {
+                qDebug() << QString("💓 空闲心跳：每%1ms").arg(m_config.heartbeatIntervalMs);
+                m_heartbeatTimer.start(m_config.heartbeatIntervalMs);
+            } else {
+                qDebug() << "⚠️ 心跳只支持 7e 和 ext 协议，已忽略";
+            }
+        }
+        return true;
+    }
+
+private slots:
+    /**
+     * @brief 新客户端连接
+     */
+    void onNewConnection()
+    {
+        while (m_server.hasPendingConnections()) {
+            QTcpSocket *socket = m_server.nextPendingConnection();
+            socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+            socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, m_config.sendBufferSize);
+
+            ClientState state;
+            state.address = QString("%1:%2").arg(socket->peerAddress().toString()).arg(socket->peerPort());
+            m_clients.insert(socket, state);
+
+            connect(socket, &QTcpSocket::readyRead, this, &CFrameSender::onClientReadyRead);
+            connect(socket, &QTcpSocket::bytesWritten, this, &CFrameSender::onClientBytesWritten);
+            connect(socket, &QTcpSocket::disconnected, this, &CFrameSender::onClientDisconnected);
+
+            qDebug() << "🔗 客户端已连接：" << state.address << "当前客户端数：" << m_clients.size();
+
+            // 首个客户端接入时启动发送节拍
+            if (m_clients.size() == 1 && !m_finished) {
+                if (m_config.fps > 0) {
+                    m_nextDeadlineNs = m_clock.nsecsElapsed();
+                    scheduleNextTick();
+                } else {
+                    pumpClient(socket);
+                }
+            } else if (m_config.fps <= 0 && !m_finished) {
+                pumpClient(socket);
+            }
+        }
+    }
+
+    /**
+     * @brief 客户端断开连接
+     */
+    void onClientDisconnected()
+    {
+        QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+        if (!socket) {
+            return;
+        }
+
+        auto it = m_clients.find(socket);
+        if (it != m_clients.end()) {
+            qDebug() << QString("🔌 客户端断开：%1，已发送 %2 帧，丢弃 %3 帧")
+                        .arg(it->address).arg(it->framesSent).arg(it->framesDropped);
+            m_clients.erase(it);
+        }
+        socket->deleteLater();
+
+        if (m_clients.isEmpty()) {
+            m_pacingTimer.stop();
+            if (m_finished) {
+                finish();
+            }
+        }
+    }
+
+    /**
+     * @brief 处理接收端应答（"OK"）和心跳
+     */
+    void onClientReadyRead()
+    {
+        QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+        auto it = m_clients.find(socket);
+        if (it == m_clients.end()) {
+            return;
+        }
+
+        it->ackBuffer.append(socket->readAll());
+        const QByteArray ack = FrameProtocol::ackToken();
+        int pos = 0;
+        while (pos < it->ackBuffer.size()) {
+            const char *data = it->ackBuffer.constData() + pos;
+            const int available = it->ackBuffer.size() - pos;
+
+            // 接收端心跳：负载为0的扩展帧头，不完整时等待后续数据
+            if (static_cast<unsigned char>(data[0]) == FrameProtocol::SYNC_BYTE && available < 4) {
+                break;
+            }
+            if (FrameProtocol::hasExtendedMagic(data, available)) {
+                if (available < FrameProtocol::HEARTBEAT_SIZE) {
+                    break;
+                }
+                FrameProtocol::ExtendedHeader header;
+                if (FrameProtocol::readExtendedHeader(data, available, header) && header.payloadSize == 0) {
+                    pos += header.headerSize;
+                    it->heartbeatsReceived++;
+                } else {
+                    pos++;
+                }
+                continue;
+            }
+
+            if (available < ack.size()) {
+                break;
+            }
+            if (memcmp(data, ack.constData(), size_t(ack.size())) != 0) {
+                pos++;
+                continue;
+            }
+            pos += ack.size();
+            m_stats.acks++;
+            m_intervalStats.acks++;
+
+            if (m_config.transport != FrameProtocol::TRANSPORT_SIZE_COMMAND) {
+                continue;
+            }
+
+            // size=握手：第一个OK确认大小指令，第二个OK确认整帧
+            if (it->handshake == HANDSHAKE_WAIT_SIZE_ACK) {
+                it->handshake = HANDSHAKE_WAIT_FRAME_ACK;
+                socket->write(currentFramePointer(), m_frameSize);
+                m_stats.bytes += m_frameSize;
+                m_intervalStats.bytes += m_frameSize;
+            } else if (it->handshake == HANDSHAKE_WAIT_FRAME_ACK) {
+                it->handshake = HANDSHAKE_IDLE;
+                if (m_finished) {
+                    socket->disconnectFromHost();
+                    return;
+                }
+                if (m_config.fps <= 0) {
+                    pumpClient(socket);
+                }
+            }
+        }
+
+        // 只留下不完整的应答或心跳（不足一条消息的长度），缓冲不会增长
+        it->ackBuffer.remove(0, pos);
+    }
+
+    /**
+     * @brief 心跳节拍：上个周期没有发出任何帧时向空闲客户端发送心跳
+     *
+     * 发送缓冲中还有数据的客户端跳过，心跳总是落在帧边界
+     */
+    void onHeartbeatTick()
+    {
+        if (m_stats.frames != m_heartbeatLastFrames) {
+            m_heartbeatLastFrames = m_stats.frames;
+            return;
+        }
+
+        char heartbeat[FrameProtocol::HEARTBEAT_SIZE];
+        FrameProtocol::writeHeartbeat(heartbeat, ++m_heartbeatSequence, FrameProtocol::wallClockMicros());
+        for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+            if (it.key()->bytesToWrite() == 0) {
+                it.key()->write(heartbeat, sizeof(heartbeat));
+                m_stats.heartbeats++;
+                m_intervalStats.heartbeats++;
+            }
+        }
+    }
+
+    /**
+     * @brief 发送缓冲区排空进度（饱和模式下继续推送）
+     */
+    void onClientBytesWritten(qint64)
+    {
+        QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+        if (!socket) {
+            return;
+        }
+
+        if (m_finished) {
+            auto it = m_clients.constFind(socket);
+            if (socket->bytesToWrite() == 0
+                && (it == m_clients.constEnd() || it->handshake == HANDSHAKE_IDLE)) {
+                socket->disconnectFromHost();
+            }
+            return;
+        }
+
+        if (m_config.fps <= 0) {
+            pumpClient(socket);
+        }
+    }
+
+    /**
+     * @brief 定时发送节拍
+     *
+     * 按绝对时间表（起始时刻 + n × 帧周期）调度，定时器提前约1ms唤醒后自旋到截止时刻，
+     * 落后超过一个周期时跳过错过的帧并计数，避免误差累积
+     */
+    void onPacingTick()
+    {
+        const qint64 periodNs = qint64(1e9 / m_config.fps);
+
+        qint64 now = m_clock.nsecsElapsed();
+        while (now < m_nextDeadlineNs) {
+            now = m_clock.nsecsElapsed();
+        }
+
+        const qint64 lateNs = now - m_nextDeadlineNs;
+        if (lateNs >= periodNs) {
+            const qint64 missed = lateNs / periodNs;
+            m_stats.lateFrames += missed;
+            m_intervalStats.lateFrames += missed;
+            m_nextDeadlineNs += missed * periodNs;
+        }
+
+        const qint64 jitterUs = (now - m_nextDeadlineNs) / 1000;
+        m_intervalStats.jitterSumUs += jitterUs;
+        m_intervalStats.jitterSamples++;
+        if (jitterUs > m_intervalStats.jitterMaxUs) {
+            m_intervalStats.jitterMaxUs = jitterUs;
+        }
+
+        broadcastFrame();
+
+        m_nextDeadlineNs += periodNs;
+        if (!m_finished && !m_clients.isEmpty()) {
+            scheduleNextTick();
+        }
+    }
+
+    /**
+     * @brief 周期性输出发送统计
+     */
+    void printStats()
+    {
+        const double seconds = m_intervalClock.elapsed() / 1000.0;
+        if (seconds <= 0.0) {
+            return;
+        }
+
+        const double fps = m_intervalStats.frames / seconds;
+        const double mbps = m_intervalStats.bytes * 8.0 / seconds / 1000000.0;
+        const double avgJitterUs = m_intervalStats.jitterSamples > 0
+            ? double(m_intervalStats.jitterSumUs) / m_intervalStats.jitterSamples : 0.0;
+
+        qDebug() << "\n📈 === 发送统计 ===";
+        qDebug() << QString("🔗 客户端：%1").arg(m_clients.size());
+        qDebug() << QString("🖼️  帧率：%1 FPS（累计 %2 帧）").arg(fps, 0, 'f', 2).arg(m_stats.frames);
+        qDebug() << QString("🌐 带宽：%1 Mbps (%2 MB/s)")
+                    .arg(mbps, 0, 'f', 1).arg(mbps / 8.0, 0, 'f', 2);
+        qDebug() << QString("🗑️  积压丢帧：%1（累计 %2），落后跳帧：%3（累计 %4）")
+                    .arg(m_intervalStats.droppedFrames).arg(m_stats.droppedFrames)
+                    .arg(m_intervalStats.lateFrames).arg(m_stats.lateFrames);
+        qDebug() << QString("✅ 接收端应答：%1").arg(m_intervalStats.acks);
+        if (m_config.heartbeatIntervalMs > 0) {
+            qint64 received = 0;
+            for (const ClientState &client : m_clients) {
+                received += client.heartbeatsReceived;
+            }
+            qDebug() << QString("💓 心跳：发出 %1，收到接收端心跳累计 %2").arg(m_intervalStats.heartbeats).arg(received);
+        }
+        if (m_config.fps > 0) {
+            qDebug() << QString("⏱️  节拍抖动：平均 %1 µs，最大 %2 µs")
+                        .arg(avgJitterUs, 0, 'f', 1).arg(m_intervalStats.jitterMaxUs);
+        }
+        qDebug() << "==================\n";
+
+        m_intervalStats = Stats();
+        m_intervalClock.restart();
+    }
+
+private:
+    enum HandshakeState {
+        HANDSHAKE_IDLE,           ///< 可发送下一帧
+        HANDSHAKE_WAIT_SIZE_ACK,  ///< 已发送size=，等待OK
+        HANDSHAKE_WAIT_FRAME_ACK  ///< 已发送图像数据，等待OK
+    };
+
+    struct ClientState
+    {
+        QString address;
+        QByteArray ackBuffer;
+        HandshakeState handshake = HANDSHAKE_IDLE;
+        qint64 framesSent = 0;
+        qint64 framesDropped = 0;
+        qint64 heartbeatsReceived = 0;
+    };
+
+    struct Stats
+    {
+        qint64 frames = 0;
+        qint64 bytes = 0;
+        qint64 droppedFrames = 0;
+        qint64 lateFrames = 0;
+        qint64 acks = 0;
+        qint64 heartbeats = 0;
+        qint64 jitterSumUs = 0;
+        qint64 jitterSamples = 0;
+        qint64 jitterMaxUs = 0;
+    };
+
+    /**
+     * @brief 生成图案数据
+     *
+     * 渐变和噪声图案预先生成一块比单帧稍大的数据池，每帧只移动起始偏移，
+     * 不需要逐帧重新计算像素；移动竖条在单帧缓冲上原地擦除/绘制变化的列
+     */
+    void preparePattern()
+    {
+        if (m_config.pattern == "noise") {
+            // 额外64KB用于随机偏移，使相邻帧内容不同
+            m_pool.resize(int(m_frameSize + 65536));
+            QRandomGenerator *rng = QRandomGenerator::global();
+            quint32 *words = reinterpret_cast<quint32*>(m_pool.data());
+            const int wordCount = m_pool.size() / int(sizeof(quint32));
+            rng->fillRange(words, wordCount);
+        } else if (m_config.pattern == "bar") {
+            m_pool.fill(char(32), int(m_frameSize));
+            m_barPosition = -1;
+        } else {
+            // ramp：每行按列号递增，额外256个像素用于逐帧滚动
+            m_pool.resize(int(m_frameSize + 256 * m_config.channels));
+            char *dst = m_pool.data();
+            const qint64 pixels = m_pool.size() / m_config.channels;
+            for (qint64 p = 0; p < pixels; ++p) {
+                const char value = char(p & 0xFF);
+                for (int c = 0; c < m_config.channels; ++c) {
+                    *dst++ = value;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 推进图案到下一帧
+     */
+    void advancePattern()
+    {
+        if (m_config.pattern != "bar") {
+            return;
+        }
+
+        const int barWidth = qMax(1, m_config.width / 16);
+        const int step = qMax(1, m_config.width / 128);
+        const int oldPos = m_barPosition;
+        const int newPos = (oldPos < 0) ? 0 : (oldPos + step) % m_config.width;
+
+        paintBar(oldPos, barWidth, char(32));
+        paintBar(newPos, barWidth, char(255));
+        m_barPosition = newPos;
+    }
+
+    /**
+     * @brief 在单帧缓冲中绘制竖条
+     */
+    void paintBar(int position, int barWidth, char value)
+    {
+        if (position < 0) {
+            return;
+        }
+
+        const int rowBytes = m_config.width * m_config.channels;
+        const int endColumn = qMin(position + barWidth, m_config.width);
+        const int spanBytes = (endColumn - position) * m_config.channels;
+        char *row = m_pool.data() + position * m_config.channels;
+        for (int y = 0; y < m_config.height; ++y) {
+            memset(row, value, size_t(spanBytes));
+            row += rowBytes;
+        }
+    }
+
+    /**
+     * @brief 当前帧数据起始地址
+     */
+    const char* currentFramePointer() const
+    {
+        if (m_config.pattern == "noise") {
+            const qint64 slack = m_pool.size() - m_frameSize;
+            return m_pool.constData() + ((m_frameIndex * 4099) % slack);
+        }
+        if (m_config.pattern == "bar") {
+            return m_pool.constData();
+        }
+        return m_pool.constData() + (m_frameIndex % 256) * m_config.channels;
+    }
+
+    /**
+     * @brief 向单个客户端写出一帧
+     * @return 写出成功返回true，因积压或握手未完成而丢帧返回false
+     */
+    bool sendFrameTo(QTcpSocket *socket, ClientState &state)
+    {
+        const qint64 maxBacklog = m_frameSize * qMax(1, m_config.maxBacklogFrames);
+        if (socket->bytesToWrite() >= maxBacklog || state.handshake != HANDSHAKE_IDLE) {
+            state.framesDropped++;
+            m_stats.droppedFrames++;
+            m_intervalStats.droppedFrames++;
+            return false;
+        }
+
+        switch (m_config.transport) {
+        case FrameProtocol::TRANSPORT_HEADER: {
+            char header[FrameProtocol::LEGACY_HEADER_SIZE];
+            FrameProtocol::writeLegacyHeader(header, quint32(m_frameSize));
+            socket->write(header, sizeof(header));
+            socket->write(currentFramePointer(), m_frameSize);
+            m_stats.bytes += m_frameSize + FrameProtocol::LEGACY_HEADER_SIZE;
+            m_intervalStats.bytes += m_frameSize + FrameProtocol::LEGACY_HEADER_SIZE;
+            break;
+        }
+        case FrameProtocol::TRANSPORT_EXTENDED: {
+            // 帧序号按连接计数，接收端可据此发现丢帧；时间戳在写出前读取，用于端到端延迟统计
+            FrameProtocol::ExtendedHeader extHeader;
+            extHeader.sequence = quint64(state.framesSent);
+            extHeader.timestampUs = FrameProtocol::wallClockMicros();
+            extHeader.payloadSize = quint64(m_frameSize);
+            extHeader.width = quint32(m_config.width);
+            extHeader.height = quint32(m_config.height);
+            extHeader.channels = quint16(m_config.channels);
+            extHeader.bitsPerSample = 8;
+            char header[FrameProtocol::EXT_HEADER_SIZE];
+            FrameProtocol::writeExtendedHeader(header, extHeader);
+            socket->write(header, sizeof(header));
+            socket->write(currentFramePointer(), m_frameSize);
+            m_stats.bytes += m_frameSize + FrameProtocol::EXT_HEADER_SIZE;
+            m_intervalStats.bytes += m_frameSize + FrameProtocol::EXT_HEADER_SIZE;
+            break;
+        }
+        case FrameProtocol::TRANSPORT_SIZE_COMMAND:
+            // 图像数据在收到size=应答后由 onClientReadyRead 发送
+            socket->write(FrameProtocol::sizeCommandPrefix() + QByteArray::number(m_frameSize));
+            state.handshake = HANDSHAKE_WAIT_SIZE_ACK;
+            break;
+        case FrameProtocol::TRANSPORT_RAW:
+        default:
+            socket->write(currentFramePointer(), m_frameSize);
+            m_stats.bytes += m_frameSize;
+            m_intervalStats.bytes += m_frameSize;
+            break;
+        }
+
+        state.framesSent++;
+        return true;
+    }
+
+    /**
+     * @brief 定时模式：向所有客户端广播当前帧
+     */
+    void broadcastFrame()
+    {
+        if (m_clients.isEmpty()) {
+            return;
+        }
+
+        advancePattern();
+
+        bool delivered = false;
+        for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+            delivered |= sendFrameTo(it.key(), it.value());
+        }
+
+        if (delivered) {
+            onFrameDelivered();
+        }
+    }
+
+    /**
+     * @brief 饱和模式：发送缓冲低于水位时持续推送
+     *
+     * 保持约两帧数据在Qt发送缓冲中，既能让内核发送缓冲持续有数据，
+     * 又不会让用户态缓冲无限增长
+     */
+    void pumpClient(QTcpSocket *socket)
+    {
+        auto it = m_clients.find(socket);
+        if (it == m_clients.end()) {
+            return;
+        }
+
+        const qint64 lowWater = m_frameSize * qBound(1, m_config.maxBacklogFrames, 2);
+        while (!m_finished
+               && it->handshake == HANDSHAKE_IDLE
+               && socket->bytesToWrite() < lowWater) {
+            advancePattern();
+            if (!sendFrameTo(socket, it.value())) {
+                break;
+            }
+            onFrameDelivered();
+        }
+    }
+
+    /**
+     * @brief 单帧发送完成后的计数与结束判断
+     */
+    void onFrameDelivered()
+    {
+        m_frameIndex++;
+        m_stats.frames++;
+        m_intervalStats.frames++;
+
+        if (m_config.frameLimit > 0 && m_stats.frames >= m_config.frameLimit) {
+            m_finished = true;
+            m_pacingTimer.stop();
+            m_heartbeatTimer.stop();
+            qDebug() << "🏁 已达到发送帧数上限：" << m_config.frameLimit;
+
+            // 等待剩余数据发送完毕后断开，所有客户端断开后退出
+            // 先收集再断开：disconnectFromHost 可能同步触发 disconnected 并修改 m_clients
+            QList<QTcpSocket*> idleSockets;
+            for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+                if (it.key()->bytesToWrite() == 0 && it->handshake == HANDSHAKE_IDLE) {
+                    idleSockets.append(it.key());
+                }
+            }
+            for (QTcpSocket *socket : idleSockets) {
+                socket->disconnectFromHost();
+            }
+        }
+    }
+
+    /**
+     * @brief 调度下一次节拍，提前约1ms唤醒
+     */
+    void scheduleNextTick()
+    {
+        const qint64 remainingNs = m_nextDeadlineNs - m_clock.nsecsElapsed();
+        const int delayMs = int(qMax<qint64>(0, remainingNs / 1000000 - 1));
+        m_pacingTimer.start(delayMs);
+    }
+
+    /**
+     * @brief 输出最终统计并退出
+     */
+    void finish()
+    {
+        printStats();
+        qDebug() << QString("🎉 发送完成：共 %1 帧，%2 MB")
+                    .arg(m_stats.frames).arg(m_stats.bytes / 1024.0 / 1024.0, 0, 'f', 2);
+        QCoreApplication::quit();
+    }
+
+    QString transportName() const
+    {
+        switch (m_config.transport) {
+        case FrameProtocol::TRANSPORT_HEADER:       return "7E 7E 帧头";
+        case FrameProtocol::TRANSPORT_EXTENDED:     return "扩展帧头";
+        case FrameProtocol::TRANSPORT_SIZE_COMMAND: return "size=握手";
+        case FrameProtocol::TRANSPORT_RAW:
+        default:                                    return "原始数据";
+        }
+    }
+
+private:
+    SenderConfig m_config;
+    qint64 m_frameSize;
+
+    QTcpServer m_server;
+    QHash<QTcpSocket*, ClientState> m_clients;
+
+    QByteArray m_pool;        ///< 图案数据池
+    int m_barPosition;        ///< 竖条当前位置（列）
+    qint64 m_frameIndex;
+
+    QElapsedTimer m_clock;
+    QTimer m_pacingTimer;
+    qint64 m_nextDeadlineNs;  ///< 下一帧的绝对发送时刻
+
+    QTimer m_statsTimer;
+    QElapsedTimer m_intervalClock;
+    Stats m_stats;
+    Stats m_intervalStats;
+
+    QTimer m_heartbeatTimer;
+    quint64 m_heartbeatSequence;
+    qint64 m_heartbeatLastFrames;  ///< 上次心跳节拍时的累计帧数
+
+    bool m_finished;
+};
+
+/**
+ * @brief 主函数
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("tcpimg-sender");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("合成图像发送端：为TCP图像接收端提供测试数据流");
+    parser.addHelpOption();
+
+    QCommandLineOption portOption(QStringList() << "p" << "port", "监听端口（默认8080）", "port", "8080");
+    QCommandLineOption bindOption("bind", "监听地址（默认所有地址）", "address", "0.0.0.0");
+    QCommandLineOption widthOption(QStringList() << "W" << "width", "图像宽度", "pixels", QString::number(WIDTH));
+    QCommandLineOption heightOption(QStringList() << "H" << "height", "图像高度", "pixels", QString::number(HEIGHT));
+    QCommandLineOption channelsOption(QStringList() << "c" << "channels", "通道数", "count", QString::number(CHANLE));
+    QCommandLineOption fpsOption(QStringList() << "f" << "fps", "帧率，0表示饱和发送（默认20）", "fps", "20");
+    QCommandLineOption patternOption("pattern", "测试图案：ramp | noise | bar（默认ramp）", "name", "ramp");
+    QCommandLineOption protocolOption("protocol", "传输协议：raw | 7e | ext | size（默认raw）", "name", "raw");
+    QCommandLineOption framesOption(QStringList() << "n" << "frames", "发送帧数上限，0表示不限", "count", "0");
+    QCommandLineOption statsOption("stats", "统计输出间隔（秒），0表示关闭", "seconds", "5");
+    QCommandLineOption backlogOption("max-backlog", "单客户端最大积压帧数（默认4）", "frames", "4");
+    QCommandLineOption heartbeatOption("heartbeat", "没有帧可发时发送心跳的间隔，0表示不发送（默认0，仅7e/ext协议）", "ms", "0");
+    QCommandLineOption sndbufOption("sndbuf", "套接字发送缓冲区大小（KB，默认4096）", "kb", "4096");
+
+    parser.addOption(portOption);
+    parser.addOption(bindOption);
+    parser.addOption(widthOption);
+    parser.addOption(heightOption);
+    parser.addOption(channelsOption);
+    parser.addOption(fpsOption);
+    parser.addOption(patternOption);
+    parser.addOption(protocolOption);
+    parser.addOption(framesOption);
+    parser.addOption(statsOption);
+    parser.addOption(backlogOption);
+    parser.addOption(sndbufOption);
+    parser.addOption(heartbeatOption);
+    parser.process(app);
+
+    SenderConfig config;
+    config.bindAddress = QHostAddress(parser.value(bindOption));
+    config.port = quint16(parser.value(portOption).toUInt());
+    config.width = parser.value(widthOption).toInt();
+    config.height = parser.value(heightOption).toInt();
+    config.channels = parser.value(channelsOption).toInt();
+    config.fps = parser.value(fpsOption).toDouble();
+    config.pattern = parser.value(patternOption).toLower();
+    config.frameLimit = parser.value(framesOption).toLongLong();
+    config.statsInterval = parser.value(statsOption).toInt();
+    config.maxBacklogFrames = parser.value(backlogOption).toInt();
+    config.sendBufferSize = parser.value(sndbufOption).toInt() * 1024;
+    config.heartbeatIntervalMs = parser.value(heartbeatOption).toInt();
+
+    const QString protocol = parser.value(protocolOption).toLower();
+    if (protocol == "7e" || protocol == "header") {
+        config.transport = FrameProtocol::TRANSPORT_HEADER;
+    } else if (protocol == "ext") {
+        config.transport = FrameProtocol::TRANSPORT_EXTENDED;
+    } else if (protocol == "size") {
+        config.transport = FrameProtocol::TRANSPORT_SIZE_COMMAND;
+    } else if (protocol == "raw") {
+        config.transport = FrameProtocol::TRANSPORT_RAW;
+    } else {
+        qDebug() << "❌ 未知协议：" << protocol;
+        return 1;
+    }
+
+    if (config.pattern != "ramp" && config.pattern != "noise" && config.pattern != "bar") {
+        qDebug() << "❌ 未知图案：" << config.pattern;
+        return 1;
+    }
+
+    if (config.width <= 0 || config.height <= 0 || config.channels <= 0 || config.fps < 0) {
+        qDebug() << "❌ 参数无效：分辨率和通道数必须为正数，帧率不能为负";
+        return 1;
+    }
+
+    CFrameSender sender(config);
+    if (!sender.start()) {
+        return 1;
+    }
+
+    return app.exec();
+}
+
+#include "tcpimg_sender.moc"
@@ -0,0 +1,372 @@
+/**
+ * @file test_frameparser.cpp
+ * @brief CFrameParser 数据流解析回归测试
+ *
+ * 覆盖原始数据、7E 7E 帧头、扩展帧头（版本1/2）、心跳、size=指令、重同步，
+ * 以及旧版16位长度字段的帧大小推断。各用例按小块或逐字节输入，检查跨数据段的状态保持
+ */
+
+#include <QtTest>
+#include <QByteArray>
+#include <QVector>
+#include "frameparser.h"
+#include "frameprotocol.h"
+
+/**
+ * @brief 收集解析器发射的信号
+ */
+struct ParserSink
+{
+    QVector<QByteArray> frames;
+    QVector<CFrameParser::FrameInfo> infos;
+    QVector<int> dropped;
+    QVector<int> sizeCommands;
+    QVector<quint64> heartbeats;
+
+    explicit ParserSink(CFrameParser& parser)
+    {
+        QObject::connect(&parser, &CFrameParser::frameReady,
+                         [this](const QByteArray& payload, const CFrameParser::FrameInfo& info) {
+            frames.append(payload);
+            infos.append(info);
+        });
+        QObject::connect(&parser, &CFrameParser::frameDropped, [this](int size) { dropped.append(size); });
+        QObject::connect(&parser, &CFrameParser::sizeCommandReceived, [this](int size) { sizeCommands.append(size); });
+        QObject::connect(&parser, &CFrameParser::heartbeatReceived,
+                         [this](quint64 sequence, qint64) { heartbeats.append(sequence); });
+    }
+};
+
+/**
+ * @brief 生成测试图像数据（0x20-0x5F，不含同步字节）
+ */
+static QByteArray makePayload(int size, int seed)
+{
+    QByteArray payload(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        payload[i] = char(0x20 + (seed * 31 + i) % 0x40);
+    }
+    return payload;
+}
+
+static QByteArray makeHeaderFrame(const QByteArray& payload)
+{
+    QByteArray frame(FrameProtocol::LEGACY_HEADER_SIZE, Qt::Uninitialized);
+    FrameProtocol::writeLegacyHeader(frame.data(), quint32(payload.size()));
+    return frame + payload;
+}
+
+static QByteArray makeExtendedFrame(const QByteArray& payload, const FrameProtocol::ExtendedHeader& fields)
+{
+    FrameProtocol::ExtendedHeader header = fields;
+    header.payloadSize = quint64(payload.size());
+    QByteArray frame(header.headerSize, Qt::Uninitialized);
+    FrameProtocol::writeExtendedHeader(frame.data(), header);
+    return frame + payload;
+}
+
+/**
+ * @brief 旧版6字节帧头：7E 7E + 4个任意字节
+ */
+static QByteArray legacyHeader(uchar b2, uchar b3, uchar b4, uchar b5)
+{
+    QByteArray header;
+    header.append(char(FrameProtocol::SYNC_BYTE)).append(char(FrameProtocol::SYNC_BYTE));
+    header.append(char(b2)).append(char(b3)).append(char(b4)).append(char(b5));
+    return header;
+}
+
+static void feedInChunks(CFrameParser& parser, const QByteArray& stream, int chunkSize)
+{
+    for (int offset = 0; offset < stream.size(); offset += chunkSize) {
+        parser.feed(stream.constData() + offset, qMin(chunkSize, stream.size() - offset));
+    }
+}
+
+class TestFrameParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rawFrames();
+    void headerFrames();
+    void extendedHeaderV1();
+    void extendedHeaderV2Geometry();
+    void extendedHeaderGeometrySwitch();
+    void heartbeat();
+    void sizeCommandSplitAcrossReads();
+    void sizeCommandWithTerminator();
+    void resyncAfterGarbage();
+    void parseFrameSizeCandidates();
+    void legacyLengthPadAndTruncate();
+    void legacyLengthWithSyncByteInHeader();
+};
+
+/**
+ * @brief 原始数据：每 expectedPayloadSize 字节一帧
+ */
+void TestFrameParser::rawFrames()
+{
+    CFrameParser parser;
+    ParserSink sink(parser);
+    parser.setExpectedPayloadSize(64);
+
+    QByteArray stream;
+    for (int f = 0; f < 3; ++f) {
+        stream.append(makePayload(64, f));
+    }
+    feedInChunks(parser, stream, 7);
+
+    QCOMPARE(parser.protocolMode(), CFrameParser::PROTOCOL_RAW);
+    QCOMPARE(sink.frames.size(), 3);
+    for (int f = 0; f < 3; ++f) {
+        QCOMPARE(sink.frames[f], makePayload(64, f));
+        QVERIFY(!sink.infos[f].hasExtendedHeader);
+    }
+    QCOMPARE(parser.droppedBytes(), qint64(0));
+}
+
+/**
+ * @brief 7E 7E 帧头（32位负载长度），逐字节输入
+ */
+void TestFrameParser::headerFrames()
+{
+    CFrameParser parser;
+    ParserSink sink(parser);
+    parser.setExpectedPayloadSize(64);
+
+    const QByteArray stream = makeHeaderFrame(makePayload(64, 1)) + makeHeaderFrame(makePayload(64, 2));
+    feedInChunks(parser, stream, 1);
+
+    QCOMPARE(parser.protocolMode(), CFrameParser::PROTOCOL_HEADER);
+    QCOMPARE(sink.frames.size(), 2);
+    QCOMPARE(sink.frames[0], makePayload(64, 1));
+    QCOMPARE(sink.frames[1], makePayload(64, 2));
+    QCOMPARE(parser.resyncCount(), qint64(0));
+}
+
+/**
+ * @brief 版本1扩展帧头（32字节）：帧序号和时间戳，没有几何
+ */
+void TestFrameParser::extendedHeaderV1()
+{
+    CFrameParser parser;
+    ParserSink sink(parser);
+    parser.setExpectedPayloadSize(64);
+
+    FrameProtocol::ExtendedHeader header;
+    header.headerSize = FrameProtocol::EXT_HEADER_MIN_SIZE;
+    header.version = 1;
+    header.sequence = 41;
+    header.timestampUs = 1700000000000000LL;
+    feedInChunks(parser, makeExtendedFrame(makePayload(64, 3), header), 5);
+
+    QCOMPARE(sink.frames.size(), 1);
+    QCOMPARE(sink.frames[0], makePayload(64, 3));
+    QVERIFY(sink.infos[0].hasExtendedHeader);
+    QCOMPARE(sink.infos[0].sequence, quint64(41));
+    QCOMPARE(sink.infos[0].senderTimestampUs, qint64(1700000000000000LL));
+    QVERIFY(!sink.infos[0].hasGeometry());
+}
+
+/**
+ * @brief 版本2扩展帧头：携带与负载一致的几何
+ */
+void TestFrameParser::extendedHeaderV2Geometry()
+{
+    CFrameParser parser;
+    ParserSink sink(parser);
+    parser.setExpectedPayloadSize(64);
+
+    FrameProtocol::ExtendedHeader header;
+    header.sequence = 7;
+    header.width = 8;
+    header.height = 4;
+    header.channels = 2;
+    header.bitsPerSample = 8;
+    feedInChunks(parser, makeExtendedFrame(makePayload(64, 4), header), 13);
+
+    QCOMPARE(sink.frames.size(), 1);
+    QCOMPARE(sink.infos[0].sequence, quint64(7));
+    QVERIFY(sink.infos[0].hasGeometry());
+    QCOMPARE(sink.infos[0].width, 8);
+    QCOMPARE(sink.infos[0].height, 4);
+    QCOMPARE(sink.infos[0].channels, 2);
+}
+
+/**
+ * @brief 帧头几何与期望大小不同：开启自动识别时切换大小，关闭时丢弃
+ */
+void TestFrameParser::extendedHeaderGeometrySwitch()
+{
+    FrameProtocol::ExtendedHeader header;
+    header.width = 4;
+    header.height = 4;
+    header.channels = 1;
+    header.bitsPerSample = 8;
+    const QByteArray stream = makeExtendedFrame(makePayload(16, 5), header);
+
+    CFrameParser parser;
+    ParserSink sink(parser);
+    parser.setExpectedPayloadSize(64);
+    parser.feed(stream);
+    QCOMPARE(parser.expectedPayloadSize(), qint64(16));
+    QCOMPARE(sink.frames.size(), 1);
+    QCOMPARE(sink.frames[0], makePayload(16, 5));
+
+    CFrameParser fixed;
+    ParserSink fixedSink(fixed);
+    fixed.setExpectedPayloadSize(64);
+    fixed.setAutoGeometry(false);
+    fixed.feed(stream);
+    QCOMPARE(fixed.expectedPayloadSize(), qint64(64));
+    QCOMPARE(fixedSink.frames.size(), 0);
+    QCOMPARE(fixedSink.dropped, QVector<int>() << 16);
+}
+
+/**
+ * @brief 心跳：不计入帧，之后的帧照常接收
+ */
+void TestFrameParser::heartbeat()
+{
+    CFrameParser parser;
+    ParserSink sink(parser);
+    parser.setExpectedPayloadSize(64);
+
+    QByteArray heartbeat(FrameProtocol::HEARTBEAT_SIZE, Qt::Uninitialized);
+    FrameProtocol::writeHeartbeat(heartbeat.data(), 9, 123456);
+    feedInChunks(parser, heartbeat + makeHeaderFrame(makePayload(64, 6)), 3);
+
+    QCOMPARE(sink.heartbeats, QVector<quint64>() << 9);
+    QCOMPARE(parser.heartbeatsReceived(), qint64(1));
+    QCOMPARE(sink.frames.size(), 1);
+    QCOMPARE(sink.frames[0], makePayload(64, 6));
+}
+
+/**
+ * @brief size=指令的数字分在两次读取中：不能在第一段结尾就结束指令
+ */
+void TestFrameParser::sizeCommandSplitAcrossReads()
+{
+    CFrameParser parser;
+    ParserSink sink(parser);
+    parser.setExpectedPayloadSize(64);
+
+    parser.feed(QByteArray("size=1"));
+    QVERIFY(parser.sizeCommandPending());
+    parser.feed(QByteArray("6"));
+    QVERIFY(parser.sizeCommandPending());
+    QVERIFY(sink.sizeCommands.isEmpty());
+
+    // 发送端等待应答，接收端空闲后结束指令
+    parser.flushSizeCommand();
+    QCOMPARE(sink.sizeCommands, QVector<int>() << 16);
+    QCOMPARE(parser.expectedPayloadSize(), qint64(16));
+
+    parser.feed(makePayload(16, 7));
+    QCOMPARE(sink.frames.size(), 1);
+    QCOMPARE(sink.frames[0], makePayload(16, 7));
+}
+
+/**
+ * @brief size=指令以换行结束，图像数据紧随其后
+ */
+void TestFrameParser::sizeCommandWithTerminator()
+{
+    CFrameParser parser;
+    ParserSink sink(parser);
+    parser.setExpectedPayloadSize(64);
+
+    parser.feed(QByteArray("size=32\r\n") + makePayload(32, 8));
+    QCOMPARE(sink.sizeCommands, QVector<int>() << 32);
+    QVERIFY(!parser.sizeCommandPending());
+    QCOMPARE(sink.frames.size(), 1);
+    QCOMPARE(sink.frames[0], makePayload(32, 8));
+}
+
+/**
+ * @brief 帧之间的垃圾数据：重同步一次，丢弃的字节数等于垃圾长度
+ */
+void TestFrameParser::resyncAfterGarbage()
+{
+    CFrameParser parser;
+    ParserSink sink(parser);
+    parser.setExpectedPayloadSize(64);
+
+    QByteArray garbage(40, char(0x5A));
+    garbage[5] = char(FrameProtocol::SYNC_BYTE);
+    const QByteArray stream = makeHeaderFrame(makePayload(64, 9)) + garbage + makeHeaderFrame(makePayload(64, 10));
+    feedInChunks(parser, stream, 11);
+
+    QCOMPARE(sink.frames.size(), 2);
+    QCOMPARE(sink.frames[1], makePayload(64, 10));
+    QCOMPARE(parser.resyncCount(), qint64(1));
+    QCOMPARE(parser.droppedBytes(), qint64(garbage.size()));
+}
+
+/**
+ * @brief 帧大小推断：32位负载长度、旧版16位字段的三种位置、都不符合时按期望大小
+ */
+void TestFrameParser::parseFrameSizeCandidates()
+{
+    const int expected = 1000;  // 0x03E8
+
+    // 32位大端负载长度
+    QCOMPARE(CFrameParser::parseFrameSize(legacyHeader(0x00, 0x00, 0x03, 0xE8).constData(), expected), 1006);
+    // 16位字段等于期望大小：负载长度
+    QCOMPARE(CFrameParser::parseFrameSize(legacyHeader(0x12, 0x34, 0x03, 0xE8).constData(), expected), 1006);
+    // 字节2-3大端：整帧长度1002
+    QCOMPARE(CFrameParser::parseFrameSize(legacyHeader(0x03, 0xEA, 0x00, 0x00).constData(), expected), 1002);
+    // 字节4-5小端：整帧长度1008
+    QCOMPARE(CFrameParser::parseFrameSize(legacyHeader(0x00, 0x00, 0xF0, 0x03).constData(), expected), 1008);
+    // 超出容差：按期望大小
+    QCOMPARE(CFrameParser::parseFrameSize(legacyHeader(0x04, 0x4D, 0x00, 0x00).constData(), expected), 1006);
+    QCOMPARE(CFrameParser::parseFrameSize(legacyHeader(0xFF, 0xFF, 0xFF, 0xFF).constData(), expected), 1006);
+}
+
+/**
+ * @brief 旧版16位整帧长度与期望大小相近：负载不足补零、多余截断，下一帧不受影响
+ */
+void TestFrameParser::legacyLengthPadAndTruncate()
+{
+    CFrameParser parser;
+    ParserSink sink(parser);
+    parser.setExpectedPayloadSize(1000);
+
+    const QByteArray shortPayload = makePayload(996, 11);     // 整帧1002
+    const QByteArray longPayload = makePayload(1004, 12);     // 整帧1010
+    const QByteArray stream = legacyHeader(0x03, 0xEA, 0x00, 0x00) + shortPayload
+                            + legacyHeader(0x03, 0xF2, 0x00, 0x00) + longPayload
+                            + makeHeaderFrame(makePayload(1000, 13));
+    feedInChunks(parser, stream, 97);
+
+    QCOMPARE(sink.frames.size(), 3);
+    QCOMPARE(sink.frames[0].size(), 1000);
+    QCOMPARE(sink.frames[0].left(996), shortPayload);
+    QCOMPARE(sink.frames[0].mid(996), QByteArray(4, '\0'));
+    QCOMPARE(sink.frames[1], longPayload.left(1000));
+    QCOMPARE(sink.frames[2], makePayload(1000, 13));
+    QCOMPARE(parser.droppedBytes(), qint64(4));
+    QCOMPARE(parser.resyncCount(), qint64(0));
+}
+
+/**
+ * @brief 旧版字节2-3长度的高字节恰好为 0x7E：仍是有效帧头，不能当作多余的同步字节
+ */
+void TestFrameParser::legacyLengthWithSyncByteInHeader()
+{
+    const int expected = 32266;     // 整帧 32272 = 0x7E10
+    CFrameParser parser;
+    ParserSink sink(parser);
+    parser.setExpectedPayloadSize(expected);
+
+    const QByteArray payload = makePayload(expected, 14);
+    feedInChunks(parser, legacyHeader(0x7E, 0x10, 0x00, 0x00) + payload, 4096);
+
+    QCOMPARE(sink.frames.size(), 1);
+    QCOMPARE(sink.frames[0], payload);
+    QCOMPARE(parser.resyncCount(), qint64(0));
+}
+
+QTEST_GUILESS_MAIN(TestFrameParser)
+#include "test_frameparser.moc"
@@ -0,0 +1,417 @@
+/**
+ * @file test_pcapcapture.cpp
+ * @brief CPcapWriter / CPcapReader 抓包文件回归测试
+ *
+ * 写入端生成的文件由读取端读回，检查负载、方向、地址和时间戳；另外直接解析文件中的
+ * 增强包块，检查合成的IP/TCP头（序号、确认号、标志、IPv4校验和）。
+ * 手工构造的 pcapng 文件覆盖 if_tsresol 的换算和超出范围的精度
+ */
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QVector>
+#include <QtEndian>
+#include <cstring>
+#include "pcapcapture.h"
+
+/**
+ * @brief 文件中的一个增强包块
+ */
+struct RawPacket
+{
+    quint64 timestamp = 0;
+    quint32 flags = 0;          ///< epb_flags：1入站 2出站
+    QByteArray data;            ///< 裸IP包
+};
+
+/**
+ * @brief 按顺序取出小端 pcapng 文件中的所有增强包块
+ */
+static QVector<RawPacket> readRawPackets(const QString& fileName)
+{
+    QVector<RawPacket> packets;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return packets;
+    }
+    const QByteArray content = file.readAll();
+    const char* data = content.constData();
+
+    int offset = 0;
+    while (offset + 12 <= content.size()) {
+        const quint32 type = qFromLittleEndian<quint32>(data + offset);
+        const int length = int(qFromLittleEndian<quint32>(data + offset + 4));
+        if (length < 12 || offset + length > content.size()) {
+            break;
+        }
+        if (type == 6) {
+            const char* body = data + offset + 8;
+            const int captured = int(qFromLittleEndian<quint32>(body + 12));
+            RawPacket packet;
+            packet.timestamp = (quint64(qFromLittleEndian<quint32>(body + 4)) << 32)
+                             | qFromLittleEndian<quint32>(body + 8);
+            packet.data = QByteArray(body + 20, captured);
+            // 写入端的第一个选项总是 epb_flags
+            const char* option = body + 20 + ((captured + 3) & ~3);
+            if (qFromLittleEndian<quint16>(option) == 2) {
+                packet.flags = qFromLittleEndian<quint32>(option + 4);
+            }
+            packets.append(packet);
+        }
+        offset += length;
+    }
+    return packets;
+}
+
+static CPcapWriter::Flow makeFlow(const QString& local, quint16 localPort, const QString& peer, quint16 peerPort)
+{
+    CPcapWriter::Flow flow;
+    flow.localAddress = QHostAddress(local);
+    flow.localPort = localPort;
+    flow.peerAddress = QHostAddress(peer);
+    flow.peerPort = peerPort;
+    flow.key = QString("%1:%2-%3:%4").arg(local).arg(localPort).arg(peer).arg(peerPort).toUtf8();
+    return flow;
+}
+
+static quint32 tcpSeq(const QByteArray& ip, int ipHeader)
+{
+    return qFromBigEndian<quint32>(ip.constData() + ipHeader + 4);
+}
+
+static quint32 tcpAck(const QByteArray& ip, int ipHeader)
+{
+    return qFromBigEndian<quint32>(ip.constData() + ipHeader + 8);
+}
+
+static quint8 tcpFlags(const QByteArray& ip, int ipHeader)
+{
+    return quint8(ip[ipHeader + 13]);
+}
+
+/**
+ * @brief 包含校验和字段的IPv4头求和，结果为0表示校验和正确
+ */
+static quint16 ipv4ChecksumResidue(const QByteArray& ip)
+{
+    const uchar* header = reinterpret_cast<const uchar*>(ip.constData());
+    quint32 sum = 0;
+    for (int i = 0; i < 20; i += 2) {
+        sum += quint32(header[i] << 8 | header[i + 1]);
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return quint16(~sum);
+}
+
+/**
+ * @brief 追加一个 pcapng 选项（小端，按4字节对齐）
+ */
+static void appendOption(QByteArray& body, quint16 code, const QByteArray& value)
+{
+    char header[4];
+    qToLittleEndian<quint16>(code, header);
+    qToLittleEndian<quint16>(quint16(value.size()), header + 2);
+    body.append(header, 4);
+    body.append(value);
+    body.append(QByteArray((4 - value.size() % 4) % 4, '\0'));
+}
+
+static QByteArray makeBlock(quint32 type, const QByteArray& body)
+{
+    const int length = body.size() + 12;
+    QByteArray block(length, Qt::Uninitialized);
+    qToLittleEndian<quint32>(type, block.data());
+    qToLittleEndian<quint32>(quint32(length), block.data() + 4);
+    memcpy(block.data() + 8, body.constData(), size_t(body.size()));
+    qToLittleEndian<quint32>(quint32(length), block.data() + length - 4);
+    return block;
+}
+
+/**
+ * @brief 手工构造的 pcapng：一个裸IP接口（指定 if_tsresol），一个带负载的TCP包
+ */
+static QByteArray makePcapng(quint8 resolution, quint64 timestamp, const QByteArray& payload)
+{
+    QByteArray section(16, '\0');
+    qToLittleEndian<quint32>(0x1A2B3C4D, section.data());
+    qToLittleEndian<quint16>(1, section.data() + 4);
+    qToLittleEndian<quint64>(~quint64(0), section.data() + 8);
+    appendOption(section, 0, QByteArray());
+
+    QByteArray description(8, '\0');
+    qToLittleEndian<quint16>(quint16(CPcapWriter::LINKTYPE_RAW), description.data());
+    appendOption(description, 9, QByteArray(1, char(resolution)));
+    appendOption(description, 0, QByteArray());
+
+    // IPv4 10.0.0.1:1000 -> 10.0.0.2:2000（读取端不检查校验和）
+    QByteArray ip(40, '\0');
+    uchar* header = reinterpret_cast<uchar*>(ip.data());
+    header[0] = 0x45;
+    qToBigEndian<quint16>(quint16(40 + payload.size()), header + 2);
+    header[8] = 64;
+    header[9] = 6;
+    qToBigEndian<quint32>(0x0A000001, header + 12);
+    qToBigEndian<quint32>(0x0A000002, header + 16);
+    qToBigEndian<quint16>(1000, header + 20);
+    qToBigEndian<quint16>(2000, header + 22);
+    header[32] = 5 << 4;
+    header[33] = 0x18;
+    ip.append(payload);
+
+    QByteArray packet(20, '\0');
+    qToLittleEndian<quint32>(quint32(timestamp >> 32), packet.data() + 4);
+    qToLittleEndian<quint32>(quint32(timestamp), packet.data() + 8);
+    qToLittleEndian<quint32>(quint32(ip.size()), packet.data() + 12);
+    qToLittleEndian<quint32>(quint32(ip.size()), packet.data() + 16);
+    packet.append(ip);
+    packet.append(QByteArray((4 - ip.size() % 4) % 4, '\0'));
+    appendOption(packet, 0, QByteArray());
+
+    return makeBlock(0x0A0D0D0A, section) + makeBlock(1, description) + makeBlock(6, packet);
+}
+
+static bool writeFile(const QString& fileName, const QByteArray& content)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+}
+
+class TestPcapCapture : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTripIPv4();
+    void roundTripIPv6();
+    void tsresolTimestamps_data();
+    void tsresolTimestamps();
+    void tsresolOutOfRange_data();
+    void tsresolOutOfRange();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+/**
+ * @brief IPv4连接（本机为客户端）：握手、双向数据（含超过单个分段的数据）、FIN
+ */
+void TestPcapCapture::roundTripIPv4()
+{
+    QVERIFY(m_dir.isValid());
+    const QString fileName = m_dir.filePath("ipv4.pcapng");
+    const CPcapWriter::Flow flow = makeFlow("192.168.1.10", 50000, "192.168.1.20", 8080);
+    const QByteArray hello("hello");
+    QByteArray image(CPcapWriter::SEGMENT_SIZE + 5000, Qt::Uninitialized);
+    for (int i = 0; i < image.size(); ++i) {
+        image[i] = char(i * 7);
+    }
+
+    const qint64 startUs = QDateTime::currentMSecsSinceEpoch() * 1000;
+    {
+        CPcapWriter writer;
+        QString error;
+        QVERIFY2(writer.open(fileName, &error), qPrintable(error));
+        writer.openFlow(flow, true);
+        writer.record(flow, CPcapWriter::DIRECTION_OUTBOUND, hello);
+        writer.record(flow, CPcapWriter::DIRECTION_INBOUND, image);
+        writer.closeFlow(flow);
+
+        const CPcapWriter::Stats stats = writer.stats();
+        QCOMPARE(stats.packets, qint64(2));
+        QCOMPARE(stats.payloadBytes, qint64(hello.size() + image.size()));
+        QCOMPARE(stats.dropped, qint64(0));
+        writer.close();
+        QCOMPARE(QFileInfo(fileName).size(), writer.stats().fileBytes);
+    }
+    const qint64 endUs = QDateTime::currentMSecsSinceEpoch() * 1000 + 1000;
+
+    // 读取端：握手和FIN没有负载，只读出三段数据
+    CPcapReader reader;
+    QString error;
+    QVERIFY2(reader.open(fileName, &error), qPrintable(error));
+
+    CPcapReader::Packet packet;
+    QVERIFY(reader.readNext(packet));
+    QCOMPARE(packet.payload, hello);
+    QCOMPARE(packet.direction, CPcapWriter::DIRECTION_OUTBOUND);
+    QCOMPARE(packet.source, QString("192.168.1.10:50000"));
+    QCOMPARE(packet.destination, QString("192.168.1.20:8080"));
+    QVERIFY(!packet.udp);
+    QVERIFY(packet.timestampUs >= startUs && packet.timestampUs <= endUs);
+    qint64 previousUs = packet.timestampUs;
+
+    QByteArray received;
+    for (int i = 0; i < 2; ++i) {
+        QVERIFY(reader.readNext(packet));
+        QCOMPARE(packet.direction, CPcapWriter::DIRECTION_INBOUND);
+        QCOMPARE(packet.source, QString("192.168.1.20:8080"));
+        QCOMPARE(packet.destination, QString("192.168.1.10:50000"));
+        QVERIFY(packet.timestampUs >= previousUs && packet.timestampUs <= endUs);
+        previousUs = packet.timestampUs;
+        received.append(packet.payload);
+    }
+    QCOMPARE(received, image);
+    QVERIFY(!reader.readNext(packet));
+    QVERIFY(reader.errorString().isEmpty());
+    QCOMPARE(reader.packetsRead(), qint64(9));
+    QCOMPARE(reader.packetsSkipped(), qint64(6));
+
+    // 合成的头：SYN/FIN各占一个序号，确认号为对方的下一个序号
+    const QVector<RawPacket> raw = readRawPackets(fileName);
+    QCOMPARE(raw.size(), 9);
+    struct Expected { quint32 flags; quint8 tcp; quint32 seq; quint32 ack; int payload; };
+    const Expected expected[] = {
+        { 2, 0x02, 0, 0, 0 },                                           // SYN
+        { 1, 0x12, 0, 1, 0 },                                           // SYN+ACK
+        { 2, 0x10, 1, 1, 0 },                                           // ACK
+        { 2, 0x18, 1, 1, hello.size() },                                // hello
+        { 1, 0x18, 1, 6, CPcapWriter::SEGMENT_SIZE },                   // 图像第一段
+        { 1, 0x18, quint32(1 + CPcapWriter::SEGMENT_SIZE), 6, 5000 },   // 图像第二段
+        { 2, 0x11, 6, quint32(1 + image.size()), 0 },                   // FIN
+        { 1, 0x11, quint32(1 + image.size()), 7, 0 },                   // FIN
+        { 2, 0x10, 7, quint32(2 + image.size()), 0 },                   // ACK
+    };
+    for (int i = 0; i < raw.size(); ++i) {
+        const QByteArray& ip = raw[i].data;
+        const bool inbound = (expected[i].flags == 1);
+        QCOMPARE(raw[i].flags, expected[i].flags);
+        QCOMPARE(ip.size(), 40 + expected[i].payload);
+        QCOMPARE(quint8(ip[0]), quint8(0x45));
+        QCOMPARE(qFromBigEndian<quint16>(ip.constData() + 2), quint16(ip.size()));
+        QCOMPARE(qFromBigEndian<quint16>(ip.constData() + 4), quint16(i));     // IP标识逐包递增
+        QCOMPARE(quint8(ip[9]), quint8(6));
+        QCOMPARE(ipv4ChecksumResidue(ip), quint16(0));
+        QCOMPARE(qFromBigEndian<quint32>(ip.constData() + 12), inbound ? 0xC0A80114u : 0xC0A8010Au);
+        QCOMPARE(qFromBigEndian<quint16>(ip.constData() + 20), quint16(inbound ? 8080 : 50000));
+        QCOMPARE(tcpFlags(ip, 20), expected[i].tcp);
+        QCOMPARE(tcpSeq(ip, 20), expected[i].seq);
+        QCOMPARE(tcpAck(ip, 20), expected[i].ack);
+        QVERIFY(qint64(raw[i].timestamp) >= startUs && qint64(raw[i].timestamp) <= endUs);
+    }
+}
+
+/**
+ * @brief IPv6连接（本机为服务器）：对端先发SYN，关闭文件前没有FIN
+ */
+void TestPcapCapture::roundTripIPv6()
+{
+    QVERIFY(m_dir.isValid());
+    const QString fileName = m_dir.filePath("ipv6.pcapng");
+    const CPcapWriter::Flow flow = makeFlow("2001:db8::1", 7000, "2001:db8::2", 40000);
+    {
+        CPcapWriter writer;
+        QString error;
+        QVERIFY2(writer.open(fileName, &error), qPrintable(error));
+        writer.openFlow(flow, false);
+        writer.record(flow, CPcapWriter::DIRECTION_INBOUND, QByteArray("ping"));
+        writer.record(flow, CPcapWriter::DIRECTION_OUTBOUND, QByteArray("pong!"));
+        writer.close();
+    }
+
+    CPcapReader reader;
+    QString error;
+    QVERIFY2(reader.open(fileName, &error), qPrintable(error));
+    CPcapReader::Packet packet;
+    QVERIFY(reader.readNext(packet));
+    QCOMPARE(packet.payload, QByteArray("ping"));
+    QCOMPARE(packet.direction, CPcapWriter::DIRECTION_INBOUND);
+    QCOMPARE(packet.source, QString("[2001:db8::2]:40000"));
+    QCOMPARE(packet.destination, QString("[2001:db8::1]:7000"));
+    QVERIFY(reader.readNext(packet));
+    QCOMPARE(packet.payload, QByteArray("pong!"));
+    QCOMPARE(packet.direction, CPcapWriter::DIRECTION_OUTBOUND);
+    QCOMPARE(packet.source, QString("[2001:db8::1]:7000"));
+    QVERIFY(!reader.readNext(packet));
+    QVERIFY(reader.errorString().isEmpty());
+
+    const QVector<RawPacket> raw = readRawPackets(fileName);
+    QCOMPARE(raw.size(), 5);
+    QCOMPARE(raw[0].flags, quint32(1));
+    QCOMPARE(tcpFlags(raw[0].data, 40), quint8(0x02));
+    QCOMPARE(raw[1].flags, quint32(2));
+    QCOMPARE(tcpFlags(raw[1].data, 40), quint8(0x12));
+    for (const RawPacket& p : raw) {
+        QCOMPARE(quint8(p.data[0]) >> 4, 6);
+        QCOMPARE(int(qFromBigEndian<quint16>(p.data.constData() + 4)), p.data.size() - 40);
+        QCOMPARE(quint8(p.data[6]), quint8(6));
+    }
+    QCOMPARE(tcpSeq(raw[3].data, 40), quint32(1));          // ping
+    QCOMPARE(tcpSeq(raw[4].data, 40), quint32(1));          // pong!
+    QCOMPARE(tcpAck(raw[4].data, 40), quint32(5));
+}
+
+void TestPcapCapture::tsresolTimestamps_data()
+{
+    QTest::addColumn<int>("resolution");
+    QTest::addColumn<quint64>("timestamp");
+    QTest::addColumn<qint64>("expectedUs");
+
+    QTest::newRow("10^-6") << 6 << Q_UINT64_C(1700000000123456) << Q_INT64_C(1700000000123456);
+    QTest::newRow("10^-9") << 9 << Q_UINT64_C(1700000000123456789) << Q_INT64_C(1700000000123456);
+    QTest::newRow("10^-3") << 3 << Q_UINT64_C(1700000000123) << Q_INT64_C(1700000000123000);
+    QTest::newRow("10^-19") << 19 << Q_UINT64_C(10000000000000000000) << Q_INT64_C(1000000);
+    QTest::newRow("2^-20") << (0x80 | 20)
+                           << ((Q_UINT64_C(1700000000) << 20) | (Q_UINT64_C(1) << 19))
+                           << Q_INT64_C(1700000000500000);
+}
+
+/**
+ * @brief if_tsresol 的十进制和二进制精度换算为微秒
+ */
+void TestPcapCapture::tsresolTimestamps()
+{
+    QFETCH(int, resolution);
+    QFETCH(quint64, timestamp);
+    QFETCH(qint64, expectedUs);
+
+    QVERIFY(m_dir.isValid());
+    const QString fileName = m_dir.filePath("tsresol.pcapng");
+    QVERIFY(writeFile(fileName, makePcapng(quint8(resolution), timestamp, QByteArray("data"))));
+
+    CPcapReader reader;
+    QString error;
+    QVERIFY2(reader.open(fileName, &error), qPrintable(error));
+    CPcapReader::Packet packet;
+    QVERIFY2(reader.readNext(packet), qPrintable(reader.errorString()));
+    QCOMPARE(packet.timestampUs, expectedUs);
+    QCOMPARE(packet.payload, QByteArray("data"));
+    QCOMPARE(packet.source, QString("10.0.0.1:1000"));
+    QCOMPARE(packet.direction, CPcapWriter::DIRECTION_UNKNOWN);
+}
+
+void TestPcapCapture::tsresolOutOfRange_data()
+{
+    QTest::addColumn<int>("resolution");
+
+    QTest::newRow("10^-20") << 20;
+    QTest::newRow("10^-127") << 0x7F;
+    QTest::newRow("2^-64") << (0x80 | 64);
+}
+
+/**
+ * @brief 超出64位换算范围的 if_tsresol：停止读取并报错，不产生错误的时间戳
+ */
+void TestPcapCapture::tsresolOutOfRange()
+{
+    QFETCH(int, resolution);
+
+    QVERIFY(m_dir.isValid());
+    const QString fileName = m_dir.filePath("tsresol_invalid.pcapng");
+    QVERIFY(writeFile(fileName, makePcapng(quint8(resolution), 1, QByteArray("data"))));
+
+    CPcapReader reader;
+    QString error;
+    QVERIFY2(reader.open(fileName, &error), qPrintable(error));
+    CPcapReader::Packet packet;
+    QVERIFY(!reader.readNext(packet));
+    QVERIFY(!reader.errorString().isEmpty());
+    QCOMPARE(reader.packetsRead(), qint64(0));
+}
+
+QTEST_GUILESS_MAIN(TestPcapCapture)
+#include "test_pcapcapture.moc"
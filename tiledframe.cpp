@@ -0,0 +1,93 @@
+#include "tiledframe.h"
+#include "imageconverter.h"
+
+/**
+ * @brief CTiledFrame构造函数
+ */
+CTiledFrame::CTiledFrame()
+    : m_width(0)
+    , m_height(0)
+    , m_channels(0)
+    , m_columns(0)
+    , m_rows(0)
+    , m_generation(0)
+    , m_tilesConverted(0)
+{
+}
+
+/**
+ * @brief 设置新帧，已转换的分块失效
+ */
+bool CTiledFrame::setFrame(const QByteArray &data, int width, int height, int channels)
+{
+    if (width <= 0 || height <= 0 || channels <= 0 || data.size() < qint64(width) * height * channels) {
+        clear();
+        return false;
+    }
+
+    if (width != m_width || height != m_height || channels != m_channels) {
+        m_width = width;
+        m_height = height;
+        m_channels = channels;
+        m_columns = (width + TILE_SIZE - 1) / TILE_SIZE;
+        m_rows = (height + TILE_SIZE - 1) / TILE_SIZE;
+        m_tiles = QVector<Tile>(m_columns * m_rows);
+    }
+
+    m_data = data;
+    m_generation++;
+    return true;
+}
+
+/**
+ * @brief 清空并释放分块缓冲
+ */
+void CTiledFrame::clear()
+{
+    m_data = QByteArray();
+    m_width = m_height = m_channels = 0;
+    m_columns = m_rows = 0;
+    m_tiles = QVector<Tile>();
+}
+
+/**
+ * @brief 分块在原图中的区域
+ */
+QRect CTiledFrame::tileRect(int column, int row) const
+{
+    return QRect(column * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE) & QRect(0, 0, m_width, m_height);
+}
+
+/**
+ * @brief 获取分块图像，当前帧尚未转换时先转换
+ */
+const QImage& CTiledFrame::tile(int column, int row, double scale)
+{
+    Tile &tile = m_tiles[row * m_columns + column];
+
+    if (tile.generation != m_generation) {
+        // 先释放金字塔对旧内容的引用，转换才能直接写入原缓冲
+        tile.pyramid.setBase(QImage());
+        if (!CImageConverter::convertRegion(m_data.constData(), m_width, m_height, m_channels,
+                                            tileRect(column, row), tile.image)) {
+            tile.image = QImage();
+        }
+        tile.pyramid.setBase(tile.image);
+        tile.generation = m_generation;
+        m_tilesConverted++;
+    }
+
+    return tile.pyramid.level(tile.pyramid.levelForScale(scale));
+}
+
+/**
+ * @brief 转换整帧
+ */
+QImage CTiledFrame::toImage() const
+{
+    QImage image;
+    if (!isNull()) {
+        CImageConverter::convertToDisplayImage(m_data.constData(), m_width, m_height, m_channels, image);
+    }
+    return image;
+}
@@ -0,0 +1,87 @@
+#ifndef TILEDFRAME_H
+#define TILEDFRAME_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QVector>
+#include "imagescaler.h"
+
+/**
+ * @class CTiledFrame
+ * @brief 按分块转换的大帧
+ *
+ * 保存一帧原始数据（共享引用，不拷贝），把图像划分为 TILE_SIZE×TILE_SIZE 的分块，
+ * 某一分块第一次被绘制时才从原始数据转换，缩小显示时再按需生成该分块的金字塔层。
+ * 平移、缩放只处理可见区域内的分块；新帧到达时只标记失效，分块缓冲在帧间复用。
+ */
+class CTiledFrame
+{
+public:
+    static const int TILE_SIZE = 512;   ///< 分块边长（像素）
+
+    CTiledFrame();
+
+    /**
+     * @brief 设置新帧，已转换的分块失效
+     * @param data 原始图像数据（宽度 × 高度 × 通道数字节）
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @param channels 通道数
+     * @return 数据不足一帧或参数无效时返回false，当前帧被清空
+     */
+    bool setFrame(const QByteArray &data, int width, int height, int channels);
+
+    /**
+     * @brief 清空并释放分块缓冲
+     */
+    void clear();
+
+    bool isNull() const { return m_data.isEmpty(); }
+    QSize size() const { return QSize(m_width, m_height); }
+    int columns() const { return m_columns; }
+    int rows() const { return m_rows; }
+
+    /**
+     * @brief 分块在原图中的区域（右侧、底部的分块可能不足 TILE_SIZE）
+     */
+    QRect tileRect(int column, int row) const;
+
+    /**
+     * @brief 获取分块图像，当前帧尚未转换时先转换
+     * @param column 分块列号
+     * @param row 分块行号
+     * @param scale 显示缩放比例，<1时返回该分块对应的金字塔层
+     */
+    const QImage& tile(int column, int row, double scale = 1.0);
+
+    /**
+     * @brief 转换整帧（保存图像等需要完整图像时使用）
+     */
+    QImage toImage() const;
+
+    /**
+     * @brief 累计转换的分块数
+     */
+    quint64 tilesConverted() const { return m_tilesConverted; }
+
+private:
+    struct Tile {
+        QImage image;           ///< 第0层
+        CImagePyramid pyramid;  ///< 缩小显示用的各层
+        quint64 generation;     ///< 转换时的帧序号
+
+        Tile() : generation(0) {}
+    };
+
+    QByteArray m_data;          ///< 当前帧原始数据
+    int m_width;
+    int m_height;
+    int m_channels;
+    int m_columns;
+    int m_rows;
+    quint64 m_generation;       ///< 当前帧序号（从1开始）
+    quint64 m_tilesConverted;
+    QVector<Tile> m_tiles;
+};
+
+#endif // TILEDFRAME_H
@@ -0,0 +1,757 @@
+#include "trafficgenerator.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QNetworkProxy>
+#include <QtEndian>
+#include <QDateTime>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+const quint32 TRAFFIC_MAGIC = 0x4E454754;   // "TGEN"（小端）
+const char TRAFFIC_MAGIC_BYTES[] = "TGEN";
+
+/**
+ * @brief CRC-32 查表（多项式 0xEDB88320）
+ */
+struct Crc32Table
+{
+    quint32 entries[256];
+
+    Crc32Table()
+    {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : (crc >> 1);
+            }
+            entries[i] = crc;
+        }
+    }
+};
+
+} // namespace
+
+/**
+ * @brief 累加另一份校验结果
+ */
+CTrafficVerifier::Result& CTrafficVerifier::Result::operator+=(const Result& other)
+{
+    packets += other.packets;
+    bytes += other.bytes;
+    lostPackets += other.lostPackets;
+    reorderedPackets += other.reorderedPackets;
+    checksumErrors += other.checksumErrors;
+    framingErrors += other.framingErrors;
+    return *this;
+}
+
+/**
+ * @brief 减去另一份校验结果（用于按基线计算增量）
+ */
+CTrafficVerifier::Result& CTrafficVerifier::Result::operator-=(const Result& other)
+{
+    packets -= other.packets;
+    bytes -= other.bytes;
+    lostPackets -= other.lostPackets;
+    reorderedPackets -= other.reorderedPackets;
+    checksumErrors -= other.checksumErrors;
+    framingErrors -= other.framingErrors;
+    return *this;
+}
+
+/**
+ * @brief 输入收到的数据
+ * @param data 任意分段的数据
+ */
+void CTrafficVerifier::feed(const QByteArray& data)
+{
+    m_buffer.append(data);
+
+    const char* base = m_buffer.constData();
+    const int size = m_buffer.size();
+    int pos = 0;
+    while (size - pos >= HEADER_SIZE) {
+        const uchar* header = reinterpret_cast<const uchar*>(base + pos);
+        const quint32 length = qFromLittleEndian<quint32>(header + 16);
+        if (qFromLittleEndian<quint32>(header) != TRAFFIC_MAGIC || length > MAX_PAYLOAD) {
+            if (m_synced) {
+                m_result.framingErrors++;
+                m_synced = false;
+            }
+            // 向后搜索下一个帧头；找不到时保留末尾可能是半个帧头的3字节
+            const int next = m_buffer.indexOf(TRAFFIC_MAGIC_BYTES, pos + 1);
+            pos = (next >= 0) ? next : qMax(pos + 1, size - 3);
+            continue;
+        }
+        if (size - pos - HEADER_SIZE < int(length)) {
+            break;
+        }
+
+        const char* payload = base + pos + HEADER_SIZE;
+        if (crc32(payload, int(length)) != qFromLittleEndian<quint32>(header + 20)) {
+            if (!m_synced) {
+                // 对齐前在数据中误认的帧头，继续搜索
+                pos += 1;
+                continue;
+            }
+            m_result.checksumErrors++;
+        } else {
+            m_synced = true;
+            m_result.packets++;
+            m_result.bytes += length;
+
+            const quint32 stream = qFromLittleEndian<quint32>(header + 4);
+            const quint64 sequence = qFromLittleEndian<quint64>(header + 8);
+            QHash<quint32, quint64>::iterator it = m_nextSequence.find(stream);
+            if (it == m_nextSequence.end()) {
+                m_nextSequence.insert(stream, sequence + 1);
+            } else if (sequence >= *it) {
+                m_result.lostPackets += qint64(sequence - *it);
+                *it = sequence + 1;
+            } else {
+                m_result.reorderedPackets++;
+            }
+        }
+        pos += HEADER_SIZE + int(length);
+    }
+
+    m_buffer.remove(0, pos);
+}
+
+/**
+ * @brief 清空状态和结果
+ */
+void CTrafficVerifier::reset()
+{
+    m_buffer.clear();
+    m_nextSequence.clear();
+    m_synced = false;
+    m_result = Result();
+}
+
+/**
+ * @brief CRC-32
+ * @param data 数据
+ * @param size 字节数
+ */
+quint32 CTrafficVerifier::crc32(const char* data, int size)
+{
+    static const Crc32Table table;
+
+    quint32 crc = 0xFFFFFFFFu;
+    const uchar* bytes = reinterpret_cast<const uchar*>(data);
+    for (int i = 0; i < size; ++i) {
+        crc = table.entries[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief 写入帧头
+ */
+void CTrafficVerifier::writeHeader(char* out, quint32 stream, quint64 sequence, quint32 length, quint32 crc)
+{
+    uchar* header = reinterpret_cast<uchar*>(out);
+    qToLittleEndian<quint32>(TRAFFIC_MAGIC, header);
+    qToLittleEndian<quint32>(stream, header + 4);
+    qToLittleEndian<quint64>(sequence, header + 8);
+    qToLittleEndian<quint32>(length, header + 16);
+    qToLittleEndian<quint32>(crc, header + 20);
+}
+
+/**
+ * @brief CTrafficGenerator构造函数
+ * @param parent 父对象指针
+ */
+CTrafficGenerator::CTrafficGenerator(QObject *parent)
+    : QObject(parent)
+    , m_thread(new QThread(this))
+    , m_worker(new CTrafficGeneratorWorker())
+    , m_running(false)
+{
+    qRegisterMetaType<CTrafficGenerator::Config>();
+    qRegisterMetaType<CTrafficGenerator::Stats>();
+
+    m_thread->setObjectName("tcpimg-traffic");
+    m_worker->moveToThread(m_thread);
+    connect(m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &CTrafficGeneratorWorker::progress, this, &CTrafficGenerator::onWorkerProgress);
+    connect(m_worker, &CTrafficGeneratorWorker::finished, this, &CTrafficGenerator::onWorkerFinished);
+    m_thread->start();
+}
+
+/**
+ * @brief 析构函数：停止工作线程（连接随工作对象一起释放）
+ */
+CTrafficGenerator::~CTrafficGenerator()
+{
+    m_thread->quit();
+    m_thread->wait();
+}
+
+/**
+ * @brief 开始发送
+ * @param config 配置
+ * @return 配置有效返回true
+ */
+bool CTrafficGenerator::start(const Config& config)
+{
+    if (m_running) {
+        m_errorString = "流量发生器正在运行";
+        return false;
+    }
+    if (config.host.isEmpty() || config.port == 0) {
+        m_errorString = "目标地址无效";
+        return false;
+    }
+    if (config.connections < 1 || config.connections > MAX_CONNECTIONS) {
+        m_errorString = QString("连接数应在 1-%1 之间").arg(MAX_CONNECTIONS);
+        return false;
+    }
+    if (config.packetSize < 1 || config.packetSize > MAX_PACKET_SIZE) {
+        m_errorString = QString("包大小应在 1-%1 字节之间").arg(MAX_PACKET_SIZE);
+        return false;
+    }
+    if (config.payload == PAYLOAD_FIXED && config.fixedData.isEmpty()) {
+        m_errorString = "固定内容为空";
+        return false;
+    }
+    if (config.payload == PAYLOAD_FILE) {
+        const QFileInfo info(config.filePath);
+        if (!info.isFile() || !info.isReadable() || info.size() == 0) {
+            m_errorString = QString("无法读取文件：%1").arg(config.filePath);
+            return false;
+        }
+        if (info.size() > MAX_FILE_BYTES) {
+            m_errorString = QString("文件超过 %1 MB").arg(MAX_FILE_BYTES / (1024 * 1024));
+            return false;
+        }
+    }
+
+    m_errorString.clear();
+    m_running = true;
+    m_stats = Stats();
+    m_stats.running = true;
+    QMetaObject::invokeMethod(m_worker, "start", Qt::QueuedConnection,
+                              Q_ARG(CTrafficGenerator::Config, config));
+    return true;
+}
+
+/**
+ * @brief 停止发送
+ */
+void CTrafficGenerator::stop()
+{
+    if (m_running) {
+        QMetaObject::invokeMethod(m_worker, "stop", Qt::QueuedConnection);
+    }
+}
+
+/**
+ * @brief 格式化统计信息
+ * @param stats 统计
+ */
+QString CTrafficGenerator::formatStats(const Stats& stats)
+{
+    QString text;
+    text += QString("连接：%1 个活动").arg(stats.activeConnections);
+    if (stats.failedConnections > 0) {
+        text += QString("，%1 个失败").arg(stats.failedConnections);
+    }
+    text += QString("\n已发送：%1 包，%2 MB，用时 %3 秒\n")
+            .arg(stats.packetsSent)
+            .arg(stats.bytesSent / (1024.0 * 1024.0), 0, 'f', 2)
+            .arg(stats.elapsedMs / 1000.0, 0, 'f', 1);
+    text += QString("吞吐量：平均 %1 Mbps，当前 %2 Mbps")
+            .arg(stats.throughputBps * 8 / 1e6, 0, 'f', 2)
+            .arg(stats.currentBps * 8 / 1e6, 0, 'f', 2);
+    if (stats.bytesReceived > 0) {
+        text += QString("\n回显：%1 字节，%2 包").arg(stats.bytesReceived).arg(stats.echo.packets);
+        if (!stats.echo.isClean()) {
+            text += QString("，丢失 %1，乱序 %2，校验错 %3，帧错 %4")
+                    .arg(stats.echo.lostPackets).arg(stats.echo.reorderedPackets)
+                    .arg(stats.echo.checksumErrors).arg(stats.echo.framingErrors);
+        }
+    }
+    if (!stats.error.isEmpty()) {
+        text += QString("\n结束原因：%1").arg(stats.error);
+    }
+    return text;
+}
+
+/**
+ * @brief 工作线程的周期统计
+ */
+void CTrafficGenerator::onWorkerProgress(const CTrafficGenerator::Stats& stats)
+{
+    m_stats = stats;
+    emit progress(stats);
+}
+
+/**
+ * @brief 工作线程发送结束
+ */
+void CTrafficGenerator::onWorkerFinished(const CTrafficGenerator::Stats& stats)
+{
+    m_stats = stats;
+    m_running = false;
+    qDebug() << QString("🏁 流量发生器结束：%1 包，%2 MB，平均 %3 Mbps")
+                .arg(stats.packetsSent)
+                .arg(stats.bytesSent / (1024.0 * 1024.0), 0, 'f', 2)
+                .arg(stats.throughputBps * 8 / 1e6, 0, 'f', 2);
+    emit finished(stats);
+}
+
+/**
+ * @brief CTrafficGeneratorWorker构造函数
+ * @param parent 父对象指针
+ */
+CTrafficGeneratorWorker::CTrafficGeneratorWorker(QObject *parent)
+    : QObject(parent)
+    , m_nextConnection(0)
+    , m_pacingTimer(this)
+    , m_statsTimer(this)
+    , m_drainTimer(this)
+    , m_lastPacingNs(0)
+    , m_tokens(0.0)
+    , m_lastStatsBytes(0)
+    , m_lastStatsMs(0)
+    , m_stopping(false)
+    , m_finishedEmitted(true)
+    , m_bytesSent(0)
+    , m_packetsSent(0)
+    , m_bytesReceived(0)
+    , m_failedConnections(0)
+    , m_currentBps(0.0)
+{
+    CMetricsRegistry& registry = CMetricsRegistry::instance();
+    m_metricBytesSent = registry.counter("tcpimg_traffic_bytes_sent_total", "流量发生器发送字节数");
+    m_metricPacketsSent = registry.counter("tcpimg_traffic_packets_sent_total", "流量发生器发送包数");
+
+    m_pacingTimer.setTimerType(Qt::PreciseTimer);
+    m_pacingTimer.setInterval(PACING_INTERVAL_MS);
+    connect(&m_pacingTimer, &QTimer::timeout, this, &CTrafficGeneratorWorker::onPacingTick);
+
+    m_statsTimer.setInterval(CTrafficGenerator::STATS_INTERVAL_MS);
+    connect(&m_statsTimer, &QTimer::timeout, this, &CTrafficGeneratorWorker::publishStats);
+
+    // 对端不再读取时不无限等待：超时后直接断开
+    m_drainTimer.setSingleShot(true);
+    connect(&m_drainTimer, &QTimer::timeout, this, [this]() {
+        for (Connection& connection : m_connections) {
+            connection.socket->abort();
+        }
+        checkFinished();
+    });
+}
+
+/**
+ * @brief 开始发送
+ * @param config 配置（已由 CTrafficGenerator 检查）
+ */
+void CTrafficGeneratorWorker::start(const CTrafficGenerator::Config& config)
+{
+    m_config = config;
+    for (Connection& connection : m_connections) {
+        connection.socket->disconnect(this);
+        connection.socket->deleteLater();
+    }
+    m_connections.clear();
+    m_socketIndex.clear();
+    m_nextConnection = 0;
+    m_tokens = 0.0;
+    m_lastStatsBytes = 0;
+    m_lastStatsMs = 0;
+    m_stopping = false;
+    m_finishedEmitted = false;
+    m_bytesSent = 0;
+    m_packetsSent = 0;
+    m_bytesReceived = 0;
+    m_failedConnections = 0;
+    m_currentBps = 0.0;
+    m_finishReason.clear();
+    m_clock.start();
+
+    const QString error = buildPayloads();
+    if (!error.isEmpty()) {
+        m_stopping = true;
+        m_finishReason = error;
+        checkFinished();
+        return;
+    }
+
+    qDebug() << QString("🚀 流量发生器：%1:%2，%3 个连接，包大小 %4 字节，%5，持续 %6")
+                .arg(m_config.host).arg(m_config.port).arg(m_config.connections).arg(m_config.packetSize)
+                .arg(m_config.rateBytesPerSec > 0
+                     ? QString("%1 Mbps").arg(m_config.rateBytesPerSec * 8 / 1e6, 0, 'f', 2)
+                     : QString("不限速"))
+                .arg(m_config.durationSec > 0 ? QString("%1 秒").arg(m_config.durationSec) : QString("直到停止"));
+
+    m_connections.resize(m_config.connections);
+    for (int i = 0; i < m_connections.size(); ++i) {
+        QTcpSocket* socket = new QTcpSocket(this);
+        socket->setProxy(QNetworkProxy::NoProxy);
+        m_connections[i].socket = socket;
+        m_socketIndex.insert(socket, i);
+
+        connect(socket, &QTcpSocket::connected, this, &CTrafficGeneratorWorker::onConnected);
+        connect(socket, &QTcpSocket::disconnected, this, &CTrafficGeneratorWorker::onDisconnected);
+        connect(socket, &QTcpSocket::readyRead, this, &CTrafficGeneratorWorker::onReadyRead);
+        connect(socket, &QTcpSocket::bytesWritten, this, &CTrafficGeneratorWorker::onBytesWritten);
+        // Qt 5.12兼容性：使用SIGNAL/SLOT宏
+        connect(socket, SIGNAL(error(QAbstractSocket::SocketError)),
+                this, SLOT(onSocketError(QAbstractSocket::SocketError)));
+        socket->connectToHost(m_config.host, m_config.port);
+    }
+
+    m_lastPacingNs = m_clock.nsecsElapsed();
+    m_pacingTimer.start();
+    m_statsTimer.start();
+}
+
+/**
+ * @brief 手动停止
+ */
+void CTrafficGeneratorWorker::stop()
+{
+    finish(QString());
+}
+
+/**
+ * @brief 预先生成负载分片
+ *
+ * 图案和随机负载生成有限个不同的分片，按序号轮流使用；
+ * 文件负载按包大小切分，每个连接从头开始顺序循环发送
+ */
+QString CTrafficGeneratorWorker::buildPayloads()
+{
+    m_payloads.clear();
+    m_payloadCrc.clear();
+
+    const int packetSize = m_config.packetSize;
+    const int slots = int(qBound<qint64>(1, MAX_SLOT_BYTES / packetSize, MAX_PAYLOAD_SLOTS));
+
+    switch (m_config.payload) {
+        case CTrafficGenerator::PAYLOAD_PATTERN:
+            for (int slot = 0; slot < slots; ++slot) {
+                QByteArray payload(packetSize, Qt::Uninitialized);
+                char* out = payload.data();
+                for (int i = 0; i < packetSize; ++i) {
+                    out[i] = char((slot + i) & 0xFF);
+                }
+                m_payloads.append(payload);
+            }
+            break;
+        case CTrafficGenerator::PAYLOAD_RANDOM: {
+            // xorshift64*，只在开始时生成，不需要密码学强度
+            quint64 state = quint64(QDateTime::currentMSecsSinceEpoch()) | 1;
+            for (int slot = 0; slot < slots; ++slot) {
+                QByteArray payload(packetSize, Qt::Uninitialized);
+                char* out = payload.data();
+                for (int i = 0; i < packetSize; i += 8) {
+                    state ^= state >> 12;
+                    state ^= state << 25;
+                    state ^= state >> 27;
+                    const quint64 value = state * 0x2545F4914F6CDD1DULL;
+                    std::memcpy(out + i, &value, size_t(qMin(8, packetSize - i)));
+                }
+                m_payloads.append(payload);
+            }
+            break;
+        }
+        case CTrafficGenerator::PAYLOAD_FIXED: {
+            QByteArray payload(packetSize, Qt::Uninitialized);
+            const QByteArray& pattern = m_config.fixedData;
+            for (int i = 0; i < packetSize; i += pattern.size()) {
+                std::memcpy(payload.data() + i, pattern.constData(), size_t(qMin(int(pattern.size()), packetSize - i)));
+            }
+            m_payloads.append(payload);
+            break;
+        }
+        case CTrafficGenerator::PAYLOAD_FILE: {
+            QFile file(m_config.filePath);
+            if (!file.open(QIODevice::ReadOnly)) {
+                return QString("无法打开文件：%1").arg(file.errorString());
+            }
+            const QByteArray content = file.readAll();
+            if (content.isEmpty()) {
+                return QString("文件为空：%1").arg(m_config.filePath);
+            }
+            m_payloads.reserve(content.size() / packetSize + 1);
+            for (int offset = 0; offset < content.size(); offset += packetSize) {
+                m_payloads.append(content.mid(offset, packetSize));
+            }
+            break;
+        }
+    }
+
+    if (m_config.framed) {
+        m_payloadCrc.reserve(m_payloads.size());
+        for (const QByteArray& payload : m_payloads) {
+            m_payloadCrc.append(CTrafficVerifier::crc32(payload.constData(), payload.size()));
+        }
+    }
+    return QString();
+}
+
+/**
+ * @brief 连接建立
+ */
+void CTrafficGeneratorWorker::onConnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!m_socketIndex.contains(socket)) {
+        return;
+    }
+    m_connections[m_socketIndex.value(socket)].connected = true;
+    if (m_stopping) {
+        socket->disconnectFromHost();
+        return;
+    }
+    pump();
+}
+
+/**
+ * @brief 连接断开
+ */
+void CTrafficGeneratorWorker::onDisconnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!m_socketIndex.contains(socket)) {
+        return;
+    }
+    m_connections[m_socketIndex.value(socket)].connected = false;
+    checkFinished();
+}
+
+/**
+ * @brief 对端回显的数据：计数并校验
+ */
+void CTrafficGeneratorWorker::onReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!m_socketIndex.contains(socket)) {
+        return;
+    }
+
+    const QByteArray data = socket->readAll();
+    m_bytesReceived += data.size();
+    if (m_config.framed && !data.isEmpty()) {
+        m_connections[m_socketIndex.value(socket)].verifier.feed(data);
+    }
+}
+
+/**
+ * @brief 数据已写入网络：计数并继续写
+ */
+void CTrafficGeneratorWorker::onBytesWritten(qint64 bytes)
+{
+    m_bytesSent += bytes;
+    m_metricBytesSent->add(bytes);
+    if (!m_stopping && m_config.rateBytesPerSec <= 0) {
+        pump();
+    }
+}
+
+/**
+ * @brief 套接字错误
+ */
+void CTrafficGeneratorWorker::onSocketError(QAbstractSocket::SocketError error)
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!m_socketIndex.contains(socket)) {
+        return;
+    }
+
+    Connection& connection = m_connections[m_socketIndex.value(socket)];
+    if (!connection.connected && error != QAbstractSocket::RemoteHostClosedError) {
+        m_failedConnections++;
+        qDebug() << "❌ 流量发生器连接失败：" << socket->errorString();
+    }
+    connection.connected = false;
+
+    // 所有连接都已失败或断开时结束
+    bool anyAlive = false;
+    for (const Connection& other : m_connections) {
+        if (other.socket->state() != QAbstractSocket::UnconnectedState) {
+            anyAlive = true;
+            break;
+        }
+    }
+    if (!anyAlive && !m_stopping) {
+        finish(socket->errorString());
+    }
+    checkFinished();
+}
+
+/**
+ * @brief 限速节拍：补充令牌并写出
+ */
+void CTrafficGeneratorWorker::onPacingTick()
+{
+    if (m_config.durationSec > 0 && m_clock.elapsed() >= qint64(m_config.durationSec) * 1000) {
+        finish(QString());
+        return;
+    }
+
+    const qint64 now = m_clock.nsecsElapsed();
+    if (m_config.rateBytesPerSec > 0) {
+        // 令牌最多累积 BURST_MS 的量，且至少能发一个完整的包
+        const double burstMs = BURST_MS;
+        const double maxTokens = qMax(m_config.rateBytesPerSec * burstMs / 1000.0,
+                                      double(m_config.packetSize + CTrafficVerifier::HEADER_SIZE));
+        m_tokens = qMin(maxTokens, m_tokens + m_config.rateBytesPerSec * ((now - m_lastPacingNs) / 1e9));
+    }
+    m_lastPacingNs = now;
+    pump();
+}
+
+/**
+ * @brief 在配额和水位允许时写出下一批包
+ *
+ * 各连接轮流写一个包，限速时令牌用完即停，下一节拍从停下的连接继续
+ */
+void CTrafficGeneratorWorker::pump()
+{
+    if (m_stopping || m_payloads.isEmpty()) {
+        return;
+    }
+
+    const bool limited = m_config.rateBytesPerSec > 0;
+    const int headerSize = m_config.framed ? CTrafficVerifier::HEADER_SIZE : 0;
+    const int count = m_connections.size();
+    bool wrote = true;
+    while (wrote) {
+        wrote = false;
+        for (int n = 0; n < count; ++n) {
+            const int index = (m_nextConnection + n) % count;
+            Connection& connection = m_connections[index];
+            if (!connection.connected || connection.socket->bytesToWrite() >= WRITE_LOW_WATER) {
+                continue;
+            }
+
+            const int size = headerSize + m_payloads.at(int(connection.sequence % quint64(m_payloads.size()))).size();
+            if (limited && m_tokens < size) {
+                m_nextConnection = index;
+                return;
+            }
+            writePacket(index, connection);
+            if (limited) {
+                m_tokens -= size;
+            }
+            wrote = true;
+        }
+    }
+}
+
+/**
+ * @brief 向连接写出一个包
+ * @param index 连接序号（帧头中的流编号）
+ * @param connection 连接
+ */
+void CTrafficGeneratorWorker::writePacket(int index, Connection& connection)
+{
+    const int slot = int(connection.sequence % quint64(m_payloads.size()));
+    const QByteArray& payload = m_payloads.at(slot);
+
+    if (m_config.framed) {
+        char header[CTrafficVerifier::HEADER_SIZE];
+        CTrafficVerifier::writeHeader(header, quint32(index), connection.sequence,
+                                      quint32(payload.size()), m_payloadCrc.at(slot));
+        connection.socket->write(header, CTrafficVerifier::HEADER_SIZE);
+    }
+    connection.socket->write(payload);
+
+    connection.sequence++;
+    m_packetsSent++;
+    m_metricPacketsSent->increment();
+}
+
+/**
+ * @brief 结束发送
+ * @param reason 结束原因，正常结束时为空
+ */
+void CTrafficGeneratorWorker::finish(const QString& reason)
+{
+    if (m_stopping) {
+        return;
+    }
+    m_stopping = true;
+    m_finishReason = reason;
+    m_pacingTimer.stop();
+
+    // disconnectFromHost 会等已排队的数据写完再关闭
+    for (Connection& connection : m_connections) {
+        if (connection.socket->state() == QAbstractSocket::ConnectedState) {
+            connection.socket->disconnectFromHost();
+        } else {
+            connection.socket->abort();
+        }
+    }
+    m_drainTimer.start(DRAIN_TIMEOUT_MS);
+    checkFinished();
+}
+
+/**
+ * @brief 所有连接关闭后上报最终统计
+ */
+void CTrafficGeneratorWorker::checkFinished()
+{
+    if (!m_stopping || m_finishedEmitted) {
+        return;
+    }
+    for (const Connection& connection : m_connections) {
+        if (connection.socket->state() != QAbstractSocket::UnconnectedState) {
+            return;
+        }
+    }
+
+    m_finishedEmitted = true;
+    m_statsTimer.stop();
+    m_drainTimer.stop();
+
+    // 套接字保留到下次开始时再释放：这里可能正处在遍历连接的 abort/disconnectFromHost 调用中
+    CTrafficGenerator::Stats stats = snapshot();
+    stats.running = false;
+    emit finished(stats);
+}
+
+/**
+ * @brief 上报周期统计
+ */
+void CTrafficGeneratorWorker::publishStats()
+{
+    const qint64 elapsedMs = m_clock.elapsed();
+    const qint64 intervalMs = qMax<qint64>(1, elapsedMs - m_lastStatsMs);
+    m_currentBps = (m_bytesSent - m_lastStatsBytes) * 1000.0 / intervalMs;
+    m_lastStatsBytes = m_bytesSent;
+    m_lastStatsMs = elapsedMs;
+
+    emit progress(snapshot());
+}
+
+/**
+ * @brief 当前统计
+ */
+CTrafficGenerator::Stats CTrafficGeneratorWorker::snapshot() const
+{
+    CTrafficGenerator::Stats stats;
+    stats.running = !m_finishedEmitted;
+    stats.elapsedMs = m_clock.elapsed();
+    stats.failedConnections = m_failedConnections;
+    stats.bytesSent = m_bytesSent;
+    stats.packetsSent = m_packetsSent;
+    stats.bytesReceived = m_bytesReceived;
+    stats.throughputBps = m_bytesSent * 1000.0 / qMax<qint64>(1, stats.elapsedMs);
+    stats.currentBps = m_currentBps;
+    stats.error = m_finishReason;
+    for (const Connection& connection : m_connections) {
+        if (connection.connected) {
+            stats.activeConnections++;
+        }
+        stats.echo += connection.verifier.result();
+    }
+    return stats;
+}
@@ -0,0 +1,299 @@
+#ifndef TRAFFICGENERATOR_H
+#define TRAFFICGENERATOR_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include "metricsregistry.h"
+
+/**
+ * @class CTrafficVerifier
+ * @brief 流量发生器数据的接收端完整性校验
+ *
+ * 开启校验帧头时，发生器发出的每个包前面都有24字节帧头（小端）：
+ *   "TGEN" | 流编号(4) | 序号(8) | 负载长度(4) | 负载CRC32(4)
+ * 校验器从任意分段的TCP字节流中还原包，检查CRC、序号连续性，
+ * 帧头不对时向后搜索下一个 "TGEN" 重新同步
+ */
+class CTrafficVerifier
+{
+public:
+    static const int HEADER_SIZE = 24;                      ///< 帧头长度
+    static const quint32 MAX_PAYLOAD = 16 * 1024 * 1024;    ///< 单包负载上限，超出视为帧头损坏
+
+    /**
+     * @struct Result
+     * @brief 校验结果
+     */
+    struct Result
+    {
+        qint64 packets = 0;             ///< 完整收到的包数
+        qint64 bytes = 0;               ///< 完整收到的负载字节数
+        qint64 lostPackets = 0;         ///< 序号跳过的包数
+        qint64 reorderedPackets = 0;    ///< 序号回退（乱序或重复）的包数
+        qint64 checksumErrors = 0;      ///< CRC不符的包数
+        qint64 framingErrors = 0;       ///< 帧头损坏、重新同步的次数
+
+        bool isClean() const { return lostPackets == 0 && reorderedPackets == 0 && checksumErrors == 0 && framingErrors == 0; }
+        Result& operator+=(const Result& other);
+        Result& operator-=(const Result& other);
+    };
+
+    /**
+     * @brief 输入收到的数据（可以是任意分段）
+     */
+    void feed(const QByteArray& data);
+
+    const Result& result() const { return m_result; }
+    void reset();
+
+    /**
+     * @brief CRC-32（IEEE 802.3，与 zlib 一致）
+     */
+    static quint32 crc32(const char* data, int size);
+
+    /**
+     * @brief 写入帧头
+     * @param out 至少 HEADER_SIZE 字节
+     */
+    static void writeHeader(char* out, quint32 stream, quint64 sequence, quint32 length, quint32 crc);
+
+private:
+    QByteArray m_buffer;                    ///< 未凑齐一个包的数据
+    QHash<quint32, quint64> m_nextSequence; ///< 每个流期望的下一个序号
+    bool m_synced = false;                  ///< 当前是否对齐在帧头上（对齐前的损坏不计数）
+    Result m_result;
+};
+
+class CTrafficGeneratorWorker;
+
+/**
+ * @class CTrafficGenerator
+ * @brief 网络调试器的流量发生器（类似 iperf 的客户端）
+ *
+ * 向目标地址建立一个或多个并行连接，按配置的包大小和总速率发送
+ * 固定内容、随机数据、递增图案或文件内容，持续指定时长：
+ * - 发送在工作线程中进行，令牌桶限速，套接字待发送字节低于水位时才继续写
+ * - 吞吐量按实际写入网络的字节数统计（每秒上报一次）
+ * - 开启校验帧头时接收端可以用 CTrafficVerifier 检查丢包、乱序和数据损坏；
+ *   对端回显时发生器自己也会校验收到的数据
+ * - 负载在开始时预先生成为若干共享分片（含CRC），发送时不逐包生成数据
+ */
+class CTrafficGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum PayloadMode
+     * @brief 负载内容
+     */
+    enum PayloadMode {
+        PAYLOAD_PATTERN,    ///< 递增字节图案
+        PAYLOAD_RANDOM,     ///< 随机数据
+        PAYLOAD_FIXED,      ///< 固定内容（重复填满包）
+        PAYLOAD_FILE        ///< 文件内容（按包大小顺序切分，循环发送）
+    };
+
+    /**
+     * @struct Config
+     * @brief 发生器配置
+     */
+    struct Config
+    {
+        QString host = "127.0.0.1";
+        quint16 port = 12345;
+        int connections = 1;            ///< 并行连接数
+        PayloadMode payload = PAYLOAD_PATTERN;
+        int packetSize = 1024;          ///< 每包负载字节数（不含校验帧头）
+        qint64 rateBytesPerSec = 0;     ///< 所有连接的总发送速率，0表示不限速
+        int durationSec = 10;           ///< 持续时间，0表示直到手动停止
+        QByteArray fixedData;           ///< PAYLOAD_FIXED 的内容
+        QString filePath;               ///< PAYLOAD_FILE 的文件
+        bool framed = true;             ///< 每包加校验帧头
+    };
+
+    /**
+     * @struct Stats
+     * @brief 发生器统计
+     */
+    struct Stats
+    {
+        bool running = false;
+        qint64 elapsedMs = 0;
+        int activeConnections = 0;
+        int failedConnections = 0;
+        qint64 bytesSent = 0;           ///< 已写入网络的字节数（含帧头）
+        qint64 packetsSent = 0;         ///< 已交给套接字的包数
+        qint64 bytesReceived = 0;       ///< 对端回显的字节数
+        double throughputBps = 0.0;     ///< 平均发送吞吐量（字节/秒）
+        double currentBps = 0.0;        ///< 最近一个统计周期的发送吞吐量
+        CTrafficVerifier::Result echo;  ///< 回显数据的校验结果
+        QString error;                  ///< 结束原因（正常结束时为空）
+    };
+
+    static const int MAX_CONNECTIONS = 256;                     ///< 并行连接数上限
+    static const int MAX_PACKET_SIZE = 4 * 1024 * 1024;         ///< 包大小上限
+    static const qint64 MAX_FILE_BYTES = 256 * 1024 * 1024;     ///< 文件负载大小上限
+    static const int STATS_INTERVAL_MS = 1000;                  ///< 统计上报周期
+
+    explicit CTrafficGenerator(QObject *parent = nullptr);
+    ~CTrafficGenerator();
+
+    /**
+     * @brief 开始发送
+     * @return 配置无效或文件读取失败时返回false，原因见 errorString()
+     */
+    bool start(const Config& config);
+
+    /**
+     * @brief 停止发送（已排队的数据发完后断开）
+     */
+    void stop();
+
+    bool isRunning() const { return m_running; }
+    Stats stats() const { return m_stats; }
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief 格式化统计信息
+     */
+    static QString formatStats(const Stats& stats);
+
+signals:
+    /**
+     * @brief 每秒一次的统计
+     */
+    void progress(const CTrafficGenerator::Stats& stats);
+
+    /**
+     * @brief 发送结束（时长到达、手动停止或全部连接失败）
+     */
+    void finished(const CTrafficGenerator::Stats& stats);
+
+private slots:
+    void onWorkerProgress(const CTrafficGenerator::Stats& stats);
+    void onWorkerFinished(const CTrafficGenerator::Stats& stats);
+
+private:
+    QThread* m_thread;
+    CTrafficGeneratorWorker* m_worker;
+    bool m_running;
+    Stats m_stats;
+    QString m_errorString;
+};
+
+Q_DECLARE_METATYPE(CTrafficGenerator::Config)
+Q_DECLARE_METATYPE(CTrafficGenerator::Stats)
+
+/**
+ * @class CTrafficGeneratorWorker
+ * @brief 流量发生器的工作线程对象，公共槽函数只能通过队列调用
+ */
+class CTrafficGeneratorWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CTrafficGeneratorWorker(QObject *parent = nullptr);
+
+public slots:
+    void start(const CTrafficGenerator::Config& config);
+    void stop();
+
+signals:
+    void progress(const CTrafficGenerator::Stats& stats);
+    void finished(const CTrafficGenerator::Stats& stats);
+
+private slots:
+    void onConnected();
+    void onDisconnected();
+    void onReadyRead();
+    void onBytesWritten(qint64 bytes);
+    void onSocketError(QAbstractSocket::SocketError error);
+    void onPacingTick();
+    void publishStats();
+
+private:
+    /**
+     * @brief 单个连接状态
+     */
+    struct Connection
+    {
+        QTcpSocket* socket = nullptr;
+        quint64 sequence = 0;           ///< 下一个包的序号
+        CTrafficVerifier verifier;      ///< 回显数据校验
+        bool connected = false;
+    };
+
+    /**
+     * @brief 预先生成负载分片和CRC
+     * @return 失败原因，成功时为空
+     */
+    QString buildPayloads();
+
+    /**
+     * @brief 在配额和水位允许时写出下一批包
+     */
+    void pump();
+
+    /**
+     * @brief 向连接写出一个包
+     */
+    void writePacket(int index, Connection& connection);
+
+    /**
+     * @brief 结束发送：停止计时，等数据写完后断开
+     */
+    void finish(const QString& reason);
+
+    /**
+     * @brief 所有连接关闭后上报最终统计
+     */
+    void checkFinished();
+
+    CTrafficGenerator::Stats snapshot() const;
+
+    static const int PACING_INTERVAL_MS = 2;            ///< 限速节拍
+    static const int BURST_MS = 20;                     ///< 令牌桶最多累积的发送时长
+    static const int DRAIN_TIMEOUT_MS = 3000;           ///< 结束时等待数据写完的最长时间
+    static const qint64 WRITE_LOW_WATER = 256 * 1024;   ///< 待发送字节低于此值时继续写
+    static const int MAX_PAYLOAD_SLOTS = 256;           ///< 图案/随机负载的分片数上限
+    static const qint64 MAX_SLOT_BYTES = 16 * 1024 * 1024; ///< 图案/随机负载分片的总字节数上限
+
+    CTrafficGenerator::Config m_config;
+    QVector<QByteArray> m_payloads;     ///< 预先生成的负载分片
+    QVector<quint32> m_payloadCrc;      ///< 各分片的CRC
+    QVector<Connection> m_connections;
+    QHash<QTcpSocket*, int> m_socketIndex;
+    int m_nextConnection;               ///< 轮转写入的起点
+
+    QElapsedTimer m_clock;
+    QTimer m_pacingTimer;
+    QTimer m_statsTimer;
+    QTimer m_drainTimer;                ///< 结束时等待数据写完的超时
+    qint64 m_lastPacingNs;
+    double m_tokens;                    ///< 令牌桶中可发送的字节数
+    qint64 m_lastStatsBytes;
+    qint64 m_lastStatsMs;
+    bool m_stopping;
+    bool m_finishedEmitted;
+
+    qint64 m_bytesSent;
+    qint64 m_packetsSent;
+    qint64 m_bytesReceived;
+    int m_failedConnections;
+    double m_currentBps;
+    QString m_finishReason;
+
+    CMetricsRegistry::Metric* m_metricBytesSent;
+    CMetricsRegistry::Metric* m_metricPacketsSent;
+};
+
+#endif // TRAFFICGENERATOR_H